@@ -0,0 +1,580 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#include <omp.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+#include <machinelearning.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/symmetric.hpp>
+#include <boost/program_options/parsers.hpp>
+#include <boost/program_options/variables_map.hpp>
+#include <boost/program_options/options_description.hpp>
+
+
+namespace po        = boost::program_options;
+namespace ublas     = boost::numeric::ublas;
+namespace cluster   = machinelearning::clustering;
+namespace distance  = machinelearning::distances;
+namespace ga        = machinelearning::geneticalgorithm;
+namespace tools     = machinelearning::tools;
+namespace dim       = machinelearning::dimensionreduce::nonsupervised;
+namespace nb        = machinelearning::neighborhood;
+
+
+/** @cond
+ abstract benchmark case, the setup call creates the data and is not timed, the run call is timed **/
+class benchmark
+{
+    public :
+    
+        virtual ~benchmark( void ) {}
+    
+        /** returns the name of the benchmark **/
+        virtual std::string getName( void ) const = 0;
+    
+        /** creates the data of the benchmark
+         * @param p_data synthetic data (rows are points)
+         * @param p_iteration number of iterations for iterative algorithms
+         **/
+        virtual void setup( const ublas::matrix<double>& p_data, const std::size_t& p_iteration ) = 0;
+    
+        /** runs the timed part **/
+        virtual void run( void ) = 0;
+};
+
+
+/** distance calculation of each point to all points (one-to-many call) **/
+class euclidbenchmark : public benchmark
+{
+    public :
+    
+        std::string getName( void ) const { return "distance.euclid"; }
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& ) { m_data = p_data; }
+    
+        void run( void )
+        {
+            #pragma omp parallel for
+            for(std::size_t i=0; i < m_data.size1(); ++i)
+                m_distance.getDistance( m_data, static_cast< ublas::vector<double> >(ublas::row(m_data, i)) );
+        }
+    
+    private :
+    
+        distance::norm::euclid<double> m_distance;
+        ublas::matrix<double> m_data;
+};
+
+
+/** neural gas training **/
+class neuralgasbenchmark : public benchmark
+{
+    public :
+    
+        std::string getName( void ) const { return "clustering.neuralgas"; }
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& p_iteration ) { m_data = p_data; m_iteration = p_iteration; }
+    
+        void run( void )
+        {
+            cluster::nonsupervised::neuralgas<double> l_ng( m_distance, 10, m_data.size2() );
+            l_ng.train( m_data, m_iteration );
+        }
+    
+    private :
+    
+        distance::norm::euclid<double> m_distance;
+        ublas::matrix<double> m_data;
+        std::size_t m_iteration;
+};
+
+
+/** k-means training **/
+class kmeansbenchmark : public benchmark
+{
+    public :
+    
+        std::string getName( void ) const { return "clustering.kmeans"; }
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& p_iteration ) { m_data = p_data; m_iteration = p_iteration; }
+    
+        void run( void )
+        {
+            cluster::nonsupervised::kmeans<double> l_kmeans( m_distance, 10, m_data.size2() );
+            l_kmeans.train( m_data, m_iteration );
+        }
+    
+    private :
+    
+        distance::norm::euclid<double> m_distance;
+        ublas::matrix<double> m_data;
+        std::size_t m_iteration;
+};
+
+
+/** rlvq training, the label is the half space of the first dimension **/
+class rlvqbenchmark : public benchmark
+{
+    public :
+    
+        std::string getName( void ) const { return "clustering.rlvq"; }
+    
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& p_iteration )
+        {
+            m_data      = p_data;
+            m_iteration = p_iteration;
+            m_labels.clear();
+            for(std::size_t i=0; i < p_data.size1(); ++i)
+                m_labels.push_back( p_data(i,0) > 0.5 ? 1 : 0 );
+        }
+    
+        void run( void )
+        {
+            std::vector<std::size_t> l_prototypes;
+            for(std::size_t i=0; i < 10; ++i)
+                l_prototypes.push_back( i % 2 );
+        
+            cluster::supervised::rlvq<double, std::size_t> l_rlvq( m_distance, l_prototypes, m_data.size2() );
+            l_rlvq.train( m_data, m_labels, m_iteration );
+        }
+    
+    private :
+    
+        distance::norm::euclid<double> m_distance;
+        ublas::matrix<double> m_data;
+        std::vector<std::size_t> m_labels;
+        std::size_t m_iteration;
+};
+
+
+/** normalized compression distance of the formatted data rows (uses a tenth of the rows, because of the quadratic run time) **/
+class ncdbenchmark : public benchmark
+{
+    public :
+    
+        std::string getName( void ) const { return "distance.ncd.symmetric"; }
+    
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& )
+        {
+            m_text.clear();
+            for(std::size_t i=0; i < std::max(static_cast<std::size_t>(2), p_data.size1()/10); ++i) {
+                std::ostringstream l_stream;
+                for(std::size_t j=0; j < p_data.size2(); ++j)
+                    l_stream << p_data(i % p_data.size1(), j) << " ";
+                m_text.push_back( l_stream.str() );
+            }
+        }
+    
+        void run( void ) { m_ncd.symmetric( m_text ); }
+    
+    private :
+    
+        distance::ncd<double> m_ncd;
+        std::vector<std::string> m_text;
+};
+
+
+/** metric MDS projection of the distance matrix **/
+class mdsbenchmark : public benchmark
+{
+    public :
+    
+        std::string getName( void ) const { return "dimensionreduce.mds"; }
+    
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& )
+        {
+            m_distance = ublas::matrix<double>( p_data.size1(), p_data.size1() );
+            for(std::size_t i=0; i < p_data.size1(); ++i)
+                ublas::row(m_distance, i) = m_euclid.getDistance( p_data, static_cast< ublas::vector<double> >(ublas::row(p_data, i)) );
+        }
+    
+        void run( void )
+        {
+            dim::mds<double> l_mds( 2, dim::mds<double>::metric );
+            l_mds.map( m_distance );
+        }
+    
+    private :
+    
+        distance::norm::euclid<double> m_euclid;
+        ublas::matrix<double> m_distance;
+};
+
+
+/** eigen decomposition of the symmetric Gram matrix **/
+class eigenbenchmark : public benchmark
+{
+    public :
+    
+        std::string getName( void ) const { return "tools.lapack.eigen"; }
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& ) { m_gram = ublas::prod( p_data, ublas::trans(p_data) ); }
+    
+        void run( void )
+        {
+            ublas::vector<double> l_values;
+            ublas::matrix<double> l_vectors;
+            tools::lapack::eigen( m_gram, l_values, l_vectors );
+        }
+    
+    private :
+    
+        ublas::matrix<double> m_gram;
+};
+
+
+/** k-nearest-neighbour search of all points, with the serial search or the parallel search, that returns the distances, too **/
+class knnbenchmark : public benchmark
+{
+    public :
+    
+        knnbenchmark( const bool& p_parallel ) : m_parallel( p_parallel ), m_distance(), m_knn( m_distance, 5 ) {}
+        std::string getName( void ) const { return m_parallel ? "neighborhood.knn.parallel" : "neighborhood.knn.serial"; }
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& ) { m_data = p_data; }
+    
+        void run( void )
+        {
+            if (m_parallel)
+                m_knn.get( m_data, m_data, m_distances );
+            else
+                m_knn.get( m_data, m_data );
+        }
+    
+    private :
+    
+        const bool m_parallel;
+        distance::norm::euclid<double> m_distance;
+        nb::knn<double> m_knn;
+        ublas::matrix<double> m_data;
+        ublas::matrix<double> m_distances;
+};
+
+
+#ifdef MACHINELEARNING_FILES
+/** reading a CSV file, that is written on setup **/
+class csvbenchmark : public benchmark
+{
+    public :
+    
+        csvbenchmark( const std::string& p_file ) : m_file( p_file ) {}
+        ~csvbenchmark( void ) { std::remove( m_file.c_str() ); }
+        std::string getName( void ) const { return "tools.files.csv"; }
+    
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& ) { m_csv.write<double>( m_file, p_data, ' ', true ); }
+    
+        void run( void ) { m_csv.readBlasMatrix<double>( m_file, " ", true ); }
+    
+    private :
+    
+        const std::string m_file;
+        tools::files::csv m_csv;
+};
+#endif
+
+
+#ifdef MACHINELEARNING_FILES_HDF
+/** reading a HDF file, that is written on setup **/
+class hdfbenchmark : public benchmark
+{
+    public :
+    
+        hdfbenchmark( const std::string& p_file ) : m_file( p_file ) {}
+        ~hdfbenchmark( void ) { std::remove( m_file.c_str() ); }
+        std::string getName( void ) const { return "tools.files.hdf"; }
+    
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& )
+        {
+            tools::files::hdf l_file( m_file, true );
+            l_file.writeBlasMatrix<double>( "/data", p_data, tools::files::hdf::NATIVE_DOUBLE );
+        }
+    
+        void run( void )
+        {
+            tools::files::hdf l_file( m_file );
+            l_file.readBlasMatrix<double>( "/data", tools::files::hdf::NATIVE_DOUBLE );
+        }
+    
+    private :
+    
+        const std::string m_file;
+};
+#endif
+
+
+/** fitness of the GA benchmark (knapsack on the first data column) **/
+class knapsack : public ga::fitness::bitfitness<double>
+{
+    public :
+    
+        knapsack( const ublas::vector<double>& p_weight ) : m_weight( p_weight ), m_max( ublas::sum(p_weight) / 2 ) {}
+    
+        double getFitness( const ga::individual::bitindividual& p_individual )
+        {
+            const double l_sum = p_individual.sum( m_weight );
+            return l_sum > m_max ? 0 : l_sum;
+        }
+    
+        bool isOptimumReached( void ) const { return false; }
+        void clone( boost::shared_ptr< ga::fitness::bitfitness<double> >& p_ptr ) const { p_ptr = boost::shared_ptr< ga::fitness::bitfitness<double> >( new knapsack(m_weight) ); }
+        void onEachIteration( const std::vector<ga::individual::bitindividual>& ) {}
+    
+    private :
+    
+        const ublas::vector<double> m_weight;
+        const double m_max;
+};
+
+
+/** genetic algorithm generations (population size is the number of rows) **/
+class gabenchmark : public benchmark
+{
+    public :
+    
+        std::string getName( void ) const { return "geneticalgorithm.bitpopulation"; }
+    
+        void setup( const ublas::matrix<double>& p_data, const std::size_t& p_iteration )
+        {
+            m_weight    = ublas::column( p_data, 0 );
+            m_size      = std::max( static_cast<std::size_t>(10), p_data.size1() / 10 );
+            m_iteration = p_iteration;
+        }
+    
+        void run( void )
+        {
+            knapsack l_fitness( m_weight );
+            ga::bitpopulation<double> l_population( m_weight.size(), m_size, std::max<std::size_t>(2, m_size / 10), 2 );
+            l_population.iterate( m_iteration, l_fitness );
+        }
+    
+    private :
+    
+        ublas::vector<double> m_weight;
+        std::size_t m_size;
+        std::size_t m_iteration;
+};
+
+
+/** result of one benchmark run **/
+struct result
+{
+    std::string name;
+    std::size_t size;
+    std::size_t threads;
+    std::vector<double> times;
+};
+
+
+/** creates the synthetic data with four clouds in the unit cube
+ * @param p_size number of points
+ * @param p_dimension dimension
+ * @return data matrix
+ **/
+ublas::matrix<double> createData( const std::size_t& p_size, const std::size_t& p_dimension )
+{
+    tools::sources::cloud<double> l_cloud( p_dimension );
+    l_cloud.setVariance( 0.05, 0.05 );
+    l_cloud.setPoints( p_size / 4 + 1, p_size / 4 + 1 );
+    for(std::size_t i=0; i < p_dimension; ++i)
+        l_cloud.setRange( i, 0, 1, i < 2 ? 2 : 1 );
+    
+    ublas::matrix<double> l_data = l_cloud.generate( tools::sources::cloud<double>::all, 0.5, true );
+    l_data.resize( std::min(p_size, l_data.size1()), l_data.size2(), true );
+    return l_data;
+}
+
+
+/** writes the results as JSON
+ * @param p_stream output stream
+ * @param p_dimension data dimension
+ * @param p_iteration iterations
+ * @param p_results results
+ **/
+void writeJSON( std::ostream& p_stream, const std::size_t& p_dimension, const std::size_t& p_iteration, const std::vector<result>& p_results )
+{
+    p_stream << "{\n  \"dimension\" : " << p_dimension << ",\n  \"iterations\" : " << p_iteration << ",\n  \"maxthreads\" : " << omp_get_num_procs() << ",\n  \"results\" : [\n";
+    
+    for(std::size_t i=0; i < p_results.size(); ++i) {
+        std::vector<double> l_times( p_results[i].times );
+        std::sort( l_times.begin(), l_times.end() );
+        
+        double l_mean = 0;
+        for(std::size_t j=0; j < l_times.size(); ++j)
+            l_mean += l_times[j];
+        l_mean /= l_times.size();
+        
+        p_stream << "    { \"name\" : \"" << p_results[i].name << "\", \"size\" : " << p_results[i].size << ", \"threads\" : " << p_results[i].threads
+                 << ", \"min\" : " << l_times.front() << ", \"median\" : " << l_times[l_times.size()/2] << ", \"mean\" : " << l_mean << ", \"max\" : " << l_times.back()
+                 << ", \"times\" : [";
+        for(std::size_t j=0; j < p_results[i].times.size(); ++j)
+            p_stream << (j == 0 ? "" : ", ") << p_results[i].times[j];
+        p_stream << "] }" << (i+1 < p_results.size() ? "," : "") << "\n";
+    }
+    
+    p_stream << "  ]\n}" << std::endl;
+}
+/** @endcond **/
+
+
+
+/** main program, that runs the benchmarks for each problem size and thread count
+ * and writes the timing results (in seconds) as JSON
+ * @param p_argc number of arguments
+ * @param p_argv arguments
+ **/
+int main(int p_argc, char* p_argv[])
+{
+    #ifdef MACHINELEARNING_MULTILANGUAGE
+    tools::language::bindings::bind();
+    #endif
+    
+    std::size_t l_dimension;
+    std::size_t l_iteration;
+    std::size_t l_repeat;
+    
+    // create CML options with description
+    po::options_description l_description("allowed options");
+    l_description.add_options()
+        ("help", "produce help message")
+        ("size", po::value< std::vector<std::size_t> >()->multitoken(), "problem sizes / number of data points [default: 500 1000 2000]")
+        ("threads", po::value< std::vector<std::size_t> >()->multitoken(), "thread counts [default: 1, 2, 4, ... number of processors]")
+        ("dimension", po::value<std::size_t>(&l_dimension)->default_value(10), "data dimension")
+        ("iteration", po::value<std::size_t>(&l_iteration)->default_value(10), "number of iterations of the iterative algorithms")
+        ("repeat", po::value<std::size_t>(&l_repeat)->default_value(3), "number of repeats of each measurement")
+        ("benchmark", po::value< std::vector<std::string> >()->multitoken(), "names (or name prefixes) of the benchmarks [default: all]")
+        ("outfile", po::value<std::string>(), "JSON output file [default: standard output]")
+        ("tempdir", po::value<std::string>(), "directory for temporary files of the file benchmarks [default: current directory]")
+    ;
+    
+    po::variables_map l_map;
+    po::positional_options_description l_input;
+    po::store(po::command_line_parser(p_argc, p_argv).options(l_description).positional(l_input).run(), l_map);
+    po::notify(l_map);
+    
+    if (l_map.count("help")) {
+        std::cout << l_description << std::endl;
+        return EXIT_SUCCESS;
+    }
+    
+    if ((l_dimension < 2) || (l_iteration == 0) || (l_repeat == 0)) {
+        std::cerr << "[--dimension] must be greater than one, [--iteration] and [--repeat] must be greater than zero" << std::endl;
+        return EXIT_FAILURE;
+    }
+    
+    
+    // read sweep values
+    std::vector<std::size_t> l_sizes;
+    if (l_map.count("size"))
+        l_sizes = l_map["size"].as< std::vector<std::size_t> >();
+    else {
+        l_sizes.push_back(500);
+        l_sizes.push_back(1000);
+        l_sizes.push_back(2000);
+    }
+    
+    std::vector<std::size_t> l_threads;
+    if (l_map.count("threads"))
+        l_threads = l_map["threads"].as< std::vector<std::size_t> >();
+    else {
+        for(std::size_t i=1; i < static_cast<std::size_t>(omp_get_num_procs()); i*=2)
+            l_threads.push_back(i);
+        l_threads.push_back( static_cast<std::size_t>(omp_get_num_procs()) );
+    }
+    
+    const std::string l_tempdir = l_map.count("tempdir") ? l_map["tempdir"].as<std::string>() + "/" : "";
+    
+    
+    // create benchmark list
+    std::vector< boost::shared_ptr<benchmark> > l_benchmarks;
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new euclidbenchmark()) );
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new knnbenchmark(false)) );
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new knnbenchmark(true)) );
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new neuralgasbenchmark()) );
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new kmeansbenchmark()) );
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new rlvqbenchmark()) );
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new ncdbenchmark()) );
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new mdsbenchmark()) );
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new eigenbenchmark()) );
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new gabenchmark()) );
+    #ifdef MACHINELEARNING_FILES
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new csvbenchmark(l_tempdir + "benchmark.csv")) );
+    #endif
+    #ifdef MACHINELEARNING_FILES_HDF
+    l_benchmarks.push_back( boost::shared_ptr<benchmark>(new hdfbenchmark(l_tempdir + "benchmark.hdf5")) );
+    #endif
+    
+    if (l_map.count("benchmark")) {
+        const std::vector<std::string> l_filter = l_map["benchmark"].as< std::vector<std::string> >();
+        std::vector< boost::shared_ptr<benchmark> > l_selected;
+        
+        for(std::size_t i=0; i < l_benchmarks.size(); ++i)
+            for(std::size_t j=0; j < l_filter.size(); ++j)
+                if (l_benchmarks[i]->getName().compare(0, l_filter[j].size(), l_filter[j]) == 0) {
+                    l_selected.push_back( l_benchmarks[i] );
+                    break;
+                }
+        
+        l_benchmarks = l_selected;
+    }
+    
+    
+    // run the sweep, the data is created once for each size
+    std::vector<result> l_results;
+    for(std::size_t i=0; i < l_sizes.size(); ++i) {
+        const ublas::matrix<double> l_data = createData( l_sizes[i], l_dimension );
+        
+        for(std::size_t j=0; j < l_benchmarks.size(); ++j) {
+            l_benchmarks[j]->setup( l_data, l_iteration );
+            
+            for(std::size_t n=0; n < l_threads.size(); ++n) {
+                omp_set_num_threads( static_cast<int>(std::max(static_cast<std::size_t>(1), l_threads[n])) );
+                
+                result l_result;
+                l_result.name       = l_benchmarks[j]->getName();
+                l_result.size       = l_data.size1();
+                l_result.threads    = l_threads[n];
+                
+                for(std::size_t k=0; k < l_repeat; ++k) {
+                    const double l_start = omp_get_wtime();
+                    l_benchmarks[j]->run();
+                    l_result.times.push_back( omp_get_wtime() - l_start );
+                }
+                
+                std::cerr << l_result.name << " size " << l_result.size << " threads " << l_result.threads << " done" << std::endl;
+                l_results.push_back( l_result );
+            }
+        }
+    }
+    
+    
+    // write results
+    if (l_map.count("outfile")) {
+        std::ofstream l_file( l_map["outfile"].as<std::string>().c_str() );
+        writeJSON( l_file, l_dimension, l_iteration, l_results );
+    } else
+        writeJSON( std::cout, l_dimension, l_iteration, l_results );
+    
+    return EXIT_SUCCESS;
+}
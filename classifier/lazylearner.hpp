@@ -25,25 +25,39 @@
 #ifndef __MACHINELEARNING_CLASSIFIER_LAZYLEARNER_HPP
 #define __MACHINELEARNING_CLASSIFIER_LAZYLEARNER_HPP
 
+#include <omp.h>
+#include <limits>
 #include <algorithm>
 #include <map>
+#include <functional>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
+#ifdef MACHINELEARNING_MPI
+#include <boost/mpi.hpp>
+#include <boost/serialization/vector.hpp>
+#endif
 
 #include "classifier.hpp"
 #include "../errorhandling/exception.hpp"
 #include "../tools/tools.h"
 #include "../neighborhood/neighborhood.h"
+#include "../clustering/nonsupervised/neuralgas.hpp"
 
 
 
 namespace machinelearning { namespace classifier {
     
     namespace ublas   = boost::numeric::ublas;
+    #ifdef MACHINELEARNING_MPI
+    namespace mpi     = boost::mpi;
+    #endif
     
     
     /** class for create a lazy learner
-     * @todo optimize distance and label extraction with distribution (it should be faster)
+     * @note On the MPI methods each process holds a shard of the database. The query data
+     * is broadcast blockwise, each process determines the nearest neighbours within its shard
+     * and the process with the query data merges the candidates of all processes, so the
+     * database is never stored on one process
      * @todo implementation of the logging structures
      **/
     template<typename T, typename L> class lazylearner : public classifier<T, L> 
@@ -70,6 +84,18 @@ namespace machinelearning { namespace classifier {
             std::vector<T> getLoggedQuantizationError( void ) const;
             std::vector<L> use( const ublas::matrix<T>& ) const;        
             void clearLogging( void );
+            ublas::vector<T> getDatabaseWeights( void ) const;
+        
+            void condenseDatabase( const std::size_t& = 1024, const std::size_t& = 10 );
+            void editDatabase( const std::size_t& = 1024 );
+            void quantizeDatabase( const distances::distance<T>&, const std::size_t&, const std::size_t& );
+        
+            #ifdef MACHINELEARNING_MPI
+            void setDatabase( const mpi::communicator&, const ublas::matrix<T>&, const std::vector<L>& );
+            std::size_t getDatabaseCount( const mpi::communicator& ) const;
+            std::vector<L> use( const mpi::communicator&, const ublas::matrix<T>&, const std::size_t& = 256 ) const;
+            void use( const mpi::communicator& ) const;
+            #endif
         
         
         private :
@@ -82,6 +108,12 @@ namespace machinelearning { namespace classifier {
             ublas::matrix<T> m_basedata;
             /** vector with data label information **/
             std::vector<L> m_baselabels;
+            /** sorted vector with the unique labels **/
+            std::vector<L> m_labels;
+            /** index of each data label within the unique labels **/
+            std::vector<std::size_t> m_baselabelindex;
+            /** vote weight of each data point (number of represented points) **/
+            ublas::vector<T> m_baseweights;
             /** bool for logging **/
             bool m_logging;
             /** std::vector with index of the nearest datapoints for each datapoint  **/
@@ -89,10 +121,16 @@ namespace machinelearning { namespace classifier {
             /** std::vector with quantisation error for each datapoint **/
             std::vector<T> m_quantizationerror;
         
-            std::vector<L> getLabelsWithoutWeight( const ublas::matrix<std::size_t>& ) const;
-            std::vector<L> getLabelsWithWeight( const ublas::matrix<std::size_t>&, const ublas::matrix<T>& ) const;
+            std::vector<std::size_t> getLabelIndex( const ublas::matrix<std::size_t>&, const ublas::matrix<T>&, const std::vector<std::size_t>&, const ublas::vector<T>&, const std::size_t& = std::numeric_limits<std::size_t>::max() ) const;
+            void setDatabase( const std::vector<std::size_t>&, const ublas::vector<T>& );
+            static ublas::matrix<T> getRows( const ublas::matrix<T>&, const std::vector<std::size_t>& );
         
-            static bool labelMapCompair( const std::pair<L, std::size_t>&, const std::pair<L, std::size_t>& );
+            #ifdef MACHINELEARNING_MPI
+            std::vector<std::size_t> getLabelIndex( const mpi::communicator&, const ublas::matrix<T>* const, const std::size_t& ) const;
+            std::vector<T> getCandidates( const ublas::matrix<T>& ) const;
+            std::vector<std::size_t> mergeCandidates( const std::vector<T>&, const std::size_t&, const std::size_t& ) const;
+            static void broadcastQuery( const mpi::communicator&, const ublas::matrix<T>* const, const std::size_t* const, const std::size_t&, const int&, ublas::matrix<T>&, MPI_Request& );
+            #endif
         
     };
     
@@ -105,6 +143,11 @@ namespace machinelearning { namespace classifier {
     template<typename T, typename L> inline lazylearner<T,L>::lazylearner( const neighborhood::neighborhood<T>& p_neighborhood, const weighttype& p_weight ) :
         m_neighborhood( &p_neighborhood ),
         m_weight( p_weight ),
+        m_basedata(),
+        m_baselabels(),
+        m_labels(),
+        m_baselabelindex(),
+        m_baseweights(),
         m_logging( false ),
         m_logprototypes( std::vector< ublas::matrix<T> >() ),
         m_quantizationerror( std::vector< T >() )
@@ -194,94 +237,315 @@ namespace machinelearning { namespace classifier {
         clearLogging();
         m_basedata      = p_data;
         m_baselabels    = p_labels;
+        
+        // create the unique labels and the label index of each data point, so the
+        // voting can be done in an array without any label comparison
+        m_labels = p_labels;
+        std::sort( m_labels.begin(), m_labels.end() );
+        m_labels.erase( std::unique(m_labels.begin(), m_labels.end()), m_labels.end() );
+        
+        m_baselabelindex.resize( p_labels.size() );
+        for(std::size_t i=0; i < p_labels.size(); ++i)
+            m_baselabelindex[i] = static_cast<std::size_t>( std::lower_bound(m_labels.begin(), m_labels.end(), p_labels[i]) - m_labels.begin() );
+        
+        m_baseweights = ublas::scalar_vector<T>( p_labels.size(), 1 );
     }
     
     
+    /** returns the vote weight of each data point (the weight is the number of original data points, that
+     * are represented by the point after a quantization, otherwise one)
+     * @return weight vector
+     **/
+    template<typename T, typename L> inline ublas::vector<T> lazylearner<T, L>::getDatabaseWeights( void ) const
+    {
+        return m_baseweights;
+    }
     
-    /** compair call for std::map, so we get the maximum element (on the second entry)
-     * @param p_left first element
-     * @param p_right right element
-     * @return bool if first pair (second component) is smaller
-    **/
-    template<typename T, typename L> inline bool lazylearner<T,L>::labelMapCompair( const std::pair<L, std::size_t>& p_left, const std::pair<L, std::size_t>& p_right)
+    
+    /** replaces the database with a subset of the points
+     * @param p_index index of the points, that are kept
+     * @param p_weights weights of the kept points
+     **/
+    template<typename T, typename L> inline void lazylearner<T, L>::setDatabase( const std::vector<std::size_t>& p_index, const ublas::vector<T>& p_weights )
+    {
+        std::vector<L> l_labels;
+        std::vector<std::size_t> l_labelindex;
+        for(std::size_t i=0; i < p_index.size(); ++i) {
+            l_labels.push_back( m_baselabels[p_index[i]] );
+            l_labelindex.push_back( m_baselabelindex[p_index[i]] );
+        }
+        
+        clearLogging();
+        m_basedata          = getRows( m_basedata, p_index );
+        m_baselabels        = l_labels;
+        m_baselabelindex    = l_labelindex;
+        m_baseweights       = p_weights;
+    }
+    
+    
+    /** copies the rows of a matrix
+     * @param p_data matrix
+     * @param p_index row indices
+     * @return matrix with the rows
+     **/
+    template<typename T, typename L> inline ublas::matrix<T> lazylearner<T, L>::getRows( const ublas::matrix<T>& p_data, const std::vector<std::size_t>& p_index )
     {
-        return p_left.second < p_right.second;
+        ublas::matrix<T> l_rows( p_index.size(), p_data.size2() );
+        
+        #pragma omp parallel for shared(l_rows)
+        for(std::size_t i=0; i < p_index.size(); ++i)
+            ublas::row(l_rows, i) = ublas::row(p_data, p_index[i]);
+        
+        return l_rows;
     }
     
     
-    /** create labels for every data point (data point label with maximum label counts)
+    
+    /** create the label index for every data point. The label counts / weights are added within a thread-local array with
+     * an entry for each label, the label with the maximum value is used (on equal values the smallest label).
+     * The distances of the neighbourhood search are used for the weights, if a data point is exact over a database
+     * point (distance == 0) the label is set direct
      * @param p_neighbour neighbourhood matrix
-     * @return vector with labels
-    **/
-    template<typename T, typename L> inline std::vector<L> lazylearner<T, L>::getLabelsWithoutWeight( const ublas::matrix<std::size_t>& p_neighbour ) const
+     * @param p_distance distance matrix of the neighbours
+     * @param p_labelindex label index of the neighbour points
+     * @param p_weights vote weights of the neighbour points
+     * @param p_self if the data points are part of the neighbour points, the index of the first data point, so the point itself is not used for voting
+     * @return vector with label index
+     **/
+    template<typename T, typename L> inline std::vector<std::size_t> lazylearner<T, L>::getLabelIndex( const ublas::matrix<std::size_t>& p_neighbour, const ublas::matrix<T>& p_distance, const std::vector<std::size_t>& p_labelindex, const ublas::vector<T>& p_weights, const std::size_t& p_self ) const
     {
-        std::vector<L> l_label; 
-        std::map<L, std::size_t> l_nnlabel;
+        std::vector<std::size_t> l_label( p_neighbour.size1() );
         
-        for(std::size_t i=0; i < p_neighbour.size1(); ++i) {            
-
-            // get label count
-            l_nnlabel.clear();
-            for(std::size_t j=0; j < p_neighbour.size2(); ++j)
-                
-                if ( l_nnlabel.find(m_baselabels[p_neighbour(i,j)]) == l_nnlabel.end())
-                    l_nnlabel.insert( std::pair<L, std::size_t>(m_baselabels[p_neighbour(i,j)], 1) );
-                else
-                    l_nnlabel[ m_baselabels[p_neighbour(i,j)] ]++;
+        #pragma omp parallel shared(l_label)
+        {
+            std::vector<T> l_vote( m_labels.size(), 0 );
             
-            // set this label that is the biggest (most counts)
-            l_label.push_back(  std::max_element(l_nnlabel.begin(), l_nnlabel.end(), labelMapCompair)->first );
+            #pragma omp for
+            for(std::size_t i=0; i < p_neighbour.size1(); ++i) {
+                
+                std::size_t l_exact = m_labels.size();
+                for(std::size_t j=0; (j < p_neighbour.size2()) && (l_exact == m_labels.size()); ++j) {
+                    if ( (p_self != std::numeric_limits<std::size_t>::max()) && (p_neighbour(i,j) == p_self+i) )
+                        continue;
+                    
+                    const std::size_t l_index = p_labelindex[ p_neighbour(i,j) ];
+                    
+                    switch (m_weight) {
+                        
+                        case none :
+                            l_vote[l_index] += p_weights(p_neighbour(i,j));
+                            break;
+                            
+                        case distance :
+                            if (tools::function::isNumericalZero<T>(p_distance(i,j)))
+                                l_exact = l_index;
+                            l_vote[l_index] += p_weights(p_neighbour(i,j)) * p_distance(i,j);
+                            break;
+                            
+                        case inversedistance :
+                            if (tools::function::isNumericalZero<T>(p_distance(i,j)))
+                                l_exact = l_index;
+                            else
+                                l_vote[l_index] += p_weights(p_neighbour(i,j)) * m_neighborhood->invert(p_distance(i,j));
+                            break;
+                    }
+                }
+                
+                // get the maximum and reset only the used entries of the array
+                std::size_t l_max = p_neighbour.size2() > 0 ? p_labelindex[ p_neighbour(i,0) ] : 0;
+                for(std::size_t j=0; j < p_neighbour.size2(); ++j) {
+                    const std::size_t l_index = p_labelindex[ p_neighbour(i,j) ];
+                    if ( (l_vote[l_index] > l_vote[l_max]) || ((l_vote[l_index] == l_vote[l_max]) && (l_index < l_max)) )
+                        l_max = l_index;
+                }
+                for(std::size_t j=0; j < p_neighbour.size2(); ++j)
+                    l_vote[ p_labelindex[p_neighbour(i,j)] ] = 0;
+                
+                l_label[i] = l_exact == m_labels.size() ? l_max : l_exact;
+            }
         }
+        
         return l_label;
     }
     
     
-    /** create weighted labels for every data point (data point label with maximum weight)
-     * @param p_neighbour neighbourhood matrix
-     * @param p_data data values for calculate distance
-     * @return vector with labels
+    /** reduces the database with the condensed nearest neighbour rule. The reduced database starts with one
+     * point of each class, the other points are classified blockwise with the reduced database and the misclassified
+     * points are added after each block. The passes are repeated until no point is added
+     * @param p_block number of points, that are classified in parallel
+     * @param p_passes maximum number of passes over the database
      **/
-    template<typename T, typename L> inline std::vector<L> lazylearner<T, L>::getLabelsWithWeight( const ublas::matrix<std::size_t>& p_neighbour, const ublas::matrix<T>& p_data ) const
+    template<typename T, typename L> inline void lazylearner<T, L>::condenseDatabase( const std::size_t& p_block, const std::size_t& p_passes )
     {
-        std::vector<L> l_label; 
-        std::map<L,T> l_nnlabel;
+        if (p_block == 0)
+            throw exception::runtime(_("block size must be greater than zero"), *this);
+        if (p_passes == 0)
+            throw exception::runtime(_("number of passes must be greater than zero"), *this);
+        if (m_basedata.size1() < m_neighborhood->getNeighborCount())
+            throw exception::runtime(_("database is smaller than the number of neighbors"), *this);
+        
+        // initialize the store with the first point of each class and fill it up to the number of neighbors
+        std::vector<bool> l_used( m_basedata.size1(), false );
+        std::vector<bool> l_labelused( m_labels.size(), false );
+        std::vector<std::size_t> l_store;
+        
+        for(std::size_t i=0; i < m_basedata.size1(); ++i)
+            if (!l_labelused[m_baselabelindex[i]]) {
+                l_labelused[m_baselabelindex[i]] = true;
+                l_used[i] = true;
+                l_store.push_back(i);
+            }
+        for(std::size_t i=0; (i < m_basedata.size1()) && (l_store.size() < m_neighborhood->getNeighborCount()); ++i)
+            if (!l_used[i]) {
+                l_used[i] = true;
+                l_store.push_back(i);
+            }
+        
         
-        for(std::size_t i=0; i < p_neighbour.size1(); ++i) {
+        for(std::size_t n=0; n < p_passes; ++n) {
+            bool l_changed = false;
             
-            // calculate the distance values of the neighbourhood points
-            // if data point exact over a prototype (distance == 0) set lable direct
-            l_nnlabel.clear();
-            for(std::size_t j=0; j < p_neighbour.size2(); ++j) {
-                T l_distance = m_neighborhood->calculateDistance( static_cast< ublas::vector<T> >(ublas::row(p_data,i)), 
-                                                                  static_cast< ublas::vector<T> >(ublas::row(m_basedata, p_neighbour(i,j)))
-                                                                );
+            for(std::size_t i=0; i < m_basedata.size1(); ) {
                 
-                if (tools::function::isNumericalZero<T>(l_distance)) {
-                    l_label.push_back( m_baselabels[p_neighbour(i,j)] );
+                // create the block with unused points
+                std::vector<std::size_t> l_block;
+                for( ; (i < m_basedata.size1()) && (l_block.size() < p_block); ++i)
+                    if (!l_used[i])
+                        l_block.push_back(i);
+                
+                if (l_block.size() == 0)
                     break;
-                }
                 
+                std::vector<std::size_t> l_storelabelindex;
+                ublas::vector<T> l_storeweights( l_store.size() );
+                for(std::size_t j=0; j < l_store.size(); ++j) {
+                    l_storelabelindex.push_back( m_baselabelindex[l_store[j]] );
+                    l_storeweights(j) = m_baseweights(l_store[j]);
+                }
                 
-                if (m_weight == inversedistance)
-                    l_distance = m_neighborhood->invert(l_distance);
+                ublas::matrix<T> l_distance;
+                const ublas::matrix<std::size_t> l_neighbour = m_neighborhood->get( getRows(m_basedata, l_store), getRows(m_basedata, l_block), l_distance );
+                const std::vector<std::size_t> l_label       = getLabelIndex( l_neighbour, l_distance, l_storelabelindex, l_storeweights );
                 
-                // add distance to bucket
-                if ( l_nnlabel.find(m_baselabels[p_neighbour(i,j)]) == l_nnlabel.end())
-                    l_nnlabel.insert( std::pair<L,T>(m_baselabels[p_neighbour(i,j) ], l_distance) );
-                else
-                    l_nnlabel[ m_baselabels[p_neighbour(i,j)] ] += l_distance;
+                // add the misclassified points
+                for(std::size_t j=0; j < l_block.size(); ++j)
+                    if (l_label[j] != m_baselabelindex[l_block[j]]) {
+                        l_used[l_block[j]] = true;
+                        l_store.push_back( l_block[j] );
+                        l_changed = true;
+                    }
             }
             
-            // data point is not over a prototype (normalize buckets and get max element label)
-            if ( i == l_label.size())
-                l_label.push_back(  std::max_element(l_nnlabel.begin(), l_nnlabel.end(), labelMapCompair)->first );
+            if (!l_changed)
+                break;
+        }
+        
+        std::sort( l_store.begin(), l_store.end() );
         
+        ublas::vector<T> l_weights( l_store.size() );
+        for(std::size_t i=0; i < l_store.size(); ++i)
+            l_weights(i) = m_baseweights(l_store[i]);
+        
+        setDatabase( l_store, l_weights );
+    }
+    
+    
+    /** reduces the database with the edited nearest neighbour rule. Each point is classified by its
+     * neighbours (without itself) and is removed if the label is not equal to the point label,
+     * so noisy points and points on the class borders are removed
+     * @note the neighbor count of the neighborhood object includes the point itself
+     * @param p_block number of points, that are classified in parallel
+     **/
+    template<typename T, typename L> inline void lazylearner<T, L>::editDatabase( const std::size_t& p_block )
+    {
+        if (p_block == 0)
+            throw exception::runtime(_("block size must be greater than zero"), *this);
+        if (m_neighborhood->getNeighborCount() < 2)
+            throw exception::runtime(_("number of neighbors must be greater than one"), *this);
+        if (m_basedata.size1() < m_neighborhood->getNeighborCount())
+            throw exception::runtime(_("database is smaller than the number of neighbors"), *this);
+        
+        std::vector<std::size_t> l_keep;
+        for(std::size_t i=0; i < m_basedata.size1(); i+=p_block) {
+            const std::size_t l_end = std::min( i+p_block, m_basedata.size1() );
+            
+            ublas::matrix<T> l_distance;
+            const ublas::matrix<std::size_t> l_neighbour = m_neighborhood->get( m_basedata, ublas::subrange(m_basedata, i, l_end, 0, m_basedata.size2()), l_distance );
+            const std::vector<std::size_t> l_label       = getLabelIndex( l_neighbour, l_distance, m_baselabelindex, m_baseweights, i );
+            
+            for(std::size_t j=0; j < l_label.size(); ++j)
+                if (l_label[j] == m_baselabelindex[i+j])
+                    l_keep.push_back( i+j );
         }
         
-        return l_label;
+        ublas::vector<T> l_weights( l_keep.size() );
+        for(std::size_t i=0; i < l_keep.size(); ++i)
+            l_weights(i) = m_baseweights(l_keep[i]);
+        
+        setDatabase( l_keep, l_weights );
     }
+    
+    
+    /** replaces the points of each class with neural gas prototypes. The weight of each prototype
+     * is the (weighted) number of class points, that are mapped to the prototype, prototypes without
+     * points are removed. Classes with less points than prototypes are not changed
+     * @param p_distance distance object for the neural gas
+     * @param p_prototypes maximum number of prototypes of each class
+     * @param p_iterations number of neural gas iterations
+     **/
+    template<typename T, typename L> inline void lazylearner<T, L>::quantizeDatabase( const distances::distance<T>& p_distance, const std::size_t& p_prototypes, const std::size_t& p_iterations )
+    {
+        if (p_prototypes == 0)
+            throw exception::runtime(_("number of prototypes must be greater than zero"), *this);
+        if (p_iterations == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        
+        std::vector< std::vector<std::size_t> > l_classes( m_labels.size() );
+        for(std::size_t i=0; i < m_baselabelindex.size(); ++i)
+            l_classes[m_baselabelindex[i]].push_back(i);
         
+        std::vector< ublas::vector<T> > l_points;
+        std::vector<L> l_labels;
+        std::vector<T> l_weights;
         
+        for(std::size_t i=0; i < l_classes.size(); ++i) {
+            
+            if (l_classes[i].size() <= p_prototypes) {
+                for(std::size_t j=0; j < l_classes[i].size(); ++j) {
+                    l_points.push_back( ublas::row(m_basedata, l_classes[i][j]) );
+                    l_labels.push_back( m_labels[i] );
+                    l_weights.push_back( m_baseweights(l_classes[i][j]) );
+                }
+                continue;
+            }
+            
+            // the neural gas runs multithreaded over the class data
+            const ublas::matrix<T> l_data = getRows( m_basedata, l_classes[i] );
+            clustering::nonsupervised::neuralgas<T> l_ng( p_distance, p_prototypes, m_basedata.size2() );
+            l_ng.train( l_data, p_iterations );
+            
+            const ublas::indirect_array<> l_winner = l_ng.use( l_data );
+            ublas::vector<T> l_count( p_prototypes, 0 );
+            for(std::size_t j=0; j < l_winner.size(); ++j)
+                l_count(l_winner(j)) += m_baseweights(l_classes[i][j]);
+            
+            const ublas::matrix<T> l_prototypes = l_ng.getPrototypes();
+            for(std::size_t j=0; j < l_prototypes.size1(); ++j)
+                if (l_count(j) > 0) {
+                    l_points.push_back( ublas::row(l_prototypes, j) );
+                    l_labels.push_back( m_labels[i] );
+                    l_weights.push_back( l_count(j) );
+                }
+        }
+        
+        ublas::matrix<T> l_data( l_points.size(), m_basedata.size2() );
+        for(std::size_t i=0; i < l_points.size(); ++i)
+            ublas::row(l_data, i) = l_points[i];
+        
+        setDatabase( l_data, l_labels );
+        m_baseweights = tools::vector::copy( l_weights );
+    }
+    
     
     /** label unkown data
      * @param p_data input data matrix (row orientated)
@@ -289,34 +553,293 @@ namespace machinelearning { namespace classifier {
     **/
     template<typename T, typename L> inline std::vector<L> lazylearner<T, L>::use( const ublas::matrix<T>& p_data ) const
     {
-        // determine nearest neighbour
-        const ublas::matrix<std::size_t> l_neighbour = m_neighborhood->get(m_basedata, p_data);
-        std::vector<L> l_label; 
+        if (m_basedata.size1() == 0)
+            throw exception::runtime(_("database is empty"), *this);
+        
+        // determine nearest neighbour with their distances
+        ublas::matrix<T> l_distance;
+        const ublas::matrix<std::size_t> l_neighbour  = m_neighborhood->get(m_basedata, p_data, l_distance);
+        const std::vector<std::size_t> l_index       = getLabelIndex( l_neighbour, l_distance, m_baselabelindex, m_baseweights );
+        
+        std::vector<L> l_label( l_index.size() );
+        for(std::size_t i=0; i < l_index.size(); ++i)
+            l_label[i] = m_labels[l_index[i]];
+        
+        //if (m_logging)
+        //    m_logprototypes.push_back( l_neighbour );
+        
+        return l_label;
+    }
+    
+    
+    
+    //======= MPI ==================================================================================================================================
+    #ifdef MACHINELEARNING_MPI
+    
+    /** sets the datapoints of the process as its shard of the database. The unique labels of
+     * all processes are gathered, so the label index of each data point is equal on all processes
+     * @param p_mpi MPI object for communication
+     * @param p_data Matrix with data of the process (rows are the vectors)
+     * @param p_labels vector for labels
+     **/
+    template<typename T, typename L> inline void lazylearner<T, L>::setDatabase( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::vector<L>& p_labels )
+    {
+        setDatabase( p_data, p_labels );
+        
+        if (mpi::all_reduce(p_mpi, p_data.size2(), mpi::maximum<std::size_t>()) != mpi::all_reduce(p_mpi, p_data.size2(), mpi::minimum<std::size_t>()))
+            throw exception::runtime(_("data dimension must be equal on each process"), *this);
+        
+        // create the unique labels of all processes
+        std::vector< std::vector<L> > l_processlabels;
+        mpi::all_gather(p_mpi, m_labels, l_processlabels);
+        
+        m_labels.clear();
+        for(std::size_t i=0; i < l_processlabels.size(); ++i)
+            m_labels.insert( m_labels.end(), l_processlabels[i].begin(), l_processlabels[i].end() );
+        
+        std::sort( m_labels.begin(), m_labels.end() );
+        m_labels.erase( std::unique(m_labels.begin(), m_labels.end()), m_labels.end() );
+        
+        for(std::size_t i=0; i < p_labels.size(); ++i)
+            m_baselabelindex[i] = static_cast<std::size_t>( std::lower_bound(m_labels.begin(), m_labels.end(), p_labels[i]) - m_labels.begin() );
+    }
+    
+    
+    /** returns the number of datapoints of all processes
+     * @param p_mpi MPI object for communication
+     * @return number of datapoints
+     **/
+    template<typename T, typename L> inline std::size_t lazylearner<T, L>::getDatabaseCount( const mpi::communicator& p_mpi ) const
+    {
+        return mpi::all_reduce(p_mpi, m_basedata.size1(), std::plus<std::size_t>());
+    }
+    
+    
+    /** determines the nearest neighbours of a query block within the shard of the process. The candidates
+     * are stored sorted by distance in one buffer (distance, label index and weight of each neighbour)
+     * @param p_query query block
+     * @return candidate buffer
+     **/
+    template<typename T, typename L> inline std::vector<T> lazylearner<T, L>::getCandidates( const ublas::matrix<T>& p_query ) const
+    {
+        ublas::matrix<T> l_distance;
+        const ublas::matrix<std::size_t> l_neighbour = m_neighborhood->get(m_basedata, p_query, l_distance);
+        
+        std::vector<T> l_candidates( l_neighbour.size1() * l_neighbour.size2() * 3 );
+        for(std::size_t i=0; i < l_neighbour.size1(); ++i)
+            for(std::size_t j=0; j < l_neighbour.size2(); ++j) {
+                const std::size_t l_pos = (i * l_neighbour.size2() + j) * 3;
+                l_candidates[l_pos]   = l_distance(i,j);
+                l_candidates[l_pos+1] = static_cast<T>( m_baselabelindex[l_neighbour(i,j)] );
+                l_candidates[l_pos+2] = m_baseweights(l_neighbour(i,j));
+            }
+        
+        return l_candidates;
+    }
+    
+    
+    /** merges the candidates of all processes and votes the labels. For each query the sorted candidate
+     * lists of the processes are merged with a heap, that holds the next candidate of each process,
+     * so only the k nearest candidates are touched
+     * @param p_candidates candidate buffer of all processes (ordered by process)
+     * @param p_processes number of processes
+     * @param p_queries number of queries
+     * @return vector with label index
+     **/
+    template<typename T, typename L> inline std::vector<std::size_t> lazylearner<T, L>::mergeCandidates( const std::vector<T>& p_candidates, const std::size_t& p_processes, const std::size_t& p_queries ) const
+    {
+        const std::size_t l_knn = m_neighborhood->getNeighborCount();
+        
+        std::vector<std::size_t> l_labelindex( p_candidates.size() / 3 );
+        ublas::vector<T> l_weights( l_labelindex.size() );
+        for(std::size_t i=0; i < l_labelindex.size(); ++i) {
+            l_labelindex[i] = static_cast<std::size_t>( p_candidates[i*3+1] );
+            l_weights(i)    = p_candidates[i*3+2];
+        }
         
-           
-        switch (m_weight) {
+        ublas::matrix<std::size_t> l_neighbour( p_queries, l_knn );
+        ublas::matrix<T> l_distance( p_queries, l_knn );
         
-            // use only neighbourhood for determine label
-            case none :     
-                l_label = getLabelsWithoutWeight( l_neighbour );            break;
+        #pragma omp parallel shared(l_neighbour, l_distance)
+        {
+            // heap with the distance and the position of the next candidate of each process
+            std::vector< std::pair<T, std::size_t> > l_heap;
+            l_heap.reserve( p_processes );
+            
+            #pragma omp for
+            for(std::size_t i=0; i < p_queries; ++i) {
+                l_heap.clear();
+                for(std::size_t n=0; n < p_processes; ++n) {
+                    const std::size_t l_pos = (n * p_queries + i) * l_knn;
+                    l_heap.push_back( std::pair<T, std::size_t>(p_candidates[l_pos*3], l_pos) );
+                }
+                std::make_heap( l_heap.begin(), l_heap.end(), std::greater< std::pair<T, std::size_t> >() );
                 
-            // get label from their distances
-            case distance : 
-                l_label = getLabelsWithWeight( l_neighbour, p_data );       break;
+                for(std::size_t j=0; j < l_knn; ++j) {
+                    std::pop_heap( l_heap.begin(), l_heap.end(), std::greater< std::pair<T, std::size_t> >() );
+                    const std::size_t l_pos = l_heap.back().second;
+                    l_heap.pop_back();
+                    
+                    l_neighbour(i,j) = l_pos;
+                    l_distance(i,j)  = p_candidates[l_pos*3];
+                    
+                    if ((l_pos+1) % l_knn != 0) {
+                        l_heap.push_back( std::pair<T, std::size_t>(p_candidates[(l_pos+1)*3], l_pos+1) );
+                        std::push_heap( l_heap.begin(), l_heap.end(), std::greater< std::pair<T, std::size_t> >() );
+                    }
+                }
+            }
+        }
+        
+        return getLabelIndex( l_neighbour, l_distance, l_labelindex, l_weights );
+    }
+    
+    
+    /** broadcasts a query block of the process with the query data
+     * @param p_mpi MPI object for communication
+     * @param p_data query data (null pointer on the processes without data)
+     * @param p_header number of queries, dimension and block size
+     * @param p_block block index
+     * @param p_root process with the query data
+     * @param p_query matrix for the block
+     * @param p_request request of the broadcast
+     **/
+    template<typename T, typename L> inline void lazylearner<T, L>::broadcastQuery( const mpi::communicator& p_mpi, const ublas::matrix<T>* const p_data, const std::size_t* const p_header, const std::size_t& p_block, const int& p_root, ublas::matrix<T>& p_query, MPI_Request& p_request )
+    {
+        const std::size_t l_start = p_block * p_header[2];
+        const std::size_t l_rows  = std::min( p_header[2], p_header[0] - l_start );
+        
+        if (p_data)
+            p_query = ublas::subrange( *p_data, l_start, l_start + l_rows, 0, p_header[1] );
+        else
+            p_query.resize( l_rows, p_header[1], false );
+        
+        #if MPI_VERSION >= 3
+        MPI_Ibcast( p_query.data().begin(), static_cast<int>(l_rows * p_header[1]), mpi::get_mpi_datatype<T>(T()), p_root, p_mpi, &p_request );
+        #else
+        MPI_Bcast( p_query.data().begin(), static_cast<int>(l_rows * p_header[1]), mpi::get_mpi_datatype<T>(T()), p_root, p_mpi );
+        #endif
+    }
+    
+    
+    /** classifies the query data of one process with the database shards of all processes. The queries are
+     * broadcast in blocks, the broadcast of the next block and the gathering of the candidates run non-blocking
+     * (blocking on MPI < 3), so the candidates of the previous block are merged while the next block is searched
+     * @param p_mpi MPI object for communication
+     * @param p_data query data (null pointer on the processes without data)
+     * @param p_batch number of queries of each block
+     * @return vector with label index (empty on the processes without data)
+     **/
+    template<typename T, typename L> inline std::vector<std::size_t> lazylearner<T, L>::getLabelIndex( const mpi::communicator& p_mpi, const ublas::matrix<T>* const p_data, const std::size_t& p_batch ) const
+    {
+        if (mpi::all_reduce(p_mpi, static_cast<std::size_t>(p_data ? 1 : 0), std::plus<std::size_t>()) != 1)
+            throw exception::runtime(_("query data must be set on one process"), *this);
+        
+        const int l_root = mpi::all_reduce(p_mpi, p_data ? p_mpi.rank() : p_mpi.size(), mpi::minimum<int>());
+        const bool l_isroot = p_mpi.rank() == l_root;
+        
+        // number of queries, dimension and block size of the process with the query data
+        std::size_t l_header[3] = { 0, 0, 0 };
+        if (l_isroot) {
+            l_header[0] = p_data->size1();
+            l_header[1] = p_data->size2();
+            l_header[2] = p_batch;
+        }
+        mpi::broadcast(p_mpi, l_header, 3, l_root);
+        
+        // the block size is checked after the broadcast, so all processes throw together
+        if (l_header[2] == 0)
+            throw exception::runtime(_("block size must be greater than zero"), *this);
+        
+        const std::size_t l_knn = m_neighborhood->getNeighborCount();
+        if (!mpi::all_reduce(p_mpi, (m_basedata.size1() >= l_knn) && (m_basedata.size2() == l_header[1]), std::multiplies<bool>()))
+            throw exception::runtime(_("database of each process must have the query dimension and at least the number of neighbors"), *this);
+        
+        std::vector<std::size_t> l_label;
+        if (l_header[0] == 0)
+            return l_label;
+        
+        
+        // double buffers for the query blocks and the candidates
+        const std::size_t l_processes = static_cast<std::size_t>(p_mpi.size());
+        const std::size_t l_blocks    = (l_header[0] + l_header[2] - 1) / l_header[2];
+        ublas::matrix<T> l_query[2];
+        std::vector<T> l_candidates[2];
+        std::vector<T> l_gathered[2];
+        MPI_Request l_broadcast  = MPI_REQUEST_NULL;
+        MPI_Request l_gather[2]  = { MPI_REQUEST_NULL, MPI_REQUEST_NULL };
+        
+        // the first block is broadcast before the search
+        broadcastQuery( p_mpi, p_data, l_header, 0, l_root, l_query[0], l_broadcast );
+        MPI_Wait( &l_broadcast, MPI_STATUS_IGNORE );
+        
+        for(std::size_t i=0; i <= l_blocks; ++i) {
+            const std::size_t l_current = i % 2;
+            const std::size_t l_next    = 1 - l_current;
+            
+            if (i+1 < l_blocks)
+                broadcastQuery( p_mpi, p_data, l_header, i+1, l_root, l_query[l_next], l_broadcast );
+            
+            // search the block within the shard and gather the candidates
+            if (i < l_blocks) {
+                l_candidates[l_current] = getCandidates( l_query[l_current] );
+                if (l_isroot)
+                    l_gathered[l_current].resize( l_candidates[l_current].size() * l_processes );
                 
-            // get label from their inverse distances    
-            case inversedistance : 
-                l_label = getLabelsWithWeight( l_neighbour, p_data );       break;
-
+                #if MPI_VERSION >= 3
+                MPI_Igather( &l_candidates[l_current][0], static_cast<int>(l_candidates[l_current].size()), mpi::get_mpi_datatype<T>(T()),
+                             l_isroot ? &l_gathered[l_current][0] : NULL, static_cast<int>(l_candidates[l_current].size()), mpi::get_mpi_datatype<T>(T()), l_root, p_mpi, &l_gather[l_current] );
+                #else
+                MPI_Gather( &l_candidates[l_current][0], static_cast<int>(l_candidates[l_current].size()), mpi::get_mpi_datatype<T>(T()),
+                            l_isroot ? &l_gathered[l_current][0] : NULL, static_cast<int>(l_candidates[l_current].size()), mpi::get_mpi_datatype<T>(T()), l_root, p_mpi );
+                #endif
+            }
+            
+            // merge the candidates of the previous block, while the current block is gathered
+            if (i > 0) {
+                MPI_Wait( &l_gather[l_next], MPI_STATUS_IGNORE );
+                
+                if (l_isroot) {
+                    const std::vector<std::size_t> l_index = mergeCandidates( l_gathered[l_next], l_processes, l_gathered[l_next].size() / (l_processes * l_knn * 3) );
+                    l_label.insert( l_label.end(), l_index.begin(), l_index.end() );
+                }
+            }
+            
+            MPI_Wait( &l_broadcast, MPI_STATUS_IGNORE );
         }
         
-        //if (m_logging)
-        //    m_logprototypes.push_back( l_neighbour );
+        return l_label;
+    }
+    
+    
+    /** label unkown data with the database of all processes
+     * @param p_mpi MPI object for communication
+     * @param p_data input data matrix (row orientated)
+     * @param p_batch number of datapoints, that are broadcast and searched together
+     * @return std::vector with label information
+     **/
+    template<typename T, typename L> inline std::vector<L> lazylearner<T, L>::use( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::size_t& p_batch ) const
+    {
+        const std::vector<std::size_t> l_index = getLabelIndex( p_mpi, &p_data, p_batch );
+        
+        std::vector<L> l_label( l_index.size() );
+        for(std::size_t i=0; i < l_index.size(); ++i)
+            l_label[i] = m_labels[l_index[i]];
         
         return l_label;
     }
     
     
+    /** MPI call for the processes without query data, the process searches its database shard
+     * @param p_mpi MPI object for communication
+     **/
+    template<typename T, typename L> inline void lazylearner<T, L>::use( const mpi::communicator& p_mpi ) const
+    {
+        getLabelIndex( p_mpi, NULL, 0 );
+    }
+    
+    #endif
+    
 }}
 #endif
 
@@ -36,11 +36,18 @@ namespace machinelearning {
 }
 
 
+#include "instrumentation.hpp"
+
 #include "nonsupervised/clustering.hpp"
+#include "nonsupervised/progress.hpp"
+#include "nonsupervised/patch.hpp"
+#include "nonsupervised/pipeline.hpp"
 #include "nonsupervised/neuralgas.hpp"
 #include "nonsupervised/relational_neuralgas.hpp"
+#include "nonsupervised/nystroem_neuralgas.hpp"
 #include "nonsupervised/kmeans.hpp"
 #include "nonsupervised/spectralclustering.hpp"
+#include "nonsupervised/task.hpp"
 
 #include "supervised/clustering.hpp"
 #include "supervised/rlvq.hpp"
@@ -0,0 +1,346 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#ifndef __MACHINELEARNING_CLUSTERING_INSTRUMENTATION_HPP
+#define __MACHINELEARNING_CLUSTERING_INSTRUMENTATION_HPP
+
+#include <omp.h>
+
+#include <string>
+#include <vector>
+#include <boost/static_assert.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include "../errorhandling/exception.hpp"
+#include "../tools/language/language.h"
+#ifdef MACHINELEARNING_FILES_HDF
+#include "../tools/files/hdf.hpp"
+#endif
+
+
+namespace machinelearning { namespace clustering {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class for recording the training process of the prototype based clustering algorithms.
+     * For each iteration the wall time of the training phases and the quantization error is
+     * stored, the error is calculated from the distances of the iteration, so it describes the
+     * prototypes at the begin of the iteration. The gradient descent uses the object too, it
+     * records the gradient, update and evaluate phases and the error function value (loss) of
+     * the values at the end of the iteration, the snapshots are the values as one row matrix. The prototypes are stored only on every n-th
+     * iteration, optional into a ring buffer or into a HDF file, so the memory usage is bounded.
+     * The object is bind to an algorithm with setInstrumentation and counts the iterations over
+     * all train calls (eg for patch clustering) until clear is called
+     * @note the object must not be shared between concurrently running algorithms
+     **/
+    template<typename T> class instrumentation
+    {
+        #ifndef SWIG
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        #endif
+        
+        public :
+        
+            /** training phases **/
+            enum phase
+            {
+                distance    = 0,
+                rank        = 1,
+                product     = 2,
+                normalize   = 3,
+                gradient    = 4,
+                update      = 5,
+                evaluate    = 6
+            };
+        
+        
+            instrumentation( const std::size_t& = 1, const std::size_t& = 0 );
+            void setSnapshot( const std::size_t&, const std::size_t& = 0 );
+            #ifdef MACHINELEARNING_FILES_HDF
+            void setSnapshotFile( const std::string&, const std::string& = "/prototypes", const tools::files::hdf::datatype& = tools::files::hdf::NATIVE_DOUBLE );
+            #endif
+            void clear( void );
+            std::size_t getIterations( void ) const;
+            std::vector<double> getTime( const phase& ) const;
+            std::vector<T> getQuantizationError( void ) const;
+            std::vector< ublas::matrix<T> > getSnapshots( void ) const;
+            std::vector<std::size_t> getSnapshotIterations( void ) const;
+        
+            // methods that are called by the algorithms
+            void reserve( const std::size_t& );
+            void beginIteration( void );
+            void startPhase( void );
+            void stopPhase( const phase& );
+            void setQuantizationError( const T& );
+            bool isSnapshot( void ) const;
+            void addSnapshot( const ublas::matrix<T>& );
+        
+        
+        private :
+        
+            /** number of phases **/
+            static const std::size_t m_phases = 7;
+        
+            /** snapshot stride (zero disables the snapshots) **/
+            std::size_t m_stride;
+            /** size of the snapshot ring buffer (zero for unbounded) **/
+            std::size_t m_ring;
+            /** next write position of the ring buffer **/
+            std::size_t m_ringposition;
+            /** start time of the running phase **/
+            double m_start;
+            /** wall times of each phase and iteration **/
+            std::vector<double> m_time[m_phases];
+            /** quantization error of each iteration **/
+            std::vector<T> m_quantizationerror;
+            /** prototype snapshots **/
+            std::vector< ublas::matrix<T> > m_snapshots;
+            /** iteration of each snapshot **/
+            std::vector<std::size_t> m_snapshotiteration;
+        
+            #ifdef MACHINELEARNING_FILES_HDF
+            /** target file of the snapshots **/
+            boost::shared_ptr<tools::files::hdf> m_file;
+            /** group path of the snapshots within the file **/
+            std::string m_filegroup;
+            /** datatype of the snapshots within the file **/
+            tools::files::hdf::datatype m_filetype;
+            #endif
+    };
+    
+    
+    
+    /** constructor
+     * @param p_stride snapshot stride, every n-th iteration the prototypes are stored (zero disables the snapshots)
+     * @param p_ring number of snapshots, that are hold in memory, older snapshots are overwritten (zero for unbounded)
+     **/
+    template<typename T> inline instrumentation<T>::instrumentation( const std::size_t& p_stride, const std::size_t& p_ring ) :
+        m_stride( p_stride ),
+        m_ring( p_ring ),
+        m_ringposition( 0 ),
+        m_start( 0 ),
+        m_quantizationerror(),
+        m_snapshots(),
+        m_snapshotiteration()
+        #ifdef MACHINELEARNING_FILES_HDF
+        , m_file(),
+        m_filegroup(),
+        m_filetype( tools::files::hdf::NATIVE_DOUBLE )
+        #endif
+    {}
+    
+    
+    /** sets the snapshot options and removes the stored snapshots
+     * @param p_stride snapshot stride, every n-th iteration the prototypes are stored (zero disables the snapshots)
+     * @param p_ring number of snapshots, that are hold in memory, older snapshots are overwritten (zero for unbounded)
+     **/
+    template<typename T> inline void instrumentation<T>::setSnapshot( const std::size_t& p_stride, const std::size_t& p_ring )
+    {
+        m_stride        = p_stride;
+        m_ring          = p_ring;
+        m_ringposition  = 0;
+        m_snapshots.clear();
+        m_snapshotiteration.clear();
+    }
+    
+    
+    #ifdef MACHINELEARNING_FILES_HDF
+    /** streams the snapshots into a HDF file instead of the memory, each snapshot
+     * is stored as dataset <group>/<iteration>, the file is created / truncated
+     * @param p_file filename
+     * @param p_group group path of the snapshots
+     * @param p_datatype datatype of the datasets
+     **/
+    template<typename T> inline void instrumentation<T>::setSnapshotFile( const std::string& p_file, const std::string& p_group, const tools::files::hdf::datatype& p_datatype )
+    {
+        if (p_group.empty() || (p_group[0] != '/'))
+            throw exception::runtime(_("group path must be an absolute path"), *this);
+        
+        m_file      = boost::shared_ptr<tools::files::hdf>( new tools::files::hdf(p_file, true) );
+        m_filegroup = p_group;
+        m_filetype  = p_datatype;
+    }
+    #endif
+    
+    
+    /** removes all recorded data and resets the iteration counter **/
+    template<typename T> inline void instrumentation<T>::clear( void )
+    {
+        for(std::size_t i=0; i < m_phases; ++i)
+            m_time[i].clear();
+        
+        m_quantizationerror.clear();
+        m_snapshots.clear();
+        m_snapshotiteration.clear();
+        m_ringposition = 0;
+    }
+    
+    
+    /** returns the number of recorded iterations
+     * @return number of iterations
+     **/
+    template<typename T> inline std::size_t instrumentation<T>::getIterations( void ) const
+    {
+        return m_quantizationerror.size();
+    }
+    
+    
+    /** returns the wall times of a phase
+     * @param p_phase phase
+     * @return std::vector with the time in seconds of each iteration
+     **/
+    template<typename T> inline std::vector<double> instrumentation<T>::getTime( const phase& p_phase ) const
+    {
+        return m_time[p_phase];
+    }
+    
+    
+    /** returns the quantization error
+     * @return std::vector with the error of each iteration
+     **/
+    template<typename T> inline std::vector<T> instrumentation<T>::getQuantizationError( void ) const
+    {
+        return m_quantizationerror;
+    }
+    
+    
+    /** returns the snapshots in memory ordered by the iterations
+     * @return std::vector with prototype matrices
+     **/
+    template<typename T> inline std::vector< ublas::matrix<T> > instrumentation<T>::getSnapshots( void ) const
+    {
+        std::vector< ublas::matrix<T> > l_snapshots( m_snapshots.begin()+m_ringposition, m_snapshots.end() );
+        l_snapshots.insert( l_snapshots.end(), m_snapshots.begin(), m_snapshots.begin()+m_ringposition );
+        return l_snapshots;
+    }
+    
+    
+    /** returns the iteration numbers of the snapshots in memory
+     * @return std::vector with the iteration number of each snapshot (same order as getSnapshots)
+     **/
+    template<typename T> inline std::vector<std::size_t> instrumentation<T>::getSnapshotIterations( void ) const
+    {
+        std::vector<std::size_t> l_iterations( m_snapshotiteration.begin()+m_ringposition, m_snapshotiteration.end() );
+        l_iterations.insert( l_iterations.end(), m_snapshotiteration.begin(), m_snapshotiteration.begin()+m_ringposition );
+        return l_iterations;
+    }
+    
+    
+    /** reserves the memory for the following iterations
+     * @param p_iterations number of iterations
+     **/
+    template<typename T> inline void instrumentation<T>::reserve( const std::size_t& p_iterations )
+    {
+        const std::size_t l_size = m_quantizationerror.size() + p_iterations;
+        
+        for(std::size_t i=0; i < m_phases; ++i)
+            m_time[i].reserve( l_size );
+        m_quantizationerror.reserve( l_size );
+    }
+    
+    
+    /** starts a new iteration, all values of the iteration are initialized with zero **/
+    template<typename T> inline void instrumentation<T>::beginIteration( void )
+    {
+        for(std::size_t i=0; i < m_phases; ++i)
+            m_time[i].push_back( 0 );
+        m_quantizationerror.push_back( 0 );
+    }
+    
+    
+    /** starts the time measurement of a phase **/
+    template<typename T> inline void instrumentation<T>::startPhase( void )
+    {
+        m_start = omp_get_wtime();
+    }
+    
+    
+    /** stops the time measurement and adds the time to the phase of the current iteration
+     * @param p_phase phase
+     **/
+    template<typename T> inline void instrumentation<T>::stopPhase( const phase& p_phase )
+    {
+        if (m_time[p_phase].empty())
+            throw exception::runtime(_("no iteration is started"), *this);
+        
+        m_time[p_phase].back() += omp_get_wtime() - m_start;
+    }
+    
+    
+    /** sets the quantization error of the current iteration
+     * @param p_error error
+     **/
+    template<typename T> inline void instrumentation<T>::setQuantizationError( const T& p_error )
+    {
+        if (m_quantizationerror.empty())
+            throw exception::runtime(_("no iteration is started"), *this);
+        
+        m_quantizationerror.back() = p_error;
+    }
+    
+    
+    /** returns if the prototypes of the current iteration should be stored
+     * @return bool
+     **/
+    template<typename T> inline bool instrumentation<T>::isSnapshot( void ) const
+    {
+        return (m_stride > 0) && (!m_quantizationerror.empty()) && ((m_quantizationerror.size()-1) % m_stride == 0);
+    }
+    
+    
+    /** stores the prototypes of the current iteration (the stride is not checked)
+     * @param p_prototypes prototype matrix
+     **/
+    template<typename T> inline void instrumentation<T>::addSnapshot( const ublas::matrix<T>& p_prototypes )
+    {
+        if (m_quantizationerror.empty())
+            throw exception::runtime(_("no iteration is started"), *this);
+        
+        const std::size_t l_iteration = m_quantizationerror.size()-1;
+        
+        #ifdef MACHINELEARNING_FILES_HDF
+        if (m_file) {
+            m_file->writeBlasMatrix<T>( m_filegroup + "/" + boost::lexical_cast<std::string>(l_iteration), p_prototypes, m_filetype );
+            return;
+        }
+        #endif
+        
+        if ((m_ring == 0) || (m_snapshots.size() < m_ring)) {
+            m_snapshots.push_back( p_prototypes );
+            m_snapshotiteration.push_back( l_iteration );
+            return;
+        }
+        
+        // overwrite the oldest snapshot
+        m_snapshots[m_ringposition]                 = p_prototypes;
+        m_snapshotiteration[m_ringposition]         = l_iteration;
+        m_ringposition                              = (m_ringposition+1) % m_ring;
+    }
+    
+}}
+#endif
@@ -27,11 +27,18 @@
 
 #include <omp.h>
 
+#include <vector>
+#include <algorithm>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/matrix_sparse.hpp>
 #include <boost/numeric/ublas/vector.hpp>
+#ifdef MACHINELEARNING_MPI
+#include <boost/mpi.hpp>
+#endif
 
 #include "clustering.hpp"
+#include "progress.hpp"
+#include "../instrumentation.hpp"
 #include "../../errorhandling/exception.hpp"
 #include "../../tools/tools.h"
 #include "../../distances/distances.h"
@@ -42,18 +49,28 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     
     #ifndef SWIG
     namespace ublas = boost::numeric::ublas;
+    #ifdef MACHINELEARNING_MPI
+    namespace mpi   = boost::mpi;
+    #endif
     #endif
     
     
-    /** class for calculate (batch) k-means
+    /** class for calculate (batch) k-means, with a concrete distance type as second
+     * template parameter the distance calls are inlined, otherwise they are virtual
+     * @note On the MPI methods each process holds a part of the data and all processes
+     * hold the same prototypes, the sums and counts of the data of each prototype are
+     * reduced over all processes in each iteration
      * @todo determine best k with variance analyse
      **/
-    template<typename T> class kmeans : public clustering<T>
+    template<typename T, typename D = distances::distance<T> > class kmeans : public clustering<T>
+        #ifdef MACHINELEARNING_MPI 
+        , public mpiclustering<T>
+        #endif
     {
         
         public:
             
-            kmeans( const distances::distance<T>&, const std::size_t&, const std::size_t& );
+            kmeans( const D&, const std::size_t&, const std::size_t& );
             void train( const ublas::matrix<T>&, const std::size_t& );
             ublas::matrix<T> getPrototypes( void ) const;
             void setLogging( const bool& );
@@ -63,12 +80,27 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             std::size_t getPrototypeCount( void ) const;
             std::vector<T> getLoggedQuantizationError( void ) const;
             ublas::indirect_array<> use( const ublas::matrix<T>& ) const;
+            #ifndef SWIG
+            void setInstrumentation( instrumentation<T>& );
+            void removeInstrumentation( void );
+            void setProgress( progress<T>& );
+            void removeProgress( void );
+            #endif
+        
+            #ifdef MACHINELEARNING_MPI
+            void train( const mpi::communicator&, const ublas::matrix<T>&, const std::size_t& );
+            ublas::matrix<T> getPrototypes( const mpi::communicator& ) const;
+            std::vector< ublas::matrix<T> > getLoggedPrototypes( const mpi::communicator& ) const;
+            std::vector<T> getLoggedQuantizationError( const mpi::communicator& ) const;
+            ublas::indirect_array<> use( const mpi::communicator&, const ublas::matrix<T>& ) const;
+            void use( const mpi::communicator& ) const;
+            #endif
         
             
         private :
         
             /** distance object **/
-            const distances::distance<T>& m_distance;        
+            typename distances::policy<D>::type m_distance;        
             /** prototypes **/
             ublas::matrix<T> m_prototypes;                
             /** bool for logging prototypes **/
@@ -77,8 +109,12 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             std::vector< ublas::matrix<T> > m_logprototypes;
             /** std::vector for quantisation error in each iteration **/
             std::vector<T> m_quantizationerror;
+            /** optional instrumentation object (not owned) **/
+            instrumentation<T>* m_instrumentation;
+            /** optional progress object (not owned) **/
+            progress<T>* m_progress;
             
-            T calculateQuantizationError( const ublas::matrix<T>& ) const;
+            ublas::indirect_array<> getNearest( const ublas::matrix<T>& ) const;
         
     };
     
@@ -89,12 +125,14 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_prototypes number of prototypes
      * @param p_prototypesize size of each prototype (data dimension)
      **/
-    template<typename T> inline kmeans<T>::kmeans( const distances::distance<T>& p_distance, const std::size_t& p_prototypes, const std::size_t& p_prototypesize ) :
+    template<typename T, typename D> inline kmeans<T, D>::kmeans( const D& p_distance, const std::size_t& p_prototypes, const std::size_t& p_prototypesize ) :
         m_distance( p_distance ),
         m_prototypes( tools::matrix::random<T>(p_prototypes, p_prototypesize) ),
         m_logging( false ),
         m_logprototypes( std::vector< ublas::matrix<T> >() ),
-        m_quantizationerror( std::vector<T>() )
+        m_quantizationerror( std::vector<T>() ),
+        m_instrumentation( NULL ),
+        m_progress( NULL )
     {
         if (p_prototypesize == 0)
             throw exception::runtime(_("prototype size must be greater than zero"), *this);
@@ -106,7 +144,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns the prototype matrix
      * @return matrix (rows = number of prototypes)
      **/
-    template<typename T> inline ublas::matrix<T> kmeans<T>::getPrototypes( void ) const
+    template<typename T, typename D> inline ublas::matrix<T> kmeans<T, D>::getPrototypes( void ) const
     {
         return m_prototypes;
     }
@@ -116,7 +154,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** enabled logging for training
      * @param p_val bool
      **/
-    template<typename T> inline void kmeans<T>::setLogging( const bool& p_val )
+    template<typename T, typename D> inline void kmeans<T, D>::setLogging( const bool& p_val )
     {
         m_logging = p_val;
         m_logprototypes.clear();
@@ -125,10 +163,46 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     
     
     
+    /** sets an instrumentation object, that records the phase times, the quantization error
+     * and the prototype snapshots of the following train calls (the rank phase is the
+     * winner determination)
+     * @param p_instrumentation instrumentation object, that must exist during training
+     **/
+    template<typename T, typename D> inline void kmeans<T, D>::setInstrumentation( instrumentation<T>& p_instrumentation )
+    {
+        m_instrumentation = &p_instrumentation;
+    }
+    
+    
+    /** removes the instrumentation object **/
+    template<typename T, typename D> inline void kmeans<T, D>::removeInstrumentation( void )
+    {
+        m_instrumentation = NULL;
+    }
+    
+    
+    /** sets a progress object, that is updated after each iteration of the
+     * following train calls and that can cancel the training
+     * @param p_progress progress object, that must exist during training
+     **/
+    template<typename T, typename D> inline void kmeans<T, D>::setProgress( progress<T>& p_progress )
+    {
+        m_progress = &p_progress;
+    }
+    
+    
+    /** removes the progress object **/
+    template<typename T, typename D> inline void kmeans<T, D>::removeProgress( void )
+    {
+        m_progress = NULL;
+    }
+    
+    
+    
     /** shows the logging status
      * @return bool
      **/
-    template<typename T> inline bool kmeans<T>::getLogging( void ) const
+    template<typename T, typename D> inline bool kmeans<T, D>::getLogging( void ) const
     {
         return m_logging && (m_logprototypes.size() > 0);
     }
@@ -138,7 +212,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns every prototype step during training
      * @return std::vector with prototype matrix
      **/
-    template<typename T> inline std::vector< ublas::matrix<T> > kmeans<T>::getLoggedPrototypes( void ) const
+    template<typename T, typename D> inline std::vector< ublas::matrix<T> > kmeans<T, D>::getLoggedPrototypes( void ) const
     {
         return m_logprototypes;
     }
@@ -147,7 +221,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns the quantisation error 
      * @return error for each iteration
      **/
-    template<typename T> inline std::vector<T> kmeans<T>::getLoggedQuantizationError( void ) const
+    template<typename T, typename D> inline std::vector<T> kmeans<T, D>::getLoggedQuantizationError( void ) const
     {
         return m_quantizationerror;
     }    
@@ -157,7 +231,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_data data matrix
      * @param p_iterations number of iterations
      **/
-    template<typename T> inline void kmeans<T>::train( const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
+    template<typename T, typename D> inline void kmeans<T, D>::train( const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
     {
         if (p_iterations == 0)
             throw exception::runtime(_("iterations must be greater than zero"), *this);
@@ -174,34 +248,72 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             m_logprototypes.reserve(p_iterations);
             m_quantizationerror.reserve(p_iterations);
         }
+        if (m_instrumentation)
+            m_instrumentation->reserve(p_iterations);
         
         
-        // run kmeans       
-        ublas::matrix<T> l_distances( m_prototypes.size1(), p_data.size1() );
+        // run kmeans, the distances are stored row-wise for each datapoint (rows = datapoints),
+        // so each thread writes contiguous rows
+        ublas::matrix<T> l_distances( p_data.size1(), m_prototypes.size1() );
+        std::vector<std::size_t> l_winner( p_data.size1() );
         // the matrix for adaption is a sparse matrix, because there are only 0 or 1 values
         ublas::mapped_matrix<T> l_adaptmatrix( m_prototypes.size1(), p_data.size1(), m_prototypes.size1()*p_data.size1() );
         
-        for(std::size_t i=0; i < p_iterations; ++i) {
+        for(std::size_t i=0; (i < p_iterations) && !(m_progress && m_progress->isCanceled()); ++i) {
             
-            // calculate for every prototype the distance
-            #pragma omp parallel for shared(l_distances)
-            for(std::size_t n=0; n < m_prototypes.size1(); ++n)
-                ublas::row(l_distances, n)  = m_distance.getDistance( p_data,  ublas::row(m_prototypes, n) );
+            if (m_logging)
+                m_logprototypes.push_back( m_prototypes );
+            if (m_instrumentation) {
+                m_instrumentation->beginIteration();
+                if (m_instrumentation->isSnapshot())
+                    m_instrumentation->addSnapshot( m_prototypes );
+                m_instrumentation->startPhase();
+            }
+            
+            // calculate for every datapoint the distance to all prototypes (static schedule,
+            // so each thread reads the same NUMA local rows of the data in each iteration)
+            #pragma omp parallel for schedule(static) shared(l_distances)
+            for(std::size_t n=0; n < p_data.size1(); ++n)
+                ublas::row(l_distances, n)  = m_distance.getDistance( m_prototypes, ublas::row(p_data, n) );
+            
+            // determine quantization error of the distances for logging
+            T l_error = 0;
+            if (m_logging || m_instrumentation || m_progress)
+                l_error = 0.5 * ublas::sum(m_distance.getAbs(tools::matrix::min(l_distances, tools::matrix::row)));
+            if (m_logging)
+                m_quantizationerror.push_back( l_error );
+            
+            if (m_instrumentation) {
+                m_instrumentation->stopPhase( instrumentation<T>::distance );
+                m_instrumentation->setQuantizationError( l_error );
+                m_instrumentation->startPhase();
+            }
+            
+            // determine winner of each datapoint and set the winner to 1
+            // (the sparse matrix is not thread-safe, so it is filled after the parallel loop)
+            #pragma omp parallel for schedule(static) shared(l_distances, l_winner)
+            for(std::size_t n=0; n < l_distances.size1(); ++n) {
+                const ublas::matrix_row< ublas::matrix<T> > l_row( l_distances, n );
+                l_winner[n] = static_cast<std::size_t>( std::min_element(l_row.begin(), l_row.end()) - l_row.begin() );
+            }
             
-            // determine winner and set the winner to 1
-            // iterate over the columns and ranks every column
             l_adaptmatrix.clear();
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < l_distances.size2(); ++n) {
-                ublas::vector<T> l_vec = ublas::column(l_distances, n);
-
-                // set winner
-                l_adaptmatrix(tools::vector::rankIndex( l_vec )(0), n) = static_cast<T>(1);
+            for(std::size_t n=0; n < l_winner.size(); ++n)
+                l_adaptmatrix(l_winner[n], n) = static_cast<T>(1);
+            
+            if (m_instrumentation) {
+                m_instrumentation->stopPhase( instrumentation<T>::rank );
+                m_instrumentation->startPhase();
             }
             
             
             // adapt to prototypes and normalize the winner row (row orientated)
             m_prototypes = ublas::prod( l_adaptmatrix, p_data );
+            
+            if (m_instrumentation) {
+                m_instrumentation->stopPhase( instrumentation<T>::product );
+                m_instrumentation->startPhase();
+            }
    
             #pragma omp parallel for
             for(std::size_t n=0; n < m_prototypes.size1(); ++n) {
@@ -211,12 +323,11 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
                     ublas::row(m_prototypes, n) /= l_norm;
             }
             
+            if (m_instrumentation)
+                m_instrumentation->stopPhase( instrumentation<T>::normalize );
             
-            // determine quantization error for logging
-            if (m_logging) {
-                m_logprototypes.push_back( m_prototypes );
-                m_quantizationerror.push_back( calculateQuantizationError(p_data) );
-            }            
+            if (m_progress)
+                m_progress->setIteration( i+1, p_iterations, l_error );
         }
     }
     
@@ -224,7 +335,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns the dimension of prototypes
      * @return dimension of the prototypes
      **/
-    template<typename T> inline std::size_t kmeans<T>::getPrototypeSize( void ) const 
+    template<typename T, typename D> inline std::size_t kmeans<T, D>::getPrototypeSize( void ) const 
     {
         return m_prototypes.size2();
     }
@@ -233,59 +344,195 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns the number of prototypes
      * @return number of the prototypes / classes
      **/
-    template<typename T> inline std::size_t kmeans<T>::getPrototypeCount( void ) const 
+    template<typename T, typename D> inline std::size_t kmeans<T, D>::getPrototypeCount( void ) const 
     {
         return m_prototypes.size1();
     }
     
     
-    /** calculate the quantization error
-     * @param p_data matrix with data points
-     * @return quantization error
-     **/    
-    template<typename T> inline T kmeans<T>::calculateQuantizationError( const ublas::matrix<T>& p_data ) const
-    {
-        ublas::matrix<T> l_distances( m_prototypes.size1(), p_data.size1() );
-        
-        #pragma omp parallel for
-        for(std::size_t i=0; i < m_prototypes.size1(); ++i)
-            ublas::row(l_distances, i) = m_distance.getDistance( p_data, ublas::row(m_prototypes, i) );
-        
-        return 0.5 * ublas::sum(  m_distance.getAbs(tools::matrix::min(l_distances, tools::matrix::column))  );  
-    }
-    
-    
     /** calulates distance between datapoints and prototypes and returns a indirect array
      * with index of the nearest prototype
      * @param p_data matrix
      * @return index array of prototype indices
      **/
-    template<typename T> inline ublas::indirect_array<> kmeans<T>::use( const ublas::matrix<T>& p_data ) const
+    template<typename T, typename D> inline ublas::indirect_array<> kmeans<T, D>::use( const ublas::matrix<T>& p_data ) const
     {
         if (p_data.size1() < m_prototypes.size1())
             throw exception::runtime(_("number of datapoints are less than prototypes"), *this);        
         
+        return getNearest( p_data );
+    }
+    
+    
+    /** determines the index of the nearest prototype of each datapoint
+     * @param p_data matrix
+     * @return index array of prototype indices
+     **/
+    template<typename T, typename D> inline ublas::indirect_array<> kmeans<T, D>::getNearest( const ublas::matrix<T>& p_data ) const
+    {
         ublas::indirect_array<> l_idx(p_data.size1());
-        ublas::matrix<T> l_distance(m_prototypes.size1(), p_data.size1());
+        ublas::matrix<T> l_distance(p_data.size1(), m_prototypes.size1());
         
-        // calculate distance for every prototype
-        #pragma omp parallel for shared(l_distance)
-        for(std::size_t i=0; i < m_prototypes.size1(); ++i)
-            ublas::row(l_distance, i)  = m_distance.getDistance( p_data, ublas::row(m_prototypes, i) );
+        // calculate distance for every datapoint (rows = datapoints)
+        #pragma omp parallel for schedule(static) shared(l_distance)
+        for(std::size_t i=0; i < p_data.size1(); ++i)
+            ublas::row(l_distance, i)  = m_distance.getDistance( m_prototypes, ublas::row(p_data, i) );
         
         // determine nearest prototype
-        #pragma omp parallel for shared(l_distance, l_idx)
-        for(std::size_t i=0; i < l_distance.size2(); ++i) {
-            ublas::vector<T> l_col                = ublas::column(l_distance, i);
-            const ublas::indirect_array<> l_rank  = tools::vector::rankIndex( l_col );
-            l_idx[i] = l_rank(0);
+        #pragma omp parallel for schedule(static) shared(l_distance, l_idx)
+        for(std::size_t i=0; i < l_distance.size1(); ++i) {
+            const ublas::matrix_row< ublas::matrix<T> > l_row( l_distance, i );
+            l_idx[i] = static_cast<std::size_t>( std::min_element(l_row.begin(), l_row.end()) - l_row.begin() );
         }
         
         return l_idx;
+    }
+    
+    
+    
+    //======= MPI ==================================================================================================================================
+    #ifdef MACHINELEARNING_MPI
+    
+    /** train the data on the cluster, each process holds a part of the data and
+     * the prototypes of the first process are used for initialization
+     * @param p_mpi MPI object for communication
+     * @param p_data datapoints of the process
+     * @param p_iterations iterations
+     **/
+    template<typename T, typename D> inline void kmeans<T, D>::train( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
+    {
+        if (p_iterations == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        if (p_data.size2() != m_prototypes.size2())
+            throw exception::runtime(_("data and prototype dimension are not equal"), *this);
+        
+        // we use the max. of all values of each process
+        const std::size_t l_iterationsMPI = mpi::all_reduce(p_mpi, p_iterations, mpi::maximum<std::size_t>());
+        const std::size_t l_prototypesMPI = mpi::all_reduce(p_mpi, m_prototypes.size1(), mpi::maximum<std::size_t>());
+        const std::size_t l_datasize      = mpi::all_reduce(p_mpi, p_data.size1(), std::plus<std::size_t>());
+        m_logging                         = mpi::all_reduce(p_mpi, m_logging, std::multiplies<bool>());
         
+        if (l_prototypesMPI != m_prototypes.size1())
+            throw exception::runtime(_("number of prototypes must be equal on each process"), *this);
+        if (l_datasize < m_prototypes.size1())
+            throw exception::runtime(_("number of datapoints are less than prototypes"), *this);
+        
+        // all processes start with the same prototypes
+        MPI_Bcast( m_prototypes.data().begin(), static_cast<int>(m_prototypes.size1() * m_prototypes.size2()), mpi::get_mpi_datatype<T>(T()), 0, p_mpi );
+        
+        // creates logging
+        if (m_logging) {
+            m_logprototypes.clear();
+            m_quantizationerror.clear();
+            m_logprototypes.reserve(l_iterationsMPI);
+            m_quantizationerror.reserve(l_iterationsMPI);
+        }
+        
+        
+        // run kmeans, the buffer holds the sum of the datapoints of each prototype and the number of datapoints in the last column
+        const std::size_t l_dim = m_prototypes.size2();
+        ublas::matrix<T> l_distances( p_data.size1(), m_prototypes.size1() );
+        ublas::matrix<T> l_buffer( m_prototypes.size1(), l_dim+1 );
+        std::vector<std::size_t> l_winner( p_data.size1() );
+        
+        for(std::size_t i=0; i < l_iterationsMPI; ++i) {
+            
+            // calculate for every datapoint the distance to all prototypes
+            #pragma omp parallel for schedule(static) shared(l_distances)
+            for(std::size_t n=0; n < p_data.size1(); ++n)
+                ublas::row(l_distances, n)  = m_distance.getDistance( m_prototypes, ublas::row(p_data, n) );
+            
+            // determine quantization error of the distances for logging (the error of the process data)
+            if (m_logging) {
+                m_logprototypes.push_back( m_prototypes );
+                m_quantizationerror.push_back( 0.5 * ublas::sum(m_distance.getAbs(tools::matrix::min(l_distances, tools::matrix::row))) );
+            }
+            
+            // determine winner
+            #pragma omp parallel for schedule(static) shared(l_distances, l_winner)
+            for(std::size_t n=0; n < l_distances.size1(); ++n) {
+                const ublas::matrix_row< ublas::matrix<T> > l_row( l_distances, n );
+                l_winner[n] = static_cast<std::size_t>( std::min_element(l_row.begin(), l_row.end()) - l_row.begin() );
+            }
+            
+            // sum the datapoints of each winner and reduce the sums over all processes
+            l_buffer.clear();
+            for(std::size_t n=0; n < l_winner.size(); ++n) {
+                for(std::size_t j=0; j < l_dim; ++j)
+                    l_buffer(l_winner[n], j) += p_data(n, j);
+                l_buffer(l_winner[n], l_dim) += 1;
+            }
+            
+            MPI_Allreduce( MPI_IN_PLACE, l_buffer.data().begin(), static_cast<int>(l_buffer.size1() * l_buffer.size2()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
+            
+            // normalize the prototypes
+            #pragma omp parallel for
+            for(std::size_t n=0; n < m_prototypes.size1(); ++n) {
+                const T l_norm = l_buffer(n, l_dim);
+                
+                for(std::size_t j=0; j < l_dim; ++j)
+                    m_prototypes(n, j) = tools::function::isNumericalZero(l_norm) ? l_buffer(n, j) : l_buffer(n, j) / l_norm;
+            }
+        }
     }
-
     
+    
+    /** return all prototypes of the cluster
+     * @param p_mpi MPI object for communication
+     * @return matrix (rows = prototypes)
+     **/
+    template<typename T, typename D> inline ublas::matrix<T> kmeans<T, D>::getPrototypes( const mpi::communicator& ) const
+    {
+        return m_prototypes;
+    }
+    
+    
+    /** returns all logged prototypes
+     * @param p_mpi MPI object for communication
+     * @return std::vector with all logged prototypes
+     **/
+    template<typename T, typename D> inline std::vector< ublas::matrix<T> > kmeans<T, D>::getLoggedPrototypes( const mpi::communicator& ) const
+    {
+        return m_logprototypes;
+    }
+    
+    
+    /** returns the logged quantisation error, the error of each process is summed
+     * @param p_mpi MPI object for communication
+     * @return std::vector with quantization error
+     **/
+    template<typename T, typename D> inline std::vector<T> kmeans<T, D>::getLoggedQuantizationError( const mpi::communicator& p_mpi ) const
+    {
+        std::vector<T> l_error( m_quantizationerror );
+        if (!l_error.empty())
+            MPI_Allreduce( MPI_IN_PLACE, &l_error[0], static_cast<int>(l_error.size()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
+        
+        return l_error;
+    }
+    
+    
+    /** calulates distance between datapoints and prototypes and returns a indirect array
+     * with index of the nearest prototype
+     * @param p_mpi MPI object for communication     
+     * @param p_data matrix
+     * @return index array of prototype indices
+     **/
+    template<typename T, typename D> inline ublas::indirect_array<> kmeans<T, D>::use( const mpi::communicator&, const ublas::matrix<T>& p_data ) const
+    {
+        if (p_data.size2() != m_prototypes.size2())
+            throw exception::runtime(_("data and prototype dimension are not equal"), *this);
+        
+        return getNearest( p_data );
+    }
+    
+    
+    /** blank method for the MPI interface, the prototypes exist on each process, so there is no communication
+     * @param p_mpi MPI object for communication 
+     **/
+    template<typename T, typename D> inline void kmeans<T, D>::use( const mpi::communicator& ) const
+    {}
+    
+    #endif
 
 }}}
 #endif
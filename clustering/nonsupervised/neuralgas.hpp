@@ -28,15 +28,20 @@
 
 #include <omp.h>
 
-#include <numeric>
+#include <algorithm>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
 #include <boost/numeric/bindings/blas.hpp>
 #ifdef MACHINELEARNING_MPI
 #include <boost/mpi.hpp>
 #endif
 
 #include "clustering.hpp"
+#include "progress.hpp"
+#include "patch.hpp"
+#include "../instrumentation.hpp"
 #include "../../errorhandling/exception.hpp"
 #include "../../tools/tools.h"
 #include "../../distances/distances.h"
@@ -53,13 +58,15 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     #endif
 
     
-    /** class for calculate (batch) neural gas
+    /** class for calculate (batch) neural gas. The distance type can be set as template
+     * parameter (eg neuralgas<double, distances::norm::euclid<double> >), so the distance
+     * calls are bound statically, the default is the virtual distance interface
      * @note The MPI methods do not check the correct ranges / dimension of the prototype
      * data, so it is the task of the developer to use the correct ranges. Also the MPI
      * methods must be called in the correct order, so the MPI calls must be run
      * on each process.
      **/
-    template<typename T> class neuralgas : public clustering<T>, public patchclustering<T>
+    template<typename T, typename D = distances::distance<T> > class neuralgas : public clustering<T>, public patchclustering<T>
         #ifdef MACHINELEARNING_MPI 
         , public mpiclustering<T>, public mpipatchclustering<T>
         #endif
@@ -67,7 +74,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         
         public:
             
-            neuralgas( const distances::distance<T>&, const std::size_t&, const std::size_t& );
+            neuralgas( const D&, const std::size_t&, const std::size_t& );
             void train( const ublas::matrix<T>&, const std::size_t& );
             void train( const ublas::matrix<T>&, const std::size_t&, const T& );
             ublas::matrix<T> getPrototypes( void ) const;
@@ -78,6 +85,12 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             std::size_t getPrototypeCount( void ) const;
             std::vector<T> getLoggedQuantizationError( void ) const;
             ublas::indirect_array<> use( const ublas::matrix<T>& ) const;
+            #ifndef SWIG
+            void setInstrumentation( instrumentation<T>& );
+            void removeInstrumentation( void );
+            void setProgress( progress<T>& );
+            void removeProgress( void );
+            #endif
         
             // derived from patch clustering
             ublas::vector<T> getPrototypeWeights( void ) const;
@@ -106,7 +119,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         private :
         
             /** distance object **/
-            const distances::distance<T>& m_distance;        
+            typename distances::policy<D>::type m_distance;        
             /** prototypes **/
             ublas::matrix<T> m_prototypes;                
             /** bool for logging prototypes **/
@@ -121,17 +134,28 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             std::vector< ublas::vector<T> > m_logprototypeWeights;
             /** bool for check initialized patch **/
             bool m_firstpatch;
+            /** optional instrumentation object (not owned) **/
+            instrumentation<T>* m_instrumentation;
+            /** optional progress object (not owned) **/
+            progress<T>* m_progress;
             
-            T calculateQuantizationError( const ublas::matrix<T>&, const ublas::matrix<T>& ) const;
+            T getQuantizationError( const ublas::matrix<T>& ) const;
+            T adapt( const patch<T>&, const ublas::vector<T>&, ublas::matrix<T>& );
             
             #ifdef MACHINELEARNING_MPI
+            /** number of chunks, in which the prototype reduction is split **/
+            static const std::size_t m_reductionchunks = 4;
             /** map with information to every process and prototype**/
             std::vector< std::pair<std::size_t,std::size_t> > m_processprototypinfo;
             
-            void synchronizePrototypes( const mpi::communicator&, ublas::matrix<T>&, ublas::vector<T>& );
+            void adapt( const mpi::communicator&, const patch<T>&, const ublas::vector<T>&, ublas::matrix<T>&, ublas::matrix<T>&, ublas::matrix<T>&, std::vector<MPI_Request>& );
+            void initializeReduction( const mpi::communicator&, ublas::matrix<T>&, ublas::matrix<T>&, std::vector<MPI_Request>& ) const;
+            void finalizeReduction( const mpi::communicator&, ublas::matrix<T>&, ublas::matrix<T>&, std::vector<MPI_Request>& );
+            void receivePrototypes( const std::size_t&, ublas::matrix<T>&, ublas::matrix<T>&, std::vector<MPI_Request>& ) const;
+            std::pair<std::size_t, std::size_t> getReductionChunk( const std::size_t&, const std::size_t& ) const;
             void synchronizePrototypeWeights( const mpi::communicator&, ublas::vector<T>& );
+            std::vector<int> getGatherCounts( const mpi::communicator&, const std::size_t& ) const;
             ublas::matrix<T> gatherAllPrototypes( const mpi::communicator& ) const;
-            std::size_t getNumberPrototypes( const mpi::communicator& ) const;
             void setProcessPrototypeInfo( const mpi::communicator& );
             #endif
     };
@@ -143,7 +167,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_prototypes number of prototypes
      * @param p_prototypesize size of each prototype (data dimension)
      **/
-    template<typename T> inline neuralgas<T>::neuralgas( const distances::distance<T>& p_distance, const std::size_t& p_prototypes, const std::size_t& p_prototypesize ) :
+    template<typename T, typename D> inline neuralgas<T, D>::neuralgas( const D& p_distance, const std::size_t& p_prototypes, const std::size_t& p_prototypesize ) :
         m_distance( p_distance ),
         m_prototypes( tools::matrix::random<T>(p_prototypes, p_prototypesize) ),
         m_logging( false ),
@@ -151,7 +175,9 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         m_quantizationerror( std::vector<T>() ),
         m_prototypeWeights( p_prototypes, 0 ),
         m_logprototypeWeights(),
-        m_firstpatch(true)
+        m_firstpatch(true),
+        m_instrumentation( NULL ),
+        m_progress( NULL )
         #ifdef MACHINELEARNING_MPI
         , m_processprototypinfo()
         #endif
@@ -164,17 +190,18 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns the prototype matrix
      * @return matrix (rows = number of prototypes)
      **/
-    template<typename T> inline ublas::matrix<T> neuralgas<T>::getPrototypes( void ) const
+    template<typename T, typename D> inline ublas::matrix<T> neuralgas<T, D>::getPrototypes( void ) const
     {
         return m_prototypes;
     }
     
     
     
-    /** enabled logging for training
+    /** enabled logging for training, the prototypes of each iteration are
+     * stored, for large prototype sets an instrumentation object should be used
      * @param p_log bool
      **/
-    template<typename T> inline void neuralgas<T>::setLogging( const bool& p_log )
+    template<typename T, typename D> inline void neuralgas<T, D>::setLogging( const bool& p_log )
     {
         m_logging = p_log;
         m_logprototypeWeights.clear();
@@ -184,10 +211,45 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     
     
     
+    /** sets an instrumentation object, that records the phase times, the quantization error
+     * and the prototype snapshots of the following train calls
+     * @param p_instrumentation instrumentation object, that must exist during training
+     **/
+    template<typename T, typename D> inline void neuralgas<T, D>::setInstrumentation( instrumentation<T>& p_instrumentation )
+    {
+        m_instrumentation = &p_instrumentation;
+    }
+    
+    
+    /** removes the instrumentation object **/
+    template<typename T, typename D> inline void neuralgas<T, D>::removeInstrumentation( void )
+    {
+        m_instrumentation = NULL;
+    }
+    
+    
+    /** sets a progress object, that is updated after each iteration of the following
+     * (non-MPI) train and trainpatch calls and that can cancel the training
+     * @param p_progress progress object, that must exist during training
+     **/
+    template<typename T, typename D> inline void neuralgas<T, D>::setProgress( progress<T>& p_progress )
+    {
+        m_progress = &p_progress;
+    }
+    
+    
+    /** removes the progress object **/
+    template<typename T, typename D> inline void neuralgas<T, D>::removeProgress( void )
+    {
+        m_progress = NULL;
+    }
+    
+    
+    
     /** shows the logging status
      * @return bool
      **/
-    template<typename T> inline bool neuralgas<T>::getLogging( void ) const
+    template<typename T, typename D> inline bool neuralgas<T, D>::getLogging( void ) const
     {
         return m_logging && (m_logprototypes.size() > 0);
     }
@@ -197,7 +259,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns every prototype step during training
      * @return std::vector with prototype matrix
      **/
-    template<typename T> inline std::vector< ublas::matrix<T> > neuralgas<T>::getLoggedPrototypes( void ) const
+    template<typename T, typename D> inline std::vector< ublas::matrix<T> > neuralgas<T, D>::getLoggedPrototypes( void ) const
     {
         return m_logprototypes;
     }
@@ -206,7 +268,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns the dimension of prototypes
      * @return dimension of the prototypes
      **/
-    template<typename T> inline std::size_t neuralgas<T>::getPrototypeSize( void ) const 
+    template<typename T, typename D> inline std::size_t neuralgas<T, D>::getPrototypeSize( void ) const 
     {
         return m_prototypes.size2();
     }
@@ -215,7 +277,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns the number of prototypes
      * @return number of the prototypes / classes
      **/
-    template<typename T> inline std::size_t neuralgas<T>::getPrototypeCount( void ) const 
+    template<typename T, typename D> inline std::size_t neuralgas<T, D>::getPrototypeCount( void ) const 
     {
         return m_prototypes.size1();
     }
@@ -224,7 +286,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns the quantisation error 
      * @return error for each iteration
      **/
-    template<typename T> inline std::vector<T> neuralgas<T>::getLoggedQuantizationError( void ) const
+    template<typename T, typename D> inline std::vector<T> neuralgas<T, D>::getLoggedQuantizationError( void ) const
     {
         return m_quantizationerror;
     }    
@@ -234,7 +296,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_data data matrix
      * @param p_iterations number of iterations
      **/
-    template<typename T> inline void neuralgas<T>::train( const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
+    template<typename T, typename D> inline void neuralgas<T, D>::train( const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
     {
         train(p_data, p_iterations, m_prototypes.size1() * 0.5);
     }
@@ -243,7 +305,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns the weights of prototypes on patch clustering
      * @return weights vector
      **/
-    template<typename T> inline ublas::vector<T> neuralgas<T>::getPrototypeWeights( void ) const
+    template<typename T, typename D> inline ublas::vector<T> neuralgas<T, D>::getPrototypeWeights( void ) const
     {
         return m_prototypeWeights;
     }
@@ -252,7 +314,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     /** returns the log of the prototype weights
      * @return std::vector with weight vector
      **/
-    template<typename T> inline std::vector< ublas::vector<T> > neuralgas<T>::getLoggedPrototypeWeights( void ) const
+    template<typename T, typename D> inline std::vector< ublas::vector<T> > neuralgas<T, D>::getLoggedPrototypeWeights( void ) const
     {
         return m_logprototypeWeights;
     }
@@ -262,7 +324,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_iterations iterations
      * @param p_lambda max adapet size
      **/
-    template<typename T> inline void neuralgas<T>::train( const ublas::matrix<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
+    template<typename T, typename D> inline void neuralgas<T, D>::train( const ublas::matrix<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
     {
         if (m_prototypes.size1() == 0)
             throw exception::runtime(_("number of prototypes must be greater than zero"), *this);
@@ -284,19 +346,17 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         }
 
         
+        if (m_instrumentation)
+            m_instrumentation->reserve(p_iterations);
+
+        
         // run neural gas       
         const T l_multi = 0.01/p_lambda;
+        const patch<T> l_patch( p_data );
         ublas::matrix<T> l_adaptmatrix( m_prototypes.size1(), p_data.size1() );
         ublas::vector<T> l_lambda(m_prototypes.size1());
         
-        for(std::size_t i=0; i < p_iterations; ++i) {
-            
-            // determine quantization error for logging
-            if (m_logging) {
-                m_logprototypes.push_back( m_prototypes );
-                m_quantizationerror.push_back( calculateQuantizationError(p_data, m_prototypes) );
-            }
-            
+        for(std::size_t i=0; (i < p_iterations) && !(m_progress && m_progress->isCanceled()); ++i) {
             
             // create adapt values
             const T l_lambdahelp = p_lambda * std::pow(l_multi, static_cast<T>(i)/static_cast<T>(p_iterations));
@@ -304,58 +364,111 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             #pragma omp parallel for shared(l_lambda)
             for(std::size_t n=0; n < l_lambda.size(); ++n)
                 l_lambda(n) = std::exp( -static_cast<T>(n) / l_lambdahelp );
-
-                                
-            // calculate for every prototype the distance
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < m_prototypes.size1(); ++n)
-                ublas::row(l_adaptmatrix, n)  = m_distance.getDistance( p_data, ublas::row(m_prototypes, n) );
-
             
-            // for every column ranks values and create adapts
-            // we need rank and not randIndex, because we 
-            // use the value of the ranking for getting the 
-            // adapt value
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < l_adaptmatrix.size2(); ++n) {
-                ublas::vector<T> l_column                = ublas::column(l_adaptmatrix, n);
-                const ublas::vector<std::size_t> l_rank  = tools::vector::rank(l_column);
-                
-                for(std::size_t j=0; j < l_rank.size(); ++j)
-                    l_adaptmatrix(j,n) = l_lambda(l_rank(j));
+            const T l_error = adapt( l_patch, l_lambda, l_adaptmatrix );
+            if (m_progress)
+                m_progress->setIteration( i+1, p_iterations, l_error );
+        }
+    }
+    
+    
+    /** runs one neural gas iteration and updates the logging / instrumentation
+     * @param p_patch weighted datapoints
+     * @param p_lambda adapt value of each rank
+     * @param p_adaptmatrix working matrix (rows = number of prototypes, columns = number of patch rows)
+     * @return quantization error of the iteration (zero if no logging, instrumentation or progress object is used)
+     **/
+    template<typename T, typename D> inline T neuralgas<T, D>::adapt( const patch<T>& p_patch, const ublas::vector<T>& p_lambda, ublas::matrix<T>& p_adaptmatrix )
+    {
+        if (m_logging)
+            m_logprototypes.push_back( m_prototypes );
+        if (m_instrumentation) {
+            m_instrumentation->beginIteration();
+            if (m_instrumentation->isSnapshot())
+                m_instrumentation->addSnapshot( m_prototypes );
+            m_instrumentation->startPhase();
+        }
+        
+        
+        // calculate for every datapoint the distance to all prototypes, the datapoints are split
+        // with a static schedule, so each thread reads the same (NUMA local) rows in each iteration.
+        // The adapt values replace the distances in place and are multiplied with the data,
+        // so the matrix rows must be the prototypes and the distances are written as (strided) columns
+        #pragma omp parallel for schedule(static) shared(p_adaptmatrix)
+        for(std::size_t i=0; i < p_patch.size1(); ++i)
+            ublas::column(p_adaptmatrix, i)  = m_distance.getDistance( m_prototypes, p_patch.getRow(i) );
+        
+        if (m_instrumentation)
+            m_instrumentation->stopPhase( instrumentation<T>::distance );
+        
+        // determine quantization error of the distances for logging
+        T l_error = 0;
+        if (m_logging || m_instrumentation || m_progress) {
+            l_error = getQuantizationError( p_adaptmatrix );
+            
+            if (m_logging)
+                m_quantizationerror.push_back( l_error );
+            if (m_instrumentation) {
+                m_instrumentation->setQuantizationError( l_error );
+                m_instrumentation->startPhase();
             }
-
+        }
+        
+        
+        // for every column ranks values and create adapts
+        // we need rank and not randIndex, because we 
+        // use the value of the ranking for getting the 
+        // adapt value
+        #pragma omp parallel for schedule(static) shared(p_adaptmatrix)
+        for(std::size_t n=0; n < p_adaptmatrix.size2(); ++n) {
+            ublas::vector<T> l_column                = ublas::column(p_adaptmatrix, n);
+            const ublas::vector<std::size_t> l_rank  = tools::vector::rank(l_column);
             
-
-            // create prototypes
-            m_prototypes = ublas::prod( l_adaptmatrix, p_data );
+            for(std::size_t j=0; j < l_rank.size(); ++j)
+                p_adaptmatrix(j,n) = p_lambda(l_rank(j));
+        }
+        
+        // add the weights of the prototype rows
+        p_patch.weight( p_adaptmatrix );
+        
+        if (m_instrumentation) {
+            m_instrumentation->stopPhase( instrumentation<T>::rank );
+            m_instrumentation->startPhase();
+        }
+        
+        
+        // create prototypes
+        m_prototypes = p_patch.prod( p_adaptmatrix );
+        
+        if (m_instrumentation) {
+            m_instrumentation->stopPhase( instrumentation<T>::product );
+            m_instrumentation->startPhase();
+        }
+        
+        
+        // normalize prototypes
+        #pragma omp parallel for
+        for(std::size_t n=0; n < m_prototypes.size1(); ++n) {
+            const T l_norm = ublas::sum( ublas::row(p_adaptmatrix, n) );
             
-            // normalize prototypes
-            #pragma omp parallel for
-            for(std::size_t n=0; n < m_prototypes.size1(); ++n) {
-                const T l_norm = ublas::sum( ublas::row(l_adaptmatrix, n) );
-                
-                if (!tools::function::isNumericalZero(l_norm))
-                    ublas::row(m_prototypes, n) /= l_norm;
-            }
+            if (!tools::function::isNumericalZero(l_norm))
+                ublas::row(m_prototypes, n) /= l_norm;
         }
+        
+        if (m_instrumentation)
+            m_instrumentation->stopPhase( instrumentation<T>::normalize );
+        
+        return l_error;
     }
     
     
-    /** calculate the quantization error
-     * @param p_data matrix with data points
-     * @param p_prototypes prototype matrix
+    /** calculate the quantization error of an already calculated distance matrix
+     * @param p_distances distance matrix (rows = prototypes, columns = datapoints)
      * @return quantization error
-     **/    
-    template<typename T> inline T neuralgas<T>::calculateQuantizationError( const ublas::matrix<T>& p_data, const ublas::matrix<T>& p_prototypes ) const
+     **/
+    template<typename T, typename D> inline T neuralgas<T, D>::getQuantizationError( const ublas::matrix<T>& p_distances ) const
     {
-        ublas::matrix<T> l_distances( p_prototypes.size1(), p_data.size1() );
-        
-        #pragma omp parallel for shared(l_distances)
-        for(std::size_t i=0; i < p_prototypes.size1(); ++i)
-            ublas::row(l_distances, i) = m_distance.getDistance( p_data, ublas::row(p_prototypes, i) );
-        
-        return 0.5 * ublas::sum(  m_distance.getAbs(tools::matrix::min(l_distances, tools::matrix::column))  );  
+        return 0.5 * ublas::sum(  m_distance.getAbs(tools::matrix::min(p_distances, tools::matrix::column))  );  
     }
     
     
@@ -364,7 +477,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_data matrix
      * @return index array of prototype indices
      **/
-    template<typename T> inline ublas::indirect_array<> neuralgas<T>::use( const ublas::matrix<T>& p_data ) const
+    template<typename T, typename D> inline ublas::indirect_array<> neuralgas<T, D>::use( const ublas::matrix<T>& p_data ) const
     {
         if (m_prototypes.size1() == 0)
             throw exception::runtime(_("number of prototypes must be greater than zero"), *this);
@@ -372,20 +485,19 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             throw exception::runtime(_("data and prototype dimension are not equal"), *this);
         
         ublas::indirect_array<> l_idx(p_data.size1());
-        ublas::matrix<T> l_distance(m_prototypes.size1(), p_data.size1());
+        ublas::matrix<T> l_distance(p_data.size1(), m_prototypes.size1());
         
-        // calculate distance for every prototype
-        #pragma omp parallel for shared(l_distance)
-        for(std::size_t i=0; i < m_prototypes.size1(); ++i)
-            ublas::row(l_distance, i)  = m_distance.getDistance( p_data,  ublas::row(m_prototypes, i) );
+        // calculate distance for every datapoint (rows = datapoints)
+        #pragma omp parallel for schedule(static) shared(l_distance)
+        for(std::size_t i=0; i < p_data.size1(); ++i)
+            ublas::row(l_distance, i)  = m_distance.getDistance( m_prototypes, ublas::row(p_data, i) );
         
         // determine nearest prototype
-        #pragma omp parallel for shared(l_idx)
-        for(std::size_t i=0; i < l_distance.size2(); ++i) {
-            ublas::vector<T> l_col                = ublas::column(l_distance, i);
-            const ublas::indirect_array<> l_rank  = tools::vector::rankIndex( l_col );
-            l_idx[i] = l_rank(0);
-         }
+        #pragma omp parallel for schedule(static) shared(l_distance, l_idx)
+        for(std::size_t i=0; i < l_distance.size1(); ++i) {
+            const ublas::matrix_row< ublas::matrix<T> > l_row( l_distance, i );
+            l_idx[i] = static_cast<std::size_t>( std::min_element(l_row.begin(), l_row.end()) - l_row.begin() );
+        }
         
         return l_idx;
     }
@@ -395,7 +507,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_data datapoints
      * @param p_iterations iterations
      **/
-    template<typename T> inline void neuralgas<T>::trainpatch( const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
+    template<typename T, typename D> inline void neuralgas<T, D>::trainpatch( const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
     {
         trainpatch(p_data, p_iterations, m_prototypes.size1() * 0.5);
     }
@@ -406,7 +518,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_iterations iterations
      * @param p_lambda max adapet size
      **/
-    template<typename T> inline void neuralgas<T>::trainpatch( const ublas::matrix<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
+    template<typename T, typename D> inline void neuralgas<T, D>::trainpatch( const ublas::matrix<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
     {
         if (m_prototypes.size1() == 0)
             throw exception::runtime(_("number of prototypes must be greater than zero"), *this);
@@ -427,39 +539,22 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             m_quantizationerror.reserve(p_iterations);
         }
         
-        // if not the first patch add prototypes to data at the end and set the multiplier
-        ublas::matrix<T> l_data(p_data);
-        ublas::vector<std::size_t> l_multiplier(l_data.size1(), 1);
-        if (!m_firstpatch) {
-            
-            // resize data matrix
-            l_data.resize( l_data.size1()+m_prototypes.size1(), l_data.size2());
-            ublas::matrix_range< ublas::matrix<T> > l_datarange(l_data, 
-                                                            ublas::range( l_data.size1()-m_prototypes.size1(), l_data.size1() ), 
-                                                            ublas::range( 0, l_data.size2() )
-                                                            );
-            l_datarange.assign(m_prototypes);
-            
-            // resize multiplier
-            l_multiplier.resize( l_multiplier.size()+m_prototypeWeights.size() );
-            ublas::vector_range< ublas::vector<std::size_t> > l_multiplierrange( l_multiplier, ublas::range( l_multiplier.size()-m_prototypeWeights.size(), l_multiplier.size()) );
-            l_multiplierrange.assign(m_prototypeWeights);
-        }
+        // if not the first patch the prototypes are added with their weights behind the data, the
+        // patch references the data, so only the prototypes are copied (they are changed on training)
+        const ublas::matrix<T> l_prototypes( m_prototypes );
+        const ublas::vector<T> l_weights( m_prototypeWeights );
+        const patch<T> l_patch = m_firstpatch ? patch<T>( p_data ) : patch<T>( p_data, l_prototypes, l_weights );
+        
+        if (m_instrumentation)
+            m_instrumentation->reserve(p_iterations);
      
 
         // run neural gas       
         const T l_multi = 0.01/p_lambda;
-        ublas::matrix<T> l_adaptmatrix( m_prototypes.size1(), p_data.size1() );
+        ublas::matrix<T> l_adaptmatrix( m_prototypes.size1(), l_patch.size1() );
         ublas::vector<T> l_lambda(m_prototypes.size1());
         
-        for(std::size_t i=0; i < p_iterations; ++i) {
-            
-            // determine quantization error for logging
-            if (m_logging) {
-                m_logprototypes.push_back( m_prototypes );
-                m_quantizationerror.push_back( calculateQuantizationError(l_data, m_prototypes) );
-            }
-            
+        for(std::size_t i=0; (i < p_iterations) && !(m_progress && m_progress->isCanceled()); ++i) {
             
             // create adapt values
             const T l_lambdahelp = p_lambda * std::pow(l_multi, static_cast<T>(i)/static_cast<T>(p_iterations));
@@ -468,44 +563,9 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             for(std::size_t n=0; n < l_lambda.size(); ++n)
                 l_lambda(n) = std::exp( -static_cast<T>(n) / l_lambdahelp );
             
-            
-            // calculate for every prototype the distance
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < m_prototypes.size1(); ++n)
-                ublas::row(l_adaptmatrix, n)  = m_distance.getDistance( l_data, ublas::row(m_prototypes, n) ) ;
-            
-            
-            // for every column ranks values and create adapts
-            // we need rank and not randIndex, because we 
-            // use the value of the ranking for getting the 
-            // adapt value
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < l_adaptmatrix.size2(); ++n) {
-                ublas::vector<T> l_column                = ublas::column(l_adaptmatrix, n);
-                const ublas::vector<std::size_t> l_rank  = tools::vector::rank(l_column);
-                
-                for(std::size_t j=0; j < l_rank.size(); ++j)
-                    l_adaptmatrix(j,n) = l_lambda(l_rank(j));
-            }
-            
-            
-            // add multiplier
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < l_adaptmatrix.size1(); ++n)
-                ublas::row(l_adaptmatrix, n) = ublas::element_prod( ublas::row(l_adaptmatrix, n), l_multiplier );
-            
-            // create prototypes
-            m_prototypes = ublas::prod( l_adaptmatrix, l_data );
-            
-            
-            // normalize prototypes
-            #pragma omp parallel for
-            for(std::size_t n=0; n < m_prototypes.size1(); ++n) {
-                const T l_norm = ublas::sum( ublas::row(l_adaptmatrix, n) );
-                
-                if (!tools::function::isNumericalZero(l_norm))
-                    ublas::row(m_prototypes, n) /= l_norm;
-            }
+            const T l_error = adapt( l_patch, l_lambda, l_adaptmatrix );
+            if (m_progress)
+                m_progress->setIteration( i+1, p_iterations, l_error );
         }
         
         // determine size of receptive fields, but we use only the data points
@@ -527,81 +587,181 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     //======= MPI ==================================================================================================================================
     #ifdef MACHINELEARNING_MPI
     
-    /** gathering prototypes of every process and return the full prototypes matrix (row oriantated)
+    /** returns the number of values of each process and gathers them on every process
+     * @param p_mpi MPI object for communication
+     * @param p_size number of values of the process
+     * @return std::vector with the number of values of each process
+     **/
+    template<typename T, typename D> inline std::vector<int> neuralgas<T, D>::getGatherCounts( const mpi::communicator& p_mpi, const std::size_t& p_size ) const
+    {
+        int l_size = static_cast<int>(p_size);
+        std::vector<int> l_count( p_mpi.size(), 0 );
+        MPI_Allgather( &l_size, 1, MPI_INT, &l_count[0], 1, MPI_INT, p_mpi );
+        return l_count;
+    }
+    
+    
+    /** gathering prototypes of every process and return the full prototypes matrix (row oriantated).
+     * The row-major data of the prototype matrices is gathered directly, so no serialization is needed
      * @param p_mpi MPI object for communication
      * @return full prototypes matrix
      **/
-    template<typename T> inline ublas::matrix<T> neuralgas<T>::gatherAllPrototypes( const mpi::communicator& p_mpi ) const
+    template<typename T, typename D> inline ublas::matrix<T> neuralgas<T, D>::gatherAllPrototypes( const mpi::communicator& p_mpi ) const
     {
-        // gathering in this way, that every process get all prototypes
-        std::vector< ublas::matrix<T> > l_prototypedata;
-        mpi::all_gather(p_mpi, m_prototypes, l_prototypedata);
-        
-        // create full prototype matrix with processprotos
-        ublas::matrix<T> l_prototypes = l_prototypedata[0];
-        for(std::size_t i=1; i < l_prototypedata.size(); ++i) {
-            l_prototypes.resize( l_prototypes.size1()+l_prototypedata[i].size1(), l_prototypes.size2());
-            
-            ublas::matrix_range< ublas::matrix<T> > l_range(l_prototypes, 
-                                                            ublas::range( l_prototypes.size1()-l_prototypedata[i].size1(), l_prototypes.size1() ), 
-                                                            ublas::range( 0, l_prototypes.size2() )
-                                                            );
-            l_range.assign(l_prototypedata[i]);
-        }
+        const std::vector<int> l_count = getGatherCounts( p_mpi, m_prototypes.size1() * m_prototypes.size2() );
+        std::vector<int> l_offset( l_count.size(), 0 );
+        for(std::size_t i=1; i < l_count.size(); ++i)
+            l_offset[i] = l_offset[i-1] + l_count[i-1];
+        
+        ublas::matrix<T> l_prototypes( static_cast<std::size_t>(l_offset.back() + l_count.back()) / m_prototypes.size2(), m_prototypes.size2() );
+        MPI_Allgatherv( const_cast<T*>(m_prototypes.data().begin()), l_count[p_mpi.rank()], mpi::get_mpi_datatype<T>(T()), 
+                        l_prototypes.data().begin(), &l_count[0], &l_offset[0], mpi::get_mpi_datatype<T>(T()), p_mpi );
         
         return l_prototypes;
     }
     
     
     
-    /** synchronize prototypes of every process and set with them the local prototypematrix.
-     * We can not use const references because of the range. The idea is the commutativity
-     * of the dot product of every prototype dimension. The prototypes are a matrix-matrix-product of the
-     * adaption value and the data values. The matrix-matrix-product is a dot product of rows and columns so
-     * the commutativity is used for parallelism / the gathering uses the commutativity for create the correct prototype values
+    /** returns the row range of a reduction chunk
+     * @param p_rows number of rows
+     * @param p_chunk chunk index
+     * @return pair with first and last (exclusive) row
+     **/
+    template<typename T, typename D> inline std::pair<std::size_t, std::size_t> neuralgas<T, D>::getReductionChunk( const std::size_t& p_rows, const std::size_t& p_chunk ) const
+    {
+        const std::size_t l_chunks = std::min( p_rows, static_cast<std::size_t>(m_reductionchunks) );
+        return std::pair<std::size_t, std::size_t>( p_rows * p_chunk / l_chunks, p_rows * (p_chunk+1) / l_chunks );
+    }
+    
+    
+    /** creates the buffers of the prototype reduction. Each row of the reduction buffer
+     * stores the numerator of a prototype and the normalization value in the last column,
+     * so the prototypes of all processes are synchronized with one collective sum. The
+     * buffer is initialized with the current prototypes and a normalization of one
      * @param p_mpi MPI object for communication
-     * @param p_localprototypes local prototype matrix
-     * @param p_localnorm normalize vector
+     * @param p_prototypes matrix for all prototypes
+     * @param p_buffer reduction buffer
+     * @param p_request request of each chunk
      **/
-    template<typename T> inline void neuralgas<T>::synchronizePrototypes( const mpi::communicator& p_mpi, ublas::matrix<T>& p_localprototypes, ublas::vector<T>& p_localnorm )
+    template<typename T, typename D> inline void neuralgas<T, D>::initializeReduction( const mpi::communicator& p_mpi, ublas::matrix<T>& p_prototypes, ublas::matrix<T>& p_buffer, std::vector<MPI_Request>& p_request ) const
     {
-        // create for each process the norm and prototypes
-        // we need two vectors, in which the index is the process ID and sends the data back to the process
-        std::vector< ublas::matrix<T> > l_prototypes;
-		std::vector< ublas::vector<T> > l_norm;
-        for(int i=0; i < p_mpi.size(); ++i) {
+        p_prototypes = gatherAllPrototypes( p_mpi );
+        
+        p_buffer.resize( p_prototypes.size1(), p_prototypes.size2()+1, false );
+        ublas::subrange( p_buffer, 0, p_prototypes.size1(), 0, p_prototypes.size2() ) = p_prototypes;
+        ublas::column( p_buffer, p_prototypes.size2() ) = ublas::scalar_vector<T>( p_prototypes.size1(), 1 );
+        
+        p_request.assign( std::min(p_prototypes.size1(), static_cast<std::size_t>(m_reductionchunks)), MPI_REQUEST_NULL );
+    }
+    
+    
+    /** waits for the reduction of a chunk and normalizes the prototypes of the chunk
+     * @param p_chunk chunk index
+     * @param p_prototypes matrix for all prototypes
+     * @param p_buffer reduction buffer
+     * @param p_request request of each chunk
+     **/
+    template<typename T, typename D> inline void neuralgas<T, D>::receivePrototypes( const std::size_t& p_chunk, ublas::matrix<T>& p_prototypes, ublas::matrix<T>& p_buffer, std::vector<MPI_Request>& p_request ) const
+    {
+        MPI_Wait( &p_request[p_chunk], MPI_STATUS_IGNORE );
+        
+        const std::pair<std::size_t, std::size_t> l_chunk = getReductionChunk( p_buffer.size1(), p_chunk );
+        const std::size_t l_dim                           = p_prototypes.size2();
+        
+        #pragma omp parallel for shared(p_prototypes, p_buffer)
+        for(std::size_t n=l_chunk.first; n < l_chunk.second; ++n) {
+            const T l_norm = p_buffer(n, l_dim);
             
-            // prototypes
-            ublas::matrix_range< ublas::matrix<T> > l_protorange(p_localprototypes, 
-                                                                 ublas::range( m_processprototypinfo[i].first, m_processprototypinfo[i].first + m_processprototypinfo[i].second ), 
-                                                                 ublas::range( 0, p_localprototypes.size2() )
-                                                                 );
-            l_prototypes.push_back(l_protorange);
+            for(std::size_t j=0; j < l_dim; ++j)
+                p_prototypes(n, j) = tools::function::isNumericalZero(l_norm) ? p_buffer(n, j) : p_buffer(n, j) / l_norm;
+        }
+    }
+    
+    
+    /** waits for all outstanding reductions and sets the local prototypes
+     * @param p_mpi MPI object for communication
+     * @param p_prototypes matrix for all prototypes
+     * @param p_buffer reduction buffer
+     * @param p_request request of each chunk
+     **/
+    template<typename T, typename D> inline void neuralgas<T, D>::finalizeReduction( const mpi::communicator& p_mpi, ublas::matrix<T>& p_prototypes, ublas::matrix<T>& p_buffer, std::vector<MPI_Request>& p_request )
+    {
+        for(std::size_t i=0; i < p_request.size(); ++i)
+            receivePrototypes( i, p_prototypes, p_buffer, p_request );
+        
+        m_prototypes = ublas::subrange( p_prototypes, m_processprototypinfo[p_mpi.rank()].first, m_processprototypinfo[p_mpi.rank()].first + m_processprototypinfo[p_mpi.rank()].second, 0, p_prototypes.size2() );
+    }
+    
+    
+    /** runs one neural gas iteration on the cluster. The synchronized prototypes of the previous
+     * iteration are received chunk by chunk, so the distances of a chunk are calculated while the
+     * following chunks are still reduced. The numerator and the normalization of all prototypes
+     * are summed over the processes with non-blocking all-reduce calls (blocking calls on MPI < 3)
+     * @param p_mpi MPI object for communication
+     * @param p_patch weighted datapoints
+     * @param p_lambda adapt value of each rank
+     * @param p_adaptmatrix working matrix (rows = number of all prototypes, columns = number of patch rows)
+     * @param p_prototypes matrix for all prototypes
+     * @param p_buffer reduction buffer
+     * @param p_request request of each chunk
+     **/
+    template<typename T, typename D> inline void neuralgas<T, D>::adapt( const mpi::communicator& p_mpi, const patch<T>& p_patch, const ublas::vector<T>& p_lambda, ublas::matrix<T>& p_adaptmatrix, ublas::matrix<T>& p_prototypes, ublas::matrix<T>& p_buffer, std::vector<MPI_Request>& p_request )
+    {
+        // calculate for every prototype the distance (of the actually prototypes)
+        for(std::size_t i=0; i < p_request.size(); ++i) {
+            receivePrototypes( i, p_prototypes, p_buffer, p_request );
             
-            //norm
-            ublas::vector_range< ublas::vector<T> > l_normrange(p_localnorm,
-                                                                ublas::range( m_processprototypinfo[i].first, m_processprototypinfo[i].first + m_processprototypinfo[i].second )
-                                                                );
-            l_norm.push_back(l_normrange);
+            const std::pair<std::size_t, std::size_t> l_chunk = getReductionChunk( p_prototypes.size1(), i );
+            #pragma omp parallel for shared(p_adaptmatrix)
+            for(std::size_t n=l_chunk.first; n < l_chunk.second; ++n)
+                ublas::row(p_adaptmatrix, n)  = p_patch.getDistance( m_distance, ublas::row(p_prototypes, n) );
+        }
+        m_prototypes = ublas::subrange( p_prototypes, m_processprototypinfo[p_mpi.rank()].first, m_processprototypinfo[p_mpi.rank()].first + m_processprototypinfo[p_mpi.rank()].second, 0, p_prototypes.size2() );
+        
+        
+        // determine quantization error for logging
+        if (m_logging) {
+            m_logprototypes.push_back( m_prototypes );
+            m_quantizationerror.push_back( getQuantizationError(p_adaptmatrix) );
+        }
+        
+        
+        // for every column ranks values and create adapts
+        // we need rank and not randIndex, because we 
+        // use the value of the ranking for getting the 
+        // adapt value
+        #pragma omp parallel for shared(p_adaptmatrix)
+        for(std::size_t n=0; n < p_adaptmatrix.size2(); ++n) {
+            ublas::vector<T> l_column                = ublas::column(p_adaptmatrix, n);
+            const ublas::vector<std::size_t> l_rank  = tools::vector::rank(l_column);
+            
+            for(std::size_t j=0; j < l_rank.size(); ++j)
+                p_adaptmatrix(j,n) = p_lambda(l_rank(j));
         }
         
+        // add the weights of the prototype rows
+        p_patch.weight( p_adaptmatrix );
         
-        // collect the norm and prototype data in each process
-		std::vector< ublas::vector<T> > l_collectnorm;
-        std::vector< ublas::matrix<T> > l_collectprototypes;
         
-        mpi::all_to_all( p_mpi, l_norm, l_collectnorm );
-        mpi::all_to_all( p_mpi, l_prototypes, l_collectprototypes );
+        // create local numerator and normalization within the reduction buffer
+        ublas::subrange( p_buffer, 0, p_buffer.size1(), 0, p_patch.size2() ) = p_patch.prod( p_adaptmatrix );
         
+        #pragma omp parallel for shared(p_buffer)
+        for(std::size_t n=0; n < p_buffer.size1(); ++n)
+            p_buffer(n, p_patch.size2()) = ublas::sum( ublas::row(p_adaptmatrix, n) );
         
-        // both std::vectors will be summerized
-        m_prototypes = std::accumulate( l_collectprototypes.begin(), l_collectprototypes.end(), ublas::matrix<T>(m_prototypes.size1(), m_prototypes.size2(), 0) );
-        const ublas::vector<T> l_sumnorm    = std::accumulate( l_collectnorm.begin(), l_collectnorm.end(), ublas::vector<T>(l_collectnorm[0].size(), 0) );
         
-        // normalize the prototypes
-        for(std::size_t i=0; i < l_sumnorm.size(); ++i)
-            if (!tools::function::isNumericalZero(l_sumnorm(i)))
-                ublas::row(m_prototypes, i) /= l_sumnorm(i);
+        // sum the buffer over all processes, each chunk is reduced on its own, so the
+        // next iteration can start with the first chunk
+        for(std::size_t i=0; i < p_request.size(); ++i) {
+            const std::pair<std::size_t, std::size_t> l_chunk = getReductionChunk( p_buffer.size1(), i );
+            
+            #if MPI_VERSION >= 3
+            MPI_Iallreduce( MPI_IN_PLACE, &p_buffer(l_chunk.first, 0), static_cast<int>((l_chunk.second-l_chunk.first) * p_buffer.size2()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi, &p_request[i] );
+            #else
+            MPI_Allreduce( MPI_IN_PLACE, &p_buffer(l_chunk.first, 0), static_cast<int>((l_chunk.second-l_chunk.first) * p_buffer.size2()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
+            #endif
+        }
     }
     
     
@@ -610,7 +770,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * of the full matrix for each process
      * @param p_mpi MPI object for communication
      **/
-    template<typename T> inline void neuralgas<T>::setProcessPrototypeInfo( const mpi::communicator& p_mpi )
+    template<typename T, typename D> inline void neuralgas<T, D>::setProcessPrototypeInfo( const mpi::communicator& p_mpi )
     {
         m_processprototypinfo.clear();
         // gathering the number of prototypes
@@ -626,24 +786,12 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     }
     
     
-    /** returns the number of all prototypes
-     * @param p_mpi MPI object for communication
-     * @return number of prototypes
-     **/
-    template<typename T> inline std::size_t neuralgas<T>::getNumberPrototypes( const mpi::communicator& p_mpi ) const
-    {
-        std::size_t l_count = 0;
-        mpi::all_reduce(p_mpi, m_prototypes.size1(), l_count, std::plus<std::size_t>());
-        return l_count;
-    }
-    
-    
     /** train the data on the cluster
      * @param p_mpi MPI object for communication
      * @param p_data datapoints
      * @param p_iterations iterations
      **/
-    template<typename T> inline void neuralgas<T>::train( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
+    template<typename T, typename D> inline void neuralgas<T, D>::train( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
     {
         // if the process has no prototypes, than lambda need not be zero, so we set it to a minimal numerical value, so the exception is not thrown
         train(p_mpi, p_data, p_iterations, ((m_prototypes.size1() == 0) ? std::numeric_limits<T>::epsilon() :  m_prototypes.size1() * 0.5) );
@@ -656,7 +804,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_iterations iterations
      * @param p_lambda max adapet size
      **/
-    template<typename T> inline void neuralgas<T>::train( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
+    template<typename T, typename D> inline void neuralgas<T, D>::train( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
     {
         if (p_data.size1() < m_prototypes.size1())
             throw exception::runtime(_("number of datapoints are less than prototypes"), *this);
@@ -685,9 +833,14 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         
         // run neural gas       
         const T l_multi = 0.01/l_lambdaMPI;
-        ublas::vector<T> l_normvec( getNumberPrototypes(p_mpi), 0 );
-        ublas::vector<T> l_lambda(l_normvec.size());
-        ublas::matrix<T> l_adaptmatrix( l_normvec.size(), p_data.size1() );
+        ublas::matrix<T> l_prototypes;
+        ublas::matrix<T> l_buffer;
+        std::vector<MPI_Request> l_request;
+        initializeReduction( p_mpi, l_prototypes, l_buffer, l_request );
+        
+        const patch<T> l_patch( p_data );
+        ublas::vector<T> l_lambda(l_prototypes.size1());
+        ublas::matrix<T> l_adaptmatrix( l_prototypes.size1(), p_data.size1() );
         
         for(std::size_t i=0; (i < l_iterationsMPI); ++i) {
             
@@ -698,50 +851,10 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             for(std::size_t n=0; n < l_lambda.size(); ++n)
                 l_lambda(n) = std::exp( -static_cast<T>(n) / l_lambdahelp );
 
-            
-            // we get all prototypes of every process
-            ublas::matrix<T> l_prototypes = gatherAllPrototypes( p_mpi );
-            
-            
-            // determine quantization error for logging
-            if (m_logging) {
-                m_logprototypes.push_back( m_prototypes );
-                m_quantizationerror.push_back( calculateQuantizationError(p_data, l_prototypes) );
-            }
-            
-            
-            // calculate for every prototype the distance (of the actually prototypes).
-            // within the adapt matrix, we must specify the position of the prototypes 
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < l_prototypes.size1(); ++n)
-                ublas::row(l_adaptmatrix, n)  = m_distance.getDistance( p_data, ublas::row(l_prototypes, n) ) ;
-            
-            
-            // for every column ranks values and create adapts
-            // we need rank and not randIndex, because we 
-            // use the value of the ranking for getting the 
-            // adapt value
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < l_adaptmatrix.size2(); ++n) {
-                ublas::vector<T> l_column                = ublas::column(l_adaptmatrix, n);
-                const ublas::vector<std::size_t> l_rank  = tools::vector::rank(l_column);
-                
-                for(std::size_t j=0; j < l_rank.size(); ++j)
-                    l_adaptmatrix(j,n) = l_lambda(l_rank(j));
-            }
-            
-            
-            // create local prototypes
-            l_prototypes = ublas::prod( l_adaptmatrix, p_data );
-            
-            
-            // normalize prototypes
-            #pragma omp parallel for shared(l_normvec)
-            for(std::size_t n=0; n < l_prototypes.size1(); ++n)
-                l_normvec(n) = ublas::sum( ublas::row(l_adaptmatrix, n) );
-            
-            synchronizePrototypes(p_mpi, l_prototypes, l_normvec);
+            adapt( p_mpi, l_patch, l_lambda, l_adaptmatrix, l_prototypes, l_buffer, l_request );
         }
+        
+        finalizeReduction( p_mpi, l_prototypes, l_buffer, l_request );
     }
     
     
@@ -749,7 +862,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_mpi MPI object for communication
      * @return matrix (rows = prototypes)
      **/
-    template<typename T> inline ublas::matrix<T> neuralgas<T>::getPrototypes( const mpi::communicator& p_mpi ) const
+    template<typename T, typename D> inline ublas::matrix<T> neuralgas<T, D>::getPrototypes( const mpi::communicator& p_mpi ) const
     {
         return gatherAllPrototypes( p_mpi );
     }
@@ -759,7 +872,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_mpi MPI object for communication
      * @return std::vector with all logged prototypes
      **/
-    template<typename T> inline std::vector< ublas::matrix<T> > neuralgas<T>::getLoggedPrototypes( const mpi::communicator& p_mpi ) const
+    template<typename T, typename D> inline std::vector< ublas::matrix<T> > neuralgas<T, D>::getLoggedPrototypes( const mpi::communicator& p_mpi ) const
     {
         // we must gather every logged prototype and create the full prototype matrix
         std::vector< std::vector< ublas::matrix<T> > > l_gatherProto;
@@ -794,7 +907,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_mpi MPI object for communication
      * @return std::vector with quantization error
      **/
-    template<typename T> inline std::vector<T> neuralgas<T>::getLoggedQuantizationError( const mpi::communicator& p_mpi ) const
+    template<typename T, typename D> inline std::vector<T> neuralgas<T, D>::getLoggedQuantizationError( const mpi::communicator& p_mpi ) const
     {
         // we must call the quantization error of every process and sum all values for the main error
         std::vector< std::vector<T> > l_gatherError;
@@ -817,7 +930,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_data matrix
      * @return index array of prototype indices
      **/
-    template<typename T> inline ublas::indirect_array<> neuralgas<T>::use( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data ) const
+    template<typename T, typename D> inline ublas::indirect_array<> neuralgas<T, D>::use( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data ) const
     {
         if (p_data.size2() != m_prototypes.size2())
             throw exception::runtime(_("data and prototype dimension are not equal"), *this);
@@ -848,7 +961,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * only one process can calculate the distances between prototypes and its data, all other process must call only this methode
      * @param p_mpi MPI object for communication 
      **/
-    template<typename T> inline void neuralgas<T>::use( const mpi::communicator& p_mpi ) const
+    template<typename T, typename D> inline void neuralgas<T, D>::use( const mpi::communicator& p_mpi ) const
     {
         gatherAllPrototypes( p_mpi );
     }
@@ -858,7 +971,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_mpi MPI object for communication 
      * @return std::vector with weight vector
      **/
-    template<typename T> inline std::vector< ublas::vector<T> > neuralgas<T>::getLoggedPrototypeWeights( const mpi::communicator& p_mpi ) const
+    template<typename T, typename D> inline std::vector< ublas::vector<T> > neuralgas<T, D>::getLoggedPrototypeWeights( const mpi::communicator& p_mpi ) const
     {
         // we must gather every logged weight
         std::vector< std::vector< ublas::vector<T> > > l_gatherWeights;
@@ -886,21 +999,16 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_mpi MPI object for communication
      * @return weights vector
      **/
-    template<typename T> inline ublas::vector<T> neuralgas<T>::getPrototypeWeights( const mpi::communicator& p_mpi ) const
+    template<typename T, typename D> inline ublas::vector<T> neuralgas<T, D>::getPrototypeWeights( const mpi::communicator& p_mpi ) const
     {
-        std::vector< ublas::vector<T> > l_weightdata;
-        mpi::all_gather(p_mpi, m_prototypeWeights, l_weightdata);
+        const std::vector<int> l_count = getGatherCounts( p_mpi, m_prototypeWeights.size() );
+        std::vector<int> l_offset( l_count.size(), 0 );
+        for(std::size_t i=1; i < l_count.size(); ++i)
+            l_offset[i] = l_offset[i-1] + l_count[i-1];
         
-        // create full weight vector with processweights
-        ublas::vector<T> l_weights = l_weightdata[0];
-        for(std::size_t i=1; i < l_weightdata.size(); ++i) {
-            l_weights.resize( l_weights.size()+l_weightdata[i].size() );
-            
-            ublas::vector_range< ublas::vector<T> > l_range(l_weights,
-                                                            ublas::range( l_weights.size()-l_weightdata[i].size(), l_weights.size() )
-                                                           );
-            l_range.assign(l_weightdata[i]);
-        }
+        ublas::vector<T> l_weights( static_cast<std::size_t>(l_offset.back() + l_count.back()) );
+        MPI_Allgatherv( const_cast<T*>(m_prototypeWeights.data().begin()), l_count[p_mpi.rank()], mpi::get_mpi_datatype<T>(T()), 
+                        l_weights.data().begin(), &l_count[0], &l_offset[0], mpi::get_mpi_datatype<T>(T()), p_mpi );
         
         return l_weights;
     }
@@ -911,7 +1019,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_data datapoints
      * @param p_iterations iterations
      **/
-    template<typename T> inline void neuralgas<T>::trainpatch( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
+    template<typename T, typename D> inline void neuralgas<T, D>::trainpatch( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
     {
         trainpatch( p_mpi, p_data, p_iterations, m_prototypes.size1() * 0.5);
     }
@@ -920,23 +1028,15 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_mpi MPI object for communication
      * @param p_weight weight vector
     **/
-    template<typename T> inline void neuralgas<T>::synchronizePrototypeWeights( const mpi::communicator& p_mpi, ublas::vector<T>& p_weight )
+    template<typename T, typename D> inline void neuralgas<T, D>::synchronizePrototypeWeights( const mpi::communicator& p_mpi, ublas::vector<T>& p_weight )
     {
-        // create the weights for each process
-        std::vector< ublas::vector<T> > l_weights;
-        for(int i=0; i < p_mpi.size(); ++i) {
-            ublas::vector_range< ublas::vector<T> > l_weightrange(p_weight,
-                                                                ublas::range( m_processprototypinfo[i].first, m_processprototypinfo[i].first + m_processprototypinfo[i].second )
-                                                                );
-            l_weights.push_back(l_weightrange);
-        }
-        
-        // create vector for receiving
-        std::vector< ublas::vector<T> > l_collectweight;
-        mpi::all_to_all( p_mpi, l_weights, l_collectweight );
+        // sum the weights over all processes and scatter the block of each process
+        std::vector<int> l_count;
+        for(std::size_t i=0; i < m_processprototypinfo.size(); ++i)
+            l_count.push_back( static_cast<int>(m_processprototypinfo[i].second) );
         
-        // std::vectors will be summerized
-        m_prototypeWeights = std::accumulate( l_collectweight.begin(), l_collectweight.end(), ublas::vector<T>(m_prototypeWeights.size(), 0) );
+        m_prototypeWeights.resize( m_processprototypinfo[p_mpi.rank()].second, false );
+        MPI_Reduce_scatter( p_weight.data().begin(), m_prototypeWeights.data().begin(), &l_count[0], mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
     }
     
     /** train a patch (input data) with the data (include the weights)
@@ -947,7 +1047,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
      * @param p_iterations iterations
      * @param p_lambda max adapet size
      **/
-    template<typename T> inline void neuralgas<T>::trainpatch( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
+    template<typename T, typename D> inline void neuralgas<T, D>::trainpatch( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
     {
         if (p_data.size1() < m_prototypes.size1())
             throw exception::runtime(_("number of datapoints are less than prototypes"), *this);
@@ -974,42 +1074,28 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             m_quantizationerror.reserve(l_iterationsMPI);
         }
 
-        // if not the first patch add prototypes to data at the end and set the multiplier
-        ublas::matrix<T> l_data(p_data);
-        ublas::vector<T> l_multiplier(l_data.size1(), 1);
-        
+        // if not the first patch the prototypes of all processes are added with their weights behind the data (the patch
+        // references the data, so the data is not copied)
         ublas::vector<T> l_prototypeWeights = getPrototypeWeights( p_mpi );
+        const ublas::matrix<T> l_allprototypes = m_firstpatch ? ublas::matrix<T>() : gatherAllPrototypes( p_mpi );
         
-        if (!m_firstpatch) {
-            
-            // resize data matrix with prototypes
-            const ublas::matrix<T> l_prototypes       = gatherAllPrototypes( p_mpi );
-            l_data.resize( l_data.size1()+l_prototypes.size1(), l_data.size2());
-            ublas::matrix_range< ublas::matrix<T> > l_datarange(l_data, 
-                                                                ublas::range( l_data.size1()-l_prototypes.size1(), l_data.size1() ), 
-                                                                ublas::range( 0, l_data.size2() )
-                                                                );
-            l_datarange.assign(l_prototypes);
-            
-            
-            
-            // resize multiplier with prototype weights and divided them with the number of CPUs for correct scaling (see note)
+        // each prototype is used n (=CPU count) times, because each CPU uses a own data block and the prototypes are added to them,
+        // so the multipliers are also added n (=CPU count) time. To correct this, we divide the weights with the number of CPUs
+        if (!m_firstpatch)
             l_prototypeWeights /= p_mpi.size();
-            
-            l_multiplier.resize( l_multiplier.size()+l_prototypeWeights.size() );
-            ublas::vector_range< ublas::vector<T> > l_multiplierrange( l_multiplier, ublas::range( l_multiplier.size()-l_prototypeWeights.size(), l_multiplier.size()) );
-            
-            // each prototype is used n (=CPU count) times, because each CPU uses a own data block and the prototypes are added to them,
-            // so the multipliers are also added n (=CPU count) time. To correct this, we divide the weights with the number of CPUs
-            l_multiplierrange.assign(l_prototypeWeights);
-        }
+        
+        const patch<T> l_patch = m_firstpatch ? patch<T>( p_data ) : patch<T>( p_data, l_allprototypes, l_prototypeWeights );
         
         
         // run neural gas       
         const T l_multi = 0.01/l_lambdaMPI;
-        ublas::vector<T> l_normvec( getNumberPrototypes(p_mpi), 0 );
-        ublas::vector<T> l_lambda(l_normvec.size());
-        ublas::matrix<T> l_adaptmatrix( l_normvec.size(), l_data.size1() );
+        ublas::matrix<T> l_prototypes;
+        ublas::matrix<T> l_buffer;
+        std::vector<MPI_Request> l_request;
+        initializeReduction( p_mpi, l_prototypes, l_buffer, l_request );
+        
+        ublas::vector<T> l_lambda(l_prototypes.size1());
+        ublas::matrix<T> l_adaptmatrix( l_prototypes.size1(), l_patch.size1() );
         
         for(std::size_t i=0; (i < l_iterationsMPI); ++i) {
             
@@ -1020,54 +1106,11 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             for(std::size_t n=0; n < l_lambda.size(); ++n)
                 l_lambda(n) = std::exp( -static_cast<T>(n) / l_lambdahelp );
 
-            
-            // we get all prototypes of every process
-            ublas::matrix<T> l_prototypes = gatherAllPrototypes( p_mpi );
-            
-            
-            // determine quantization error for logging
-            if (m_logging) {
-                m_logprototypes.push_back( m_prototypes );
-                m_quantizationerror.push_back( calculateQuantizationError(l_data, m_prototypes) );
-            }
-            
-            
-            // calculate for every prototype the distance
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < l_prototypes.size1(); ++n)
-                ublas::row(l_adaptmatrix, n)  = m_distance.getDistance( l_data, ublas::row(l_prototypes, n) ) ;
-            
-            
-            // for every column ranks values and create adapts
-            // we need rank and not randIndex, because we 
-            // use the value of the ranking for getting the 
-            // adapt value
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < l_adaptmatrix.size2(); ++n) {
-                ublas::vector<T> l_column                = ublas::column(l_adaptmatrix, n);
-                const ublas::vector<std::size_t> l_rank  = tools::vector::rank(l_column);
-                
-                for(std::size_t j=0; j < l_rank.size(); ++j)
-                    l_adaptmatrix(j,n) = l_lambda(l_rank(j));
-            }
-            
-            
-            // add multiplier
-            #pragma omp parallel for shared(l_adaptmatrix)
-            for(std::size_t n=0; n < l_adaptmatrix.size1(); ++n)
-                ublas::row(l_adaptmatrix, n) = ublas::element_prod( ublas::row(l_adaptmatrix, n), l_multiplier );
-            
-            // create local prototypes
-            l_prototypes = ublas::prod( l_adaptmatrix, l_data );
-            
-            
-            // normalize prototypes and sync them on each process
-            #pragma omp parallel for shared(l_normvec)
-            for(std::size_t n=0; n < l_prototypes.size1(); ++n)
-                l_normvec(n) = ublas::sum( ublas::row(l_adaptmatrix, n) );
-            synchronizePrototypes(p_mpi, l_prototypes, l_normvec);
+            adapt( p_mpi, l_patch, l_lambda, l_adaptmatrix, l_prototypes, l_buffer, l_request );
         }
         
+        finalizeReduction( p_mpi, l_prototypes, l_buffer, l_request );
+        
         // determine size of receptive fields, but we use only the data points
         const ublas::indirect_array<> l_winner = use(p_mpi, p_data);
 		for(std::size_t i=0; i < l_winner.size(); ++i)
@@ -0,0 +1,568 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+#ifndef __MACHINELEARNING_CLUSTERING_NONSUPERVISED_NYSTROEM_NEURALGAS_HPP
+#define __MACHINELEARNING_CLUSTERING_NONSUPERVISED_NYSTROEM_NEURALGAS_HPP
+
+#include <omp.h>
+
+#include <vector>
+#include <algorithm>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_sparse.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+#include "clustering.hpp"
+#include "../../errorhandling/exception.hpp"
+#include "../../tools/tools.h"
+#include "../../distances/distances.h"
+
+
+
+namespace machinelearning { namespace clustering { namespace nonsupervised {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class for calculate (batch) relational neural gas with a Nystroem approximation
+     * of the dissimilarity matrix. The algorithm uses only m landmark columns C (N x m) of the
+     * dissimilarity matrix D and approximates D ~ C * W^+ * C^t (W = landmark rows of C), so
+     * the distance calculation needs O(P*N*m) instead of O(P*N^2) and the full matrix must not
+     * be stored. The columns are read from the matrix or requested through a dissimilarity
+     * callback object. Optional the prototype coefficient vectors can be sparse, so only the
+     * k largest entries of each prototype row are used and stored in a compressed matrix
+     **/
+    template<typename T> class nystroem_neuralgas : public clustering<T>
+    {
+        
+        public:
+        
+            nystroem_neuralgas( const std::size_t&, const std::size_t&, const std::size_t&, const std::size_t& = 0 );
+            void train( const ublas::matrix<T>&, const std::size_t& );
+            void train( const ublas::matrix<T>&, const std::size_t&, const T& );
+            void train( const distances::dissimilarity<T>&, const std::size_t& );
+            void train( const distances::dissimilarity<T>&, const std::size_t&, const T& );
+            ublas::matrix<T> getPrototypes( void ) const;
+            void setLogging( const bool& );
+            std::vector< ublas::matrix<T> > getLoggedPrototypes( void ) const;
+            bool getLogging( void ) const;
+            std::size_t getPrototypeSize( void ) const;
+            std::size_t getPrototypeCount( void ) const;
+            std::vector<T> getLoggedQuantizationError( void ) const;
+            ublas::indirect_array<> use( const ublas::matrix<T>& ) const;
+            ublas::indirect_array<> getLandmarks( void ) const;
+        
+        
+        private:
+        
+            /** prototypes (only used on dense prototypes) **/
+            ublas::matrix<T> m_prototypes;
+            /** prototypes with the non-zero coefficients (only used on sparse prototypes) **/
+            ublas::compressed_matrix<T> m_sparseprototypes;
+            /** number of landmark columns **/
+            const std::size_t m_landmarknumber;
+            /** number of non-zero entries of each prototype (zero for dense prototypes) **/
+            const std::size_t m_sparse;
+            /** indices of the landmark columns **/
+            ublas::indirect_array<> m_landmarks;
+            /** self-distance value 0.5 * alpha_i^t * D * alpha_i of each prototype **/
+            ublas::vector<T> m_selfdistance;
+            /** bool for logging prototypes **/
+            bool m_logging;
+            /** std::vector for prototypes for each iteration **/
+            std::vector< ublas::matrix<T> > m_logprototypes;
+            /** std::vector for quantisation error in each iteration **/
+            std::vector<T> m_quantizationerror;
+        
+            void createLandmarks( void );
+            void checkParameter( const std::size_t&, const std::size_t&, const T& ) const;
+            void run( const ublas::matrix<T>&, const std::size_t&, const T& );
+            ublas::matrix<T> getPseudoInverse( const ublas::matrix<T>& ) const;
+            ublas::matrix<T> getCoefficientProduct( const ublas::matrix<T>& ) const;
+            ublas::matrix<T> calcDistance( const ublas::matrix<T>&, const ublas::matrix<T>& );
+            void setPrototypes( const ublas::matrix<T>& );
+            T calculateQuantizationError( const ublas::matrix<T>& ) const;
+        
+    };
+
+    
+    /** contructor for initialization the neural gas
+     * @param p_prototypes number of prototypes
+     * @param p_prototypesize size of each prototype (number of objects / size of the dissimilarity matrix)
+     * @param p_landmarks number of landmark columns
+     * @param p_sparse number of non-zero coefficients of each prototype (zero for dense prototypes)
+     **/
+    template<typename T> inline nystroem_neuralgas<T>::nystroem_neuralgas( const std::size_t& p_prototypes, const std::size_t& p_prototypesize, const std::size_t& p_landmarks, const std::size_t& p_sparse ) :
+        m_prototypes(),
+        m_sparseprototypes(),
+        m_landmarknumber( p_landmarks ),
+        m_sparse( p_sparse ),
+        m_landmarks(),
+        m_selfdistance( p_prototypes, 0 ),
+        m_logging( false ),
+        m_logprototypes( std::vector< ublas::matrix<T> >() ),
+        m_quantizationerror( std::vector<T>() )
+    {
+        if (p_prototypesize == 0)
+            throw exception::runtime(_("prototype size must be greater than zero"), *this);
+        if (p_landmarks == 0)
+            throw exception::runtime(_("number of landmarks must be greater than zero"), *this);
+        if (p_landmarks > p_prototypesize)
+            throw exception::runtime(_("number of landmarks must be less or equal than the prototype size"), *this);
+        
+        // normalize the prototypes (and reduce them to the sparse structure)
+        setPrototypes( tools::matrix::random<T>(p_prototypes, p_prototypesize) );
+        
+        createLandmarks();
+    }   
+    
+    
+    /** creates the landmark indices with a random permutation (without repetition)
+     * of the object indices
+     **/
+    template<typename T> inline void nystroem_neuralgas<T>::createLandmarks( void )
+    {
+        std::vector<std::size_t> l_index( getPrototypeSize() );
+        for(std::size_t i=0; i < l_index.size(); ++i)
+            l_index[i] = i;
+        
+        // partial Fisher-Yates shuffle, only the first m elements are needed
+        tools::random l_rand;
+        for(std::size_t i=0; i < m_landmarknumber; ++i) {
+            const std::size_t l_swap = std::min( l_index.size()-1, i + static_cast<std::size_t>(l_rand.get<T>(tools::random::uniform, 0, static_cast<T>(l_index.size()-i))) );
+            std::swap( l_index[i], l_index[l_swap] );
+        }
+        
+        // sorting the landmarks for linear memory access on reading the columns
+        std::sort( l_index.begin(), l_index.begin()+m_landmarknumber );
+        
+        m_landmarks = ublas::indirect_array<>( m_landmarknumber );
+        for(std::size_t i=0; i < m_landmarknumber; ++i)
+            m_landmarks[i] = l_index[i];
+    }
+    
+    
+    /** returns the prototype matrix
+     * @return matrix (rows = number of prototypes)
+     **/
+    template<typename T> inline ublas::matrix<T> nystroem_neuralgas<T>::getPrototypes( void ) const
+    {
+        if (m_sparse == 0)
+            return m_prototypes;
+        
+        return ublas::matrix<T>( m_sparseprototypes );
+    }
+    
+    
+    /** returns the indices of the landmark columns
+     * @return index array
+     **/
+    template<typename T> inline ublas::indirect_array<> nystroem_neuralgas<T>::getLandmarks( void ) const
+    {
+        return m_landmarks;
+    }
+    
+    
+    /** enabled logging for training
+     * @param p_log bool
+     **/
+    template<typename T> inline void nystroem_neuralgas<T>::setLogging( const bool& p_log )
+    {
+        m_logging = p_log;
+        m_logprototypes.clear();
+        m_quantizationerror.clear();
+    }
+    
+    
+    /** shows the logging status
+     * @return bool
+     **/
+    template<typename T> inline bool nystroem_neuralgas<T>::getLogging( void ) const
+    {
+        return m_logging && (m_logprototypes.size() > 0);
+    }
+    
+    
+    /** returns every prototype step during training
+     * @return std::vector with prototype matrix
+     **/
+    template<typename T> inline std::vector< ublas::matrix<T> > nystroem_neuralgas<T>::getLoggedPrototypes( void ) const
+    {
+        return m_logprototypes;
+    }
+    
+    
+    /** returns the dimension of prototypes
+     * @return dimension of the prototypes
+     **/
+    template<typename T> inline std::size_t nystroem_neuralgas<T>::getPrototypeSize( void ) const 
+    {
+        return (m_sparse == 0) ? m_prototypes.size2() : m_sparseprototypes.size2();
+    }
+    
+    
+    /** returns the number of prototypes
+     * @return number of the prototypes / classes
+     **/
+    template<typename T> inline std::size_t nystroem_neuralgas<T>::getPrototypeCount( void ) const 
+    {
+        return (m_sparse == 0) ? m_prototypes.size1() : m_sparseprototypes.size1();
+    }
+    
+    
+    /** returns the quantisation error 
+     * @return error for each iteration
+     **/
+    template<typename T> inline std::vector<T> nystroem_neuralgas<T>::getLoggedQuantizationError( void ) const
+    {
+        return m_quantizationerror;
+    }    
+    
+    
+    /** checks the training parameter
+     * @param p_size number of objects
+     * @param p_iterations number of iterations
+     * @param p_lambda max adapt size
+     **/
+    template<typename T> inline void nystroem_neuralgas<T>::checkParameter( const std::size_t& p_size, const std::size_t& p_iterations, const T& p_lambda ) const
+    {
+        if (getPrototypeCount() == 0)
+            throw exception::runtime(_("number of prototypes must be greater than zero"), *this);
+        if (p_size < getPrototypeCount())
+            throw exception::runtime(_("number of datapoints are less than prototypes"), *this);
+        if (p_iterations == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        if (p_size != getPrototypeSize())
+            throw exception::runtime(_("data and prototype dimension are not equal"), *this);
+        if (p_lambda <= 0)
+            throw exception::runtime(_("lambda must be greater than zero"), *this);
+    }
+    
+    
+    /** train the prototypes
+     * @param p_data dissimilarity matrix
+     * @param p_iterations number of iterations
+     **/
+    template<typename T> inline void nystroem_neuralgas<T>::train( const ublas::matrix<T>& p_data, const std::size_t& p_iterations )
+    {
+        train(p_data, p_iterations, getPrototypeCount() * 0.5);
+    }
+    
+    
+    /** training the prototypes, only the landmark columns of the matrix are used
+     * @param p_data dissimilarity matrix
+     * @param p_iterations iterations
+     * @param p_lambda max adapet size
+     **/
+    template<typename T> inline void nystroem_neuralgas<T>::train( const ublas::matrix<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
+    {
+        if (p_data.size1() != p_data.size2())
+            throw exception::runtime(_("matrix must be square"), *this);
+        checkParameter(p_data.size1(), p_iterations, p_lambda);
+        
+        ublas::matrix<T> l_columns( p_data.size1(), m_landmarks.size() );
+        
+        #pragma omp parallel for shared(l_columns)
+        for(std::size_t i=0; i < m_landmarks.size(); ++i)
+            ublas::column(l_columns, i) = ublas::column(p_data, m_landmarks[i]);
+        
+        run( l_columns, p_iterations, p_lambda );
+    }
+    
+    
+    /** train the prototypes
+     * @param p_data dissimilarity callback object
+     * @param p_iterations number of iterations
+     **/
+    template<typename T> inline void nystroem_neuralgas<T>::train( const distances::dissimilarity<T>& p_data, const std::size_t& p_iterations )
+    {
+        train(p_data, p_iterations, getPrototypeCount() * 0.5);
+    }
+    
+    
+    /** training the prototypes, only the landmark columns are requested from the callback
+     * @note the callback is called in parallel, so it must be thread-safe
+     * @param p_data dissimilarity callback object
+     * @param p_iterations iterations
+     * @param p_lambda max adapet size
+     **/
+    template<typename T> inline void nystroem_neuralgas<T>::train( const distances::dissimilarity<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
+    {
+        checkParameter(p_data.size(), p_iterations, p_lambda);
+        
+        // exceptions must not leave the parallel region, so we check the column size after reading
+        ublas::matrix<T> l_columns( p_data.size(), m_landmarks.size() );
+        bool l_sizeerror = false;
+        
+        #pragma omp parallel for shared(l_columns, l_sizeerror)
+        for(std::size_t i=0; i < m_landmarks.size(); ++i) {
+            const ublas::vector<T> l_column = p_data.getColumn( m_landmarks[i] );
+            
+            if (l_column.size() != l_columns.size1())
+                l_sizeerror = true;
+            else
+                ublas::column(l_columns, i) = l_column;
+        }
+        
+        if (l_sizeerror)
+            throw exception::runtime(_("column size and number of objects are not equal"), *this);
+        
+        run( l_columns, p_iterations, p_lambda );
+    }
+    
+    
+    /** runs the neural gas iterations on the landmark columns
+     * @param p_columns landmark columns of the dissimilarity matrix (N x m)
+     * @param p_iterations iterations
+     * @param p_lambda max adapt size
+     **/
+    template<typename T> inline void nystroem_neuralgas<T>::run( const ublas::matrix<T>& p_columns, const std::size_t& p_iterations, const T& p_lambda )
+    {
+        // creates logging
+        if (m_logging) {
+            m_logprototypes.clear();
+            m_quantizationerror.clear();
+            m_logprototypes.reserve(p_iterations);
+            m_quantizationerror.reserve(p_iterations);
+        }
+        
+        // the landmark rows of the columns are the (m x m) matrix W, which is inverted once
+        ublas::matrix<T> l_landmark( m_landmarks.size(), m_landmarks.size() );
+        for(std::size_t i=0; i < m_landmarks.size(); ++i)
+            ublas::row(l_landmark, i) = ublas::row(p_columns, m_landmarks[i]);
+        const ublas::matrix<T> l_inverse = getPseudoInverse( l_landmark );
+        
+        
+        // run neural gas       
+        const T l_multi = 0.01/p_lambda;
+        ublas::vector<T> l_lambda(getPrototypeCount());
+        
+        for(std::size_t i=0; i < p_iterations; ++i) {
+            
+            // create adapt values
+            const T l_lambdahelp = p_lambda * std::pow(l_multi, static_cast<T>(i)/static_cast<T>(p_iterations));
+            
+            #pragma omp parallel for shared(l_lambda)
+            for(std::size_t n=0; n < l_lambda.size(); ++n)
+                l_lambda(n) = std::exp( -static_cast<T>(n) / l_lambdahelp );
+            
+            // create adapt values
+            ublas::matrix<T> l_adaptmatrix = calcDistance( p_columns, l_inverse );
+            
+            
+            // determine quantization error for logging (adaption matrix)
+            if (m_logging) {
+                m_quantizationerror.push_back( calculateQuantizationError(l_adaptmatrix) );
+                m_logprototypes.push_back( getPrototypes() );
+            }
+            
+            
+            // for every column ranks values and create adapts
+            // we need rank and not randIndex, because we 
+            // use the value of the ranking for calculate the 
+            // adapt value
+            #pragma omp parallel for shared(l_adaptmatrix)
+            for(std::size_t n=0; n < l_adaptmatrix.size2(); ++n) {
+                ublas::vector<T> l_column                = ublas::column(l_adaptmatrix, n);
+                const ublas::vector<std::size_t> l_rank  = tools::vector::rank(l_column);
+                
+                for(std::size_t j=0; j < l_rank.size(); ++j)
+                    l_adaptmatrix(j,n) = l_lambda(l_rank(j));
+            }
+            
+            
+            // adapt values are the new prototypes (and run normalization)
+            setPrototypes( l_adaptmatrix );
+        }
+        
+        // the self-distance values must be fit to the latest prototypes for the use call
+        calcDistance( p_columns, l_inverse );
+    }
+    
+    
+    /** calculates the Moore-Penrose pseudo-inverse of the landmark matrix with a SVD, singular
+     * values that are numerical zero are ignored, because the dissimilarity matrix need not be regular
+     * @param p_matrix landmark matrix W
+     * @return pseudo-inverse matrix
+     **/
+    template<typename T> inline ublas::matrix<T> nystroem_neuralgas<T>::getPseudoInverse( const ublas::matrix<T>& p_matrix ) const
+    {
+        ublas::vector<T> l_svdval;
+        ublas::matrix<T> l_svdvec1;
+        ublas::matrix<T> l_svdvec2;
+        tools::lapack::svd( p_matrix, l_svdval, l_svdvec1, l_svdvec2, false );
+        
+        // W = U * S * V^t => W^+ = V * S^+ * U^t
+        const T l_tolerance = static_cast<T>(p_matrix.size1()) * std::numeric_limits<T>::epsilon() * tools::vector::max(l_svdval);
+        ublas::matrix<T> l_inverse( p_matrix.size2(), p_matrix.size1(), 0 );
+        
+        for(std::size_t n=0; n < l_svdval.size(); ++n) {
+            if (l_svdval(n) <= l_tolerance)
+                continue;
+            
+            l_inverse += ublas::outer_prod( ublas::column(l_svdvec2, n), ublas::column(l_svdvec1, n) ) / l_svdval(n);
+        }
+        
+        return l_inverse;
+    }
+    
+    
+    /** calculates the product of the prototype coefficients and a matrix with one row
+     * for each object (alpha * C), on sparse prototypes only the non-zero coefficients of
+     * the compressed rows are used
+     * @param p_matrix matrix (number of objects x any size)
+     * @return matrix (number of prototypes x number of matrix columns)
+     **/
+    template<typename T> inline ublas::matrix<T> nystroem_neuralgas<T>::getCoefficientProduct( const ublas::matrix<T>& p_matrix ) const
+    {
+        if (m_sparse == 0)
+            return ublas::prod( m_prototypes, p_matrix );
+        
+        ublas::matrix<T> l_product( m_sparseprototypes.size1(), p_matrix.size2(), 0 );
+        
+        #pragma omp parallel for shared(l_product)
+        for(std::size_t n=0; n < m_sparseprototypes.size1(); ++n)
+            for(std::size_t j=m_sparseprototypes.index1_data()[n]; j < m_sparseprototypes.index1_data()[n+1]; ++j)
+                ublas::row(l_product, n) += m_sparseprototypes.value_data()[j] * ublas::row(p_matrix, m_sparseprototypes.index2_data()[j]);
+        
+        return l_product;
+    }
+    
+    
+    /** calculates the distance values between neurons and data with the Nystroem approximation.
+     * relational: (D * alpha_i)_j - 0.5 * alpha_i^t * D * alpha_i = || x^j - w^i || with D ~ C * W^+ * C^t,
+     * so we calculate B = (alpha * C) * W^+ and get D * alpha_i = C * B_i and alpha_i^t * D * alpha_i = B_i * (alpha_i * C)
+     * @param p_columns landmark columns of the dissimilarity matrix (N x m)
+     * @param p_inverse pseudo-inverse of the landmark matrix (m x m)
+     * @return matrix with distance values (number of prototypes X number of objects)
+     **/
+    template<typename T> inline ublas::matrix<T> nystroem_neuralgas<T>::calcDistance( const ublas::matrix<T>& p_columns, const ublas::matrix<T>& p_inverse )
+    {
+        const ublas::matrix<T> l_product   = getCoefficientProduct( p_columns );
+        const ublas::matrix<T> l_weight    = ublas::prod( l_product, p_inverse );
+        ublas::matrix<T> l_adaptmatrix     = ublas::prod( l_weight, ublas::trans(p_columns) );
+        
+        #pragma omp parallel for shared(l_adaptmatrix)
+        for(std::size_t n=0; n < l_adaptmatrix.size1(); ++n) {
+            m_selfdistance(n) = 0.5 * ublas::inner_prod( ublas::row(l_weight, n), ublas::row(l_product, n) );
+            
+            for(std::size_t j=0; j < l_adaptmatrix.size2(); ++j)
+                l_adaptmatrix(n, j) -= m_selfdistance(n);
+        }
+        
+        return l_adaptmatrix;
+    }
+    
+    
+    /** sets the prototypes and normalizes each row, on sparse prototypes each row
+     * is reduced to the k largest coefficients, which are stored in the compressed matrix
+     * @param p_prototypes prototype matrix (rows = number of prototypes)
+     **/
+    template<typename T> inline void nystroem_neuralgas<T>::setPrototypes( const ublas::matrix<T>& p_prototypes )
+    {
+        if (m_sparse == 0) {
+            m_prototypes = p_prototypes;
+            
+            #pragma omp parallel for
+            for(std::size_t n=0; n < m_prototypes.size1(); ++n) {
+                const T l_sum = ublas::sum( ublas::row( m_prototypes, n) );
+                
+                if (!tools::function::isNumericalZero(l_sum))
+                    ublas::row( m_prototypes, n ) /= l_sum;
+            }
+            return;
+        }
+        
+        // determine the k largest values of each row with a partial ordering of the (value, index) pairs,
+        // the compressed matrix must be filled row by row, so the rows are created first
+        const std::size_t l_count = std::min( m_sparse, p_prototypes.size2() );
+        std::vector< std::vector< std::pair<std::size_t, T> > > l_rows( p_prototypes.size1() );
+        
+        #pragma omp parallel for shared(l_rows)
+        for(std::size_t n=0; n < p_prototypes.size1(); ++n) {
+            std::vector< std::pair<T, std::size_t> > l_value( p_prototypes.size2() );
+            for(std::size_t j=0; j < l_value.size(); ++j)
+                l_value[j] = std::pair<T, std::size_t>( -p_prototypes(n, j), j );
+            std::nth_element( l_value.begin(), l_value.begin()+(l_count-1), l_value.end() );
+            
+            T l_sum = 0;
+            l_rows[n].resize( l_count );
+            for(std::size_t j=0; j < l_count; ++j) {
+                l_rows[n][j] = std::pair<std::size_t, T>( l_value[j].second, -l_value[j].first );
+                l_sum       += l_rows[n][j].second;
+            }
+            std::sort( l_rows[n].begin(), l_rows[n].end() );
+            
+            if (!tools::function::isNumericalZero(l_sum))
+                for(std::size_t j=0; j < l_count; ++j)
+                    l_rows[n][j].second /= l_sum;
+        }
+        
+        m_sparseprototypes = ublas::compressed_matrix<T>( p_prototypes.size1(), p_prototypes.size2(), p_prototypes.size1() * l_count );
+        for(std::size_t n=0; n < l_rows.size(); ++n)
+            for(std::size_t j=0; j < l_rows[n].size(); ++j)
+                m_sparseprototypes.push_back( n, l_rows[n][j].first, l_rows[n][j].second );
+        m_sparseprototypes.complete_index1_data();
+    }
+    
+    
+    /** calculate the quantization error
+     * @param p_distance distance matrix (adaption matrix)
+     * @return quantization error
+     **/    
+    template<typename T> inline T nystroem_neuralgas<T>::calculateQuantizationError( const ublas::matrix<T>& p_distance ) const
+    {
+        return 0.5 * ublas::sum( tools::matrix::min( p_distance, tools::matrix::column ) );
+    }
+    
+    
+    /** calulates distance between datapoints and prototypes and returns a indirect array
+     * with index of the nearest prototype
+     * @param p_data matrix with dissimilarities of each datapoint (row) to all trained objects
+     * @return index array of prototype indices
+     **/
+    template<typename T> inline ublas::indirect_array<> nystroem_neuralgas<T>::use( const ublas::matrix<T>& p_data ) const
+    {
+        if (getPrototypeCount() == 0)
+            throw exception::runtime(_("number of prototypes must be greater than zero"), *this);
+        if (p_data.size2() != getPrototypeSize())
+            throw exception::runtime(_("data and prototype dimension are not equal"), *this);
+        
+        ublas::indirect_array<> l_idx(p_data.size1());
+        ublas::matrix<T> l_distance = ublas::trans( getCoefficientProduct( ublas::matrix<T>(ublas::trans(p_data)) ) );
+        
+        #pragma omp parallel for shared(l_idx, l_distance)
+        for(std::size_t i=0; i < l_distance.size1(); ++i) {
+            ublas::vector<T> l_col                = ublas::row(l_distance, i) - m_selfdistance;
+            const ublas::indirect_array<> l_rank  = tools::vector::rankIndex( l_col );
+            l_idx[i] = l_rank(0);
+        }
+        
+        return l_idx;
+    }
+    
+}}}
+#endif
@@ -0,0 +1,219 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#ifndef __MACHINELEARNING_CLUSTERING_NONSUPERVISED_PATCH_HPP
+#define __MACHINELEARNING_CLUSTERING_NONSUPERVISED_PATCH_HPP
+
+#include <omp.h>
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
+
+#include "../../errorhandling/exception.hpp"
+#include "../../tools/language/language.h"
+
+
+namespace machinelearning { namespace clustering { namespace nonsupervised {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class of a weighted data patch, that is used by the patch clustering. The rows of the patch are
+     * the datapoints (weight one) followed by the prototypes of the previous patch (weighted with the
+     * size of their receptive fields). The patch holds only references of the data, the prototypes
+     * and the weights, so the rows are concatenated without copying
+     * @note the referenced objects must exist and must not be changed while the patch is used
+     **/
+    template<typename T> class patch
+    {
+        #ifndef SWIG
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        #endif
+        
+        public :
+        
+            patch( const ublas::matrix<T>& );
+            patch( const ublas::matrix<T>&, const ublas::matrix<T>&, const ublas::vector<T>& );
+            std::size_t size1( void ) const;
+            std::size_t size2( void ) const;
+            bool hasPrototypes( void ) const;
+            const ublas::matrix<T>& getData( void ) const;
+            ublas::matrix_row< const ublas::matrix<T> > getRow( const std::size_t& ) const;
+            template<typename D> ublas::vector<T> getDistance( const D&, const ublas::vector<T>& ) const;
+            void weight( ublas::matrix<T>& ) const;
+            ublas::matrix<T> prod( const ublas::matrix<T>& ) const;
+        
+        
+        private :
+        
+            /** datapoints **/
+            const ublas::matrix<T>& m_data;
+            /** prototypes of the previous patch (null pointer if there are no prototypes) **/
+            const ublas::matrix<T>* const m_prototypes;
+            /** weights of the prototypes (null pointer if there are no prototypes) **/
+            const ublas::vector<T>* const m_weights;
+        
+            patch& operator=( const patch& );
+        
+    };
+    
+    
+    
+    /** constructor of a patch without prototypes
+     * @param p_data datapoints
+     **/
+    template<typename T> inline patch<T>::patch( const ublas::matrix<T>& p_data ) :
+        m_data( p_data ),
+        m_prototypes( NULL ),
+        m_weights( NULL )
+    {}
+    
+    
+    /** constructor of a patch with datapoints and weighted prototypes
+     * @param p_data datapoints
+     * @param p_prototypes prototypes of the previous patch
+     * @param p_weights weights of the prototypes
+     **/
+    template<typename T> inline patch<T>::patch( const ublas::matrix<T>& p_data, const ublas::matrix<T>& p_prototypes, const ublas::vector<T>& p_weights ) :
+        m_data( p_data ),
+        m_prototypes( &p_prototypes ),
+        m_weights( &p_weights )
+    {
+        if (p_data.size2() != p_prototypes.size2())
+            throw exception::runtime(_("data and prototype dimension are not equal"), *this);
+        if (p_prototypes.size1() != p_weights.size())
+            throw exception::runtime(_("number of prototypes and weights are not equal"), *this);
+    }
+    
+    
+    /** returns the number of rows (datapoints and prototypes)
+     * @return number of rows
+     **/
+    template<typename T> inline std::size_t patch<T>::size1( void ) const
+    {
+        return m_prototypes ? m_data.size1() + m_prototypes->size1() : m_data.size1();
+    }
+    
+    
+    /** returns the dimension of the rows
+     * @return dimension
+     **/
+    template<typename T> inline std::size_t patch<T>::size2( void ) const
+    {
+        return m_data.size2();
+    }
+    
+    
+    /** returns the flag, that the patch holds prototypes
+     * @return bool
+     **/
+    template<typename T> inline bool patch<T>::hasPrototypes( void ) const
+    {
+        return m_prototypes != NULL;
+    }
+    
+    
+    /** returns the datapoints (without the prototypes)
+     * @return data matrix
+     **/
+    template<typename T> inline const ublas::matrix<T>& patch<T>::getData( void ) const
+    {
+        return m_data;
+    }
+    
+    
+    /** returns a row of the patch
+     * @param p_index row index
+     * @return row of the datapoints or of the prototypes
+     **/
+    template<typename T> inline ublas::matrix_row< const ublas::matrix<T> > patch<T>::getRow( const std::size_t& p_index ) const
+    {
+        if (p_index < m_data.size1())
+            return ublas::row( m_data, p_index );
+        
+        return ublas::row( *m_prototypes, p_index - m_data.size1() );
+    }
+    
+    
+    /** calculates the distances of a vector to all rows of the patch
+     * @param p_distance distance object
+     * @param p_vec vector
+     * @return distance vector (one value for each row)
+     **/
+    template<typename T> template<typename D> inline ublas::vector<T> patch<T>::getDistance( const D& p_distance, const ublas::vector<T>& p_vec ) const
+    {
+        if (!m_prototypes)
+            return p_distance.getDistance( m_data, p_vec );
+        
+        ublas::vector<T> l_distance( size1() );
+        ublas::subrange( l_distance, 0, m_data.size1() )           = p_distance.getDistance( m_data, p_vec );
+        ublas::subrange( l_distance, m_data.size1(), size1() )     = p_distance.getDistance( *m_prototypes, p_vec );
+        
+        return l_distance;
+    }
+    
+    
+    /** multiplies the columns of the prototypes with their weights (the columns of the datapoints have the weight one)
+     * @param p_matrix matrix with one column for each row of the patch
+     **/
+    template<typename T> inline void patch<T>::weight( ublas::matrix<T>& p_matrix ) const
+    {
+        if (p_matrix.size2() != size1())
+            throw exception::runtime(_("matrix columns and patch rows are not equal"), *this);
+        if (!m_prototypes)
+            return;
+        
+        #pragma omp parallel for shared(p_matrix)
+        for(std::size_t i=0; i < p_matrix.size1(); ++i)
+            for(std::size_t j=0; j < m_weights->size(); ++j)
+                p_matrix(i, m_data.size1()+j) *= (*m_weights)(j);
+    }
+    
+    
+    /** calculates the matrix product of a matrix with the rows of the patch, the product is split into
+     * the product with the datapoints and the product with the prototypes, so the patch is not copied
+     * @param p_matrix matrix with one column for each row of the patch
+     * @return product matrix
+     **/
+    template<typename T> inline ublas::matrix<T> patch<T>::prod( const ublas::matrix<T>& p_matrix ) const
+    {
+        if (p_matrix.size2() != size1())
+            throw exception::runtime(_("matrix columns and patch rows are not equal"), *this);
+        
+        if (!m_prototypes)
+            return ublas::prod( p_matrix, m_data );
+        
+        ublas::matrix<T> l_product = ublas::prod( ublas::subrange(p_matrix, 0, p_matrix.size1(), 0, m_data.size1()), m_data );
+        l_product += ublas::prod( ublas::subrange(p_matrix, 0, p_matrix.size1(), m_data.size1(), size1()), *m_prototypes );
+        
+        return l_product;
+    }
+    
+}}}
+#endif
@@ -0,0 +1,163 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#ifndef __MACHINELEARNING_CLUSTERING_NONSUPERVISED_PIPELINE_HPP
+#define __MACHINELEARNING_CLUSTERING_NONSUPERVISED_PIPELINE_HPP
+
+#include <string>
+#include <exception>
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include "clustering.hpp"
+#include "../../errorhandling/exception.hpp"
+#include "../../tools/language/language.h"
+
+
+namespace machinelearning { namespace clustering { namespace nonsupervised {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class of a patch clustering pipeline. The patches are created by a loader function, which
+     * writes the next patch into the passed matrix and returns false if there is no further patch.
+     * The loader of patch k+1 runs on its own thread while the algorithm is trained with patch k,
+     * so loading and preprocessing of the data overlaps with the training. Two patch buffers are
+     * used alternately, so a loader, that creates patches of equal size, reuses the memory
+     * @note the loader is called on a different thread than the training, so it must not use
+     * the algorithm. An exception of the loader stops the pipeline after the running training
+     **/
+    template<typename T> class pipeline
+    {
+        #ifndef SWIG
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        #endif
+        
+        public :
+        
+            #ifndef SWIG
+            pipeline( patchclustering<T>&, const boost::function<bool (ublas::matrix<T>&)>& );
+            #endif
+            std::size_t train( const std::size_t& );
+        
+        
+        private :
+        
+            /** algorithm **/
+            patchclustering<T>& m_algorithm;
+            /** loader function **/
+            const boost::function<bool (ublas::matrix<T>&)> m_loader;
+        
+            pipeline( const pipeline& );
+            pipeline& operator=( const pipeline& );
+            static void load( const boost::function<bool (ublas::matrix<T>&)>&, ublas::matrix<T>&, bool&, std::string& );
+        
+    };
+    
+    
+    
+    /** constructor
+     * @param p_algorithm patch clustering algorithm
+     * @param p_loader loader function
+     **/
+    template<typename T> inline pipeline<T>::pipeline( patchclustering<T>& p_algorithm, const boost::function<bool (ublas::matrix<T>&)>& p_loader ) :
+        m_algorithm( p_algorithm ),
+        m_loader( p_loader )
+    {
+        if (!p_loader)
+            throw exception::runtime(_("loader function must be set"), *this);
+    }
+    
+    
+    /** trains the algorithm with all patches of the loader
+     * @param p_iterations number of iterations of each patch
+     * @return number of trained patches
+     **/
+    template<typename T> inline std::size_t pipeline<T>::train( const std::size_t& p_iterations )
+    {
+        if (p_iterations == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        
+        ublas::matrix<T> l_patch[2];
+        bool l_loaded[2] = { false, false };
+        std::string l_message;
+        
+        // the first patch is loaded before the training
+        load( m_loader, l_patch[0], l_loaded[0], l_message );
+        if (!l_message.empty())
+            throw exception::runtime(l_message, *this);
+        
+        std::size_t l_count = 0;
+        for(std::size_t i=0; l_loaded[i % 2]; ++i) {
+            const std::size_t l_current = i % 2;
+            const std::size_t l_next    = (i+1) % 2;
+            
+            // load the next patch while the current patch is trained
+            boost::thread l_thread( boost::bind( &pipeline<T>::load, boost::cref(m_loader), boost::ref(l_patch[l_next]), boost::ref(l_loaded[l_next]), boost::ref(l_message) ) );
+            
+            try {
+                m_algorithm.trainpatch( l_patch[l_current], p_iterations );
+            } catch (...) {
+                l_thread.join();
+                throw;
+            }
+            l_thread.join();
+            l_count++;
+            
+            if (!l_message.empty())
+                throw exception::runtime(l_message, *this);
+        }
+        
+        return l_count;
+    }
+    
+    
+    /** thread method, that calls the loader and stores the result
+     * @param p_loader loader function
+     * @param p_patch patch buffer
+     * @param p_loaded flag, that is set to the return value of the loader
+     * @param p_message message of a loader exception
+     **/
+    template<typename T> inline void pipeline<T>::load( const boost::function<bool (ublas::matrix<T>&)>& p_loader, ublas::matrix<T>& p_patch, bool& p_loaded, std::string& p_message )
+    {
+        p_loaded = false;
+        
+        try {
+            p_loaded = p_loader( p_patch );
+        } catch (const std::exception& e) {
+            p_message = e.what();
+        } catch (...) {
+            p_message = _("patch can not be loaded");
+        }
+    }
+    
+}}}
+#endif
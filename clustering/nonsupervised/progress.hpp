@@ -0,0 +1,144 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#ifndef __MACHINELEARNING_CLUSTERING_NONSUPERVISED_PROGRESS_HPP
+#define __MACHINELEARNING_CLUSTERING_NONSUPERVISED_PROGRESS_HPP
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/atomic.hpp>
+
+
+namespace machinelearning { namespace clustering { namespace nonsupervised {
+    
+    
+    /** class for observing and cancelling a training. The algorithm calls
+     * setIteration after each iteration, which calls the update method, so
+     * a derived class (also a Java class) gets the progress of the training.
+     * The quantization error is determined from the distances of the iteration,
+     * so it describes the prototypes at the begin of the iteration. The
+     * cancellation is cooperative, the algorithm checks the flag before each
+     * iteration and stops, so the prototypes are the result of the last finished
+     * iteration. The object is bind to an algorithm with setProgress
+     * @note cancel, isCanceled and getIteration can be called from any thread,
+     * update is called by the thread that runs the training
+     **/
+    template<typename T> class progress
+    {
+        #ifndef SWIG
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        #endif
+        
+        public :
+        
+            progress( void );
+            virtual ~progress( void );
+            virtual void update( const std::size_t&, const std::size_t&, const T& );
+            void cancel( void );
+            bool isCanceled( void ) const;
+            std::size_t getIteration( void ) const;
+            void reset( void );
+        
+            // method that is called by the algorithms
+            void setIteration( const std::size_t&, const std::size_t&, const T& );
+        
+        
+        private :
+        
+            /** cancel flag **/
+            boost::atomic<bool> m_canceled;
+            /** last finished iteration **/
+            boost::atomic<std::size_t> m_iteration;
+        
+            progress( const progress& );
+            progress& operator=( const progress& );
+        
+    };
+    
+    
+    
+    /** constructor **/
+    template<typename T> inline progress<T>::progress( void ) :
+        m_canceled( false ),
+        m_iteration( 0 )
+    {}
+    
+    
+    /** destructor **/
+    template<typename T> inline progress<T>::~progress( void ) {}
+    
+    
+    /** callback after each iteration, the default implementation does nothing
+     * @param p_iteration number of finished iterations
+     * @param p_iterations number of all iterations
+     * @param p_error quantization error of the iteration
+     **/
+    template<typename T> inline void progress<T>::update( const std::size_t&, const std::size_t&, const T& ) {}
+    
+    
+    /** requests the cancellation of the training **/
+    template<typename T> inline void progress<T>::cancel( void )
+    {
+        m_canceled.store( true );
+    }
+    
+    
+    /** returns the cancel flag
+     * @return true if the training is canceled
+     **/
+    template<typename T> inline bool progress<T>::isCanceled( void ) const
+    {
+        return m_canceled.load();
+    }
+    
+    
+    /** returns the last finished iteration
+     * @return iteration
+     **/
+    template<typename T> inline std::size_t progress<T>::getIteration( void ) const
+    {
+        return m_iteration.load();
+    }
+    
+    
+    /** resets the cancel flag and the iteration, so the object can be used for a new training **/
+    template<typename T> inline void progress<T>::reset( void )
+    {
+        m_canceled.store( false );
+        m_iteration.store( 0 );
+    }
+    
+    
+    /** stores the finished iteration and calls the update method
+     * @param p_iteration number of finished iterations
+     * @param p_iterations number of all iterations
+     * @param p_error quantization error of the iteration
+     **/
+    template<typename T> inline void progress<T>::setIteration( const std::size_t& p_iteration, const std::size_t& p_iterations, const T& p_error )
+    {
+        m_iteration.store( p_iteration );
+        update( p_iteration, p_iterations, p_error );
+    }
+    
+}}}
+#endif
@@ -0,0 +1,43 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+/** interface file for the training progress, the update method can be
+ * overloaded by a Java class (director), it is called by the native thread
+ * that runs the training
+ **/
+
+
+#ifdef SWIGJAVA
+%module(directors="1") "progressmodule"
+%include "../../swig/java/java.i"
+
+%feature("director") machinelearning::clustering::nonsupervised::progress<double>;
+%typemap(directorin, descriptor="J")   const std::size_t&     "$input = static_cast<jlong>($1);"
+%typemap(javadirectorin)                const std::size_t&     "$jniinput"
+
+%ignore machinelearning::clustering::nonsupervised::progress<double>::setIteration;
+#endif
+
+
+%include "progress.hpp"
+%template(Progress) machinelearning::clustering::nonsupervised::progress<double>;
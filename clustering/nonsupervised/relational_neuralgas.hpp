@@ -30,15 +30,18 @@
 #include <numeric>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
 
 #ifdef MACHINELEARNING_MPI
 #include <boost/mpi.hpp>
 #endif
 
 #include "clustering.hpp"
+#include "progress.hpp"
 #include "../../errorhandling/exception.hpp"
 #include "../../tools/tools.h"
 #include "../../neighborhood/neighborhood.h"
+#include "../../distances/distances.h"
 
 
 
@@ -101,6 +104,10 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             //relational_neuralgas( const std::size_t&, const std::size_t&, const neighborhood::kapproximation<T>& );
             void train( const ublas::matrix<T>&, const std::size_t& );
             void train( const ublas::matrix<T>&, const std::size_t&, const T& );
+            #ifndef SWIG
+            void train( const distances::dissimilarity<T>&, const std::size_t& );
+            void train( const distances::dissimilarity<T>&, const std::size_t&, const T& );
+            #endif
             ublas::matrix<T> getPrototypes( void ) const;
             void setLogging( const bool& );
             std::vector< ublas::matrix<T> > getLoggedPrototypes( void ) const;
@@ -109,6 +116,10 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             std::size_t getPrototypeCount( void ) const;
             std::vector<T> getLoggedQuantizationError( void ) const;
             ublas::indirect_array<> use( const ublas::matrix<T>& ) const;
+            #ifndef SWIG
+            void setProgress( progress<T>& );
+            void removeProgress( void );
+            #endif
         
         
             #ifdef MACHINELEARNING_MPI
@@ -132,9 +143,17 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             std::vector< ublas::matrix<T> > m_logprototypes;
             /** std::vector for quantisation error in each iteration **/
             std::vector<T> m_quantizationerror;
+            /** optional progress object (not owned) **/
+            progress<T>* m_progress;
+        
+            /** number of columns of a dissimilarity block, that is requested on training **/
+            static const std::size_t m_blockcolumns = 256;
         
             T calculateQuantizationError( const ublas::matrix<T>& ) const;
             ublas::matrix<T> calcDistance( const ublas::matrix<T>&, const ublas::matrix<T>& ) const;
+            ublas::matrix<T> calcDistance( const ublas::matrix<T>&, const distances::dissimilarity<T>& ) const;
+            void subtractPrototypeNorm( const ublas::matrix<T>&, ublas::matrix<T>& ) const;
+            template<typename M> void run( const M&, const std::size_t&, const T& );
         
             #ifdef MACHINELEARNING_MPI
             /** vector with information to every process and width of the prototype / data matrix **/
@@ -160,7 +179,8 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         m_prototypes( tools::matrix::random<T>(p_prototypes, p_prototypesize) ),
         m_logging( false ),
         m_logprototypes( std::vector< ublas::matrix<T> >() ),
-        m_quantizationerror( std::vector<T>() )
+        m_quantizationerror( std::vector<T>() ),
+        m_progress( NULL )
         #ifdef MACHINELEARNING_MPI
         , m_processdatainfo(),
         m_processprototypinfo()
@@ -200,6 +220,23 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     }
     
     
+    /** sets a progress object, that is updated after each iteration of the following
+     * (non-MPI) train calls and that can cancel the training
+     * @param p_progress progress object, that must exist during training
+     **/
+    template<typename T> inline void relational_neuralgas<T>::setProgress( progress<T>& p_progress )
+    {
+        m_progress = &p_progress;
+    }
+    
+    
+    /** removes the progress object **/
+    template<typename T> inline void relational_neuralgas<T>::removeProgress( void )
+    {
+        m_progress = NULL;
+    }
+    
+    
     /** shows the logging status
      * @return bool
      **/
@@ -276,7 +313,51 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         if (p_data.size1() != p_data.size2())
             throw exception::runtime(_("matrix must be square"), *this);
         
+        run( p_data, p_iterations, p_lambda );
+    }
+    
+    
+    /** 
+     * train the prototypes with a dissimilarity matrix, that is not stored in memory
+     * @param p_data dissimilarity object
+     * @param p_iterations number of iterations
+     **/
+    template<typename T> inline void relational_neuralgas<T>::train( const distances::dissimilarity<T>& p_data, const std::size_t& p_iterations )
+    {
+        train(p_data, p_iterations, m_prototypes.size1() * 0.5);
+    }
+    
+    
+    /** train the prototypes with a dissimilarity matrix, that is not stored in memory. The matrix
+     * is requested in blocks of columns on each iteration, so only one block must be stored
+     * @param p_data dissimilarity object
+     * @param p_iterations iterations
+     * @param p_lambda max adapet size
+     **/
+    template<typename T> inline void relational_neuralgas<T>::train( const distances::dissimilarity<T>& p_data, const std::size_t& p_iterations, const T& p_lambda )
+    {
+        if (m_prototypes.size1() == 0)
+            throw exception::runtime(_("number of prototypes must be greater than zero"), *this);
+        if (p_data.size() < m_prototypes.size1())
+            throw exception::runtime(_("number of datapoints are less than prototypes"), *this);
+        if (p_iterations == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        if (p_data.size() != m_prototypes.size2())
+            throw exception::runtime(_("data and prototype dimension are not equal"), *this);
+        if (p_lambda <= 0)
+            throw exception::runtime(_("lambda must be greater than zero"), *this);
         
+        run( p_data, p_iterations, p_lambda );
+    }
+    
+    
+    /** runs the training iterations
+     * @param p_data dissimilarity matrix or dissimilarity object
+     * @param p_iterations iterations
+     * @param p_lambda max adapet size
+     **/
+    template<typename T> template<typename M> inline void relational_neuralgas<T>::run( const M& p_data, const std::size_t& p_iterations, const T& p_lambda )
+    {
         // creates logging
         if (m_logging) {
             m_logprototypes.clear();
@@ -291,7 +372,7 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         const T l_multi = 0.01/p_lambda;
         ublas::vector<T> l_lambda(m_prototypes.size1());
         
-        for(std::size_t i=0; i < p_iterations; ++i) {
+        for(std::size_t i=0; (i < p_iterations) && !(m_progress && m_progress->isCanceled()); ++i) {
             
             // create adapt values
             const T l_lambdahelp = p_lambda * std::pow(l_multi, static_cast<T>(i)/static_cast<T>(p_iterations));
@@ -305,8 +386,9 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
 
             
             // determine quantization error for logging (adaption matrix)
+            const T l_error = (m_logging || m_progress) ? calculateQuantizationError(l_adaptmatrix) : static_cast<T>(0);
             if (m_logging) {
-                m_quantizationerror.push_back( calculateQuantizationError(l_adaptmatrix) );
+                m_quantizationerror.push_back( l_error );
                 m_logprototypes.push_back( m_prototypes );
             }
             
@@ -334,6 +416,9 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
                 if (!tools::function::isNumericalZero(l_sum))
                     ublas::row( m_prototypes, n ) /= l_sum;
             }
+            
+            if (m_progress)
+                m_progress->setIteration( i+1, p_iterations, l_error );
         }
     }
     
@@ -386,18 +471,47 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         // relational: (D * alpha_i)_j - 0.5 * alpha_i^t * D * alpha_i = || x^j - w^i || 
         // D = distance, alpha = weight of the prototype for the convex combination
         ublas::matrix<T> l_adaptmatrix = ublas::prod(p_prototypes, p_data);
-       
-        #pragma omp parallel for shared(l_adaptmatrix)
-        for(std::size_t n=0; n < l_adaptmatrix.size1(); ++n) {
-            const T l_val = 0.5 * ublas::inner_prod( ublas::row(p_prototypes, n), ublas::row(l_adaptmatrix, n) );
-            
-            for(std::size_t j=0; j < l_adaptmatrix.size2(); ++j)
-                l_adaptmatrix(n, j) -= l_val;
-        }        
+        subtractPrototypeNorm( p_prototypes, l_adaptmatrix );
     
         return l_adaptmatrix;
     }
     
+    
+    /** calculates the distance values between neurons and data, the product of the prototypes
+     * and the dissimilarity matrix is calculated on blocks of columns
+     * @param p_prototypes prototype matrix
+     * @param p_data dissimilarity object
+     * @return matrix with distance values (number of prototypes X data dimension)
+     **/
+    template<typename T> inline ublas::matrix<T> relational_neuralgas<T>::calcDistance( const ublas::matrix<T>& p_prototypes, const distances::dissimilarity<T>& p_data ) const
+    {
+        ublas::matrix<T> l_adaptmatrix( p_prototypes.size1(), p_data.size() );
+        
+        for(std::size_t i=0; i < p_data.size(); i += m_blockcolumns) {
+            const std::size_t l_end = std::min( i + m_blockcolumns, p_data.size() );
+            ublas::subrange( l_adaptmatrix, 0, l_adaptmatrix.size1(), i, l_end ) = ublas::prod( p_prototypes, p_data.getBlock(0, p_data.size(), i, l_end) );
+        }
+        subtractPrototypeNorm( p_prototypes, l_adaptmatrix );
+        
+        return l_adaptmatrix;
+    }
+    
+    
+    /** subtracts the norm of each prototype of its row of the product (prototypes x dissimilarity matrix)
+     * @param p_prototypes prototype matrix
+     * @param p_product product matrix
+     **/
+    template<typename T> inline void relational_neuralgas<T>::subtractPrototypeNorm( const ublas::matrix<T>& p_prototypes, ublas::matrix<T>& p_product ) const
+    {
+        #pragma omp parallel for shared(p_product)
+        for(std::size_t n=0; n < p_product.size1(); ++n) {
+            const T l_val = 0.5 * ublas::inner_prod( ublas::row(p_prototypes, n), ublas::row(p_product, n) );
+            
+            for(std::size_t j=0; j < p_product.size2(); ++j)
+                p_product(n, j) -= l_val;
+        }
+    }
+    
     //======= MPI ==================================================================================================================================
     #ifdef MACHINELEARNING_MPI
     
@@ -26,9 +26,16 @@
 
 #include <omp.h>
 
+#include <cmath>
+#include <limits>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/bindings/blas.hpp>
+#ifdef MACHINELEARNING_MPI
+#include <vector>
+#include <boost/mpi.hpp>
+#include <boost/serialization/vector.hpp>
+#endif
 
 #include "clustering.hpp"
 #include "kmeans.hpp"
@@ -42,16 +49,26 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
     #ifndef SWIG
     namespace ublas = boost::numeric::ublas;
     namespace blas  = boost::numeric::bindings::blas;
+    #ifdef MACHINELEARNING_MPI
+    namespace mpi   = boost::mpi;
+    #endif
     #endif
     
     
     /** class for normalized spectral clustering. This class calculates only the graph laplacian
      * and creates the general eigenvector decomposition. A neuralgas algorithm with euclidian
      * distancesis used for clustering the data
+     * @note On the MPI methods each process holds a block of rows of the (symmetric) adjacency
+     * matrix, the eigenvectors are calculated with a subspace iteration, in which only the
+     * rows of the process are multiplied and the small Gram matrices are reduced, so the full
+     * adjacency matrix is never stored on one process
      * @todo set all routines to sparse matrix if arpack can be used with boost
      * @todo create eigengap heurstic
      **/
     template<typename T> class spectralclustering : public clustering<T>
+        #ifdef MACHINELEARNING_MPI 
+        , public mpiclustering<T>
+        #endif
     {
         public :
 
@@ -65,6 +82,15 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             std::size_t getPrototypeCount( void ) const;
             std::vector<T> getLoggedQuantizationError( void ) const;
             ublas::indirect_array<> use( const ublas::matrix<T>& ) const;
+        
+            #ifdef MACHINELEARNING_MPI
+            void train( const mpi::communicator&, const ublas::matrix<T>&, const std::size_t& );
+            ublas::matrix<T> getPrototypes( const mpi::communicator& ) const;
+            std::vector< ublas::matrix<T> > getLoggedPrototypes( const mpi::communicator& ) const;
+            std::vector<T> getLoggedQuantizationError( const mpi::communicator& ) const;
+            ublas::indirect_array<> use( const mpi::communicator&, const ublas::matrix<T>& ) const;
+            void use( const mpi::communicator& ) const;
+            #endif
             
             //static std::size_t getEigenGap( const ublas::matrix<T>& ) const;
 
@@ -78,6 +104,15 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
             /** neural gas for clustering the graph laplacian **/
             kmeans<T> m_kmeans;
         
+            #ifdef MACHINELEARNING_MPI
+            /** maximum number of iterations of the subspace iteration **/
+            static const std::size_t m_eigeniterations = 1000;
+        
+            ublas::matrix<T> getEigenGraphLaplacian( const mpi::communicator&, const ublas::matrix<T>& ) const;
+            void gatherRows( const mpi::communicator&, const ublas::matrix<T>&, const std::vector<int>&, ublas::matrix<T>& ) const;
+            void orthonormalize( const mpi::communicator&, ublas::matrix<T>& ) const;
+            #endif
+        
     };
     
 
@@ -200,6 +235,254 @@ namespace machinelearning { namespace clustering { namespace nonsupervised {
         return m_kmeans.use( getEigenGraphLaplacian(p_data) );
     }
     
+    
+    
+    //======= MPI ==================================================================================================================================
+    #ifdef MACHINELEARNING_MPI
+    
+    /** gathers the row blocks of all processes into one row-major matrix
+     * @param p_mpi MPI object for communication
+     * @param p_local rows of the process
+     * @param p_rows number of rows of each process
+     * @param p_full full matrix (must have the size of all rows)
+     **/
+    template<typename T> inline void spectralclustering<T>::gatherRows( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_local, const std::vector<int>& p_rows, ublas::matrix<T>& p_full ) const
+    {
+        std::vector<int> l_count( p_rows.size() );
+        std::vector<int> l_offset( p_rows.size(), 0 );
+        for(std::size_t i=0; i < p_rows.size(); ++i) {
+            l_count[i] = p_rows[i] * static_cast<int>(p_full.size2());
+            if (i > 0)
+                l_offset[i] = l_offset[i-1] + l_count[i-1];
+        }
+        
+        MPI_Allgatherv( const_cast<T*>(p_local.data().begin()), l_count[p_mpi.rank()], mpi::get_mpi_datatype<T>(T()), 
+                        p_full.data().begin(), &l_count[0], &l_offset[0], mpi::get_mpi_datatype<T>(T()), p_mpi );
+    }
+    
+    
+    /** orthonormalizes the columns of a matrix, that is distributed in row blocks. The
+     * Gram matrix G is reduced over all processes and the rows are multiplied with G^(-1/2)
+     * @param p_mpi MPI object for communication
+     * @param p_matrix rows of the process
+     **/
+    template<typename T> inline void spectralclustering<T>::orthonormalize( const mpi::communicator& p_mpi, ublas::matrix<T>& p_matrix ) const
+    {
+        ublas::matrix<T> l_gram = ublas::prod( ublas::trans(p_matrix), p_matrix );
+        MPI_Allreduce( MPI_IN_PLACE, l_gram.data().begin(), static_cast<int>(l_gram.size1() * l_gram.size2()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
+        
+        ublas::vector<T> l_eigenvalue;
+        ublas::matrix<T> l_eigenvector;
+        tools::lapack::eigen( l_gram, l_eigenvalue, l_eigenvector );
+        
+        // G^(-1/2) = V * diag(1/sqrt(lambda)) * V^t, directions without variance are removed
+        for(std::size_t i=0; i < l_eigenvalue.size(); ++i)
+            ublas::column(l_eigenvector, i) *= (l_eigenvalue(i) > std::numeric_limits<T>::epsilon()) ? 1/std::sqrt(std::sqrt(l_eigenvalue(i))) : 0;
+        
+        p_matrix = ublas::prod( p_matrix, ublas::matrix<T>(ublas::prod(l_eigenvector, ublas::trans(l_eigenvector))) );
+    }
+    
+    
+    /** creates the cluster rows of the graph laplacian of the process. The adjacency matrix is
+     * distributed in row blocks (the block of the first process holds the first rows), so the
+     * eigenvectors of the k smallest eigenvalues of the normalized graph laplacian are determined
+     * by a subspace iteration of the symmetric matrix D^(-1/2) * A * D^(-1/2) + I, which only needs
+     * the rows of the process
+     * @param p_mpi MPI object for communication
+     * @param p_adjacency rows of the adjacency matrix of the process
+     * @return rows of the eigenvector matrix of the process
+     **/
+    template<typename T> inline ublas::matrix<T> spectralclustering<T>::getEigenGraphLaplacian( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_adjacency ) const
+    {
+        const std::size_t l_size    = mpi::all_reduce(p_mpi, p_adjacency.size1(), std::plus<std::size_t>());
+        const std::size_t l_columns = mpi::all_reduce(p_mpi, p_adjacency.size2(), mpi::maximum<std::size_t>());
+        
+        if (l_size != l_columns)
+            throw exception::runtime(_("matrix must be square"), *this);
+        if ( (p_adjacency.size1() > 0) && (p_adjacency.size2() != l_columns) )
+            throw exception::runtime(_("number of columns must be equal on each process"), *this);
+        if (l_size < m_kmeans.getPrototypeCount())
+            throw exception::runtime(_("number of datapoints are less than prototypes"), *this);
+        
+        // number of rows and offset of each process
+        int l_localrows = static_cast<int>(p_adjacency.size1());
+        std::vector<int> l_rows( p_mpi.size(), 0 );
+        std::vector<int> l_offset( p_mpi.size(), 0 );
+        MPI_Allgather( &l_localrows, 1, MPI_INT, &l_rows[0], 1, MPI_INT, p_mpi );
+        for(std::size_t i=1; i < l_rows.size(); ++i)
+            l_offset[i] = l_offset[i-1] + l_rows[i-1];
+        const std::size_t l_first = static_cast<std::size_t>(l_offset[p_mpi.rank()]);
+        
+        
+        // vertex degrees of all rows, that are stored as D^(-1/2)
+        const ublas::vector<T> l_localdegree = tools::matrix::sum( p_adjacency );
+        ublas::vector<T> l_degree( l_size );
+        MPI_Allgatherv( const_cast<T*>(l_localdegree.data().begin()), l_localrows, mpi::get_mpi_datatype<T>(T()), 
+                        l_degree.data().begin(), &l_rows[0], &l_offset[0], mpi::get_mpi_datatype<T>(T()), p_mpi );
+        
+        for(std::size_t i=0; i < l_degree.size(); ++i)
+            l_degree(i) = tools::function::isNumericalZero(l_degree(i)) ? 0 : 1/std::sqrt(l_degree(i));
+        
+        // normalized affinity rows of the process
+        ublas::matrix<T> l_affinity( p_adjacency.size1(), l_size );
+        #pragma omp parallel for shared(l_affinity)
+        for(std::size_t i=0; i < l_affinity.size1(); ++i)
+            for(std::size_t j=0; j < l_affinity.size2(); ++j)
+                l_affinity(i,j) = l_degree(l_first+i) * p_adjacency(i,j) * l_degree(j);
+        
+        
+        // subspace iteration, the shift by the identity matrix creates a positive semidefinite
+        // matrix, so the largest eigenvalues are the smallest eigenvalues of the graph laplacian
+        const T l_tolerance = 100 * std::numeric_limits<T>::epsilon();
+        ublas::matrix<T> l_basis = tools::matrix::random<T>( p_adjacency.size1(), m_kmeans.getPrototypeCount() );
+        ublas::matrix<T> l_full( l_size, l_basis.size2() );
+        ublas::matrix<T> l_product;
+        orthonormalize( p_mpi, l_basis );
+        
+        T l_trace = 0;
+        for(std::size_t i=0; i < m_eigeniterations; ++i) {
+            gatherRows( p_mpi, l_basis, l_rows, l_full );
+            l_product = ublas::prod( l_affinity, l_full ) + l_basis;
+            
+            // the trace of the Rayleigh quotient converges with the subspace
+            T l_quotient = 0;
+            for(std::size_t n=0; n < l_basis.size1(); ++n)
+                l_quotient += ublas::inner_prod( ublas::row(l_basis, n), ublas::row(l_product, n) );
+            l_quotient = mpi::all_reduce(p_mpi, l_quotient, std::plus<T>());
+            
+            l_basis.swap( l_product );
+            orthonormalize( p_mpi, l_basis );
+            
+            if (std::fabs(l_quotient - l_trace) <= l_tolerance * std::fabs(l_quotient))
+                break;
+            l_trace = l_quotient;
+        }
+        
+        
+        // Rayleigh-Ritz projection creates the eigenvectors of the subspace
+        gatherRows( p_mpi, l_basis, l_rows, l_full );
+        l_product = ublas::prod( l_affinity, l_full ) + l_basis;
+        
+        ublas::matrix<T> l_projection = ublas::prod( ublas::trans(l_basis), l_product );
+        MPI_Allreduce( MPI_IN_PLACE, l_projection.data().begin(), static_cast<int>(l_projection.size1() * l_projection.size2()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
+        
+        ublas::vector<T> l_eigenvalue;
+        ublas::matrix<T> l_eigenvector;
+        tools::lapack::eigen( l_projection, l_eigenvalue, l_eigenvector );
+        
+        // sort the eigenvectors by descending eigenvalues (ascending eigenvalues of the laplacian)
+        const ublas::indirect_array<> l_rank = tools::vector::rankIndex<T>(l_eigenvalue);
+        ublas::matrix<T> l_sorted( l_eigenvector.size1(), l_eigenvector.size2() );
+        for(std::size_t i=0; i < l_sorted.size2(); ++i)
+            ublas::column(l_sorted, i) = ublas::column(l_eigenvector, l_rank(l_rank.size()-1-i));
+        
+        l_basis = ublas::prod( l_basis, l_sorted );
+        
+        
+        // eigenvectors of the laplacian D^(-1) * (D - A) are D^(-1/2) * v, each column is normalized
+        for(std::size_t i=0; i < l_basis.size1(); ++i)
+            ublas::row(l_basis, i) *= l_degree(l_first+i);
+        
+        ublas::vector<T> l_norm( l_basis.size2(), 0 );
+        for(std::size_t i=0; i < l_basis.size1(); ++i)
+            l_norm += ublas::element_prod( ublas::row(l_basis, i), ublas::row(l_basis, i) );
+        MPI_Allreduce( MPI_IN_PLACE, l_norm.data().begin(), static_cast<int>(l_norm.size()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
+        
+        for(std::size_t i=0; i < l_norm.size(); ++i)
+            if (!tools::function::isNumericalZero(l_norm(i)))
+                ublas::column(l_basis, i) /= std::sqrt(l_norm(i));
+        
+        
+        // the sign of each eigenvector depends on the random start of the subspace iteration, so the
+        // component with the largest magnitude (first row on equal values) is set positive, otherwise
+        // the embedding of the use call does not match the embedding of the trained prototypes
+        std::vector<T> l_extreme( l_basis.size2(), 0 );
+        for(std::size_t i=0; i < l_basis.size1(); ++i)
+            for(std::size_t j=0; j < l_basis.size2(); ++j)
+                if (std::fabs(l_basis(i,j)) > std::fabs(l_extreme[j]))
+                    l_extreme[j] = l_basis(i,j);
+        
+        std::vector< std::vector<T> > l_processextreme;
+        mpi::all_gather(p_mpi, l_extreme, l_processextreme);
+        
+        for(std::size_t j=0; j < l_basis.size2(); ++j) {
+            T l_max = 0;
+            for(std::size_t n=0; n < l_processextreme.size(); ++n)
+                if (std::fabs(l_processextreme[n][j]) > std::fabs(l_max))
+                    l_max = l_processextreme[n][j];
+            
+            if (l_max < 0)
+                ublas::column(l_basis, j) *= -1;
+        }
+        
+        return l_basis;
+    }
+    
+    
+    /** cluster the graph with the <strong>normalized</strong> graph laplacian on the cluster
+     * @param p_mpi MPI object for communication
+     * @param p_adjacency rows of the adjacency / distance matrix of the process
+     * @param p_iterations number of iterations
+     **/
+    template<typename T> inline void spectralclustering<T>::train( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_adjacency, const std::size_t& p_iterations )
+    {
+        m_kmeans.train( p_mpi, getEigenGraphLaplacian(p_mpi, p_adjacency), p_iterations );
+    }
+    
+    
+    /** return all prototypes of the cluster
+     * @param p_mpi MPI object for communication
+     * @return matrix (rows = prototypes)
+     **/
+    template<typename T> inline ublas::matrix<T> spectralclustering<T>::getPrototypes( const mpi::communicator& p_mpi ) const
+    {
+        return m_kmeans.getPrototypes( p_mpi );
+    }
+    
+    
+    /** returns all logged prototypes
+     * @param p_mpi MPI object for communication
+     * @return std::vector with all logged prototypes
+     **/
+    template<typename T> inline std::vector< ublas::matrix<T> > spectralclustering<T>::getLoggedPrototypes( const mpi::communicator& p_mpi ) const
+    {
+        return m_kmeans.getLoggedPrototypes( p_mpi );
+    }
+    
+    
+    /** returns the logged quantisation error
+     * @param p_mpi MPI object for communication
+     * @return std::vector with quantization error
+     **/
+    template<typename T> inline std::vector<T> spectralclustering<T>::getLoggedQuantizationError( const mpi::communicator& p_mpi ) const
+    {
+        return m_kmeans.getLoggedQuantizationError( p_mpi );
+    }
+    
+    
+    /** returns the index for each datapoint to the prototype
+     * @param p_mpi MPI object for communication
+     * @param p_data rows of the adjacency matrix of the process
+     * @return array with index values
+     **/
+    template<typename T> inline ublas::indirect_array<> spectralclustering<T>::use( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data ) const
+    {
+        return m_kmeans.use( p_mpi, getEigenGraphLaplacian(p_mpi, p_data) );
+    }
+    
+    
+    /** blank method for processes without rows, the eigenvector calculation needs all processes
+     * @param p_mpi MPI object for communication
+     **/
+    template<typename T> inline void spectralclustering<T>::use( const mpi::communicator& p_mpi ) const
+    {
+        getEigenGraphLaplacian( p_mpi, ublas::matrix<T>(0, 0) );
+        m_kmeans.use( p_mpi );
+    }
+    
+    #endif
+    
+
         
 }}}
 #endif
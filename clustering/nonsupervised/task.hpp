@@ -0,0 +1,302 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#ifndef __MACHINELEARNING_CLUSTERING_NONSUPERVISED_TASK_HPP
+#define __MACHINELEARNING_CLUSTERING_NONSUPERVISED_TASK_HPP
+
+#include <string>
+#include <exception>
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include "progress.hpp"
+#include "../../tools/threadpool.hpp"
+
+
+namespace machinelearning { namespace clustering { namespace nonsupervised {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class for an asynchronous training, the constructor copies the data and posts the
+     * train call of the algorithm to a thread pool, so the object is a handle of the running
+     * training, which can be waited for or canceled. The algorithm type must support a progress
+     * object (eg neuralgas, kmeans or relational_neuralgas), the progress object is updated
+     * after each iteration and the cancellation takes effect before the next iteration.
+     * The destructor cancels the training and waits until it is stopped
+     * @note the algorithm object and the progress object must exist until the training is
+     * done and the algorithm must not be used by another training at the same time
+     **/
+    template<typename T, typename A> class task
+    {
+        #ifndef SWIG
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        #endif
+        
+        public :
+        
+            /** state of the training **/
+            enum state
+            {
+                waiting     = 0,
+                running     = 1,
+                finished    = 2,
+                canceled    = 3,
+                failed      = 4
+            };
+        
+        
+            task( tools::threadpool&, A&, const ublas::matrix<T>&, const std::size_t& );
+            task( tools::threadpool&, A&, const ublas::matrix<T>&, const std::size_t&, progress<T>& );
+            ~task( void );
+            void cancel( void );
+            void wait( void ) const;
+            bool wait( const std::size_t& ) const;
+            bool isDone( void ) const;
+            state getState( void ) const;
+            std::size_t getIteration( void ) const;
+            std::string getMessage( void ) const;
+        
+        
+        private :
+        
+            /** data, that is shared between the handle and the job **/
+            struct shared
+            {
+                /** algorithm **/
+                A& algorithm;
+                /** copy of the data **/
+                const ublas::matrix<T> data;
+                /** number of iterations **/
+                const std::size_t iterations;
+                /** progress object, that is used if no progress object is passed **/
+                progress<T> defaultprogress;
+                /** progress object of the training **/
+                progress<T>* const progressobject;
+                /** mutex of the state **/
+                mutable boost::mutex mutex;
+                /** condition, that is notified on the end of the training **/
+                mutable boost::condition_variable condition;
+                /** state of the training **/
+                state status;
+                /** exception message of a failed training **/
+                std::string message;
+                
+                shared( A&, const ublas::matrix<T>&, const std::size_t&, progress<T>* const );
+            };
+        
+            /** shared data **/
+            const boost::shared_ptr<shared> m_shared;
+        
+            task( const task& );
+            task& operator=( const task& );
+            static void run( const boost::shared_ptr<shared>& );
+            static void setState( shared&, const state&, const std::string& = std::string() );
+        
+    };
+    
+    
+    
+    /** constructor of the shared data
+     * @param p_algorithm algorithm
+     * @param p_data data
+     * @param p_iterations number of iterations
+     * @param p_progress progress object or null for the default progress object
+     **/
+    template<typename T, typename A> inline task<T, A>::shared::shared( A& p_algorithm, const ublas::matrix<T>& p_data, const std::size_t& p_iterations, progress<T>* const p_progress ) :
+        algorithm( p_algorithm ),
+        data( p_data ),
+        iterations( p_iterations ),
+        defaultprogress(),
+        progressobject( p_progress ? p_progress : &defaultprogress ),
+        mutex(),
+        condition(),
+        status( waiting ),
+        message()
+    {}
+    
+    
+    /** constructor, that starts the training
+     * @param p_pool thread pool
+     * @param p_algorithm algorithm
+     * @param p_data data matrix
+     * @param p_iterations number of iterations
+     **/
+    template<typename T, typename A> inline task<T, A>::task( tools::threadpool& p_pool, A& p_algorithm, const ublas::matrix<T>& p_data, const std::size_t& p_iterations ) :
+        m_shared( new shared(p_algorithm, p_data, p_iterations, NULL) )
+    {
+        p_pool.post( boost::bind( &task<T, A>::run, m_shared ) );
+    }
+    
+    
+    /** constructor, that starts the training
+     * @param p_pool thread pool
+     * @param p_algorithm algorithm
+     * @param p_data data matrix
+     * @param p_iterations number of iterations
+     * @param p_progress progress object, that gets the updates of each iteration (it is reset, so a canceled object can be reused)
+     **/
+    template<typename T, typename A> inline task<T, A>::task( tools::threadpool& p_pool, A& p_algorithm, const ublas::matrix<T>& p_data, const std::size_t& p_iterations, progress<T>& p_progress ) :
+        m_shared( new shared(p_algorithm, p_data, p_iterations, &p_progress) )
+    {
+        p_progress.reset();
+        p_pool.post( boost::bind( &task<T, A>::run, m_shared ) );
+    }
+    
+    
+    /** destructor, cancels a running training and waits until the job is stopped **/
+    template<typename T, typename A> inline task<T, A>::~task( void )
+    {
+        if (!isDone())
+            cancel();
+        wait();
+    }
+    
+    
+    /** requests the cancellation, a waiting job is not started, a running
+     * training stops before the next iteration
+     **/
+    template<typename T, typename A> inline void task<T, A>::cancel( void )
+    {
+        m_shared->progressobject->cancel();
+    }
+    
+    
+    /** waits until the training is done **/
+    template<typename T, typename A> inline void task<T, A>::wait( void ) const
+    {
+        boost::unique_lock<boost::mutex> l_lock( m_shared->mutex );
+        while ( (m_shared->status == waiting) || (m_shared->status == running) )
+            m_shared->condition.wait( l_lock );
+    }
+    
+    
+    /** waits until the training is done or the time is elapsed
+     * @param p_milliseconds maximum waiting time in milliseconds
+     * @return true if the training is done
+     **/
+    template<typename T, typename A> inline bool task<T, A>::wait( const std::size_t& p_milliseconds ) const
+    {
+        const boost::system_time l_timeout = boost::get_system_time() + boost::posix_time::milliseconds( static_cast<long>(p_milliseconds) );
+        
+        boost::unique_lock<boost::mutex> l_lock( m_shared->mutex );
+        while ( (m_shared->status == waiting) || (m_shared->status == running) )
+            if (!m_shared->condition.timed_wait( l_lock, l_timeout ))
+                return (m_shared->status != waiting) && (m_shared->status != running);
+        
+        return true;
+    }
+    
+    
+    /** checks if the training is done (finished, canceled or failed)
+     * @return bool
+     **/
+    template<typename T, typename A> inline bool task<T, A>::isDone( void ) const
+    {
+        const state l_state = getState();
+        return (l_state != waiting) && (l_state != running);
+    }
+    
+    
+    /** returns the state of the training
+     * @return state
+     **/
+    template<typename T, typename A> inline typename task<T, A>::state task<T, A>::getState( void ) const
+    {
+        boost::lock_guard<boost::mutex> l_lock( m_shared->mutex );
+        return m_shared->status;
+    }
+    
+    
+    /** returns the number of finished iterations
+     * @return iterations
+     **/
+    template<typename T, typename A> inline std::size_t task<T, A>::getIteration( void ) const
+    {
+        return m_shared->progressobject->getIteration();
+    }
+    
+    
+    /** returns the exception message of a failed training
+     * @return message (empty if the training has not failed)
+     **/
+    template<typename T, typename A> inline std::string task<T, A>::getMessage( void ) const
+    {
+        boost::lock_guard<boost::mutex> l_lock( m_shared->mutex );
+        return m_shared->message;
+    }
+    
+    
+    /** sets the state and notifies the waiting threads
+     * @param p_shared shared data
+     * @param p_state new state
+     * @param p_message message
+     **/
+    template<typename T, typename A> inline void task<T, A>::setState( shared& p_shared, const state& p_state, const std::string& p_message )
+    {
+        {
+            boost::lock_guard<boost::mutex> l_lock( p_shared.mutex );
+            p_shared.status  = p_state;
+            p_shared.message = p_message;
+        }
+        p_shared.condition.notify_all();
+    }
+    
+    
+    /** job, that runs the training within the thread pool, the exceptions
+     * of the training are stored as failed state
+     * @param p_shared shared data
+     **/
+    template<typename T, typename A> inline void task<T, A>::run( const boost::shared_ptr<shared>& p_shared )
+    {
+        if (p_shared->progressobject->isCanceled()) {
+            setState( *p_shared, canceled );
+            return;
+        }
+        setState( *p_shared, running );
+        
+        p_shared->algorithm.setProgress( *p_shared->progressobject );
+        try {
+            p_shared->algorithm.train( p_shared->data, p_shared->iterations );
+            p_shared->algorithm.removeProgress();
+            
+            setState( *p_shared, p_shared->progressobject->isCanceled() ? canceled : finished );
+            
+        } catch (const std::exception& e) {
+            p_shared->algorithm.removeProgress();
+            setState( *p_shared, failed, e.what() );
+        } catch (...) {
+            p_shared->algorithm.removeProgress();
+            setState( *p_shared, failed, "unknown exception" );
+        }
+    }
+    
+}}}
+#endif
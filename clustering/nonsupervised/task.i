@@ -0,0 +1,55 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+/** interface file for the asynchronous training, the Java object holds the
+ * references of the thread pool, the algorithm and the progress object, so
+ * they are not collected during the training
+ **/
+
+
+#ifdef SWIGJAVA
+%module "taskmodule"
+%include "../../swig/java/java.i"
+
+%import "../../tools/threadpool.i"
+%import "progress.i"
+%import "neuralgas.i"
+%import "kmeans.i"
+%import "relational_neuralgas.i"
+
+// the wait methods of java.lang.Object are final
+%rename(waitFor) machinelearning::clustering::nonsupervised::task::wait;
+
+%typemap(javaimports)   SWIGTYPE        "import machinelearning.tools.ThreadPool;"
+%typemap(javain, post="        m_references.add($javainput);") SWIGTYPE&  "$javaclassname.getCPtr($javainput)"
+%typemap(javacode)      SWIGTYPE        %{
+    /** references of the objects, that are used by the native training **/
+    private final java.util.ArrayList<Object> m_references = new java.util.ArrayList<Object>();
+%}
+#endif
+
+
+%include "task.hpp"
+%template(NeuralGasTask) machinelearning::clustering::nonsupervised::task<double, machinelearning::clustering::nonsupervised::neuralgas<double> >;
+%template(kMeansTask) machinelearning::clustering::nonsupervised::task<double, machinelearning::clustering::nonsupervised::kmeans<double> >;
+%template(RelationalNeuralGasTask) machinelearning::clustering::nonsupervised::task<double, machinelearning::clustering::nonsupervised::relational_neuralgas<double> >;
@@ -27,6 +27,7 @@
 
 #include <omp.h>
 
+#include <algorithm>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 
@@ -44,20 +45,23 @@ namespace machinelearning { namespace clustering { namespace supervised {
     #endif
     
     
-    /** class for calculate relevance vector quantisation (RLVQ).
+    /** class for calculate relevance vector quantisation (RLVQ). The optional third template
+     * parameter is the distance type, for a concrete distance class the calls are bound statically.
      * RLVQ is not the best solution for overlapping cluster,
      * the class is created like a template class for free types
      * of the label structure
     **/
-    template<typename T, typename L> class rlvq : public clustering<T, L> 
+    template<typename T, typename L, typename D = distances::distance<T> > class rlvq : public clustering<T, L> 
     {
         
         public:
         
-            rlvq( const distances::distance<T>&, const std::vector<L>&, const std::size_t& );
+            rlvq( const D&, const std::vector<L>&, const std::size_t& );
             void train( const ublas::matrix<T>&, const std::vector<L>&, const std::size_t& );
             void train( const ublas::matrix<T>&, const std::vector<L>&, const std::size_t&, const T& );
             void train( const ublas::matrix<T>&, const std::vector<L>&, const std::size_t&, const T&, const T& );
+            void trainbatch( const ublas::matrix<T>&, const std::vector<L>&, const std::size_t&, const std::size_t& );
+            void trainbatch( const ublas::matrix<T>&, const std::vector<L>&, const std::size_t&, const std::size_t&, const T&, const T& );
             ublas::matrix<T> getPrototypes( void ) const;
             std::vector<L> getPrototypesLabel( void ) const;
             void setLogging( const bool& );
@@ -72,7 +76,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
         private :
         
             /** distance object **/
-            const distances::distance<T>& m_distance;
+            typename distances::policy<D>::type m_distance;
             /** prototypes **/
             ublas::matrix<T> m_prototypes;
             /** vector with neuron label information **/
@@ -85,6 +89,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
             std::vector<T> m_quantizationerror;
         
             T calculateQuantizationError( const ublas::matrix<T>& ) const;
+            void checkParameter( const ublas::matrix<T>&, const std::vector<L>&, const std::size_t&, const T&, const T& ) const;
     };
    
     
@@ -93,7 +98,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
      * @param p_neuronlabels protoype labeling
      * @param p_prototypesize length of prototypes   
     **/
-    template<typename T, typename L> inline rlvq<T, L>::rlvq( const distances::distance<T>& p_distance, const std::vector<L>& p_neuronlabels, const std::size_t& p_prototypesize ) :
+    template<typename T, typename L, typename D> inline rlvq<T, L, D>::rlvq( const D& p_distance, const std::vector<L>& p_neuronlabels, const std::size_t& p_prototypesize ) :
         m_distance( p_distance ),    
         m_prototypes( tools::matrix::random<T>(p_neuronlabels.size(), p_prototypesize) ),
         m_neuronlabels( p_neuronlabels ),
@@ -109,7 +114,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
     /** returns the prototype matrix
      * @return matrix (rows = prototypes)
      **/
-    template<typename T, typename L> inline ublas::matrix<T> rlvq<T, L>::getPrototypes( void ) const
+    template<typename T, typename L, typename D> inline ublas::matrix<T> rlvq<T, L, D>::getPrototypes( void ) const
     {
         return m_prototypes;
     }
@@ -118,7 +123,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
     /** returns the prototypes labels
      * @return vector with label information
     **/
-    template<typename T, typename L> inline std::vector<L> rlvq<T, L>::getPrototypesLabel( void ) const
+    template<typename T, typename L, typename D> inline std::vector<L> rlvq<T, L, D>::getPrototypesLabel( void ) const
     {
         return m_neuronlabels;
     }
@@ -127,7 +132,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
     /** enabled / disable logging for training
      * @param p_log bool
     **/
-    template<typename T, typename L> inline void rlvq<T, L>::setLogging( const bool& p_log )
+    template<typename T, typename L, typename D> inline void rlvq<T, L, D>::setLogging( const bool& p_log )
     {
         m_logging = p_log;
         m_logprototypes.clear();
@@ -137,7 +142,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
     /** shows the logging status
      * @return bool
     **/
-    template<typename T, typename L> inline bool rlvq<T, L>::getLogging( void ) const
+    template<typename T, typename L, typename D> inline bool rlvq<T, L, D>::getLogging( void ) const
     {
         return m_logging && (m_logprototypes.size() > 0);
     }
@@ -146,7 +151,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
     /** returns every prototype step during training
      * @return std::vector with prototype matrix
     **/
-    template<typename T, typename L> inline std::vector< ublas::matrix<T> > rlvq<T, L>::getLoggedPrototypes( void ) const
+    template<typename T, typename L, typename D> inline std::vector< ublas::matrix<T> > rlvq<T, L, D>::getLoggedPrototypes( void ) const
     {
         return m_logprototypes;
     }
@@ -155,7 +160,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
     /** returns the dimension of prototypes
      * @return dimension of the prototypes
      **/
-    template<typename T, typename L> inline std::size_t rlvq<T, L>::getPrototypeSize( void ) const 
+    template<typename T, typename L, typename D> inline std::size_t rlvq<T, L, D>::getPrototypeSize( void ) const 
     {
         return m_prototypes.size2();
     }
@@ -164,7 +169,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
     /** returns the number of prototypes
      * @return number of the prototypes / classes
      **/
-    template<typename T, typename L> inline std::size_t rlvq<T, L>::getPrototypeCount( void ) const 
+    template<typename T, typename L, typename D> inline std::size_t rlvq<T, L, D>::getPrototypeCount( void ) const 
     {
         return m_prototypes.size1();
     }
@@ -173,7 +178,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
     /** returns the quantisation error 
      * @return error for each iteration
     **/
-    template<typename T, typename L> inline std::vector<T> rlvq<T, L>::getLoggedQuantizationError( void ) const
+    template<typename T, typename L, typename D> inline std::vector<T> rlvq<T, L, D>::getLoggedQuantizationError( void ) const
     {
         return m_quantizationerror;
     }
@@ -184,7 +189,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
      * @param p_labels vector for labels
      * @param p_iterations iterations
      **/
-    template<typename T, typename L> inline void rlvq<T, L>::train( const ublas::matrix<T>& p_data, const std::vector<L>& p_labels, const std::size_t& p_iterations )
+    template<typename T, typename L, typename D> inline void rlvq<T, L, D>::train( const ublas::matrix<T>& p_data, const std::vector<L>& p_labels, const std::size_t& p_iterations )
     {
         train(p_data, p_labels, p_iterations, 0.01/m_prototypes.size1());
     }
@@ -196,7 +201,7 @@ namespace machinelearning { namespace clustering { namespace supervised {
      * @param p_iterations iterations
      * @param p_lambda multiplicator for adaption for prototypes
      **/
-    template<typename T, typename L> inline void rlvq<T, L>::train( const ublas::matrix<T>& p_data, const std::vector<L>& p_labels, const std::size_t& p_iterations, const T& p_lambda )
+    template<typename T, typename L, typename D> inline void rlvq<T, L, D>::train( const ublas::matrix<T>& p_data, const std::vector<L>& p_labels, const std::size_t& p_iterations, const T& p_lambda )
     {
         train(p_data, p_labels, p_iterations, p_lambda, 0.1*p_lambda);
     }
@@ -209,7 +214,70 @@ namespace machinelearning { namespace clustering { namespace supervised {
      * @param p_lambda multiplicator for adaption for prototypes
      * @param p_eta multiplicator for adaption for the dimension weights
     **/
-    template<typename T, typename L> inline void rlvq<T, L>::train( const ublas::matrix<T>& p_data, const std::vector<L>& p_labels, const std::size_t& p_iterations, const T& p_lambda, const T& p_eta )
+    template<typename T, typename L, typename D> inline void rlvq<T, L, D>::train( const ublas::matrix<T>& p_data, const std::vector<L>& p_labels, const std::size_t& p_iterations, const T& p_lambda, const T& p_eta )
+    {
+        checkParameter(p_data, p_labels, p_iterations, p_lambda, p_eta);
+        
+        // for every prototype create a own lambda, initialisate with 1 and normalize prototypes
+        ublas::matrix<T> l_lambda(m_neuronlabels.size(), p_data.size2(), 1);
+        m_distance.normalize( l_lambda );
+        
+        // creates logging
+        if (m_logging) {
+            m_logprototypes     = std::vector< ublas::matrix<T> >();
+            m_quantizationerror = std::vector< T >();
+            m_logprototypes.reserve(p_iterations);
+            m_quantizationerror.reserve(p_iterations);
+        }
+        
+        
+        for(std::size_t i=0; i < p_iterations; ++i) {
+            
+            // determine quantization error for logging
+            if (m_logging) {
+                m_logprototypes.push_back( m_prototypes );
+                m_quantizationerror.push_back( calculateQuantizationError(p_data) );
+            }
+            
+            #pragma omp parallel for schedule(static) shared(l_lambda)
+            for (std::size_t j=0; j < p_data.size1(); ++j) {
+                
+                // determine the winner prototype with the weighted distance
+                const ublas::vector<T> l_point = ublas::row(p_data, j);
+                const std::size_t l_winner     = m_distance.getWeightedNearest( m_prototypes, l_point, l_lambda );
+                
+                // calculate adapt values
+                const ublas::vector<T> l_winnerdelta    = p_lambda * (l_point - ublas::row(m_prototypes, l_winner));
+                const ublas::vector<T> l_lambdaadapt    = p_eta    * ublas::element_prod(ublas::row(l_lambda, l_winner), m_distance.getAbs(l_winnerdelta));
+                
+                // label checking and adaption for winner and lambda
+                #pragma omp critical
+                {
+                    if (  m_neuronlabels[l_winner] == p_labels[j] ) {
+                        ublas::row(m_prototypes, l_winner) += l_winnerdelta;
+                        ublas::row(l_lambda, l_winner)     -= l_lambdaadapt;
+                    } else {
+                        ublas::row(m_prototypes, l_winner) -= l_winnerdelta;
+                        ublas::row(l_lambda, l_winner)     += l_lambdaadapt;
+                    }
+                    
+                    // normalize lambda (only one row, which has been changed)
+                    ublas::row(l_lambda, l_winner)  /= m_distance.getLength( static_cast< ublas::vector<T> >(ublas::row(l_lambda, l_winner)) );
+                }
+            }
+        }
+    }
+    
+    
+    
+    /** checks the training parameter
+     * @param p_data Matrix with data (rows are the vectors)
+     * @param p_labels vector for labels
+     * @param p_iterations iterations
+     * @param p_lambda multiplicator for adaption for prototypes
+     * @param p_eta multiplicator for adaption for the dimension weights
+     **/
+    template<typename T, typename L, typename D> inline void rlvq<T, L, D>::checkParameter( const ublas::matrix<T>& p_data, const std::vector<L>& p_labels, const std::size_t& p_iterations, const T& p_lambda, const T& p_eta ) const
     {
         if (p_data.size1() < m_prototypes.size1())
             throw exception::runtime(_("number of datapoints are less than prototypes"), *this);
@@ -223,6 +291,37 @@ namespace machinelearning { namespace clustering { namespace supervised {
             throw exception::runtime(_("lambda must be greater than zero"), *this);
         if (p_eta <= 0)
             throw exception::runtime(_("eta must be greater than zero"), *this);
+    }
+    
+    
+    /** trains the prototypes in mini-batches
+     * @param p_data Matrix with data (rows are the vectors)
+     * @param p_labels vector for labels
+     * @param p_iterations iterations
+     * @param p_batch number of datapoints within a batch
+     **/
+    template<typename T, typename L, typename D> inline void rlvq<T, L, D>::trainbatch( const ublas::matrix<T>& p_data, const std::vector<L>& p_labels, const std::size_t& p_iterations, const std::size_t& p_batch )
+    {
+        trainbatch(p_data, p_labels, p_iterations, p_batch, 0.01/m_prototypes.size1(), 0.001/m_prototypes.size1());
+    }
+    
+    
+    /** trains the prototypes in mini-batches. Within a batch the winner and the adaption values are calculated with
+     * the prototypes and weights of the batch start, so every thread accumulates the deltas in local matrices without
+     * any lock. The deltas of all threads are added once at the end of each batch. A batch size of the number of datapoints
+     * creates a full batch RLVQ
+     * @param p_data Matrix with data (rows are the vectors)
+     * @param p_labels vector for labels
+     * @param p_iterations iterations
+     * @param p_batch number of datapoints within a batch
+     * @param p_lambda multiplicator for adaption for prototypes
+     * @param p_eta multiplicator for adaption for the dimension weights
+     **/
+    template<typename T, typename L, typename D> inline void rlvq<T, L, D>::trainbatch( const ublas::matrix<T>& p_data, const std::vector<L>& p_labels, const std::size_t& p_iterations, const std::size_t& p_batch, const T& p_lambda, const T& p_eta )
+    {
+        checkParameter(p_data, p_labels, p_iterations, p_lambda, p_eta);
+        if (p_batch == 0)
+            throw exception::runtime(_("batch size must be greater than zero"), *this);
         
         // for every prototype create a own lambda, initialisate with 1 and normalize prototypes
         ublas::matrix<T> l_lambda(m_neuronlabels.size(), p_data.size2(), 1);
@@ -236,6 +335,10 @@ namespace machinelearning { namespace clustering { namespace supervised {
             m_quantizationerror.reserve(p_iterations);
         }
         
+        // global deltas of a batch and flags for changed prototypes
+        ublas::matrix<T> l_prototypedelta( m_prototypes.size1(), m_prototypes.size2() );
+        ublas::matrix<T> l_lambdadelta( l_lambda.size1(), l_lambda.size2() );
+        std::vector<bool> l_changed( m_prototypes.size1() );
         
         for(std::size_t i=0; i < p_iterations; ++i) {
             
@@ -245,50 +348,79 @@ namespace machinelearning { namespace clustering { namespace supervised {
                 m_quantizationerror.push_back( calculateQuantizationError(p_data) );
             }
             
-            #pragma omp parallel for shared(l_lambda)
-            for (std::size_t j=0; j < p_data.size1(); ++j) {
+            for(std::size_t l_begin=0; l_begin < p_data.size1(); l_begin += p_batch) {
+                const std::size_t l_end = std::min(l_begin + p_batch, p_data.size1());
                 
-                // calculate weighted distance and rank vector elements, the first element is the index of the winner prototype
-                ublas::vector<T> l_distance          = m_distance.getWeightedDistance( m_prototypes, ublas::row(p_data, j), l_lambda );
-                const ublas::indirect_array<> l_rank = tools::vector::rankIndex( l_distance );
-                
-                // calculate adapt values
-                const ublas::vector<T> l_winnerdelta    = p_lambda * (ublas::row(p_data, j) - ublas::row(m_prototypes, l_rank(0) ));
-                const ublas::vector<T> l_lambdaadapt    = p_eta    * ublas::element_prod(ublas::row(l_lambda, l_rank(0)), m_distance.getAbs(l_winnerdelta));
+                l_prototypedelta.clear();
+                l_lambdadelta.clear();
+                std::fill( l_changed.begin(), l_changed.end(), false );
                 
-                // label checking and adaption for winner and lambda
-                #pragma omp critical
+                #pragma omp parallel shared(l_prototypedelta, l_lambdadelta, l_changed)
                 {
-                    if (  m_neuronlabels[l_rank(0)] == p_labels[j] ) {
-                        ublas::row(m_prototypes, l_rank(0) ) += l_winnerdelta;
-                        ublas::row(l_lambda, l_rank(0))      -= l_lambdaadapt;
-                    } else {
-                        ublas::row(m_prototypes, l_rank(0) ) -= l_winnerdelta;
-                        ublas::row(l_lambda, l_rank(0))      += l_lambdaadapt;
+                    // thread-local accumulators
+                    ublas::matrix<T> l_localprototype( m_prototypes.size1(), m_prototypes.size2(), 0 );
+                    ublas::matrix<T> l_locallambda( l_lambda.size1(), l_lambda.size2(), 0 );
+                    std::vector<bool> l_localchanged( m_prototypes.size1(), false );
+                    ublas::vector<T> l_point( p_data.size2() );
+                    
+                    #pragma omp for nowait
+                    for(std::size_t j=l_begin; j < l_end; ++j) {
+                        // the winner is searched by the distance, a concrete distance type binds
+                        // the call statically (the euclidean distance uses a running minimum of the kernel)
+                        l_point                    = ublas::row(p_data, j);
+                        const std::size_t l_winner = m_distance.getWeightedNearest( m_prototypes, l_point, l_lambda );
+                        
+                        // calculate adapt values
+                        const ublas::vector<T> l_winnerdelta    = p_lambda * (l_point - ublas::row(m_prototypes, l_winner));
+                        const ublas::vector<T> l_lambdaadapt    = p_eta    * ublas::element_prod(ublas::row(l_lambda, l_winner), m_distance.getAbs(l_winnerdelta));
+                        
+                        // label checking and adaption for winner and lambda
+                        if (m_neuronlabels[l_winner] == p_labels[j]) {
+                            ublas::row(l_localprototype, l_winner) += l_winnerdelta;
+                            ublas::row(l_locallambda, l_winner)    -= l_lambdaadapt;
+                        } else {
+                            ublas::row(l_localprototype, l_winner) -= l_winnerdelta;
+                            ublas::row(l_locallambda, l_winner)    += l_lambdaadapt;
+                        }
+                        l_localchanged[l_winner] = true;
                     }
                     
-                    // normalize lambda (only one row, which has been changed)
-                    ublas::row(l_lambda, l_rank(0))  /= m_distance.getLength( static_cast< ublas::vector<T> >(ublas::row(l_lambda, l_rank(0))) );
+                    // reduce the thread-local values once per batch
+                    #pragma omp critical
+                    {
+                        l_prototypedelta += l_localprototype;
+                        l_lambdadelta    += l_locallambda;
+                        for(std::size_t n=0; n < l_changed.size(); ++n)
+                            l_changed[n] = l_changed[n] || l_localchanged[n];
+                    }
                 }
+                
+                // adapt prototypes and lambda, normalize only the changed lambda rows
+                m_prototypes += l_prototypedelta;
+                l_lambda     += l_lambdadelta;
+                
+                for(std::size_t n=0; n < l_changed.size(); ++n)
+                    if (l_changed[n])
+                        ublas::row(l_lambda, n) /= m_distance.getLength( static_cast< ublas::vector<T> >(ublas::row(l_lambda, n)) );
             }
         }
     }
     
     
-    
     /** calculate the quantization error
      * @param p_data matrix with data points
      * @return quantization error
      **/
-    template<typename T, typename L> inline T rlvq<T, L>::calculateQuantizationError( const ublas::matrix<T>& p_data ) const
+    template<typename T, typename L, typename D> inline T rlvq<T, L, D>::calculateQuantizationError( const ublas::matrix<T>& p_data ) const
     {
-        ublas::matrix<T> l_distances( m_prototypes.size1(), p_data.size1() );
+        // rows = datapoints, so each thread writes contiguous rows
+        ublas::matrix<T> l_distances( p_data.size1(), m_prototypes.size1() );
         
-        #pragma omp parallel for shared(l_distances)
-        for(std::size_t i=0; i < m_prototypes.size1(); ++i)
-            ublas::row(l_distances, i) = m_distance.getDistance( p_data, ublas::row(m_prototypes, i) );
+        #pragma omp parallel for schedule(static) shared(l_distances)
+        for(std::size_t i=0; i < p_data.size1(); ++i)
+            ublas::row(l_distances, i) = m_distance.getDistance( m_prototypes, ublas::row(p_data, i) );
         
-        return 0.5 * ublas::sum(  m_distance.getAbs(tools::matrix::min(l_distances, tools::matrix::column))  );  
+        return 0.5 * ublas::sum(  m_distance.getAbs(tools::matrix::min(l_distances, tools::matrix::row))  );  
     }
     
     
@@ -297,13 +429,13 @@ namespace machinelearning { namespace clustering { namespace supervised {
      * @param p_data unkwon datamatrix
      * @return index position for every datapoint and its prototype / label
     **/
-    template<typename T, typename L> inline ublas::indirect_array<> rlvq<T, L>::use( const ublas::matrix<T>& p_data ) const
+    template<typename T, typename L, typename D> inline ublas::indirect_array<> rlvq<T, L, D>::use( const ublas::matrix<T>& p_data ) const
     {
         if (p_data.size2() != m_prototypes.size2())
             throw exception::runtime( _("data and prototype dimension are not equal"), *this );
         
         ublas::indirect_array<> l_idx(p_data.size1());
-        #pragma omp parallel for shared(l_idx)
+        #pragma omp parallel for schedule(static) shared(l_idx)
         for(std::size_t i=0; i < p_data.size1(); ++i) {
             
             // calculate distance from datapoint to all prototyps and rank position
@@ -26,6 +26,8 @@
 
 #include <boost/static_assert.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
 
 #include "reduce.hpp"
 #include "../../errorhandling/exception.hpp"
@@ -36,11 +38,22 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     
     #ifndef SWIG
     namespace ublas  = boost::numeric::ublas;
+    #ifdef MACHINELEARNING_MPI
+    namespace mpi    = boost::mpi;
+    #endif
     #endif
     
     
-    /** create the principal component analysis (PCA) **/
+    /** create the principal component analysis (PCA)
+     * @note On the MPI method each process holds a block of rows. The mean and the scatter
+     * matrix are summed over all processes, or the data is reduced with a TSQR (tree of QR
+     * decompositions of the stacked triangular factors), so only dxd matrices are communicated
+     * and each process solves the small eigen / singular value problem
+     **/
     template<typename T> class pca : public reduce<T>
+        #ifdef MACHINELEARNING_MPI
+        , public reducempi<T>
+        #endif
     {
         #ifndef SWIG
         BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
@@ -54,6 +67,17 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
             std::size_t getDimension( void ) const;
             ublas::matrix<T> getProject( void ) const;
         
+            #ifdef MACHINELEARNING_MPI
+            enum decomposition
+            {
+                scatter = 0,
+                tsqr    = 1
+            };
+        
+            void setDecomposition( const decomposition& );
+            ublas::matrix<T> map( const mpi::communicator&, const ublas::matrix<T>& );
+            #endif
+        
         
         private :
             
@@ -62,6 +86,13 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
             /** matrix with project vectors **/
             ublas::matrix<T> m_project;
         
+            #ifdef MACHINELEARNING_MPI
+            /** decomposition of the MPI method **/
+            decomposition m_decomposition;
+        
+            static ublas::matrix<T> getTSQR( const mpi::communicator&, const ublas::matrix<T>& );
+            #endif
+        
     };
     
     
@@ -72,6 +103,9 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
     template<typename T> inline pca<T>::pca( const std::size_t& p_dim ) :
         m_dim( p_dim ),
         m_project()
+        #ifdef MACHINELEARNING_MPI
+        , m_decomposition( scatter )
+        #endif
     {
         if (p_dim == 0)
             throw exception::runtime(_("dimension must be greater than zero"), *this);
@@ -134,5 +168,132 @@ namespace machinelearning { namespace dimensionreduce { namespace nonsupervised
         return ublas::prod(l_center, m_project);
     }
     
+    
+    
+    //======= MPI ==================================================================================================================================
+    #ifdef MACHINELEARNING_MPI
+    
+    /** sets the decomposition of the MPI method
+     * @param p_decomposition decomposition type (scatter matrix or TSQR)
+     **/
+    template<typename T> inline void pca<T>::setDecomposition( const decomposition& p_decomposition )
+    {
+        m_decomposition = p_decomposition;
+    }
+    
+    
+    /** creates the triangular factor R of the data of all processes (communication-avoiding QR).
+     * Each process factorizes its rows, the triangular factors are stacked pairwise along a binary
+     * tree and factorized again, so R^t * R is the scatter matrix of all rows
+     * @param p_mpi MPI object for communication
+     * @param p_data rows of the process
+     * @return dxd triangular matrix (equal on each process)
+     **/
+    template<typename T> inline ublas::matrix<T> pca<T>::getTSQR( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data )
+    {
+        const std::size_t l_dim = p_data.size2();
+        
+        // processes with less rows than columns get a triangular factor with zero rows
+        ublas::matrix<T> l_triangular( l_dim, l_dim, 0 );
+        if (p_data.size1() > 0) {
+            const ublas::matrix<T> l_local = tools::lapack::qr( p_data );
+            ublas::subrange( l_triangular, 0, l_local.size1(), 0, l_dim ) = l_local;
+        }
+        
+        ublas::matrix<T> l_stack( 2*l_dim, l_dim );
+        ublas::matrix<T> l_receive( l_dim, l_dim );
+        for(int i=1; i < p_mpi.size(); i *= 2) {
+            
+            if (p_mpi.rank() % (2*i) == i) {
+                MPI_Send( l_triangular.data().begin(), static_cast<int>(l_dim * l_dim), mpi::get_mpi_datatype<T>(T()), p_mpi.rank()-i, 0, p_mpi );
+                break;
+            }
+            
+            if (p_mpi.rank() + i < p_mpi.size()) {
+                MPI_Recv( l_receive.data().begin(), static_cast<int>(l_dim * l_dim), mpi::get_mpi_datatype<T>(T()), p_mpi.rank()+i, 0, p_mpi, MPI_STATUS_IGNORE );
+                
+                ublas::subrange( l_stack, 0, l_dim, 0, l_dim )       = l_triangular;
+                ublas::subrange( l_stack, l_dim, 2*l_dim, 0, l_dim ) = l_receive;
+                l_triangular = tools::lapack::qr( l_stack );
+            }
+        }
+        
+        MPI_Bcast( l_triangular.data().begin(), static_cast<int>(l_dim * l_dim), mpi::get_mpi_datatype<T>(T()), 0, p_mpi );
+        return l_triangular;
+    }
+    
+    
+    /** caluate and project the input data of all processes
+     * @param p_mpi MPI object for communication
+     * @param p_data rows of the process
+     * @return projected rows of the process
+    **/
+    template<typename T> inline ublas::matrix<T> pca<T>::map( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data )
+    {
+        // the dimension is agreed before it is checked, so all processes throw together,
+        // processes without rows can pass a matrix with any number of columns
+        const std::size_t l_dim = mpi::all_reduce(p_mpi, p_data.size2(), mpi::maximum<std::size_t>());
+        if (!mpi::all_reduce(p_mpi, (p_data.size1() == 0) || (p_data.size2() == l_dim), std::multiplies<bool>()))
+            throw exception::runtime(_("data dimension must be equal on each process"), *this);
+        if (l_dim <= m_dim)
+            throw exception::runtime(_("datapoint dimension are less than target dimension"), *this);
+        
+        ublas::matrix<T> l_center( (p_data.size1() > 0) ? p_data : ublas::matrix<T>(0, l_dim) );
+        
+        // the column sums and the number of rows are reduced together
+        ublas::vector<T> l_sum( l_dim+1 );
+        ublas::subrange( l_sum, 0, l_dim ) = tools::matrix::sum( l_center, tools::matrix::column );
+        l_sum(l_dim) = static_cast<T>( l_center.size1() );
+        MPI_Allreduce( MPI_IN_PLACE, l_sum.data().begin(), static_cast<int>(l_sum.size()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
+        
+        if (tools::function::isNumericalZero(l_sum(l_dim)))
+            throw exception::runtime(_("row size must be greater than zero"), *this);
+        
+        // centering the data with the mean of all processes
+        const ublas::vector<T> l_mean = ublas::subrange( l_sum, 0, l_dim ) / l_sum(l_dim);
+        #pragma omp parallel for shared(l_center)
+        for(std::size_t i=0; i < l_center.size1(); ++i)
+            ublas::row(l_center, i) -= l_mean;
+        
+        // calculate the eigenvalues & -vectors of the scatter matrix, the scaling of the
+        // covariance is not needed, because only the eigenvectors are used
+        ublas::vector<T> l_eigenvalues;
+        ublas::matrix<T> l_eigenvectors;
+        
+        switch (m_decomposition) {
+                
+            case scatter : {
+                ublas::matrix<T> l_scatter = ublas::prod( ublas::trans(l_center), l_center );
+                MPI_Allreduce( MPI_IN_PLACE, l_scatter.data().begin(), static_cast<int>(l_scatter.size1() * l_scatter.size2()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
+                
+                tools::lapack::eigen<T>(l_scatter, l_eigenvalues, l_eigenvectors);
+                break;
+            }
+                
+            // the right singular vectors of R are the eigenvectors of R^t * R
+            case tsqr : {
+                ublas::matrix<T> l_left;
+                tools::lapack::svd<T>( getTSQR(p_mpi, l_center), l_eigenvalues, l_left, l_eigenvectors );
+                l_eigenvalues = ublas::element_prod( l_eigenvalues, l_eigenvalues );
+                break;
+            }
+                
+            default :
+                throw exception::runtime(_("decomposition option is unkown"), *this);
+        }
+        
+        // rank the eigenvalues
+        const ublas::indirect_array<> l_rank = tools::vector::rankIndex( l_eigenvalues );
+        
+        // create projection (largest eigenvectors correspondends with the largest eigenvalues -> last values in rank)
+        m_project = ublas::matrix<T>( l_eigenvectors.size2(), m_dim );
+        for(std::size_t i=0; i < m_dim; ++i)
+            ublas::column(m_project, i) = ublas::column(l_eigenvectors, l_rank(l_rank.size()-i-1));
+        
+        return ublas::prod(l_center, m_project);
+    }
+    
+    #endif
+    
 }}}
 #endif
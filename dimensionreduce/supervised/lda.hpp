@@ -29,7 +29,12 @@
 
 #include <map>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
 #include <boost/numeric/ublas/vector.hpp>
+#ifdef MACHINELEARNING_MPI
+#include <boost/serialization/vector.hpp>
+#endif
 
 #include "reduce.hpp"
 #include "../../errorhandling/exception.hpp"
@@ -40,11 +45,21 @@ namespace machinelearning { namespace dimensionreduce { namespace supervised {
     
     #ifndef SWIG
     namespace ublas  = boost::numeric::ublas;
+    #ifdef MACHINELEARNING_MPI
+    namespace mpi    = boost::mpi;
+    #endif
     #endif
     
     
-    /** class for projection the (Fisher) lineare discriminant analysis (LDA) **/
+    /** class for projection the (Fisher) lineare discriminant analysis (LDA)
+     * @note On the MPI method each process holds a block of rows. The mean, the scatter matrix,
+     * the sum and the size of each class are summed over all processes, so each process can
+     * create the between- and within-class matrices and solve the small eigen problem
+     **/
     template<typename T, typename L> class lda : public reduce<T,L>
+        #ifdef MACHINELEARNING_MPI
+        , public reducempi<T,L>
+        #endif
     {
         
         public :
@@ -54,6 +69,10 @@ namespace machinelearning { namespace dimensionreduce { namespace supervised {
             std::size_t getDimension( void ) const;
             ublas::matrix<T> getProject( void ) const;
         
+            #ifdef MACHINELEARNING_MPI
+            ublas::matrix<T> map( const mpi::communicator&, const ublas::matrix<T>&, const std::vector<L>& );
+            #endif
+        
         
         private :
         
@@ -121,7 +140,7 @@ namespace machinelearning { namespace dimensionreduce { namespace supervised {
 
         // calculate covarianz for every class and all data
         ublas::matrix<T> l_sb = tools::matrix::cov(l_center);
-        ublas::matrix<T> l_sw(l_sb.size1(), l_sb.size2());
+        ublas::matrix<T> l_sw(l_sb.size1(), l_sb.size2(), 0);
         const T l_classes = static_cast<T>(l_uniquelabel.size()-1);
     
         #pragma omp parallel for shared(l_uniquelabel, l_sw)
@@ -158,6 +177,119 @@ namespace machinelearning { namespace dimensionreduce { namespace supervised {
         return ublas::prod(p_data, m_project);
     }
     
+    
+    
+    //======= MPI ==================================================================================================================================
+    #ifdef MACHINELEARNING_MPI
+    
+    /** caluate and project the input data of all processes
+     * @param p_mpi MPI object for communication
+     * @param p_data rows of the process
+     * @param p_label labeling for matrix rows
+     * @return matrix with mapped points of the process
+     **/
+    template<typename T, typename L> inline ublas::matrix<T> lda<T, L>::map( const mpi::communicator& p_mpi, const ublas::matrix<T>& p_data, const std::vector<L>& p_label )
+    {
+        // all checks are reduced, so all processes throw together
+        if (!mpi::all_reduce(p_mpi, p_data.size1() == p_label.size(), std::multiplies<bool>()))
+            throw exception::runtime(_("matrix rows and label size are not equal"), *this);
+        if (mpi::all_reduce(p_mpi, p_data.size2(), mpi::maximum<std::size_t>()) != mpi::all_reduce(p_mpi, p_data.size2(), mpi::minimum<std::size_t>()))
+            throw exception::runtime(_("data dimension must be equal on each process"), *this);
+        
+        // create a unique label vector of all processes
+        std::vector< std::vector<L> > l_processlabel;
+        mpi::all_gather(p_mpi, tools::vector::unique<L>(p_label), l_processlabel);
+        
+        std::vector<L> l_uniquelabel;
+        for(std::size_t i=0; i < l_processlabel.size(); ++i)
+            l_uniquelabel.insert( l_uniquelabel.end(), l_processlabel[i].begin(), l_processlabel[i].end() );
+        l_uniquelabel = tools::vector::unique<L>(l_uniquelabel);
+        
+        // we can only reduce to length(classes)-1
+        if (m_dim >= l_uniquelabel.size())
+            throw exception::runtime(_("target dimension must be less than unique data classes"), *this);
+        
+        
+        // centering the data with the mean of all processes (column sums and number of rows are reduced together)
+        const std::size_t l_dim = p_data.size2();
+        ublas::vector<T> l_sum( l_dim+1 );
+        ublas::subrange( l_sum, 0, l_dim ) = tools::matrix::sum( p_data, tools::matrix::column );
+        l_sum(l_dim) = static_cast<T>( p_data.size1() );
+        MPI_Allreduce( MPI_IN_PLACE, l_sum.data().begin(), static_cast<int>(l_sum.size()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
+        
+        const ublas::vector<T> l_mean = ublas::subrange( l_sum, 0, l_dim ) / l_sum(l_dim);
+        ublas::matrix<T> l_center( p_data );
+        #pragma omp parallel for shared(l_center)
+        for(std::size_t i=0; i < l_center.size1(); ++i)
+            ublas::row(l_center, i) -= l_mean;
+        
+        // we create a map for indexing the rows of the matrix with their labels
+        std::multimap<L, std::size_t> l_index;
+        for(std::size_t i=0; i < p_label.size(); ++i)
+            l_index.insert( std::make_pair(p_label[i], i) );
+        
+        
+        // each row of the buffer holds the scatter matrix (row-major), the sum and the size of one class
+        ublas::matrix<T> l_buffer( l_uniquelabel.size(), l_dim*l_dim + l_dim + 1, 0 );
+        
+        #pragma omp parallel for shared(l_uniquelabel, l_buffer)
+        for(std::size_t i=0; i < l_uniquelabel.size(); ++i) {
+            
+            std::size_t n=0;
+            ublas::matrix<T> l_cluster(  std::distance(l_index.lower_bound(l_uniquelabel[i]), l_index.upper_bound(l_uniquelabel[i])),  l_center.size2()  );
+            for( typename std::multimap<L, std::size_t>::iterator it = l_index.lower_bound(l_uniquelabel[i]); it != l_index.upper_bound(l_uniquelabel[i]); ++it )
+                ublas::row(l_cluster, n++) = ublas::row(l_center, it->second);
+            
+            if (l_cluster.size1() == 0)
+                continue;
+            
+            const ublas::matrix<T> l_scatter = ublas::prod( ublas::trans(l_cluster), l_cluster );
+            const ublas::vector<T> l_clustersum = tools::matrix::sum( l_cluster, tools::matrix::column );
+            for(std::size_t j=0; j < l_dim; ++j) {
+                for(std::size_t k=0; k < l_dim; ++k)
+                    l_buffer(i, j*l_dim+k) = l_scatter(j,k);
+                l_buffer(i, l_dim*l_dim+j) = l_clustersum(j);
+            }
+            l_buffer(i, l_dim*l_dim+l_dim) = static_cast<T>( l_cluster.size1() );
+        }
+        
+        MPI_Allreduce( MPI_IN_PLACE, l_buffer.data().begin(), static_cast<int>(l_buffer.size1() * l_buffer.size2()), mpi::get_mpi_datatype<T>(T()), MPI_SUM, p_mpi );
+        
+        
+        // calculate covarianz for every class and all data (the column sum of the centered data is zero)
+        ublas::matrix<T> l_sb(l_dim, l_dim, 0);
+        ublas::matrix<T> l_sw(l_dim, l_dim, 0);
+        const T l_classes = static_cast<T>(l_uniquelabel.size()-1);
+        
+        for(std::size_t i=0; i < l_uniquelabel.size(); ++i) {
+            const T l_size = l_buffer(i, l_dim*l_dim+l_dim);
+            
+            for(std::size_t j=0; j < l_dim; ++j)
+                for(std::size_t k=0; k < l_dim; ++k) {
+                    l_sb(j,k) += l_buffer(i, j*l_dim+k);
+                    l_sw(j,k) += l_size / l_classes * (l_buffer(i, j*l_dim+k) - l_buffer(i, l_dim*l_dim+j) * l_buffer(i, l_dim*l_dim+k) / l_size) / (l_size-1);
+                }
+        }
+        l_sb /= l_sum(l_dim)-1;
+        
+        // calculate the eigenvalues & -vectors
+        ublas::vector<T> l_eigenvalues;
+        ublas::matrix<T> l_eigenvectors;
+        ublas::matrix<T> l_sdiff = l_sb-l_sw;
+        tools::lapack::eigen<T>(l_sdiff, l_sw, l_eigenvalues, l_eigenvectors);
+        
+        // rank the eigenvalues
+        const ublas::indirect_array<> l_rank = tools::vector::rankIndex( l_eigenvalues );
+        
+        // create projection (largest eigenvectors correspondends with the largest eigenvalues -> last values in rank)
+        m_project = ublas::matrix<T>( l_eigenvectors.size2(), m_dim );
+        for(std::size_t i=0; i < m_dim; ++i)
+            ublas::column(m_project, i) = ublas::column(l_eigenvectors, l_rank(l_rank.size()-i-1));
+        
+        return ublas::prod(p_data, m_project);
+    }
+    
+    #endif
 
 
 }}}
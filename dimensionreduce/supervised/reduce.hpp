@@ -44,6 +44,9 @@ namespace machinelearning { namespace dimensionreduce {
         
         #ifndef SWIG
         namespace ublas = boost::numeric::ublas;
+        #ifdef MACHINELEARNING_MPI
+        namespace mpi   = boost::mpi;
+        #endif
         #endif
         
         
@@ -65,6 +68,23 @@ namespace machinelearning { namespace dimensionreduce {
             
         };
         
+        
+        #ifdef MACHINELEARNING_MPI
+        
+        /** abstract class for supervised dimension reducing classes with MPI support **/      
+        template<typename T, typename L> class reducempi
+        {
+            BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+            
+            
+            public :
+            
+                /** maps data to target dimension **/
+                virtual ublas::matrix<T> map( const mpi::communicator&, const ublas::matrix<T>&, const std::vector<L>& ) = 0;
+            
+        };
+        
+        #endif
     }
         
 } }
@@ -0,0 +1,107 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+#ifndef __MACHINELEARNING_DISTANCES_DISSIMILARITY_HPP
+#define __MACHINELEARNING_DISTANCES_DISSIMILARITY_HPP
+
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
+
+#include "../errorhandling/exception.hpp"
+#include "../tools/language/language.h"
+
+
+
+namespace machinelearning { namespace distances {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** abstract class for a (symmetric) dissimilarity matrix, that is not stored
+     * in memory. Relational algorithms request only the entries which they need
+     * through this callback, so the full N x N matrix must not be materialised.
+     * The row and block accessors are build on the columns, a derived class can
+     * overload them, if it can create the entries in a faster way
+     **/
+    template<typename T> class dissimilarity
+    {
+        #ifndef SWIG
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        #endif
+        
+        
+        public :
+        
+            virtual ~dissimilarity( void ) {}
+        
+            /** returns the number of objects (rows / columns of the dissimilarity matrix) **/
+            virtual std::size_t size( void ) const = 0;
+        
+            /** returns a column of the dissimilarity matrix (the dissimilarities of one object to all other objects) **/
+            virtual ublas::vector<T> getColumn( const std::size_t& ) const = 0;
+        
+            virtual ublas::vector<T> getRow( const std::size_t& ) const;
+            virtual ublas::matrix<T> getBlock( const std::size_t&, const std::size_t&, const std::size_t&, const std::size_t& ) const;
+        
+    };
+    
+    
+    
+    /** returns a row of the dissimilarity matrix, the matrix is symmetric, so the row is equal to the column
+     * @param p_row row index
+     * @return row vector
+     **/
+    template<typename T> inline ublas::vector<T> dissimilarity<T>::getRow( const std::size_t& p_row ) const
+    {
+        return getColumn( p_row );
+    }
+    
+    
+    /** returns a block of the dissimilarity matrix
+     * @param p_rowbegin first row
+     * @param p_rowend row behind the last row
+     * @param p_colbegin first column
+     * @param p_colend column behind the last column
+     * @return block matrix
+     **/
+    template<typename T> inline ublas::matrix<T> dissimilarity<T>::getBlock( const std::size_t& p_rowbegin, const std::size_t& p_rowend, const std::size_t& p_colbegin, const std::size_t& p_colend ) const
+    {
+        if ((p_rowbegin > p_rowend) || (p_colbegin > p_colend) || (p_rowend > size()) || (p_colend > size()))
+            throw exception::runtime(_("block range is not valid"), *this);
+        
+        ublas::matrix<T> l_block( p_rowend-p_rowbegin, p_colend-p_colbegin );
+        for(std::size_t j=p_colbegin; j < p_colend; ++j)
+            ublas::column(l_block, j-p_colbegin) = ublas::subrange( getColumn(j), p_rowbegin, p_rowend );
+        
+        return l_block;
+    }
+    
+} }
+#endif
@@ -0,0 +1,626 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+#ifndef __MACHINELEARNING_DISTANCES_DISSIMILARITYCACHE_HPP
+#define __MACHINELEARNING_DISTANCES_DISSIMILARITYCACHE_HPP
+
+#include <map>
+#include <set>
+#include <list>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <fstream>
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include <boost/numeric/ublas/vector_proxy.hpp>
+
+#include "dissimilarity.hpp"
+#include "ncd.hpp"
+#include "../errorhandling/exception.hpp"
+#include "../tools/language/language.h"
+
+
+
+namespace machinelearning { namespace distances {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class of a dissimilarity matrix, that is created on demand in square tiles. A tile is created
+     * on the first access by a tile function (eg a user callback or the normalized compression distance)
+     * and is stored in a cache with a fixed memory size. If the cache is full, the least recently used
+     * tile is removed, optionally the removed tiles are written to a spill directory, so they are read
+     * from disk and must not be created again. On a symmetric matrix only the tiles of the upper triangle
+     * are created, the lower tiles are the transposed upper tiles. A row / column reads the cached tiles
+     * and calls the tile function only for the requested elements of the other tiles, so sampling single
+     * columns (eg Nyström landmarks) does not create the whole tile band
+     * @note the accessors can be called from different threads, the tile function is called without
+     * the lock, so it must be thread-safe. A thread, that needs a tile, which is created by another
+     * thread, waits for it, so each tile is created once
+     **/
+    template<typename T> class dissimilaritycache : public dissimilarity<T>
+    {
+        
+        public :
+        
+            #ifndef SWIG
+            /** type of the tile function, that creates the block [rowbegin, rowend) x [columnbegin, columnend) **/
+            typedef boost::function<ublas::matrix<T> (const std::size_t&, const std::size_t&, const std::size_t&, const std::size_t&)> tilefunction;
+        
+            dissimilaritycache( const std::size_t&, const tilefunction&, const bool& = true, const std::size_t& = 256, const std::size_t& = 268435456 );
+            #endif
+            dissimilaritycache( const ncd<T>&, const std::vector<std::string>&, const bool& = false, const std::size_t& = 256, const std::size_t& = 268435456 );
+            ~dissimilaritycache( void );
+            void setSpill( const std::string& );
+            std::string getSpill( void ) const;
+            std::size_t size( void ) const;
+            std::size_t getTileSize( void ) const;
+            std::size_t getCachedTiles( void ) const;
+            std::size_t getCreatedTiles( void ) const;
+            void clear( void );
+            T get( const std::size_t&, const std::size_t& ) const;
+            ublas::vector<T> getColumn( const std::size_t& ) const;
+            ublas::vector<T> getRow( const std::size_t& ) const;
+            ublas::matrix<T> getBlock( const std::size_t&, const std::size_t&, const std::size_t&, const std::size_t& ) const;
+        
+        
+        private :
+        
+            /** index of a tile (row, column) **/
+            typedef std::pair<std::size_t, std::size_t> tileindex;
+        
+            /** cached tile **/
+            struct tile
+            {
+                /** data of the tile **/
+                ublas::matrix<T> data;
+                /** position within the usage list **/
+                typename std::list<tileindex>::iterator position;
+            };
+        
+        
+            /** number of objects **/
+            const std::size_t m_size;
+            /** tile function **/
+            const tilefunction m_function;
+            /** flag for a symmetric matrix **/
+            const bool m_symmetric;
+            /** number of rows / columns of a tile **/
+            const std::size_t m_tilesize;
+            /** maximum number of cached tiles **/
+            const std::size_t m_maxtiles;
+            /** spill directory (empty for no spill) **/
+            std::string m_spill;
+            /** cached tiles **/
+            mutable std::map<tileindex, tile> m_tiles;
+            /** usage list of the tiles (the front is the last used tile) **/
+            mutable std::list<tileindex> m_usage;
+            /** tiles, that are written to the spill directory **/
+            mutable std::set<tileindex> m_spilled;
+            /** tiles, that are created by a thread at the moment **/
+            mutable std::set<tileindex> m_inflight;
+            /** number of created tiles **/
+            mutable std::size_t m_created;
+            /** mutex of the cache **/
+            mutable boost::mutex m_mutex;
+            /** condition, that is notified if a tile is created **/
+            mutable boost::condition_variable m_condition;
+        
+            dissimilaritycache( const dissimilaritycache& );
+            dissimilaritycache& operator=( const dissimilaritycache& );
+            const ublas::matrix<T>& getTile( const tileindex&, boost::unique_lock<boost::mutex>& ) const;
+            ublas::matrix<T> createTile( const tileindex&, const std::string& ) const;
+            ublas::vector<T> getVector( const std::size_t&, const bool& ) const;
+            ublas::vector<T> createVector( const std::size_t&, const bool&, const std::size_t&, const std::size_t& ) const;
+            void removeTile( void ) const;
+            void removeSpill( void );
+            std::string getSpillFile( const tileindex& ) const;
+            static std::size_t getMaxTiles( const std::size_t&, const std::size_t& );
+            static ublas::matrix<T> getNCDTile( const ncd<T>&, const std::vector<std::string>&, const bool&, const std::size_t&, const std::size_t&, const std::size_t&, const std::size_t& );
+        
+    };
+    
+    
+    
+    /** constructor with a tile function
+     * @param p_size number of objects
+     * @param p_function tile function
+     * @param p_symmetric flag for a symmetric matrix
+     * @param p_tilesize number of rows / columns of a tile
+     * @param p_cachesize maximum memory of the cached tiles in bytes (at least one tile is cached)
+     **/
+    template<typename T> inline dissimilaritycache<T>::dissimilaritycache( const std::size_t& p_size, const tilefunction& p_function, const bool& p_symmetric, const std::size_t& p_tilesize, const std::size_t& p_cachesize ) :
+        m_size( p_size ),
+        m_function( p_function ),
+        m_symmetric( p_symmetric ),
+        m_tilesize( p_tilesize ),
+        m_maxtiles( getMaxTiles(p_tilesize, p_cachesize) ),
+        m_spill(),
+        m_tiles(),
+        m_usage(),
+        m_spilled(),
+        m_inflight(),
+        m_created( 0 ),
+        m_mutex(),
+        m_condition()
+    {
+        if (p_size == 0)
+            throw exception::runtime(_("number of objects must be greater than zero"), *this);
+        if (p_tilesize == 0)
+            throw exception::runtime(_("tile size must be greater than zero"), *this);
+        if (!p_function)
+            throw exception::runtime(_("tile function must be set"), *this);
+    }
+    
+    
+    /** constructor with the normalized compression distance, the matrix is symmetric, so the
+     * distance of two objects is the compression of the object with the lower index concatenated
+     * with the object with the higher index
+     * @param p_ncd NCD object
+     * @param p_data strings or filenames
+     * @param p_isfile parameter for interpreting the strings as files
+     * @param p_tilesize number of rows / columns of a tile
+     * @param p_cachesize maximum memory of the cached tiles in bytes (at least one tile is cached)
+     **/
+    template<typename T> inline dissimilaritycache<T>::dissimilaritycache( const ncd<T>& p_ncd, const std::vector<std::string>& p_data, const bool& p_isfile, const std::size_t& p_tilesize, const std::size_t& p_cachesize ) :
+        m_size( p_data.size() ),
+        m_function( boost::bind( &dissimilaritycache<T>::getNCDTile, p_ncd, p_data, p_isfile, _1, _2, _3, _4 ) ),
+        m_symmetric( true ),
+        m_tilesize( p_tilesize ),
+        m_maxtiles( getMaxTiles(p_tilesize, p_cachesize) ),
+        m_spill(),
+        m_tiles(),
+        m_usage(),
+        m_spilled(),
+        m_inflight(),
+        m_created( 0 ),
+        m_mutex(),
+        m_condition()
+    {
+        if (p_data.size() == 0)
+            throw exception::runtime(_("number of objects must be greater than zero"), *this);
+        if (p_tilesize == 0)
+            throw exception::runtime(_("tile size must be greater than zero"), *this);
+    }
+    
+    
+    /** destructor, that removes the spill files **/
+    template<typename T> inline dissimilaritycache<T>::~dissimilaritycache( void )
+    {
+        removeSpill();
+    }
+    
+    
+    /** sets the spill directory, the files of the previous directory are removed
+     * @param p_directory directory (empty for no spill)
+     **/
+    template<typename T> inline void dissimilaritycache<T>::setSpill( const std::string& p_directory )
+    {
+        boost::lock_guard<boost::mutex> l_lock(m_mutex);
+        
+        removeSpill();
+        m_spill = p_directory;
+    }
+    
+    
+    /** returns the spill directory
+     * @return directory (empty for no spill)
+     **/
+    template<typename T> inline std::string dissimilaritycache<T>::getSpill( void ) const
+    {
+        boost::lock_guard<boost::mutex> l_lock(m_mutex);
+        return m_spill;
+    }
+    
+    
+    /** returns the number of objects
+     * @return number of rows / columns
+     **/
+    template<typename T> inline std::size_t dissimilaritycache<T>::size( void ) const
+    {
+        return m_size;
+    }
+    
+    
+    /** returns the tile size
+     * @return number of rows / columns of a tile
+     **/
+    template<typename T> inline std::size_t dissimilaritycache<T>::getTileSize( void ) const
+    {
+        return m_tilesize;
+    }
+    
+    
+    /** returns the number of cached tiles
+     * @return number of tiles
+     **/
+    template<typename T> inline std::size_t dissimilaritycache<T>::getCachedTiles( void ) const
+    {
+        boost::lock_guard<boost::mutex> l_lock(m_mutex);
+        return m_tiles.size();
+    }
+    
+    
+    /** returns the number of tiles, that are created by the tile function (the elements
+     * of the row / column calls are not counted)
+     * @return number of created tiles
+     **/
+    template<typename T> inline std::size_t dissimilaritycache<T>::getCreatedTiles( void ) const
+    {
+        boost::lock_guard<boost::mutex> l_lock(m_mutex);
+        return m_created;
+    }
+    
+    
+    /** removes all cached and spilled tiles **/
+    template<typename T> inline void dissimilaritycache<T>::clear( void )
+    {
+        boost::lock_guard<boost::mutex> l_lock(m_mutex);
+        
+        m_tiles.clear();
+        m_usage.clear();
+        removeSpill();
+    }
+    
+    
+    /** returns an element of the matrix
+     * @param p_row row index
+     * @param p_col column index
+     * @return dissimilarity
+     **/
+    template<typename T> inline T dissimilaritycache<T>::get( const std::size_t& p_row, const std::size_t& p_col ) const
+    {
+        return getBlock( p_row, p_row+1, p_col, p_col+1 )(0, 0);
+    }
+    
+    
+    /** returns a column of the matrix
+     * @param p_col column index
+     * @return column vector
+     **/
+    template<typename T> inline ublas::vector<T> dissimilaritycache<T>::getColumn( const std::size_t& p_col ) const
+    {
+        return getVector( p_col, true );
+    }
+    
+    
+    /** returns a row of the matrix
+     * @param p_row row index
+     * @return row vector
+     **/
+    template<typename T> inline ublas::vector<T> dissimilaritycache<T>::getRow( const std::size_t& p_row ) const
+    {
+        return getVector( p_row, false );
+    }
+    
+    
+    /** returns a block of the matrix, the block is copied from the overlapping tiles
+     * @param p_rowbegin first row
+     * @param p_rowend row behind the last row
+     * @param p_colbegin first column
+     * @param p_colend column behind the last column
+     * @return block matrix
+     **/
+    template<typename T> inline ublas::matrix<T> dissimilaritycache<T>::getBlock( const std::size_t& p_rowbegin, const std::size_t& p_rowend, const std::size_t& p_colbegin, const std::size_t& p_colend ) const
+    {
+        if ((p_rowbegin >= p_rowend) || (p_colbegin >= p_colend) || (p_rowend > m_size) || (p_colend > m_size))
+            throw exception::runtime(_("block range is not valid"), *this);
+        
+        ublas::matrix<T> l_block( p_rowend-p_rowbegin, p_colend-p_colbegin );
+        
+        boost::unique_lock<boost::mutex> l_lock(m_mutex);
+        for(std::size_t i=p_rowbegin / m_tilesize; i*m_tilesize < p_rowend; ++i)
+            for(std::size_t j=p_colbegin / m_tilesize; j*m_tilesize < p_colend; ++j) {
+                
+                // range of the block within the tile (i,j)
+                const std::size_t l_rowbegin = std::max(p_rowbegin, i*m_tilesize);
+                const std::size_t l_rowend   = std::min(p_rowend, (i+1)*m_tilesize);
+                const std::size_t l_colbegin = std::max(p_colbegin, j*m_tilesize);
+                const std::size_t l_colend   = std::min(p_colend, (j+1)*m_tilesize);
+                
+                ublas::matrix_range< ublas::matrix<T> > l_target( l_block, ublas::range(l_rowbegin-p_rowbegin, l_rowend-p_rowbegin), ublas::range(l_colbegin-p_colbegin, l_colend-p_colbegin) );
+                
+                // the tiles of the lower triangle are the transposed tiles of the upper triangle
+                if (m_symmetric && (i > j))
+                    l_target = ublas::trans( ublas::subrange( getTile(tileindex(j, i), l_lock), l_colbegin-j*m_tilesize, l_colend-j*m_tilesize, l_rowbegin-i*m_tilesize, l_rowend-i*m_tilesize ) );
+                else
+                    l_target = ublas::subrange( getTile(tileindex(i, j), l_lock), l_rowbegin-i*m_tilesize, l_rowend-i*m_tilesize, l_colbegin-j*m_tilesize, l_colend-j*m_tilesize );
+            }
+        
+        return l_block;
+    }
+    
+    
+    /** returns a row or a column, the elements of the cached tiles are copied, the other
+     * elements are created by the tile function without creating the tiles
+     * @param p_index row / column index
+     * @param p_column flag for a column
+     * @return vector
+     **/
+    template<typename T> inline ublas::vector<T> dissimilaritycache<T>::getVector( const std::size_t& p_index, const bool& p_column ) const
+    {
+        if (p_index >= m_size)
+            throw exception::runtime(_("index must be less than the number of objects"), *this);
+        
+        // the rows of a symmetric matrix are the columns
+        const bool l_column = p_column || m_symmetric;
+        const std::size_t l_tile = p_index / m_tilesize;
+        const std::size_t l_bands = (m_size + m_tilesize - 1) / m_tilesize;
+        
+        ublas::vector<T> l_vector( m_size );
+        std::vector<bool> l_cached( l_bands, false );
+        
+        {
+            boost::lock_guard<boost::mutex> l_lock(m_mutex);
+            for(std::size_t i=0; i < l_bands; ++i) {
+                
+                // the tiles of the lower triangle are the transposed tiles of the upper triangle
+                const bool l_transpose = m_symmetric && (i > l_tile);
+                const tileindex l_index = l_transpose ? tileindex(l_tile, i) : (l_column ? tileindex(i, l_tile) : tileindex(l_tile, i));
+                
+                typename std::map<tileindex, tile>::iterator l_found = m_tiles.find( l_index );
+                if (l_found == m_tiles.end())
+                    continue;
+                
+                m_usage.splice( m_usage.begin(), m_usage, l_found->second.position );
+                const ublas::matrix<T>& l_data = l_found->second.data;
+                for(std::size_t n=i*m_tilesize; n < std::min(m_size, (i+1)*m_tilesize); ++n)
+                    l_vector(n) = (l_column != l_transpose) ? l_data(n-i*m_tilesize, p_index-l_tile*m_tilesize) : l_data(p_index-l_tile*m_tilesize, n-i*m_tilesize);
+                
+                l_cached[i] = true;
+            }
+        }
+        
+        // the elements of consecutive tiles, that are not cached, are created together
+        for(std::size_t i=0; i < l_bands; ) {
+            if (l_cached[i]) {
+                ++i;
+                continue;
+            }
+            
+            std::size_t l_end = i+1;
+            while ((l_end < l_bands) && (!l_cached[l_end]))
+                ++l_end;
+            
+            const std::size_t l_begin = i*m_tilesize;
+            ublas::subrange( l_vector, l_begin, std::min(m_size, l_end*m_tilesize) ) = createVector( p_index, l_column, l_begin, std::min(m_size, l_end*m_tilesize) );
+            i = l_end;
+        }
+        
+        return l_vector;
+    }
+    
+    
+    /** creates elements of a row or a column with the tile function, on a symmetric matrix the
+     * elements below the diagonal are created with the upper triangle
+     * @param p_index row / column index
+     * @param p_column flag for a column
+     * @param p_begin first element
+     * @param p_end element behind the last element
+     * @return vector with the elements [begin, end)
+     **/
+    template<typename T> inline ublas::vector<T> dissimilaritycache<T>::createVector( const std::size_t& p_index, const bool& p_column, const std::size_t& p_begin, const std::size_t& p_end ) const
+    {
+        ublas::vector<T> l_vector( p_end-p_begin );
+        
+        // split of the range on the diagonal, the elements [begin, split) are created directly
+        const std::size_t l_split = m_symmetric ? std::max(p_begin, std::min(p_end, p_index+1)) : p_end;
+        
+        if (l_split > p_begin) {
+            const ublas::matrix<T> l_data = p_column ? m_function( p_begin, l_split, p_index, p_index+1 ) : m_function( p_index, p_index+1, p_begin, l_split );
+            if ( (l_data.size1() != (p_column ? l_split-p_begin : 1)) || (l_data.size2() != (p_column ? 1 : l_split-p_begin)) )
+                throw exception::runtime(_("tile size is not equal to the requested size"), *this);
+            
+            if (p_column)
+                ublas::subrange( l_vector, 0, l_split-p_begin ) = ublas::column(l_data, 0);
+            else
+                ublas::subrange( l_vector, 0, l_split-p_begin ) = ublas::row(l_data, 0);
+        }
+        
+        if (p_end > l_split) {
+            const ublas::matrix<T> l_data = m_function( p_index, p_index+1, l_split, p_end );
+            if ( (l_data.size1() != 1) || (l_data.size2() != p_end-l_split) )
+                throw exception::runtime(_("tile size is not equal to the requested size"), *this);
+            
+            ublas::subrange( l_vector, l_split-p_begin, p_end-p_begin ) = ublas::row(l_data, 0);
+        }
+        
+        return l_vector;
+    }
+    
+    
+    /** returns a tile, the tile is read from the cache, from the spill directory or is
+     * created by the tile function. The lock must be held, it is released while the tile
+     * is created, so other threads can access the cache. A tile, that is created by another
+     * thread, is waited for
+     * @param p_index tile index
+     * @param p_lock lock of the cache mutex
+     * @return reference to the tile, that is valid until the lock is released
+     **/
+    template<typename T> inline const ublas::matrix<T>& dissimilaritycache<T>::getTile( const tileindex& p_index, boost::unique_lock<boost::mutex>& p_lock ) const
+    {
+        for(;;) {
+            typename std::map<tileindex, tile>::iterator l_tile = m_tiles.find( p_index );
+            if (l_tile != m_tiles.end()) {
+                m_usage.splice( m_usage.begin(), m_usage, l_tile->second.position );
+                return l_tile->second.data;
+            }
+            
+            if (!m_inflight.count(p_index))
+                break;
+            m_condition.wait( p_lock );
+        }
+        
+        const std::string l_file = m_spilled.count(p_index) ? getSpillFile(p_index) : std::string();
+        m_inflight.insert( p_index );
+        
+        tile l_new;
+        try {
+            p_lock.unlock();
+            l_new.data = createTile( p_index, l_file );
+            p_lock.lock();
+        } catch (...) {
+            if (!p_lock.owns_lock())
+                p_lock.lock();
+            m_inflight.erase( p_index );
+            m_condition.notify_all();
+            throw;
+        }
+        
+        if (l_file.empty())
+            m_created++;
+        m_inflight.erase( p_index );
+        m_condition.notify_all();
+        
+        while (m_tiles.size() >= m_maxtiles)
+            removeTile();
+        
+        m_usage.push_front( p_index );
+        l_new.position = m_usage.begin();
+        
+        return m_tiles.insert( std::pair<tileindex, tile>(p_index, l_new) ).first->second.data;
+    }
+    
+    
+    /** creates a tile with the tile function or reads it from a spill file (the lock must not be held)
+     * @param p_index tile index
+     * @param p_file spill file (empty for the tile function)
+     * @return tile
+     **/
+    template<typename T> inline ublas::matrix<T> dissimilaritycache<T>::createTile( const tileindex& p_index, const std::string& p_file ) const
+    {
+        const std::size_t l_rowbegin = p_index.first * m_tilesize;
+        const std::size_t l_colbegin = p_index.second * m_tilesize;
+        const std::size_t l_rowend   = std::min(m_size, l_rowbegin + m_tilesize);
+        const std::size_t l_colend   = std::min(m_size, l_colbegin + m_tilesize);
+        
+        if (p_file.empty()) {
+            const ublas::matrix<T> l_tile = m_function( l_rowbegin, l_rowend, l_colbegin, l_colend );
+            if ((l_tile.size1() != l_rowend-l_rowbegin) || (l_tile.size2() != l_colend-l_colbegin))
+                throw exception::runtime(_("tile size is not equal to the requested size"), *this);
+            return l_tile;
+        }
+        
+        ublas::matrix<T> l_tile( l_rowend-l_rowbegin, l_colend-l_colbegin );
+        std::ifstream l_stream( p_file.c_str(), std::ifstream::in | std::ifstream::binary );
+        l_stream.read( reinterpret_cast<char*>(&(l_tile.data()[0])), static_cast<std::streamsize>(l_tile.size1() * l_tile.size2() * sizeof(T)) );
+        if (!l_stream)
+            throw exception::runtime(_("spilled tile can not be read"), *this);
+        
+        return l_tile;
+    }
+    
+    
+    /** removes the least recently used tile of the cache and writes it to the spill directory (the lock must be held) **/
+    template<typename T> inline void dissimilaritycache<T>::removeTile( void ) const
+    {
+        const tileindex l_index = m_usage.back();
+        typename std::map<tileindex, tile>::iterator l_tile = m_tiles.find( l_index );
+        
+        if ((!m_spill.empty()) && (!m_spilled.count(l_index))) {
+            std::ofstream l_stream( getSpillFile(l_index).c_str(), std::ofstream::out | std::ofstream::binary | std::ofstream::trunc );
+            l_stream.write( reinterpret_cast<const char*>(&(l_tile->second.data.data()[0])), static_cast<std::streamsize>(l_tile->second.data.size1() * l_tile->second.data.size2() * sizeof(T)) );
+            
+            // a tile, that can not be written, is created again on the next access
+            if (l_stream)
+                m_spilled.insert( l_index );
+        }
+        
+        m_tiles.erase( l_tile );
+        m_usage.pop_back();
+    }
+    
+    
+    /** removes all files of the spill directory (the lock must be held) **/
+    template<typename T> inline void dissimilaritycache<T>::removeSpill( void )
+    {
+        for(typename std::set<tileindex>::const_iterator it=m_spilled.begin(); it != m_spilled.end(); ++it)
+            std::remove( getSpillFile(*it).c_str() );
+        m_spilled.clear();
+    }
+    
+    
+    /** returns the filename of a spilled tile, the name contains the address of the object,
+     * so different objects can use the same directory
+     * @param p_index tile index
+     * @return filename
+     **/
+    template<typename T> inline std::string dissimilaritycache<T>::getSpillFile( const tileindex& p_index ) const
+    {
+        return m_spill + "/dissimilarity_" + boost::lexical_cast<std::string>(static_cast<const void*>(this)) + "_" + boost::lexical_cast<std::string>(p_index.first) + "_" + boost::lexical_cast<std::string>(p_index.second) + ".tile";
+    }
+    
+    
+    /** returns the maximum number of tiles of the cache
+     * @param p_tilesize number of rows / columns of a tile
+     * @param p_cachesize cache size in bytes
+     * @return number of tiles (at least one)
+     **/
+    template<typename T> inline std::size_t dissimilaritycache<T>::getMaxTiles( const std::size_t& p_tilesize, const std::size_t& p_cachesize )
+    {
+        if (p_tilesize == 0)
+            return 1;
+        
+        return std::max( static_cast<std::size_t>(1), p_cachesize / (p_tilesize * p_tilesize * sizeof(T)) );
+    }
+    
+    
+    /** tile function of the normalized compression distance
+     * @param p_ncd NCD object
+     * @param p_data strings or filenames
+     * @param p_isfile parameter for interpreting the strings as files
+     * @param p_rowbegin first row
+     * @param p_rowend row behind the last row
+     * @param p_colbegin first column
+     * @param p_colend column behind the last column
+     * @return tile
+     **/
+    template<typename T> inline ublas::matrix<T> dissimilaritycache<T>::getNCDTile( const ncd<T>& p_ncd, const std::vector<std::string>& p_data, const bool& p_isfile, const std::size_t& p_rowbegin, const std::size_t& p_rowend, const std::size_t& p_colbegin, const std::size_t& p_colend )
+    {
+        const std::vector<std::string> l_rows( p_data.begin()+p_rowbegin, p_data.begin()+p_rowend );
+        const std::vector<std::string> l_cols( p_data.begin()+p_colbegin, p_data.begin()+p_colend );
+        
+        ublas::matrix<T> l_tile = p_ncd.unsquare( l_rows, l_cols, p_isfile );
+        
+        // the diagonal tiles are symmetrized with the upper triangle (see constructor)
+        if (p_rowbegin == p_colbegin)
+            for(std::size_t i=0; i < l_tile.size1(); ++i)
+                for(std::size_t j=0; j < i; ++j)
+                    l_tile(i, j) = l_tile(j, i);
+        
+        return l_tile;
+    }
+    
+}}
+#endif
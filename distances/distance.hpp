@@ -25,9 +25,13 @@
 #ifndef __MACHINELEARNING_DISTANCES_DISTANCE_HPP
 #define __MACHINELEARNING_DISTANCES_DISTANCE_HPP
 
+#include <algorithm>
 #include <boost/static_assert.hpp>
+#include <boost/mpl/if.hpp>
+#include <boost/type_traits/is_abstract.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
 
 #include "../tools/tools.h"
 
@@ -97,6 +101,9 @@ namespace machinelearning { namespace distances {
                 /** distances between row / column vectors of matrix and  row / column vectors of the other matrix **/
                 virtual ublas::vector<T> getDistance( const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const = 0;
             
+                /** distances between each row / column vector of the matrix and each row / column vector of the other matrix **/
+                virtual ublas::matrix<T> getDistanceMatrix( const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            
             
                 #ifndef SWIG
                 /** weight distance between two vectors **/
@@ -110,9 +117,73 @@ namespace machinelearning { namespace distances {
             
                 /** distances between row / column vectors of matrix and  row / column of the weighted matrix **/
                 virtual ublas::vector<T> getWeightedDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const = 0;
+            
+                /** index of the nearest row vector of the matrix, each row is weighted with the row of the weighted matrix **/
+                virtual std::size_t getWeightedNearest( const ublas::matrix<T>&, const ublas::vector<T>&, const ublas::matrix<T>& ) const;
                 #endif
 
         };
+        
+        
+        
+        /** default implementation of the many-to-many distances, that calls the one-to-many distance
+         * for each row / column of the second matrix, the derived classes overload it with batch kernels
+         * @param p_first first matrix
+         * @param p_second second matrix
+         * @param p_row row / column option (default row)
+         * @return matrix with the distances (first rows x second rows or first columns x second columns)
+         **/
+        template<typename T> inline ublas::matrix<T> distance<T>::getDistanceMatrix( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, const tools::matrix::rowtype& p_row ) const
+        {
+            ublas::matrix<T> l_distance;
+            
+            switch (p_row) {
+                case tools::matrix::row :
+                    
+                    l_distance.resize( p_first.size1(), p_second.size1(), false );
+                    for(std::size_t i=0; i < p_second.size1(); ++i)
+                        ublas::column(l_distance, i) = getDistance( p_first, static_cast< ublas::vector<T> >(ublas::row(p_second, i)), tools::matrix::row );
+                    break;
+                    
+                    
+                case tools::matrix::column :
+                    
+                    l_distance.resize( p_first.size2(), p_second.size2(), false );
+                    for(std::size_t i=0; i < p_second.size2(); ++i)
+                        ublas::column(l_distance, i) = getDistance( p_first, static_cast< ublas::vector<T> >(ublas::column(p_second, i)), tools::matrix::column );
+                    break;
+            }
+            
+            return l_distance;
+        }
+        
+        
+        #ifndef SWIG
+        /** default implementation of the weighted nearest row, that calculates the weighted distances of all rows
+         * and returns the index of the minimum, the derived classes overload it with a running minimum of the kernel
+         * @param p_matrix matrix
+         * @param p_vec vector
+         * @param p_weight weight matrix (one row for each row of the matrix)
+         * @return row index of the nearest row
+         **/
+        template<typename T> inline std::size_t distance<T>::getWeightedNearest( const ublas::matrix<T>& p_matrix, const ublas::vector<T>& p_vec, const ublas::matrix<T>& p_weight ) const
+        {
+            const ublas::vector<T> l_distance = getWeightedDistance( p_matrix, p_vec, p_weight, tools::matrix::row );
+            return static_cast<std::size_t>( std::min_element(l_distance.begin(), l_distance.end()) - l_distance.begin() );
+        }
+        #endif
+        
+        
+        
+        /** distance policy for the algorithm classes, that are templated over the distance type.
+         * The abstract distance is stored as reference, so all calls are dispatched at runtime.
+         * A concrete distance class is stored as copy, so the compiler knows the dynamic type,
+         * binds the calls at compile time and can inline them into the loops
+         **/
+        template<typename D> struct policy
+        {
+            typedef typename boost::mpl::if_< boost::is_abstract<D>, const D&, const D >::type type;
+        };
 
 } }
 #endif
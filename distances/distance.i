@@ -44,6 +44,7 @@
 %typemap(javaout)            ublas::vector<double> machinelearning::distances::distance<double>::getAbs           ";"
 %typemap(javaout)            double machinelearning::distances::distance<double>::getDistance                     ";"
 %typemap(javaout)            ublas::vector<double> machinelearning::distances::distance<double>::getDistance      ";"
+%typemap(javaout)            ublas::matrix<double> machinelearning::distances::distance<double>::getDistanceMatrix ";"
 #endif
 
 
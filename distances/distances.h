@@ -41,8 +41,15 @@ namespace machinelearning {
 }
         
 
+#include "kernel.hpp"
 #include "distance.hpp"
+#include "dissimilarity.hpp"
 #include "ncd.hpp"
+#include "dissimilaritycache.hpp"
 #include "norm/euclid.hpp"
+#include "norm/manhattan.hpp"
+#include "norm/chebyshev.hpp"
+#include "norm/cosine.hpp"
+#include "norm/mahalanobis.hpp"
 
 #endif
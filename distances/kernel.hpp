@@ -0,0 +1,671 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#ifndef __MACHINELEARNING_DISTANCES_KERNEL_HPP
+#define __MACHINELEARNING_DISTANCES_KERNEL_HPP
+
+#include <cmath>
+#include <string>
+#include <cstddef>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
+
+// the SIMD kernels are compiled with the GCC target pragma, so they need not be enabled with compiler flags
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER) && (defined(__x86_64__) || defined(__i386__)) && !defined(MACHINELEARNING_DISTANCES_KERNEL_SCALAR) && !defined(SWIG)
+#define MACHINELEARNING_DISTANCES_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+
+namespace machinelearning { namespace distances {
+    
+    
+    /** namespace with the kernel implementations of each instruction set **/
+    namespace simd {
+        
+        /** function table of an instruction set **/
+        template<typename T> struct table
+        {
+            typedef T (*pairfunction)( const T*, const T*, const std::size_t& );
+            typedef T (*weightedpairfunction)( const T*, const T*, const T*, const std::size_t& );
+            typedef void (*onetomanyfunction)( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, T* );
+            typedef void (*manytomanyfunction)( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, const std::size_t&, const std::size_t&, T* );
+            typedef void (*weightedonetomanyfunction)( const T*, const std::size_t&, const std::size_t&, const T*, const T*, const std::size_t&, const std::size_t&, T* );
+            
+            /** name of the instruction set **/
+            const char* name;
+            
+            pairfunction squaredEuclid;
+            weightedpairfunction weightedSquaredEuclid;
+            pairfunction dot;
+            pairfunction manhattan;
+            weightedpairfunction weightedManhattan;
+            pairfunction chebyshev;
+            weightedpairfunction weightedChebyshev;
+            
+            onetomanyfunction squaredEuclidOneToMany;
+            manytomanyfunction squaredEuclidManyToMany;
+            weightedonetomanyfunction weightedSquaredEuclidOneToMany;
+            onetomanyfunction dotOneToMany;
+            manytomanyfunction dotManyToMany;
+            onetomanyfunction manhattanOneToMany;
+            manytomanyfunction manhattanManyToMany;
+            onetomanyfunction chebyshevOneToMany;
+            manytomanyfunction chebyshevManyToMany;
+            onetomanyfunction cosineOneToMany;
+        };
+        
+        
+        /** scalar instruction set (used for all types and as fallback) **/
+        namespace scalar {
+            
+            /** vector operations with one element **/
+            template<typename T> struct vector
+            {
+                typedef T type;
+                static const std::size_t width = 1;
+                
+                static inline type zero( void ) { return 0; }
+                static inline type load( const T* p ) { return *p; }
+                static inline type add( const type& a, const type& b ) { return a+b; }
+                static inline type sub( const type& a, const type& b ) { return a-b; }
+                static inline type mul( const type& a, const type& b ) { return a*b; }
+                static inline type muladd( const type& a, const type& b, const type& c ) { return a*b+c; }
+                static inline type abs( const type& a ) { return a < 0 ? -a : a; }
+                static inline type max( const type& a, const type& b ) { return a < b ? b : a; }
+                static inline T sum( const type& a ) { return a; }
+                static inline T hmax( const type& a ) { return a; }
+            };
+            
+            #include "kernel.implementation.hpp"
+            
+            /** returns the function table
+             * @return table
+             **/
+            template<typename T> inline table<T> createTable( void ) { return getTable<T>( "scalar" ); }
+        }
+        
+        
+        #ifdef MACHINELEARNING_DISTANCES_KERNEL_X86
+        
+        /** SSE2 instruction set (2 doubles / 4 floats) **/
+        #pragma GCC push_options
+        #pragma GCC target("sse2")
+        namespace sse {
+            
+            template<typename T> struct vector;
+            
+            template<> struct vector<double>
+            {
+                typedef __m128d type;
+                static const std::size_t width = 2;
+                
+                static inline type zero( void ) { return _mm_setzero_pd(); }
+                static inline type load( const double* p ) { return _mm_loadu_pd(p); }
+                static inline type add( const type& a, const type& b ) { return _mm_add_pd(a, b); }
+                static inline type sub( const type& a, const type& b ) { return _mm_sub_pd(a, b); }
+                static inline type mul( const type& a, const type& b ) { return _mm_mul_pd(a, b); }
+                static inline type muladd( const type& a, const type& b, const type& c ) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+                static inline type abs( const type& a ) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+                static inline type max( const type& a, const type& b ) { return _mm_max_pd(a, b); }
+                static inline double sum( const type& a ) { return _mm_cvtsd_f64( _mm_add_sd(a, _mm_unpackhi_pd(a, a)) ); }
+                static inline double hmax( const type& a ) { return _mm_cvtsd_f64( _mm_max_sd(a, _mm_unpackhi_pd(a, a)) ); }
+            };
+            
+            template<> struct vector<float>
+            {
+                typedef __m128 type;
+                static const std::size_t width = 4;
+                
+                static inline type zero( void ) { return _mm_setzero_ps(); }
+                static inline type load( const float* p ) { return _mm_loadu_ps(p); }
+                static inline type add( const type& a, const type& b ) { return _mm_add_ps(a, b); }
+                static inline type sub( const type& a, const type& b ) { return _mm_sub_ps(a, b); }
+                static inline type mul( const type& a, const type& b ) { return _mm_mul_ps(a, b); }
+                static inline type muladd( const type& a, const type& b, const type& c ) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+                static inline type abs( const type& a ) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+                static inline type max( const type& a, const type& b ) { return _mm_max_ps(a, b); }
+                static inline float sum( const type& a )
+                {
+                    const __m128 l_half = _mm_add_ps(a, _mm_movehl_ps(a, a));
+                    return _mm_cvtss_f32( _mm_add_ss(l_half, _mm_shuffle_ps(l_half, l_half, 1)) );
+                }
+                static inline float hmax( const type& a )
+                {
+                    const __m128 l_half = _mm_max_ps(a, _mm_movehl_ps(a, a));
+                    return _mm_cvtss_f32( _mm_max_ss(l_half, _mm_shuffle_ps(l_half, l_half, 1)) );
+                }
+            };
+            
+            #include "kernel.implementation.hpp"
+            
+            /** returns the function table
+             * @return table
+             **/
+            template<typename T> inline table<T> createTable( void ) { return getTable<T>( "sse2" ); }
+        }
+        #pragma GCC pop_options
+        
+        
+        /** AVX2 instruction set with FMA (4 doubles / 8 floats) **/
+        #pragma GCC push_options
+        #pragma GCC target("avx2,fma")
+        namespace avx2 {
+            
+            template<typename T> struct vector;
+            
+            template<> struct vector<double>
+            {
+                typedef __m256d type;
+                static const std::size_t width = 4;
+                
+                static inline type zero( void ) { return _mm256_setzero_pd(); }
+                static inline type load( const double* p ) { return _mm256_loadu_pd(p); }
+                static inline type add( const type& a, const type& b ) { return _mm256_add_pd(a, b); }
+                static inline type sub( const type& a, const type& b ) { return _mm256_sub_pd(a, b); }
+                static inline type mul( const type& a, const type& b ) { return _mm256_mul_pd(a, b); }
+                static inline type muladd( const type& a, const type& b, const type& c ) { return _mm256_fmadd_pd(a, b, c); }
+                static inline type abs( const type& a ) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+                static inline type max( const type& a, const type& b ) { return _mm256_max_pd(a, b); }
+                static inline double sum( const type& a )
+                {
+                    const __m128d l_half = _mm_add_pd( _mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1) );
+                    return _mm_cvtsd_f64( _mm_add_sd(l_half, _mm_unpackhi_pd(l_half, l_half)) );
+                }
+                static inline double hmax( const type& a )
+                {
+                    const __m128d l_half = _mm_max_pd( _mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1) );
+                    return _mm_cvtsd_f64( _mm_max_sd(l_half, _mm_unpackhi_pd(l_half, l_half)) );
+                }
+            };
+            
+            template<> struct vector<float>
+            {
+                typedef __m256 type;
+                static const std::size_t width = 8;
+                
+                static inline type zero( void ) { return _mm256_setzero_ps(); }
+                static inline type load( const float* p ) { return _mm256_loadu_ps(p); }
+                static inline type add( const type& a, const type& b ) { return _mm256_add_ps(a, b); }
+                static inline type sub( const type& a, const type& b ) { return _mm256_sub_ps(a, b); }
+                static inline type mul( const type& a, const type& b ) { return _mm256_mul_ps(a, b); }
+                static inline type muladd( const type& a, const type& b, const type& c ) { return _mm256_fmadd_ps(a, b, c); }
+                static inline type abs( const type& a ) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+                static inline type max( const type& a, const type& b ) { return _mm256_max_ps(a, b); }
+                static inline float sum( const type& a )
+                {
+                    __m128 l_half = _mm_add_ps( _mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1) );
+                    l_half        = _mm_add_ps( l_half, _mm_movehl_ps(l_half, l_half) );
+                    return _mm_cvtss_f32( _mm_add_ss(l_half, _mm_shuffle_ps(l_half, l_half, 1)) );
+                }
+                static inline float hmax( const type& a )
+                {
+                    __m128 l_half = _mm_max_ps( _mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1) );
+                    l_half        = _mm_max_ps( l_half, _mm_movehl_ps(l_half, l_half) );
+                    return _mm_cvtss_f32( _mm_max_ss(l_half, _mm_shuffle_ps(l_half, l_half, 1)) );
+                }
+            };
+            
+            #include "kernel.implementation.hpp"
+            
+            /** returns the function table
+             * @return table
+             **/
+            template<typename T> inline table<T> createTable( void ) { return getTable<T>( "avx2" ); }
+        }
+        #pragma GCC pop_options
+        
+        
+        /** AVX-512 foundation instruction set (8 doubles / 16 floats) **/
+        #pragma GCC push_options
+        #pragma GCC target("avx512f")
+        namespace avx512 {
+            
+            template<typename T> struct vector;
+            
+            template<> struct vector<double>
+            {
+                typedef __m512d type;
+                static const std::size_t width = 8;
+                
+                static inline type zero( void ) { return _mm512_setzero_pd(); }
+                static inline type load( const double* p ) { return _mm512_loadu_pd(p); }
+                static inline type add( const type& a, const type& b ) { return _mm512_add_pd(a, b); }
+                static inline type sub( const type& a, const type& b ) { return _mm512_sub_pd(a, b); }
+                static inline type mul( const type& a, const type& b ) { return _mm512_mul_pd(a, b); }
+                static inline type muladd( const type& a, const type& b, const type& c ) { return _mm512_fmadd_pd(a, b, c); }
+                static inline type abs( const type& a ) { return _mm512_abs_pd(a); }
+                static inline type max( const type& a, const type& b ) { return _mm512_mask_max_pd(a, 0xff, a, b); }
+                static inline double sum( const type& a )
+                {
+                    const __m256d l_half    = _mm256_add_pd( _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xff, a, 0), _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xff, a, 1) );
+                    const __m128d l_quarter = _mm_add_pd( _mm256_castpd256_pd128(l_half), _mm256_extractf128_pd(l_half, 1) );
+                    return _mm_cvtsd_f64( _mm_add_sd(l_quarter, _mm_unpackhi_pd(l_quarter, l_quarter)) );
+                }
+                static inline double hmax( const type& a )
+                {
+                    const __m256d l_half    = _mm256_max_pd( _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xff, a, 0), _mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xff, a, 1) );
+                    const __m128d l_quarter = _mm_max_pd( _mm256_castpd256_pd128(l_half), _mm256_extractf128_pd(l_half, 1) );
+                    return _mm_cvtsd_f64( _mm_max_sd(l_quarter, _mm_unpackhi_pd(l_quarter, l_quarter)) );
+                }
+            };
+            
+            template<> struct vector<float>
+            {
+                typedef __m512 type;
+                static const std::size_t width = 16;
+                
+                static inline type zero( void ) { return _mm512_setzero_ps(); }
+                static inline type load( const float* p ) { return _mm512_loadu_ps(p); }
+                static inline type add( const type& a, const type& b ) { return _mm512_add_ps(a, b); }
+                static inline type sub( const type& a, const type& b ) { return _mm512_sub_ps(a, b); }
+                static inline type mul( const type& a, const type& b ) { return _mm512_mul_ps(a, b); }
+                static inline type muladd( const type& a, const type& b, const type& c ) { return _mm512_fmadd_ps(a, b, c); }
+                static inline type abs( const type& a ) { return _mm512_abs_ps(a); }
+                static inline type max( const type& a, const type& b ) { return _mm512_mask_max_ps(a, 0xffff, a, b); }
+                static inline float sum( const type& a )
+                {
+                    const __m512d l_value = _mm512_castps_pd(a);
+                    const __m256 l_half   = _mm256_add_ps( _mm256_castpd_ps(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xff, l_value, 0)), _mm256_castpd_ps(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xff, l_value, 1)) );
+                    __m128 l_quarter      = _mm_add_ps( _mm256_castps256_ps128(l_half), _mm256_extractf128_ps(l_half, 1) );
+                    l_quarter             = _mm_add_ps( l_quarter, _mm_movehl_ps(l_quarter, l_quarter) );
+                    return _mm_cvtss_f32( _mm_add_ss(l_quarter, _mm_shuffle_ps(l_quarter, l_quarter, 1)) );
+                }
+                static inline float hmax( const type& a )
+                {
+                    const __m512d l_value = _mm512_castps_pd(a);
+                    const __m256 l_half   = _mm256_max_ps( _mm256_castpd_ps(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xff, l_value, 0)), _mm256_castpd_ps(_mm512_mask_extractf64x4_pd(_mm256_setzero_pd(), 0xff, l_value, 1)) );
+                    __m128 l_quarter      = _mm_max_ps( _mm256_castps256_ps128(l_half), _mm256_extractf128_ps(l_half, 1) );
+                    l_quarter             = _mm_max_ps( l_quarter, _mm_movehl_ps(l_quarter, l_quarter) );
+                    return _mm_cvtss_f32( _mm_max_ss(l_quarter, _mm_shuffle_ps(l_quarter, l_quarter, 1)) );
+                }
+            };
+            
+            #include "kernel.implementation.hpp"
+            
+            /** returns the function table
+             * @return table
+             **/
+            template<typename T> inline table<T> createTable( void ) { return getTable<T>( "avx512" ); }
+        }
+        #pragma GCC pop_options
+        
+        #endif
+        
+    }
+    
+    
+    
+    /** class with the distance kernels on raw arrays, the instruction set (scalar, SSE2, AVX2 / FMA, AVX-512)
+     * is chosen on the first call by the CPU features (CPUID). All batch methods use row-major arrays with a
+     * row stride, so ublas row-major matrices can be passed without copying
+     * @note the SIMD kernels are used for float and double with the GCC compiler on x86, other compilers and
+     * types use the scalar kernels. The flag MACHINELEARNING_DISTANCES_KERNEL_SCALAR disables the SIMD kernels
+     **/
+    template<typename T> class kernel
+    {
+        #ifndef SWIG
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        #endif
+        
+        public :
+        
+            static std::string getInstructionSet( void );
+        
+            static T squaredEuclid( const T*, const T*, const std::size_t& );
+            static T weightedSquaredEuclid( const T*, const T*, const T*, const std::size_t& );
+            static T dot( const T*, const T*, const std::size_t& );
+            static T manhattan( const T*, const T*, const std::size_t& );
+            static T weightedManhattan( const T*, const T*, const T*, const std::size_t& );
+            static T chebyshev( const T*, const T*, const std::size_t& );
+            static T weightedChebyshev( const T*, const T*, const T*, const std::size_t& );
+        
+            static void squaredEuclid( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, T* );
+            static void squaredEuclid( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, const std::size_t&, const std::size_t&, T* );
+            static void weightedSquaredEuclid( const T*, const std::size_t&, const std::size_t&, const T*, const T*, const std::size_t&, const std::size_t&, T* );
+            static void dot( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, T* );
+            static void dot( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, const std::size_t&, const std::size_t&, T* );
+            static void manhattan( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, T* );
+            static void manhattan( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, const std::size_t&, const std::size_t&, T* );
+            static void chebyshev( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, T* );
+            static void chebyshev( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, const std::size_t&, const std::size_t&, T* );
+            static void cosine( const T*, const std::size_t&, const std::size_t&, const T*, const std::size_t&, T* );
+        
+        
+        private :
+        
+            static const simd::table<T>& getTable( void );
+            static simd::table<T> createTable( void );
+    };
+    
+    
+    
+    /** returns the function table, that is created on the first call
+     * @return table
+     **/
+    template<typename T> inline const simd::table<T>& kernel<T>::getTable( void )
+    {
+        static const simd::table<T> l_table = createTable();
+        return l_table;
+    }
+    
+    
+    /** creates the function table of the best instruction set for the type
+     * @return table
+     **/
+    template<typename T> inline simd::table<T> kernel<T>::createTable( void )
+    {
+        return simd::scalar::createTable<T>();
+    }
+    
+    
+    #ifdef MACHINELEARNING_DISTANCES_KERNEL_X86
+    
+    namespace simd {
+        
+        /** selects the table of the best instruction set by the CPU features
+         * @return table
+         **/
+        template<typename T> inline table<T> select( void )
+        {
+            __builtin_cpu_init();
+            
+            if (__builtin_cpu_supports("avx512f"))
+                return avx512::createTable<T>();
+            if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                return avx2::createTable<T>();
+            if (__builtin_cpu_supports("sse2"))
+                return sse::createTable<T>();
+            
+            return scalar::createTable<T>();
+        }
+        
+    }
+    
+    /** creates the table for float
+     * @return table
+     **/
+    template<> inline simd::table<float> kernel<float>::createTable( void )
+    {
+        return simd::select<float>();
+    }
+    
+    /** creates the table for double
+     * @return table
+     **/
+    template<> inline simd::table<double> kernel<double>::createTable( void )
+    {
+        return simd::select<double>();
+    }
+    
+    #endif
+    
+    
+    /** returns the name of the used instruction set
+     * @return name
+     **/
+    template<typename T> inline std::string kernel<T>::getInstructionSet( void )
+    {
+        return getTable().name;
+    }
+    
+    
+    /** squared euclidian distance of two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_size number of elements
+     * @return distance
+     **/
+    template<typename T> inline T kernel<T>::squaredEuclid( const T* p_first, const T* p_second, const std::size_t& p_size )
+    {
+        return getTable().squaredEuclid( p_first, p_second, p_size );
+    }
+    
+    
+    /** squared weighted euclidian distance of two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_weight weight array
+     * @param p_size number of elements
+     * @return distance
+     **/
+    template<typename T> inline T kernel<T>::weightedSquaredEuclid( const T* p_first, const T* p_second, const T* p_weight, const std::size_t& p_size )
+    {
+        return getTable().weightedSquaredEuclid( p_first, p_second, p_weight, p_size );
+    }
+    
+    
+    /** dot product of two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_size number of elements
+     * @return dot product
+     **/
+    template<typename T> inline T kernel<T>::dot( const T* p_first, const T* p_second, const std::size_t& p_size )
+    {
+        return getTable().dot( p_first, p_second, p_size );
+    }
+    
+    
+    /** manhattan (L1) distance of two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_size number of elements
+     * @return distance
+     **/
+    template<typename T> inline T kernel<T>::manhattan( const T* p_first, const T* p_second, const std::size_t& p_size )
+    {
+        return getTable().manhattan( p_first, p_second, p_size );
+    }
+    
+    
+    /** weighted manhattan distance of two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_weight weight array
+     * @param p_size number of elements
+     * @return distance
+     **/
+    template<typename T> inline T kernel<T>::weightedManhattan( const T* p_first, const T* p_second, const T* p_weight, const std::size_t& p_size )
+    {
+        return getTable().weightedManhattan( p_first, p_second, p_weight, p_size );
+    }
+    
+    
+    /** chebyshev (maximum) distance of two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_size number of elements
+     * @return distance
+     **/
+    template<typename T> inline T kernel<T>::chebyshev( const T* p_first, const T* p_second, const std::size_t& p_size )
+    {
+        return getTable().chebyshev( p_first, p_second, p_size );
+    }
+    
+    
+    /** weighted chebyshev distance of two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_weight weight array
+     * @param p_size number of elements
+     * @return distance
+     **/
+    template<typename T> inline T kernel<T>::weightedChebyshev( const T* p_first, const T* p_second, const T* p_weight, const std::size_t& p_size )
+    {
+        return getTable().weightedChebyshev( p_first, p_second, p_weight, p_size );
+    }
+    
+    
+    /** squared euclidian distances between each row of an array and a vector
+     * @param p_data row-major data array
+     * @param p_rows number of rows
+     * @param p_stride number of elements between two rows
+     * @param p_vec vector
+     * @param p_size number of columns
+     * @param p_result result array (one value for each row)
+     **/
+    template<typename T> inline void kernel<T>::squaredEuclid( const T* p_data, const std::size_t& p_rows, const std::size_t& p_stride, const T* p_vec, const std::size_t& p_size, T* p_result )
+    {
+        getTable().squaredEuclidOneToMany( p_data, p_rows, p_stride, p_vec, p_size, p_result );
+    }
+    
+    
+    /** squared euclidian distances between all rows of two arrays
+     * @param p_first row-major first array
+     * @param p_firstrows number of rows of the first array
+     * @param p_firststride number of elements between two rows of the first array
+     * @param p_second row-major second array
+     * @param p_secondrows number of rows of the second array
+     * @param p_secondstride number of elements between two rows of the second array
+     * @param p_size number of columns
+     * @param p_result row-major result array (first rows x second rows)
+     **/
+    template<typename T> inline void kernel<T>::squaredEuclid( const T* p_first, const std::size_t& p_firstrows, const std::size_t& p_firststride, const T* p_second, const std::size_t& p_secondrows, const std::size_t& p_secondstride, const std::size_t& p_size, T* p_result )
+    {
+        getTable().squaredEuclidManyToMany( p_first, p_firstrows, p_firststride, p_second, p_secondrows, p_secondstride, p_size, p_result );
+    }
+    
+    
+    /** squared weighted euclidian distances between each row of an array and a vector
+     * @param p_data row-major data array
+     * @param p_rows number of rows
+     * @param p_stride number of elements between two rows
+     * @param p_vec vector
+     * @param p_weight weight array
+     * @param p_weightstride number of elements between two weight rows (zero uses the same weights for each row)
+     * @param p_size number of columns
+     * @param p_result result array (one value for each row)
+     **/
+    template<typename T> inline void kernel<T>::weightedSquaredEuclid( const T* p_data, const std::size_t& p_rows, const std::size_t& p_stride, const T* p_vec, const T* p_weight, const std::size_t& p_weightstride, const std::size_t& p_size, T* p_result )
+    {
+        getTable().weightedSquaredEuclidOneToMany( p_data, p_rows, p_stride, p_vec, p_weight, p_weightstride, p_size, p_result );
+    }
+    
+    
+    /** dot products between each row of an array and a vector
+     * @param p_data row-major data array
+     * @param p_rows number of rows
+     * @param p_stride number of elements between two rows
+     * @param p_vec vector
+     * @param p_size number of columns
+     * @param p_result result array (one value for each row)
+     **/
+    template<typename T> inline void kernel<T>::dot( const T* p_data, const std::size_t& p_rows, const std::size_t& p_stride, const T* p_vec, const std::size_t& p_size, T* p_result )
+    {
+        getTable().dotOneToMany( p_data, p_rows, p_stride, p_vec, p_size, p_result );
+    }
+    
+    
+    /** dot products between all rows of two arrays
+     * @param p_first row-major first array
+     * @param p_firstrows number of rows of the first array
+     * @param p_firststride number of elements between two rows of the first array
+     * @param p_second row-major second array
+     * @param p_secondrows number of rows of the second array
+     * @param p_secondstride number of elements between two rows of the second array
+     * @param p_size number of columns
+     * @param p_result row-major result array (first rows x second rows)
+     **/
+    template<typename T> inline void kernel<T>::dot( const T* p_first, const std::size_t& p_firstrows, const std::size_t& p_firststride, const T* p_second, const std::size_t& p_secondrows, const std::size_t& p_secondstride, const std::size_t& p_size, T* p_result )
+    {
+        getTable().dotManyToMany( p_first, p_firstrows, p_firststride, p_second, p_secondrows, p_secondstride, p_size, p_result );
+    }
+    
+    
+    /** manhattan distances between each row of an array and a vector
+     * @param p_data row-major data array
+     * @param p_rows number of rows
+     * @param p_stride number of elements between two rows
+     * @param p_vec vector
+     * @param p_size number of columns
+     * @param p_result result array (one value for each row)
+     **/
+    template<typename T> inline void kernel<T>::manhattan( const T* p_data, const std::size_t& p_rows, const std::size_t& p_stride, const T* p_vec, const std::size_t& p_size, T* p_result )
+    {
+        getTable().manhattanOneToMany( p_data, p_rows, p_stride, p_vec, p_size, p_result );
+    }
+    
+    
+    /** manhattan distances between all rows of two arrays
+     * @param p_first row-major first array
+     * @param p_firstrows number of rows of the first array
+     * @param p_firststride number of elements between two rows of the first array
+     * @param p_second row-major second array
+     * @param p_secondrows number of rows of the second array
+     * @param p_secondstride number of elements between two rows of the second array
+     * @param p_size number of columns
+     * @param p_result row-major result array (first rows x second rows)
+     **/
+    template<typename T> inline void kernel<T>::manhattan( const T* p_first, const std::size_t& p_firstrows, const std::size_t& p_firststride, const T* p_second, const std::size_t& p_secondrows, const std::size_t& p_secondstride, const std::size_t& p_size, T* p_result )
+    {
+        getTable().manhattanManyToMany( p_first, p_firstrows, p_firststride, p_second, p_secondrows, p_secondstride, p_size, p_result );
+    }
+    
+    
+    /** chebyshev distances between each row of an array and a vector
+     * @param p_data row-major data array
+     * @param p_rows number of rows
+     * @param p_stride number of elements between two rows
+     * @param p_vec vector
+     * @param p_size number of columns
+     * @param p_result result array (one value for each row)
+     **/
+    template<typename T> inline void kernel<T>::chebyshev( const T* p_data, const std::size_t& p_rows, const std::size_t& p_stride, const T* p_vec, const std::size_t& p_size, T* p_result )
+    {
+        getTable().chebyshevOneToMany( p_data, p_rows, p_stride, p_vec, p_size, p_result );
+    }
+    
+    
+    /** chebyshev distances between all rows of two arrays
+     * @param p_first row-major first array
+     * @param p_firstrows number of rows of the first array
+     * @param p_firststride number of elements between two rows of the first array
+     * @param p_second row-major second array
+     * @param p_secondrows number of rows of the second array
+     * @param p_secondstride number of elements between two rows of the second array
+     * @param p_size number of columns
+     * @param p_result row-major result array (first rows x second rows)
+     **/
+    template<typename T> inline void kernel<T>::chebyshev( const T* p_first, const std::size_t& p_firstrows, const std::size_t& p_firststride, const T* p_second, const std::size_t& p_secondrows, const std::size_t& p_secondstride, const std::size_t& p_size, T* p_result )
+    {
+        getTable().chebyshevManyToMany( p_first, p_firstrows, p_firststride, p_second, p_secondrows, p_secondstride, p_size, p_result );
+    }
+    
+    
+    /** cosine distances ( 1 - cos(angle) ) between each row of an array and a vector. The dot product
+     * and the row norm are calculated within one pass over the row, the vector norm is calculated once
+     * @param p_data row-major data array
+     * @param p_rows number of rows
+     * @param p_stride number of elements between two rows
+     * @param p_vec vector
+     * @param p_size number of columns
+     * @param p_result result array (one value for each row)
+     **/
+    template<typename T> inline void kernel<T>::cosine( const T* p_data, const std::size_t& p_rows, const std::size_t& p_stride, const T* p_vec, const std::size_t& p_size, T* p_result )
+    {
+        getTable().cosineOneToMany( p_data, p_rows, p_stride, p_vec, p_size, p_result );
+    }
+    
+}}
+#endif
@@ -0,0 +1,409 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#ifndef __MACHINELEARNING_DISTANCES_KERNEL_HPP
+#error never include this file directly
+#endif
+
+// the file has no include guard, because it is included for each instruction set within
+// the namespace of the instruction set, the namespace must define the vector<T> structure
+
+
+    /** squared euclidian distance between two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_size number of elements
+     * @return sum( (first - second)^2 )
+     **/
+    template<typename T> inline T squaredEuclid( const T* p_first, const T* p_second, const std::size_t& p_size )
+    {
+        typedef vector<T> simd;
+        typename simd::type l_sum0 = simd::zero();
+        typename simd::type l_sum1 = simd::zero();
+        
+        std::size_t i = 0;
+        for( ; i + 2*simd::width <= p_size; i += 2*simd::width) {
+            const typename simd::type l_diff0 = simd::sub( simd::load(p_first+i), simd::load(p_second+i) );
+            const typename simd::type l_diff1 = simd::sub( simd::load(p_first+i+simd::width), simd::load(p_second+i+simd::width) );
+            l_sum0 = simd::muladd( l_diff0, l_diff0, l_sum0 );
+            l_sum1 = simd::muladd( l_diff1, l_diff1, l_sum1 );
+        }
+        for( ; i + simd::width <= p_size; i += simd::width) {
+            const typename simd::type l_diff = simd::sub( simd::load(p_first+i), simd::load(p_second+i) );
+            l_sum0 = simd::muladd( l_diff, l_diff, l_sum0 );
+        }
+        
+        T l_result = simd::sum( simd::add(l_sum0, l_sum1) );
+        for( ; i < p_size; ++i) {
+            const T l_diff = p_first[i] - p_second[i];
+            l_result      += l_diff * l_diff;
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** squared weighted euclidian distance between two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_weight weight array
+     * @param p_size number of elements
+     * @return sum( (weight .* (first - second))^2 )
+     **/
+    template<typename T> inline T weightedSquaredEuclid( const T* p_first, const T* p_second, const T* p_weight, const std::size_t& p_size )
+    {
+        typedef vector<T> simd;
+        typename simd::type l_sum0 = simd::zero();
+        typename simd::type l_sum1 = simd::zero();
+        
+        std::size_t i = 0;
+        for( ; i + 2*simd::width <= p_size; i += 2*simd::width) {
+            const typename simd::type l_diff0 = simd::mul( simd::load(p_weight+i), simd::sub( simd::load(p_first+i), simd::load(p_second+i) ) );
+            const typename simd::type l_diff1 = simd::mul( simd::load(p_weight+i+simd::width), simd::sub( simd::load(p_first+i+simd::width), simd::load(p_second+i+simd::width) ) );
+            l_sum0 = simd::muladd( l_diff0, l_diff0, l_sum0 );
+            l_sum1 = simd::muladd( l_diff1, l_diff1, l_sum1 );
+        }
+        for( ; i + simd::width <= p_size; i += simd::width) {
+            const typename simd::type l_diff = simd::mul( simd::load(p_weight+i), simd::sub( simd::load(p_first+i), simd::load(p_second+i) ) );
+            l_sum0 = simd::muladd( l_diff, l_diff, l_sum0 );
+        }
+        
+        T l_result = simd::sum( simd::add(l_sum0, l_sum1) );
+        for( ; i < p_size; ++i) {
+            const T l_diff = p_weight[i] * (p_first[i] - p_second[i]);
+            l_result      += l_diff * l_diff;
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** dot product of two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_size number of elements
+     * @return sum( first .* second )
+     **/
+    template<typename T> inline T dot( const T* p_first, const T* p_second, const std::size_t& p_size )
+    {
+        typedef vector<T> simd;
+        typename simd::type l_sum0 = simd::zero();
+        typename simd::type l_sum1 = simd::zero();
+        
+        std::size_t i = 0;
+        for( ; i + 2*simd::width <= p_size; i += 2*simd::width) {
+            l_sum0 = simd::muladd( simd::load(p_first+i), simd::load(p_second+i), l_sum0 );
+            l_sum1 = simd::muladd( simd::load(p_first+i+simd::width), simd::load(p_second+i+simd::width), l_sum1 );
+        }
+        for( ; i + simd::width <= p_size; i += simd::width)
+            l_sum0 = simd::muladd( simd::load(p_first+i), simd::load(p_second+i), l_sum0 );
+        
+        T l_result = simd::sum( simd::add(l_sum0, l_sum1) );
+        for( ; i < p_size; ++i)
+            l_result += p_first[i] * p_second[i];
+        
+        return l_result;
+    }
+    
+    
+    /** manhattan (L1) distance between two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_size number of elements
+     * @return sum( |first - second| )
+     **/
+    template<typename T> inline T manhattan( const T* p_first, const T* p_second, const std::size_t& p_size )
+    {
+        typedef vector<T> simd;
+        typename simd::type l_sum0 = simd::zero();
+        typename simd::type l_sum1 = simd::zero();
+        
+        std::size_t i = 0;
+        for( ; i + 2*simd::width <= p_size; i += 2*simd::width) {
+            l_sum0 = simd::add( l_sum0, simd::abs( simd::sub( simd::load(p_first+i), simd::load(p_second+i) ) ) );
+            l_sum1 = simd::add( l_sum1, simd::abs( simd::sub( simd::load(p_first+i+simd::width), simd::load(p_second+i+simd::width) ) ) );
+        }
+        for( ; i + simd::width <= p_size; i += simd::width)
+            l_sum0 = simd::add( l_sum0, simd::abs( simd::sub( simd::load(p_first+i), simd::load(p_second+i) ) ) );
+        
+        T l_result = simd::sum( simd::add(l_sum0, l_sum1) );
+        for( ; i < p_size; ++i)
+            l_result += (p_first[i] < p_second[i]) ? p_second[i] - p_first[i] : p_first[i] - p_second[i];
+        
+        return l_result;
+    }
+    
+    
+    /** weighted manhattan distance between two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_weight weight array
+     * @param p_size number of elements
+     * @return sum( |weight .* (first - second)| )
+     **/
+    template<typename T> inline T weightedManhattan( const T* p_first, const T* p_second, const T* p_weight, const std::size_t& p_size )
+    {
+        typedef vector<T> simd;
+        typename simd::type l_sum0 = simd::zero();
+        typename simd::type l_sum1 = simd::zero();
+        
+        std::size_t i = 0;
+        for( ; i + 2*simd::width <= p_size; i += 2*simd::width) {
+            l_sum0 = simd::add( l_sum0, simd::abs( simd::mul( simd::load(p_weight+i), simd::sub( simd::load(p_first+i), simd::load(p_second+i) ) ) ) );
+            l_sum1 = simd::add( l_sum1, simd::abs( simd::mul( simd::load(p_weight+i+simd::width), simd::sub( simd::load(p_first+i+simd::width), simd::load(p_second+i+simd::width) ) ) ) );
+        }
+        for( ; i + simd::width <= p_size; i += simd::width)
+            l_sum0 = simd::add( l_sum0, simd::abs( simd::mul( simd::load(p_weight+i), simd::sub( simd::load(p_first+i), simd::load(p_second+i) ) ) ) );
+        
+        T l_result = simd::sum( simd::add(l_sum0, l_sum1) );
+        for( ; i < p_size; ++i) {
+            const T l_diff = p_weight[i] * (p_first[i] - p_second[i]);
+            l_result      += (l_diff < 0) ? -l_diff : l_diff;
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** chebyshev (maximum) distance between two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_size number of elements
+     * @return max( |first - second| )
+     **/
+    template<typename T> inline T chebyshev( const T* p_first, const T* p_second, const std::size_t& p_size )
+    {
+        typedef vector<T> simd;
+        typename simd::type l_max0 = simd::zero();
+        typename simd::type l_max1 = simd::zero();
+        
+        std::size_t i = 0;
+        for( ; i + 2*simd::width <= p_size; i += 2*simd::width) {
+            l_max0 = simd::max( l_max0, simd::abs( simd::sub( simd::load(p_first+i), simd::load(p_second+i) ) ) );
+            l_max1 = simd::max( l_max1, simd::abs( simd::sub( simd::load(p_first+i+simd::width), simd::load(p_second+i+simd::width) ) ) );
+        }
+        for( ; i + simd::width <= p_size; i += simd::width)
+            l_max0 = simd::max( l_max0, simd::abs( simd::sub( simd::load(p_first+i), simd::load(p_second+i) ) ) );
+        
+        T l_result = simd::hmax( simd::max(l_max0, l_max1) );
+        for( ; i < p_size; ++i) {
+            const T l_diff = (p_first[i] < p_second[i]) ? p_second[i] - p_first[i] : p_first[i] - p_second[i];
+            if (l_diff > l_result)
+                l_result = l_diff;
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** weighted chebyshev distance between two arrays
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_weight weight array
+     * @param p_size number of elements
+     * @return max( |weight .* (first - second)| )
+     **/
+    template<typename T> inline T weightedChebyshev( const T* p_first, const T* p_second, const T* p_weight, const std::size_t& p_size )
+    {
+        typedef vector<T> simd;
+        typename simd::type l_max0 = simd::zero();
+        typename simd::type l_max1 = simd::zero();
+        
+        std::size_t i = 0;
+        for( ; i + 2*simd::width <= p_size; i += 2*simd::width) {
+            l_max0 = simd::max( l_max0, simd::abs( simd::mul( simd::load(p_weight+i), simd::sub( simd::load(p_first+i), simd::load(p_second+i) ) ) ) );
+            l_max1 = simd::max( l_max1, simd::abs( simd::mul( simd::load(p_weight+i+simd::width), simd::sub( simd::load(p_first+i+simd::width), simd::load(p_second+i+simd::width) ) ) ) );
+        }
+        for( ; i + simd::width <= p_size; i += simd::width)
+            l_max0 = simd::max( l_max0, simd::abs( simd::mul( simd::load(p_weight+i), simd::sub( simd::load(p_first+i), simd::load(p_second+i) ) ) ) );
+        
+        T l_result = simd::hmax( simd::max(l_max0, l_max1) );
+        for( ; i < p_size; ++i) {
+            T l_diff = p_weight[i] * (p_first[i] - p_second[i]);
+            if (l_diff < 0)
+                l_diff = -l_diff;
+            if (l_diff > l_result)
+                l_result = l_diff;
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** dot product and squared norm of the first array within one pass
+     * @param p_first first array
+     * @param p_second second array
+     * @param p_size number of elements
+     * @param p_norm squared norm of the first array
+     * @return sum( first .* second )
+     **/
+    template<typename T> inline T dotNorm( const T* p_first, const T* p_second, const std::size_t& p_size, T& p_norm )
+    {
+        typedef vector<T> simd;
+        typename simd::type l_dot  = simd::zero();
+        typename simd::type l_norm = simd::zero();
+        
+        std::size_t i = 0;
+        for( ; i + simd::width <= p_size; i += simd::width) {
+            const typename simd::type l_value = simd::load(p_first+i);
+            l_dot  = simd::muladd( l_value, simd::load(p_second+i), l_dot );
+            l_norm = simd::muladd( l_value, l_value, l_norm );
+        }
+        
+        T l_result = simd::sum( l_dot );
+        p_norm     = simd::sum( l_norm );
+        for( ; i < p_size; ++i) {
+            l_result += p_first[i] * p_second[i];
+            p_norm   += p_first[i] * p_first[i];
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** functor structures for the batch calls, so the kernel is inlined into the row loop **/
+    struct squaredeuclidkernel
+    {
+        template<typename T> static inline T get( const T* p_first, const T* p_second, const std::size_t& p_size ) { return squaredEuclid(p_first, p_second, p_size); }
+    };
+    
+    struct dotkernel
+    {
+        template<typename T> static inline T get( const T* p_first, const T* p_second, const std::size_t& p_size ) { return dot(p_first, p_second, p_size); }
+    };
+    
+    struct manhattankernel
+    {
+        template<typename T> static inline T get( const T* p_first, const T* p_second, const std::size_t& p_size ) { return manhattan(p_first, p_second, p_size); }
+    };
+    
+    struct chebyshevkernel
+    {
+        template<typename T> static inline T get( const T* p_first, const T* p_second, const std::size_t& p_size ) { return chebyshev(p_first, p_second, p_size); }
+    };
+    
+    
+    /** calculates the values between each row of a row-major array and a vector
+     * @param p_data data array
+     * @param p_rows number of rows
+     * @param p_stride distance between two rows in elements
+     * @param p_vec vector array
+     * @param p_size number of columns / vector elements
+     * @param p_result result array with one element for each row
+     **/
+    template<typename K, typename T> inline void oneToMany( const T* p_data, const std::size_t& p_rows, const std::size_t& p_stride, const T* p_vec, const std::size_t& p_size, T* p_result )
+    {
+        for(std::size_t i=0; i < p_rows; ++i)
+            p_result[i] = K::get( p_data + i*p_stride, p_vec, p_size );
+    }
+    
+    
+    /** calculates the values between each row of two row-major arrays
+     * @param p_first first array
+     * @param p_firstrows number of rows of the first array
+     * @param p_firststride distance between two rows of the first array
+     * @param p_second second array
+     * @param p_secondrows number of rows of the second array
+     * @param p_secondstride distance between two rows of the second array
+     * @param p_size number of columns
+     * @param p_result row-major result array (first rows x second rows)
+     **/
+    template<typename K, typename T> inline void manyToMany( const T* p_first, const std::size_t& p_firstrows, const std::size_t& p_firststride, const T* p_second, const std::size_t& p_secondrows, const std::size_t& p_secondstride, const std::size_t& p_size, T* p_result )
+    {
+        for(std::size_t i=0; i < p_firstrows; ++i)
+            for(std::size_t j=0; j < p_secondrows; ++j)
+                p_result[i*p_secondrows+j] = K::get( p_first + i*p_firststride, p_second + j*p_secondstride, p_size );
+    }
+    
+    
+    /** calculates the squared weighted euclidian distance between each row of a row-major array and a vector
+     * @param p_data data array
+     * @param p_rows number of rows
+     * @param p_stride distance between two rows in elements
+     * @param p_vec vector array
+     * @param p_weight weight array
+     * @param p_weightstride distance between two weight rows (zero for the same weight on each row)
+     * @param p_size number of columns / vector elements
+     * @param p_result result array with one element for each row
+     **/
+    template<typename T> inline void weightedSquaredEuclidOneToMany( const T* p_data, const std::size_t& p_rows, const std::size_t& p_stride, const T* p_vec, const T* p_weight, const std::size_t& p_weightstride, const std::size_t& p_size, T* p_result )
+    {
+        for(std::size_t i=0; i < p_rows; ++i)
+            p_result[i] = weightedSquaredEuclid( p_data + i*p_stride, p_vec, p_weight + i*p_weightstride, p_size );
+    }
+    
+    
+    /** calculates the cosine distance between each row of a row-major array and a vector, a
+     * zero vector has the distance 1 to all other vectors and 0 to a zero vector
+     * @param p_data data array
+     * @param p_rows number of rows
+     * @param p_stride distance between two rows in elements
+     * @param p_vec vector array
+     * @param p_size number of columns / vector elements
+     * @param p_result result array with one element for each row
+     **/
+    template<typename T> inline void cosineOneToMany( const T* p_data, const std::size_t& p_rows, const std::size_t& p_stride, const T* p_vec, const std::size_t& p_size, T* p_result )
+    {
+        const T l_vecnorm = dot( p_vec, p_vec, p_size );
+        
+        for(std::size_t i=0; i < p_rows; ++i) {
+            T l_norm;
+            const T l_dot = dotNorm( p_data + i*p_stride, p_vec, p_size, l_norm );
+            
+            if ((l_norm == 0) || (l_vecnorm == 0))
+                p_result[i] = ((l_norm == 0) && (l_vecnorm == 0)) ? 0 : 1;
+            else
+                p_result[i] = 1 - l_dot / std::sqrt(l_norm * l_vecnorm);
+        }
+    }
+    
+    
+    /** creates the function table of the kernels
+     * @param p_name name of the instruction set
+     * @return table
+     **/
+    template<typename T> inline table<T> getTable( const char* p_name )
+    {
+        table<T> l_table;
+        
+        l_table.name                            = p_name;
+        l_table.squaredEuclid                   = &squaredEuclid<T>;
+        l_table.weightedSquaredEuclid           = &weightedSquaredEuclid<T>;
+        l_table.dot                             = &dot<T>;
+        l_table.manhattan                       = &manhattan<T>;
+        l_table.squaredEuclidOneToMany          = &oneToMany<squaredeuclidkernel, T>;
+        l_table.squaredEuclidManyToMany         = &manyToMany<squaredeuclidkernel, T>;
+        l_table.weightedSquaredEuclidOneToMany  = &weightedSquaredEuclidOneToMany<T>;
+        l_table.dotOneToMany                    = &oneToMany<dotkernel, T>;
+        l_table.dotManyToMany                   = &manyToMany<dotkernel, T>;
+        l_table.manhattanOneToMany              = &oneToMany<manhattankernel, T>;
+        l_table.manhattanManyToMany             = &manyToMany<manhattankernel, T>;
+        l_table.weightedManhattan               = &weightedManhattan<T>;
+        l_table.chebyshev                       = &chebyshev<T>;
+        l_table.weightedChebyshev               = &weightedChebyshev<T>;
+        l_table.chebyshevOneToMany              = &oneToMany<chebyshevkernel, T>;
+        l_table.chebyshevManyToMany             = &manyToMany<chebyshevkernel, T>;
+        l_table.cosineOneToMany                 = &cosineOneToMany<T>;
+        
+        return l_table;
+    }
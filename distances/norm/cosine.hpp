@@ -0,0 +1,427 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+#ifndef __MACHINELEARNING_DISTANCES_NORM_COSINE_HPP
+#define __MACHINELEARNING_DISTANCES_NORM_COSINE_HPP
+
+#include <cmath>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+
+#include "../distance.hpp"
+#include "../kernel.hpp"
+#include "../../errorhandling/exception.hpp"
+#include "../../tools/tools.h"
+
+
+namespace machinelearning { namespace distances { namespace norm {
+    
+    
+    #ifndef SWIG
+    namespace ublas  = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class for calculating the cosine distance beween datapoints [ 1 - <a,b> / (|a| |b|) ]. The norms
+     * of the datapoints are calculated once for each call and reused for all pairs, within the one-to-many
+     * kernel the norm of each row is calculated in the same pass as the dot product
+     **/
+    template<typename T> class cosine : public distance<T>
+    {
+        
+        public:
+        
+            #ifndef SWIG
+            void normalize( ublas::vector<T>& ) const;
+            void normalize( ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;        
+            #endif
+            ublas::vector<T> getNormalize( const ublas::vector<T>& ) const;
+            ublas::matrix<T> getNormalize( const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+        
+            T getLength( const ublas::vector<T>& ) const;
+            ublas::vector<T> getLength( const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            T getInvert( const T& ) const;
+            ublas::vector<T> getAbs( const ublas::vector<T>& ) const;
+            #ifndef SWIG
+            void abs( ublas::vector<T>& ) const;
+            #endif
+        
+            T getDistance( const ublas::vector<T>&, const ublas::vector<T>& ) const;        
+            ublas::vector<T> getDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            ublas::vector<T> getDistance( const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            ublas::matrix<T> getDistanceMatrix( const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+        
+            #ifndef SWIG
+            T getWeightedDistance( const ublas::vector<T>&, const ublas::vector<T>&, const ublas::vector<T>& ) const;        
+            ublas::vector<T> getWeightedDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const ublas::vector<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;        
+            ublas::vector<T> getWeightedDistance( const ublas::matrix<T>&, const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            ublas::vector<T> getWeightedDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            #endif
+        
+        
+        private :
+        
+            static T getCosine( const T&, const T&, const T& );
+
+    };
+    
+    
+    
+    /** normalize a vector with the euclidian norm, so the cosine distance is 1 - dot product,
+     * a zero vector is not changed
+     * @param p_vec vector which should be normalized
+     **/
+    template<typename T> inline void cosine<T>::normalize( ublas::vector<T>& p_vec ) const 
+    {
+        const T l_length = getLength( p_vec );
+        
+        if (l_length != 0)
+            p_vec /= l_length;
+    }    
+    
+    
+   
+    /** normalize a matrix on their rows or columns vectors, zero vectors are not changed
+     * @param p_matrix matrix for normalization
+     * @param p_row option for row or column iteration (default row)
+     **/
+    template<typename T> inline void cosine<T>::normalize( ublas::matrix<T>& p_matrix, const tools::matrix::rowtype& p_row ) const
+    { 
+        const ublas::vector<T> l_length = getLength( p_matrix, p_row );
+        
+        switch (p_row) {                
+            case tools::matrix::row :
+                
+                    for(std::size_t i=0; i < p_matrix.size1(); ++i)
+                        if (l_length(i) != 0)
+                            ublas::row(p_matrix, i) /= l_length(i);
+                    break;
+                
+                
+            case tools::matrix::column :  
+                
+                    for(std::size_t i=0; i < p_matrix.size2(); ++i)
+                        if (l_length(i) != 0)
+                            ublas::column(p_matrix, i) /= l_length(i);
+                    break;
+        }
+    }
+    
+    
+    
+    /** return the normalized vector
+     * @param p_vec vector which should be normalized
+     * @return vector
+     **/
+    template<typename T> inline ublas::vector<T> cosine<T>::getNormalize( const ublas::vector<T>& p_vec ) const 
+    {
+        ublas::vector<T> l_vec = p_vec;
+        normalize(l_vec);
+        return l_vec;
+    }
+    
+    
+    
+    /** normalize a matrix on their rows or columns vectors
+     * @param p_matrix matrix for noamlization
+     * @param p_row option for row or column iteration (default row)
+     * @return normalized matrix
+     **/
+    template<typename T> inline ublas::matrix<T> cosine<T>::getNormalize( const ublas::matrix<T>& p_matrix, const tools::matrix::rowtype& p_row ) const
+    {
+        ublas::matrix<T> l_matrix = p_matrix;
+        normalize(l_matrix, p_row);
+        return l_matrix;
+    }
+    
+    
+    
+    /** returns the euclidian length of a vector
+     * @param p_vec vector
+     * @return length of the vector
+     **/
+    template<typename T> inline T cosine<T>::getLength( const ublas::vector<T>& p_vec ) const
+    {
+        return std::sqrt( kernel<T>::dot(p_vec.data().begin(), p_vec.data().begin(), p_vec.size()) );
+    }
+
+    
+    
+    /** returns for every row or column the length 
+     * @param p_matrix matrix
+     * @param p_row option for row or column iteration (default row)
+     * @return vector with length
+     **/
+    template<typename T> inline ublas::vector<T> cosine<T>::getLength( const ublas::matrix<T>& p_matrix, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getLength( static_cast< ublas::matrix<T> >(ublas::trans(p_matrix)), tools::matrix::row );
+        
+        ublas::vector<T> l_vec( p_matrix.size1() );
+        for(std::size_t i=0; i < l_vec.size(); ++i) {
+            const T* l_row = p_matrix.data().begin() + i*p_matrix.size2();
+            l_vec(i)       = std::sqrt( kernel<T>::dot(l_row, l_row, p_matrix.size2()) );
+        }
+        
+        return l_vec;
+    }
+    
+    
+    
+    /** calculates the cosine distance of a dot product and the two norms, a zero
+     * vector has the distance 1 to all other vectors and 0 to a zero vector
+     * @param p_dot dot product
+     * @param p_firstnorm norm of the first vector
+     * @param p_secondnorm norm of the second vector
+     * @return distance
+     **/
+    template<typename T> inline T cosine<T>::getCosine( const T& p_dot, const T& p_firstnorm, const T& p_secondnorm )
+    {
+        if ((p_firstnorm == 0) || (p_secondnorm == 0))
+            return ((p_firstnorm == 0) && (p_secondnorm == 0)) ? 0 : 1;
+        
+        return 1 - p_dot / (p_firstnorm * p_secondnorm);
+    }
+    
+    
+    
+    /** returns a invertet value
+     * @param p_val value
+     * @return inverted value
+     **/
+    template<typename T> inline T cosine<T>::getInvert( const T& p_val ) const
+    {
+        return static_cast<T>(1) / p_val;
+    }    
+    
+    
+    
+    /** calculate absolut values for a vector
+     * @param p_vec vector
+     * @return absolut value
+     **/
+    template<typename T> inline ublas::vector<T> cosine<T>::getAbs( const ublas::vector<T>& p_vec ) const
+    {
+        ublas::vector<T> l_vec = p_vec;
+        abs( l_vec );
+        return l_vec;
+    }    
+    
+    
+    
+    /** calculate absolut values for every element of the vector
+     * @param p_vec vector
+     **/
+    template<typename T> inline void cosine<T>::abs( ublas::vector<T>& p_vec ) const
+    {
+        for(std::size_t i=0; i < p_vec.size(); ++i)
+            p_vec(i) = std::fabs( p_vec(i) );
+    }
+   
+
+    
+    /** calculates the distance between two vectors
+     * @param p_first first vector
+     * @param p_second second vector
+     * @return distance value
+     **/
+    template<typename T> inline T cosine<T>::getDistance( const ublas::vector<T>& p_first, const ublas::vector<T>& p_second ) const
+    {
+        if (p_first.size() != p_second.size())
+            throw exception::runtime(_("vector sizes are not equal"), *this);
+        
+        T l_distance = 0;
+        kernel<T>::cosine( p_first.data().begin(), 1, p_first.size(), p_second.data().begin(), p_second.size(), &l_distance );
+        return l_distance;
+    }
+    
+    
+    /** calculates the distance beween every row or column of the matrix and the vector
+     * @param p_data matrix
+     * @param p_vec vector
+     * @param p_row row / column option (default row)
+     * @return vector with distance values
+     **/
+    template<typename T> inline ublas::vector<T> cosine<T>::getDistance( const ublas::matrix<T>& p_data, const ublas::vector<T>& p_vec, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_data)), p_vec, tools::matrix::row );
+        
+        if (p_data.size2() != p_vec.size())
+            throw exception::runtime(_("matrix and vector dimension are not equal"), *this);
+        
+        ublas::vector<T> l_vec( p_data.size1() );
+        kernel<T>::cosine( p_data.data().begin(), p_data.size1(), p_data.size2(), p_vec.data().begin(), p_vec.size(), l_vec.data().begin() );
+
+        return l_vec;
+    }
+    
+    
+    
+    /** calculates the distance between every row and column of the matrices
+     * @param p_first first matrix
+     * @param p_second second matrix
+     * @param p_row row / column option (default row)
+     * @return distance vector
+     **/
+    template<typename T> inline ublas::vector<T> cosine<T>::getDistance( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_first)), static_cast< ublas::matrix<T> >(ublas::trans(p_second)), tools::matrix::row );
+        
+        if ((p_first.size1() != p_second.size1()) || (p_first.size2() != p_second.size2()))
+            throw exception::runtime(_("matrix dimensions are not equal"), *this);
+        
+        ublas::vector<T> l_vec( p_first.size1() );
+        for(std::size_t i=0; i < l_vec.size(); ++i)
+            kernel<T>::cosine( p_first.data().begin() + i*p_first.size2(), 1, p_first.size2(), p_second.data().begin() + i*p_second.size2(), p_second.size2(), &l_vec(i) );
+        
+        return l_vec;
+    }
+    
+    
+    
+    /** calculates the distances between all rows or columns of the two matrices
+     * @param p_first first matrix
+     * @param p_second second matrix
+     * @param p_row row / column option (default row)
+     * @return distance matrix (first rows x second rows)
+     **/
+    template<typename T> inline ublas::matrix<T> cosine<T>::getDistanceMatrix( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getDistanceMatrix( static_cast< ublas::matrix<T> >(ublas::trans(p_first)), static_cast< ublas::matrix<T> >(ublas::trans(p_second)), tools::matrix::row );
+        
+        if (p_first.size2() != p_second.size2())
+            throw exception::runtime(_("matrix dimensions are not equal"), *this);
+        
+        const ublas::vector<T> l_firstnorm  = getLength( p_first );
+        const ublas::vector<T> l_secondnorm = getLength( p_second );
+        
+        ublas::matrix<T> l_distance( p_first.size1(), p_second.size1() );
+        kernel<T>::dot( p_first.data().begin(), p_first.size1(), p_first.size2(), p_second.data().begin(), p_second.size1(), p_second.size2(), p_first.size2(), l_distance.data().begin() );
+        
+        for(std::size_t i=0; i < l_distance.size1(); ++i)
+            for(std::size_t j=0; j < l_distance.size2(); ++j)
+                l_distance(i,j) = getCosine( l_distance(i,j), l_firstnorm(i), l_secondnorm(j) );
+        
+        return l_distance;
+    }
+    
+    
+    
+    /** calculates the weighted distance between two vectors, the weights are multiplied elementwise
+     * on both vectors before the angle is calculated
+     * @param p_first first vector
+     * @param p_second second vector
+     * @param p_weight weight vector
+     * @return distance value
+     **/
+    template<typename T> inline T cosine<T>::getWeightedDistance( const ublas::vector<T>& p_first, const ublas::vector<T>& p_second, const ublas::vector<T>& p_weight ) const
+    {
+        if ((p_first.size() != p_second.size()) || (p_first.size() != p_weight.size()))
+            throw exception::runtime(_("vector sizes are not equal"), *this);
+        
+        return getDistance( static_cast< ublas::vector<T> >(ublas::element_prod(p_weight, p_first)), static_cast< ublas::vector<T> >(ublas::element_prod(p_weight, p_second)) );
+    }
+    
+
+    
+    /** calculates the weighted distance between each row / column of the matrix and the vector
+     * @param p_data data matrix
+     * @param p_vec vector
+     * @param p_weight weight vector
+     * @param p_row row / column option (default row)
+     * @return distance vector
+     **/
+    template<typename T> inline ublas::vector<T> cosine<T>::getWeightedDistance( const ublas::matrix<T>& p_data, const ublas::vector<T>& p_vec, const ublas::vector<T>& p_weight, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getWeightedDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_data)), p_vec, p_weight, tools::matrix::row );
+        
+        if ((p_data.size2() != p_vec.size()) || (p_vec.size() != p_weight.size()))
+            throw exception::runtime(_("matrix, vector and weight dimension are not equal"), *this);
+        
+        ublas::matrix<T> l_data( p_data );
+        for(std::size_t i=0; i < l_data.size1(); ++i)
+            ublas::row(l_data, i) = ublas::element_prod( ublas::row(l_data, i), p_weight );
+        
+        return getDistance( l_data, static_cast< ublas::vector<T> >(ublas::element_prod(p_weight, p_vec)) );        
+    }
+    
+    
+    
+    /** calculates the weighted distance between the rows / columns of two matrices
+     * @param p_first first matrix
+     * @param p_second second matrix
+     * @param p_weight weight matrix
+     * @param p_row row / column option (default row)
+     * @return distance vector
+     **/
+    template<typename T> inline ublas::vector<T> cosine<T>::getWeightedDistance( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, const ublas::matrix<T>& p_weight, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getWeightedDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_first)), static_cast< ublas::matrix<T> >(ublas::trans(p_second)), static_cast< ublas::matrix<T> >(ublas::trans(p_weight)), tools::matrix::row );
+        
+        if ((p_first.size1() != p_second.size1()) || (p_first.size2() != p_second.size2()) || (p_first.size1() != p_weight.size1()) || (p_first.size2() != p_weight.size2()))
+            throw exception::runtime(_("matrix dimensions are not equal"), *this);
+        
+        return getDistance( static_cast< ublas::matrix<T> >(ublas::element_prod(p_weight, p_first)), static_cast< ublas::matrix<T> >(ublas::element_prod(p_weight, p_second)) );
+    }
+    
+    
+    
+    /** calculates the weighted distance between each row / column of the matrix and the vector with row / column weights
+     * @param p_matrix matrix
+     * @param p_vec vector
+     * @param p_weight weight matrix
+     * @param p_row row / column option (default row)
+     * @return distance vector
+     **/
+    template<typename T> inline ublas::vector<T> cosine<T>::getWeightedDistance( const ublas::matrix<T>& p_matrix, const ublas::vector<T>& p_vec, const ublas::matrix<T>& p_weight, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getWeightedDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_matrix)), p_vec, static_cast< ublas::matrix<T> >(ublas::trans(p_weight)), tools::matrix::row );
+        
+        if ((p_matrix.size2() != p_vec.size()) || (p_matrix.size1() != p_weight.size1()) || (p_matrix.size2() != p_weight.size2()))
+            throw exception::runtime(_("matrix, vector and weight dimension are not equal"), *this);
+        
+        ublas::matrix<T> l_vec( p_weight );
+        for(std::size_t i=0; i < l_vec.size1(); ++i)
+            ublas::row(l_vec, i) = ublas::element_prod( ublas::row(l_vec, i), p_vec );
+        
+        return getDistance( static_cast< ublas::matrix<T> >(ublas::element_prod(p_weight, p_matrix)), l_vec );
+    }
+    
+    
+} } }
+#endif
@@ -26,6 +26,7 @@
 #ifndef __MACHINELEARNING_DISTANCES_NORM_EUCLID_HPP
 #define __MACHINELEARNING_DISTANCES_NORM_EUCLID_HPP
 
+#include <limits>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/bindings/blas.hpp>
@@ -33,6 +34,7 @@
 #include <boost/numeric/bindings/ublas/matrix.hpp>
 
 #include "../distance.hpp"
+#include "../kernel.hpp"
 #include "../../errorhandling/exception.hpp"
 #include "../../tools/tools.h"
 
@@ -46,7 +48,8 @@ namespace machinelearning { namespace distances { namespace norm {
     #endif
     
     
-    /** class for calculating euclid distance beween datapoints
+    /** class for calculating euclid distance beween datapoints, the distances and lengths are
+     * calculated with the SIMD kernels of distances::kernel directly on the row-major storage
      * @todo portage this class to the Intel Math Kernel Library http://software.intel.com/en-us/articles/intel-mkl/
      **/
     template<typename T> class euclid : public distance<T>
@@ -72,13 +75,20 @@ namespace machinelearning { namespace distances { namespace norm {
             T getDistance( const ublas::vector<T>&, const ublas::vector<T>& ) const;        
             ublas::vector<T> getDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
             ublas::vector<T> getDistance( const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            ublas::matrix<T> getDistanceMatrix( const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
         
             #ifndef SWIG
             T getWeightedDistance( const ublas::vector<T>&, const ublas::vector<T>&, const ublas::vector<T>& ) const;        
             ublas::vector<T> getWeightedDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const ublas::vector<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;        
             ublas::vector<T> getWeightedDistance( const ublas::matrix<T>&, const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
             ublas::vector<T> getWeightedDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            std::size_t getWeightedNearest( const ublas::matrix<T>&, const ublas::vector<T>&, const ublas::matrix<T>& ) const;
             #endif
+        
+        
+        private :
+        
+            static void sqrt( ublas::vector<T>& );
 
     };
     
@@ -89,7 +99,7 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline void euclid<T>::normalize( ublas::vector<T>& p_vec ) const 
     {
-        p_vec /= blas::nrm2( p_vec );
+        p_vec /= getLength( p_vec );
     }    
     
     
@@ -100,18 +110,20 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline void euclid<T>::normalize( ublas::matrix<T>& p_matrix, const tools::matrix::rowtype& p_row ) const
     { 
+        const ublas::vector<T> l_length = getLength( p_matrix, p_row );
+        
         switch (p_row) {                
             case tools::matrix::row :
                 
                     for(std::size_t i=0; i < p_matrix.size1(); ++i)
-                        ublas::row(p_matrix, i) /= blas::nrm2( static_cast< ublas::vector<T> >(ublas::row(p_matrix, i)) );
+                        ublas::row(p_matrix, i) /= l_length(i);
                     break;
                 
                 
             case tools::matrix::column :  
                 
                     for(std::size_t i=0; i < p_matrix.size2(); ++i)
-                        ublas::column(p_matrix, i) /= blas::nrm2( static_cast< ublas::vector<T> >(ublas::column(p_matrix, i)) );
+                        ublas::column(p_matrix, i) /= l_length(i);
                     break;
         }
         
@@ -152,7 +164,7 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline T euclid<T>::getLength( const ublas::vector<T>& p_vec ) const
     {
-        return blas::nrm2( p_vec );
+        return std::sqrt( kernel<T>::dot(p_vec.data().begin(), p_vec.data().begin(), p_vec.size()) );
     }
 
     
@@ -164,22 +176,16 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline ublas::vector<T> euclid<T>::getLength( const ublas::matrix<T>& p_matrix, const tools::matrix::rowtype& p_row ) const
     {
-        ublas::vector<T> l_vec( (p_row==tools::matrix::row) ? p_matrix.size1() : p_matrix.size2()  );
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getLength( static_cast< ublas::matrix<T> >(ublas::trans(p_matrix)), tools::matrix::row );
         
-        switch (p_row) {                
-            case tools::matrix::row :
-                
-                for(std::size_t i=0; i < l_vec.size(); ++i)
-                    l_vec(i) = blas::nrm2( static_cast< ublas::vector<T> >(ublas::row(p_matrix, i)) );
-                break;
-                
-                
-            case tools::matrix::column :  
-                
-                for(std::size_t i=0; i < l_vec.size(); ++i)
-                    l_vec(i) = blas::nrm2( static_cast< ublas::vector<T> >(ublas::column(p_matrix, i)) );
-                break;
+        ublas::vector<T> l_vec( p_matrix.size1() );
+        for(std::size_t i=0; i < l_vec.size(); ++i) {
+            const T* l_row = p_matrix.data().begin() + i*p_matrix.size2();
+            l_vec(i)       = kernel<T>::dot( l_row, l_row, p_matrix.size2() );
         }
+        sqrt( l_vec );
         
         return l_vec;
     }
@@ -215,6 +221,17 @@ namespace machinelearning { namespace distances { namespace norm {
     {
         p_vec = tools::vector::pow<T>(p_vec, 2);
     }
+    
+    
+    
+    /** calculates the square root of each element
+     * @param p_vec vector
+     **/
+    template<typename T> inline void euclid<T>::sqrt( ublas::vector<T>& p_vec )
+    {
+        for(std::size_t i=0; i < p_vec.size(); ++i)
+            p_vec(i) = std::sqrt( p_vec(i) );
+    }
    
 
     
@@ -225,8 +242,10 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline T euclid<T>::getDistance( const ublas::vector<T>& p_first, const ublas::vector<T>& p_second ) const
     {
-        ublas::vector<T> l_vec = p_first-p_second;
-        return blas::nrm2( l_vec );
+        if (p_first.size() != p_second.size())
+            throw exception::runtime(_("vector sizes are not equal"), *this);
+        
+        return std::sqrt( kernel<T>::squaredEuclid(p_first.data().begin(), p_second.data().begin(), p_first.size()) );
     }
     
     
@@ -238,24 +257,16 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline ublas::vector<T> euclid<T>::getDistance( const ublas::matrix<T>& p_data, const ublas::vector<T>& p_vec, const tools::matrix::rowtype& p_row ) const
     {
-        ublas::vector<T> l_vec( (p_row==tools::matrix::row) ? p_data.size1() : p_data.size2()  );
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_data)), p_vec, tools::matrix::row );
         
-        switch (p_row) {                
-            case tools::matrix::row :
-                
-                for(std::size_t i=0; i < l_vec.size(); ++i)
-                    l_vec(i) = getDistance( ublas::row(p_data, i), p_vec);
-                    
-                break;
-                
-                
-            case tools::matrix::column :  
-                
-                for(std::size_t i=0; i < l_vec.size(); ++i)
-                    l_vec(i) = getDistance( ublas::column(p_data, i), p_vec);
-                
-                break;
-        }
+        if (p_data.size2() != p_vec.size())
+            throw exception::runtime(_("matrix and vector dimension are not equal"), *this);
+        
+        ublas::vector<T> l_vec( p_data.size1() );
+        kernel<T>::squaredEuclid( p_data.data().begin(), p_data.size1(), p_data.size2(), p_vec.data().begin(), p_vec.size(), l_vec.data().begin() );
+        sqrt( l_vec );
 
         return l_vec;
     }
@@ -270,28 +281,49 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline ublas::vector<T> euclid<T>::getDistance( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, const tools::matrix::rowtype& p_row ) const
     {
-        ublas::vector<T> l_vec( (p_row==tools::matrix::row) ? p_first.size1() : p_first.size2()  );
-        ublas::matrix<T> l_matrix = p_first-p_second;
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_first)), static_cast< ublas::matrix<T> >(ublas::trans(p_second)), tools::matrix::row );
         
-        switch (p_row) {                
-            
-            case tools::matrix::row :
-                
-                for(std::size_t i=0; i < l_vec.size(); ++i)
-                    l_vec(i) = blas::nrm2( static_cast< ublas::vector<T> >(ublas::row(l_matrix, i)) );
-                break;
-            
-                
-            case tools::matrix::column :  for(std::size_t i=0; i < l_vec.size(); ++i)
-                    l_vec(i) = blas::nrm2( static_cast< ublas::vector<T> >(ublas::column(l_matrix, i)) );
-                break;
-        }
+        if ((p_first.size1() != p_second.size1()) || (p_first.size2() != p_second.size2()))
+            throw exception::runtime(_("matrix dimensions are not equal"), *this);
+        
+        ublas::vector<T> l_vec( p_first.size1() );
+        for(std::size_t i=0; i < l_vec.size(); ++i)
+            l_vec(i) = kernel<T>::squaredEuclid( p_first.data().begin() + i*p_first.size2(), p_second.data().begin() + i*p_second.size2(), p_first.size2() );
+        sqrt( l_vec );
         
         return l_vec;
     }
     
     
     
+    /** calculates the distances between all rows or columns of the two matrices
+     * @param p_first first matrix
+     * @param p_second second matrix
+     * @param p_row row / column option (default row)
+     * @return distance matrix (first rows x second rows)
+     **/
+    template<typename T> inline ublas::matrix<T> euclid<T>::getDistanceMatrix( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getDistanceMatrix( static_cast< ublas::matrix<T> >(ublas::trans(p_first)), static_cast< ublas::matrix<T> >(ublas::trans(p_second)), tools::matrix::row );
+        
+        if (p_first.size2() != p_second.size2())
+            throw exception::runtime(_("matrix dimensions are not equal"), *this);
+        
+        ublas::matrix<T> l_distance( p_first.size1(), p_second.size1() );
+        kernel<T>::squaredEuclid( p_first.data().begin(), p_first.size1(), p_first.size2(), p_second.data().begin(), p_second.size1(), p_second.size2(), p_first.size2(), l_distance.data().begin() );
+        
+        for(T* i = l_distance.data().begin(); i != l_distance.data().end(); ++i)
+            *i = std::sqrt( *i );
+        
+        return l_distance;
+    }
+    
+    
+    
     /** calculates the weighted distance between two vectors [ norm2(weight .* (vectorA - vectorB)) ]
      * @param p_first first vector
      * @param p_second second vector
@@ -300,9 +332,10 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline T euclid<T>::getWeightedDistance( const ublas::vector<T>& p_first, const ublas::vector<T>& p_second, const ublas::vector<T>& p_weight ) const
     {
-        ublas::vector<T> l_vec = p_first-p_second;
-        l_vec = ublas::element_prod( p_weight, l_vec );
-        return blas::nrm2(  l_vec );
+        if ((p_first.size() != p_second.size()) || (p_first.size() != p_weight.size()))
+            throw exception::runtime(_("vector sizes are not equal"), *this);
+        
+        return std::sqrt( kernel<T>::weightedSquaredEuclid(p_first.data().begin(), p_second.data().begin(), p_weight.data().begin(), p_first.size()) );
     }
     
 
@@ -316,31 +349,16 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline ublas::vector<T> euclid<T>::getWeightedDistance( const ublas::matrix<T>& p_data, const ublas::vector<T>& p_vec, const ublas::vector<T>& p_weight, const tools::matrix::rowtype& p_row ) const
     {
-        ublas::vector<T> l_vec( (p_row==tools::matrix::row) ? p_data.size1() : p_data.size2()  );
-        ublas::vector<T> l_help;
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getWeightedDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_data)), p_vec, p_weight, tools::matrix::row );
         
-        switch (p_row) {                
-            case tools::matrix::row :
-                
-                for(std::size_t i=0; i < l_vec.size(); ++i) {
-                    l_help   = ublas::row(p_data, i) - p_vec;
-                    l_help   = ublas::element_prod( p_weight, l_help );
-                    l_vec(i) = blas::nrm2( l_help );
-                }
-                
-                break;
-                
-                
-            case tools::matrix::column :  
-                
-                for(std::size_t i=0; i < l_vec.size(); ++i) {
-                    l_help   = ublas::column(p_data, i) - p_vec;
-                    l_help   = ublas::element_prod( p_weight, l_help );
-                    l_vec(i) = blas::nrm2( l_help );
-                }
-                
-                break;
-        }
+        if ((p_data.size2() != p_vec.size()) || (p_vec.size() != p_weight.size()))
+            throw exception::runtime(_("matrix, vector and weight dimension are not equal"), *this);
+        
+        ublas::vector<T> l_vec( p_data.size1() );
+        kernel<T>::weightedSquaredEuclid( p_data.data().begin(), p_data.size1(), p_data.size2(), p_vec.data().begin(), p_weight.data().begin(), 0, p_vec.size(), l_vec.data().begin() );
+        sqrt( l_vec );
         
         return l_vec;        
     }
@@ -356,24 +374,17 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline ublas::vector<T> euclid<T>::getWeightedDistance( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, const ublas::matrix<T>& p_weight, const tools::matrix::rowtype& p_row ) const
     {
-        ublas::vector<T> l_vec( (p_row==tools::matrix::row) ? p_first.size1() : p_first.size2()  );
-        ublas::matrix<T> l_matrix = ublas::element_prod( p_weight, p_first-p_second );
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getWeightedDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_first)), static_cast< ublas::matrix<T> >(ublas::trans(p_second)), static_cast< ublas::matrix<T> >(ublas::trans(p_weight)), tools::matrix::row );
         
-        switch (p_row) {                
-                
-            case tools::matrix::row :
-                
-                for(std::size_t i=0; i < l_vec.size(); ++i)
-                    l_vec(i) = blas::nrm2( static_cast< ublas::vector<T> >(ublas::row(l_matrix, i)) );
-                break;
-                
-                
-            case tools::matrix::column : 
-                
-                for(std::size_t i=0; i < l_vec.size(); ++i)
-                    l_vec(i) = blas::nrm2( static_cast< ublas::vector<T> >(ublas::column(l_matrix, i)) );
-                break;
-        }
+        if ((p_first.size1() != p_second.size1()) || (p_first.size2() != p_second.size2()) || (p_first.size1() != p_weight.size1()) || (p_first.size2() != p_weight.size2()))
+            throw exception::runtime(_("matrix dimensions are not equal"), *this);
+        
+        ublas::vector<T> l_vec( p_first.size1() );
+        for(std::size_t i=0; i < l_vec.size(); ++i)
+            l_vec(i) = kernel<T>::weightedSquaredEuclid( p_first.data().begin() + i*p_first.size2(), p_second.data().begin() + i*p_second.size2(), p_weight.data().begin() + i*p_weight.size2(), p_first.size2() );
+        sqrt( l_vec );
         
         return l_vec;
     }
@@ -389,28 +400,47 @@ namespace machinelearning { namespace distances { namespace norm {
      **/
     template<typename T> inline ublas::vector<T> euclid<T>::getWeightedDistance( const ublas::matrix<T>& p_matrix, const ublas::vector<T>& p_vec, const ublas::matrix<T>& p_weight, const tools::matrix::rowtype& p_row ) const
     {
-        ublas::vector<T> l_vec( (p_row==tools::matrix::row) ? p_matrix.size1() : p_matrix.size2()  );
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getWeightedDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_matrix)), p_vec, static_cast< ublas::matrix<T> >(ublas::trans(p_weight)), tools::matrix::row );
         
-        switch (p_row) {                
-                
-            case tools::matrix::row :
-                
-                for(std::size_t i=0; i < l_vec.size(); ++i)
-                    l_vec(i) = getWeightedDistance( ublas::row(p_matrix, i), p_vec, ublas::row(p_weight, i) );
-                break;
-                
-            
-            case tools::matrix::column :
-
-                for(std::size_t i=0; i < l_vec.size(); ++i)
-                    l_vec(i) = getWeightedDistance( ublas::column(p_matrix, i), p_vec, ublas::column(p_weight, i) );
-                break;
+        if ((p_matrix.size2() != p_vec.size()) || (p_matrix.size1() != p_weight.size1()) || (p_matrix.size2() != p_weight.size2()))
+            throw exception::runtime(_("matrix, vector and weight dimension are not equal"), *this);
         
-        }
+        ublas::vector<T> l_vec( p_matrix.size1() );
+        kernel<T>::weightedSquaredEuclid( p_matrix.data().begin(), p_matrix.size1(), p_matrix.size2(), p_vec.data().begin(), p_weight.data().begin(), p_weight.size2(), p_vec.size(), l_vec.data().begin() );
+        sqrt( l_vec );
         
         return l_vec;
     }
     
     
+    /** index of the nearest row of the matrix, each row is weighted with the row of the
+     * weight matrix. The kernel is called on the rows with a running minimum, so there is
+     * no temporary distance vector (the squared distance has got the same nearest row)
+     * @param p_matrix matrix
+     * @param p_vec vector
+     * @param p_weight weight matrix (one row for each row of the matrix)
+     * @return row index of the nearest row
+     **/
+    template<typename T> inline std::size_t euclid<T>::getWeightedNearest( const ublas::matrix<T>& p_matrix, const ublas::vector<T>& p_vec, const ublas::matrix<T>& p_weight ) const
+    {
+        if ((p_matrix.size2() != p_vec.size()) || (p_matrix.size1() != p_weight.size1()) || (p_matrix.size2() != p_weight.size2()))
+            throw exception::runtime(_("matrix, vector and weight dimension are not equal"), *this);
+        
+        std::size_t l_nearest = 0;
+        T l_min               = std::numeric_limits<T>::max();
+        for(std::size_t i=0; i < p_matrix.size1(); ++i) {
+            const T l_distance = kernel<T>::weightedSquaredEuclid( p_matrix.data().begin() + i*p_matrix.size2(), p_vec.data().begin(), p_weight.data().begin() + i*p_weight.size2(), p_vec.size() );
+            if (l_distance < l_min) {
+                l_min     = l_distance;
+                l_nearest = i;
+            }
+        }
+        
+        return l_nearest;
+    }
+    
+    
 } } }
 #endif
@@ -0,0 +1,493 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+
+#ifndef __MACHINELEARNING_DISTANCES_NORM_MAHALANOBIS_HPP
+#define __MACHINELEARNING_DISTANCES_NORM_MAHALANOBIS_HPP
+
+#include <cmath>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+
+#include "../distance.hpp"
+#include "../kernel.hpp"
+#include "../../errorhandling/exception.hpp"
+#include "../../tools/tools.h"
+
+
+namespace machinelearning { namespace distances { namespace norm {
+    
+    
+    #ifndef SWIG
+    namespace ublas  = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class for calculating the mahalanobis distance beween datapoints [ sqrt( (a-b)' * inv(C) * (a-b) ) ].
+     * The Cholesky factor C = L * L' is calculated once in the constructor and the inverse of L is stored,
+     * so each distance is the euclidian distance of the whitened datapoints ( inv(L) * a ). The matrices are
+     * whitened once for each call and the distances are calculated with the SIMD kernels
+     **/
+    template<typename T> class mahalanobis : public distance<T>
+    {
+        
+        public:
+        
+            mahalanobis( const ublas::matrix<T>& );
+        
+            #ifndef SWIG
+            void normalize( ublas::vector<T>& ) const;
+            void normalize( ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;        
+            #endif
+            ublas::vector<T> getNormalize( const ublas::vector<T>& ) const;
+            ublas::matrix<T> getNormalize( const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+        
+            T getLength( const ublas::vector<T>& ) const;
+            ublas::vector<T> getLength( const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            T getInvert( const T& ) const;
+            ublas::vector<T> getAbs( const ublas::vector<T>& ) const;
+            #ifndef SWIG
+            void abs( ublas::vector<T>& ) const;
+            #endif
+        
+            T getDistance( const ublas::vector<T>&, const ublas::vector<T>& ) const;        
+            ublas::vector<T> getDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            ublas::vector<T> getDistance( const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            ublas::matrix<T> getDistanceMatrix( const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+        
+            #ifndef SWIG
+            T getWeightedDistance( const ublas::vector<T>&, const ublas::vector<T>&, const ublas::vector<T>& ) const;        
+            ublas::vector<T> getWeightedDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const ublas::vector<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;        
+            ublas::vector<T> getWeightedDistance( const ublas::matrix<T>&, const ublas::matrix<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            ublas::vector<T> getWeightedDistance( const ublas::matrix<T>&, const ublas::vector<T>&, const ublas::matrix<T>&, const tools::matrix::rowtype& = tools::matrix::row ) const;
+            #endif
+        
+        
+        private :
+        
+            /** inverse of the lower Cholesky factor of the covariance matrix **/
+            ublas::matrix<T> m_whitening;
+        
+            ublas::vector<T> whiten( const ublas::vector<T>& ) const;
+            ublas::matrix<T> whiten( const ublas::matrix<T>& ) const;
+            static void sqrt( ublas::vector<T>& );
+
+    };
+    
+    
+    
+    /** constructor, that calculates the Cholesky factor of the covariance matrix and their inverse
+     * @param p_covariance symmetric positive definite covariance matrix
+     **/
+    template<typename T> inline mahalanobis<T>::mahalanobis( const ublas::matrix<T>& p_covariance ) :
+        m_whitening( p_covariance.size1(), p_covariance.size2(), 0 )
+    {
+        if (p_covariance.size1() != p_covariance.size2())
+            throw exception::runtime(_("covariance matrix must be square"), *this);
+        
+        // Cholesky decomposition C = L * L'
+        ublas::matrix<T> l_cholesky( p_covariance.size1(), p_covariance.size2(), 0 );
+        for(std::size_t j=0; j < l_cholesky.size1(); ++j) {
+            T l_diagonal = p_covariance(j,j);
+            for(std::size_t k=0; k < j; ++k)
+                l_diagonal -= l_cholesky(j,k) * l_cholesky(j,k);
+            
+            if (l_diagonal <= 0)
+                throw exception::runtime(_("covariance matrix must be positive definite"), *this);
+            l_cholesky(j,j) = std::sqrt( l_diagonal );
+            
+            for(std::size_t i=j+1; i < l_cholesky.size1(); ++i) {
+                T l_value = p_covariance(i,j);
+                for(std::size_t k=0; k < j; ++k)
+                    l_value -= l_cholesky(i,k) * l_cholesky(j,k);
+                l_cholesky(i,j) = l_value / l_cholesky(j,j);
+            }
+        }
+        
+        // inverse of the lower triangular matrix by forward substitution
+        for(std::size_t j=0; j < m_whitening.size2(); ++j) {
+            m_whitening(j,j) = static_cast<T>(1) / l_cholesky(j,j);
+            
+            for(std::size_t i=j+1; i < m_whitening.size1(); ++i) {
+                T l_value = 0;
+                for(std::size_t k=j; k < i; ++k)
+                    l_value -= l_cholesky(i,k) * m_whitening(k,j);
+                m_whitening(i,j) = l_value / l_cholesky(i,i);
+            }
+        }
+    }
+    
+    
+    
+    /** whitens a vector [ inv(L) * vector ]
+     * @param p_vec vector
+     * @return whitened vector
+     **/
+    template<typename T> inline ublas::vector<T> mahalanobis<T>::whiten( const ublas::vector<T>& p_vec ) const
+    {
+        if (p_vec.size() != m_whitening.size2())
+            throw exception::runtime(_("vector and covariance dimension are not equal"), *this);
+        
+        ublas::vector<T> l_vec( m_whitening.size1() );
+        kernel<T>::dot( m_whitening.data().begin(), m_whitening.size1(), m_whitening.size2(), p_vec.data().begin(), p_vec.size(), l_vec.data().begin() );
+        return l_vec;
+    }
+    
+    
+    
+    /** whitens each row of the matrix [ matrix * inv(L)' ]
+     * @param p_matrix row-orientated matrix
+     * @return whitened matrix
+     **/
+    template<typename T> inline ublas::matrix<T> mahalanobis<T>::whiten( const ublas::matrix<T>& p_matrix ) const
+    {
+        if (p_matrix.size2() != m_whitening.size2())
+            throw exception::runtime(_("matrix and covariance dimension are not equal"), *this);
+        
+        ublas::matrix<T> l_matrix( p_matrix.size1(), m_whitening.size1() );
+        kernel<T>::dot( p_matrix.data().begin(), p_matrix.size1(), p_matrix.size2(), m_whitening.data().begin(), m_whitening.size1(), m_whitening.size2(), p_matrix.size2(), l_matrix.data().begin() );
+        return l_matrix;
+    }
+    
+    
+    
+    /** calculates the square root of each element
+     * @param p_vec vector
+     **/
+    template<typename T> inline void mahalanobis<T>::sqrt( ublas::vector<T>& p_vec )
+    {
+        for(std::size_t i=0; i < p_vec.size(); ++i)
+            p_vec(i) = std::sqrt( p_vec(i) );
+    }
+    
+    
+    
+    /** normalize a vector with the mahalanobis norm
+     * @param p_vec vector which should be normalized
+     **/
+    template<typename T> inline void mahalanobis<T>::normalize( ublas::vector<T>& p_vec ) const 
+    {
+        p_vec /= getLength( p_vec );
+    }    
+    
+    
+   
+    /** normalize a matrix on their rows or columns vectors
+     * @param p_matrix matrix for normalization
+     * @param p_row option for row or column iteration (default row)
+     **/
+    template<typename T> inline void mahalanobis<T>::normalize( ublas::matrix<T>& p_matrix, const tools::matrix::rowtype& p_row ) const
+    { 
+        const ublas::vector<T> l_length = getLength( p_matrix, p_row );
+        
+        switch (p_row) {                
+            case tools::matrix::row :
+                
+                    for(std::size_t i=0; i < p_matrix.size1(); ++i)
+                        ublas::row(p_matrix, i) /= l_length(i);
+                    break;
+                
+                
+            case tools::matrix::column :  
+                
+                    for(std::size_t i=0; i < p_matrix.size2(); ++i)
+                        ublas::column(p_matrix, i) /= l_length(i);
+                    break;
+        }
+    }
+    
+    
+    
+    /** return the normalized vector
+     * @param p_vec vector which should be normalized
+     * @return vector
+     **/
+    template<typename T> inline ublas::vector<T> mahalanobis<T>::getNormalize( const ublas::vector<T>& p_vec ) const 
+    {
+        ublas::vector<T> l_vec = p_vec;
+        normalize(l_vec);
+        return l_vec;
+    }
+    
+    
+    
+    /** normalize a matrix on their rows or columns vectors
+     * @param p_matrix matrix for noamlization
+     * @param p_row option for row or column iteration (default row)
+     * @return normalized matrix
+     **/
+    template<typename T> inline ublas::matrix<T> mahalanobis<T>::getNormalize( const ublas::matrix<T>& p_matrix, const tools::matrix::rowtype& p_row ) const
+    {
+        ublas::matrix<T> l_matrix = p_matrix;
+        normalize(l_matrix, p_row);
+        return l_matrix;
+    }
+    
+    
+    
+    /** returns the mahalanobis length of a vector [ sqrt(vector' * inv(C) * vector) ]
+     * @param p_vec vector
+     * @return length of the vector
+     **/
+    template<typename T> inline T mahalanobis<T>::getLength( const ublas::vector<T>& p_vec ) const
+    {
+        const ublas::vector<T> l_vec = whiten( p_vec );
+        return std::sqrt( kernel<T>::dot(l_vec.data().begin(), l_vec.data().begin(), l_vec.size()) );
+    }
+
+    
+    
+    /** returns for every row or column the length 
+     * @param p_matrix matrix
+     * @param p_row option for row or column iteration (default row)
+     * @return vector with length
+     **/
+    template<typename T> inline ublas::vector<T> mahalanobis<T>::getLength( const ublas::matrix<T>& p_matrix, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getLength( static_cast< ublas::matrix<T> >(ublas::trans(p_matrix)), tools::matrix::row );
+        
+        const ublas::matrix<T> l_matrix = whiten( p_matrix );
+        
+        ublas::vector<T> l_vec( l_matrix.size1() );
+        for(std::size_t i=0; i < l_vec.size(); ++i) {
+            const T* l_row = l_matrix.data().begin() + i*l_matrix.size2();
+            l_vec(i)       = kernel<T>::dot( l_row, l_row, l_matrix.size2() );
+        }
+        sqrt( l_vec );
+        
+        return l_vec;
+    }
+    
+    
+    
+    /** returns a invertet value
+     * @param p_val value
+     * @return inverted value
+     **/
+    template<typename T> inline T mahalanobis<T>::getInvert( const T& p_val ) const
+    {
+        return std::pow( p_val, static_cast<T>(-2) );
+    }    
+    
+    
+    
+    /** calculate absolut values for a vector like vec.^2
+     * @param p_vec vector
+     * @return absolut value
+     **/
+    template<typename T> inline ublas::vector<T> mahalanobis<T>::getAbs( const ublas::vector<T>& p_vec ) const
+    {
+        return tools::vector::pow<T>(p_vec, 2);
+    }    
+    
+    
+    
+    /** calculate absolut values for every element of the vector like vec.^2
+     * @param p_vec vector
+     **/
+    template<typename T> inline void mahalanobis<T>::abs( ublas::vector<T>& p_vec ) const
+    {
+        p_vec = tools::vector::pow<T>(p_vec, 2);
+    }
+   
+
+    
+    /** calculates the distance between two vectors
+     * @param p_first first vector
+     * @param p_second second vector
+     * @return distance value
+     **/
+    template<typename T> inline T mahalanobis<T>::getDistance( const ublas::vector<T>& p_first, const ublas::vector<T>& p_second ) const
+    {
+        if (p_first.size() != p_second.size())
+            throw exception::runtime(_("vector sizes are not equal"), *this);
+        
+        return getLength( static_cast< ublas::vector<T> >(p_first - p_second) );
+    }
+    
+    
+    /** calculates the distance beween every row or column of the matrix and the vector
+     * @param p_data matrix
+     * @param p_vec vector
+     * @param p_row row / column option (default row)
+     * @return vector with distance values
+     **/
+    template<typename T> inline ublas::vector<T> mahalanobis<T>::getDistance( const ublas::matrix<T>& p_data, const ublas::vector<T>& p_vec, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_data)), p_vec, tools::matrix::row );
+        
+        if (p_data.size2() != p_vec.size())
+            throw exception::runtime(_("matrix and vector dimension are not equal"), *this);
+        
+        const ublas::matrix<T> l_data = whiten( p_data );
+        const ublas::vector<T> l_point = whiten( p_vec );
+        
+        ublas::vector<T> l_vec( l_data.size1() );
+        kernel<T>::squaredEuclid( l_data.data().begin(), l_data.size1(), l_data.size2(), l_point.data().begin(), l_point.size(), l_vec.data().begin() );
+        sqrt( l_vec );
+
+        return l_vec;
+    }
+    
+    
+    
+    /** calculates the distance between every row and column of the matrices
+     * @param p_first first matrix
+     * @param p_second second matrix
+     * @param p_row row / column option (default row)
+     * @return distance vector
+     **/
+    template<typename T> inline ublas::vector<T> mahalanobis<T>::getDistance( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_first)), static_cast< ublas::matrix<T> >(ublas::trans(p_second)), tools::matrix::row );
+        
+        if ((p_first.size1() != p_second.size1()) || (p_first.size2() != p_second.size2()))
+            throw exception::runtime(_("matrix dimensions are not equal"), *this);
+        
+        return getLength( static_cast< ublas::matrix<T> >(p_first - p_second) );
+    }
+    
+    
+    
+    /** calculates the distances between all rows or columns of the two matrices
+     * @param p_first first matrix
+     * @param p_second second matrix
+     * @param p_row row / column option (default row)
+     * @return distance matrix (first rows x second rows)
+     **/
+    template<typename T> inline ublas::matrix<T> mahalanobis<T>::getDistanceMatrix( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getDistanceMatrix( static_cast< ublas::matrix<T> >(ublas::trans(p_first)), static_cast< ublas::matrix<T> >(ublas::trans(p_second)), tools::matrix::row );
+        
+        const ublas::matrix<T> l_first  = whiten( p_first );
+        const ublas::matrix<T> l_second = whiten( p_second );
+        
+        ublas::matrix<T> l_distance( l_first.size1(), l_second.size1() );
+        kernel<T>::squaredEuclid( l_first.data().begin(), l_first.size1(), l_first.size2(), l_second.data().begin(), l_second.size1(), l_second.size2(), l_first.size2(), l_distance.data().begin() );
+        
+        for(T* i = l_distance.data().begin(); i != l_distance.data().end(); ++i)
+            *i = std::sqrt( *i );
+        
+        return l_distance;
+    }
+    
+    
+    
+    /** calculates the weighted distance between two vectors [ length(weight .* (vectorA - vectorB)) ]
+     * @param p_first first vector
+     * @param p_second second vector
+     * @param p_weight weight vector
+     * @return distance value
+     **/
+    template<typename T> inline T mahalanobis<T>::getWeightedDistance( const ublas::vector<T>& p_first, const ublas::vector<T>& p_second, const ublas::vector<T>& p_weight ) const
+    {
+        if ((p_first.size() != p_second.size()) || (p_first.size() != p_weight.size()))
+            throw exception::runtime(_("vector sizes are not equal"), *this);
+        
+        return getLength( static_cast< ublas::vector<T> >(ublas::element_prod(p_weight, p_first - p_second)) );
+    }
+    
+
+    
+    /** calculates the weighted distance between each row / column of the matrix and the vector
+     * @param p_data data matrix
+     * @param p_vec vector
+     * @param p_weight weight vector
+     * @param p_row row / column option (default row)
+     * @return distance vector
+     **/
+    template<typename T> inline ublas::vector<T> mahalanobis<T>::getWeightedDistance( const ublas::matrix<T>& p_data, const ublas::vector<T>& p_vec, const ublas::vector<T>& p_weight, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getWeightedDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_data)), p_vec, p_weight, tools::matrix::row );
+        
+        if ((p_data.size2() != p_vec.size()) || (p_vec.size() != p_weight.size()))
+            throw exception::runtime(_("matrix, vector and weight dimension are not equal"), *this);
+        
+        ublas::matrix<T> l_data( p_data );
+        for(std::size_t i=0; i < l_data.size1(); ++i)
+            ublas::row(l_data, i) = ublas::element_prod( ublas::row(l_data, i) - p_vec, p_weight );
+        
+        return getLength( l_data );
+    }
+    
+    
+    
+    /** calculates the weighted distance between the rows / columns of two matrices
+     * @param p_first first matrix
+     * @param p_second second matrix
+     * @param p_weight weight matrix
+     * @param p_row row / column option (default row)
+     * @return distance vector
+     **/
+    template<typename T> inline ublas::vector<T> mahalanobis<T>::getWeightedDistance( const ublas::matrix<T>& p_first, const ublas::matrix<T>& p_second, const ublas::matrix<T>& p_weight, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getWeightedDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_first)), static_cast< ublas::matrix<T> >(ublas::trans(p_second)), static_cast< ublas::matrix<T> >(ublas::trans(p_weight)), tools::matrix::row );
+        
+        if ((p_first.size1() != p_second.size1()) || (p_first.size2() != p_second.size2()) || (p_first.size1() != p_weight.size1()) || (p_first.size2() != p_weight.size2()))
+            throw exception::runtime(_("matrix dimensions are not equal"), *this);
+        
+        return getLength( static_cast< ublas::matrix<T> >(ublas::element_prod(p_weight, p_first - p_second)) );
+    }
+    
+    
+    
+    /** calculates the weighted distance between each row / column of the matrix and the vector with row / column weights
+     * @param p_matrix matrix
+     * @param p_vec vector
+     * @param p_weight weight matrix
+     * @param p_row row / column option (default row)
+     * @return distance vector
+     **/
+    template<typename T> inline ublas::vector<T> mahalanobis<T>::getWeightedDistance( const ublas::matrix<T>& p_matrix, const ublas::vector<T>& p_vec, const ublas::matrix<T>& p_weight, const tools::matrix::rowtype& p_row ) const
+    {
+        // the kernels work on rows, so columns are transposed
+        if (p_row == tools::matrix::column)
+            return getWeightedDistance( static_cast< ublas::matrix<T> >(ublas::trans(p_matrix)), p_vec, static_cast< ublas::matrix<T> >(ublas::trans(p_weight)), tools::matrix::row );
+        
+        if ((p_matrix.size2() != p_vec.size()) || (p_matrix.size1() != p_weight.size1()) || (p_matrix.size2() != p_weight.size2()))
+            throw exception::runtime(_("matrix, vector and weight dimension are not equal"), *this);
+        
+        ublas::matrix<T> l_data( p_matrix );
+        for(std::size_t i=0; i < l_data.size1(); ++i)
+            ublas::row(l_data, i) = ublas::element_prod( ublas::row(l_data, i) - p_vec, ublas::row(p_weight, i) );
+        
+        return getLength( l_data );
+    }
+    
+    
+} } }
+#endif
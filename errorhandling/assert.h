@@ -50,7 +50,7 @@
                     if (machinelearning::tools::logger::exists()) {   \
                         std::stringstream l_msg; \
                         l_msg << p_message << ", " << __FILE__ << ", line " << __LINE__; \
-                        machinelearning::tools::logger::getInstance()->write( machinelearning::tools::logger::assert, l_msg.str() ); \
+                        machinelearning::tools::logger::getInstance()->write<machinelearning::tools::logger::assert>( l_msg.str() ); \
                     } \
                     std::cerr << "Machinlearning Assertion failed: " << p_message << ", " << __FILE__ << ", line " << __LINE__ << std::endl; \
                     exit(EXIT_FAILURE); \
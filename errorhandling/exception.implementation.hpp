@@ -45,7 +45,7 @@ namespace machinelearning { namespace exception {
     {
         #ifdef MACHINELEARNING_LOGGER
         if (tools::logger::exists())
-            tools::logger::getInstance()->write( tools::logger::exception, _("runtime exception is thrown: ") + p_msg);
+            tools::logger::getInstance()->write<tools::logger::exception>( _("runtime exception is thrown: ") + p_msg);
         #endif
     }  
 
@@ -59,7 +59,7 @@ namespace machinelearning { namespace exception {
     {
         #ifdef MACHINELEARNING_LOGGER
         if (tools::logger::exists())
-            tools::logger::getInstance()->write( tools::logger::exception, _("runtime exception is thrown: ") + p_msg + ( !tools::typeinfo::getClassName(p_ptr).empty() ? " ["+tools::typeinfo::getClassName(p_ptr)+"]" : ""));
+            tools::logger::getInstance()->write<tools::logger::exception>( _("runtime exception is thrown: ") + p_msg + ( !tools::typeinfo::getClassName(p_ptr).empty() ? " ["+tools::typeinfo::getClassName(p_ptr)+"]" : ""));
         #endif
     }  
 
@@ -73,7 +73,7 @@ namespace machinelearning { namespace exception {
     {
         #ifdef MACHINELEARNING_LOGGER
         if (tools::logger::exists())
-            tools::logger::getInstance()->write( tools::logger::exception, _("runtime exception is thrown: ") + p_msg + ( !tools::typeinfo::getClassName(p_obj).empty() ? " ["+tools::typeinfo::getClassName(p_obj)+"]" : ""));
+            tools::logger::getInstance()->write<tools::logger::exception>( _("runtime exception is thrown: ") + p_msg + ( !tools::typeinfo::getClassName(p_obj).empty() ? " ["+tools::typeinfo::getClassName(p_obj)+"]" : ""));
         #endif
     }  
   
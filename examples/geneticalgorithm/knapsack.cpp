@@ -43,7 +43,7 @@ template<typename T, typename L> class fitness : public ga::fitness::fitness<T,L
 {
     public :
 
-        fitness( const ublas::vector<T>& p_weight, const T& p_max ) : m_optimum(false), m_weight(p_weight), m_max(p_max) {}
+        fitness( const ublas::vector<T>& p_weight, const T& p_max ) : m_optimum(false), m_generation(0), m_weight(p_weight), m_max(p_max) {}
 
         T getFitness( const ga::individual::individual<L>& p_ind )
         {
@@ -66,12 +66,22 @@ template<typename T, typename L> class fitness : public ga::fitness::fitness<T,L
             p_ptr = boost::shared_ptr< ga::fitness::fitness<T,L> >( new fitness(m_weight, m_max) );
         }
 
-        void onEachIteration( const std::vector< boost::shared_ptr< ga::individual::individual<L> > >& ) {}
+        // counts the generations (the calls are passed through the cache, if it is used)
+        void onEachIteration( const std::vector< boost::shared_ptr< ga::individual::individual<L> > >& )
+        {
+            m_generation++;
+        }
+
+        std::size_t getGeneration( void ) const
+        {
+            return m_generation;
+        }
 
 
     private :
 
         bool m_optimum;
+        std::size_t m_generation;
         const ublas::vector<T> m_weight;
         const T m_max;
 };
@@ -95,6 +105,7 @@ int main(int p_argc, char* p_argv[])
     std::size_t l_cuts;
     double l_packsize;
     double l_mutation;
+    std::size_t l_cachesize;
 
 
     // create CML options with description
@@ -109,6 +120,7 @@ int main(int p_argc, char* p_argv[])
         ("selection", po::value< std::vector<std::string> >()->multitoken(), "type of selection (values: bestof <number = 3> [default], roulette)")
         ("iteration", po::value<std::size_t>(&l_iteration)->default_value(25), "number of iterations")
         ("mutation", po::value<double>(&l_mutation)->default_value(0.65), "mutation probability")
+        ("cache", po::value<std::size_t>(&l_cachesize)->default_value(0), "number of cached fitness values (zero disables the cache)")
     ;
 
     po::variables_map l_map;
@@ -169,7 +181,13 @@ int main(int p_argc, char* p_argv[])
     ga::population<double,unsigned char> l_population(l_individual, l_populationsize, l_elitesize);
 
     l_population.setMutalProbability( l_map["mutation"].as<double>() );
-    l_population.iterate( l_iteration, l_fitness, *l_selection, l_crossover );
+    if (l_cachesize == 0)
+        l_population.iterate( l_iteration, l_fitness, *l_selection, l_crossover );
+    else {
+        ga::fitness::cachedfitness<double,unsigned char> l_cache( l_fitness, l_cachesize );
+        l_population.iterate( l_iteration, l_cache, *l_selection, l_crossover );
+        std::cout << "fitness cache hits: " << l_cache.getHits() << ", misses: " << l_cache.getMisses() << std::endl;
+    }
 
     delete l_selection;
     const std::vector< boost::shared_ptr< ga::individual::individual<unsigned char> > > l_elite = l_population.getElite();
@@ -177,6 +195,7 @@ int main(int p_argc, char* p_argv[])
 
 
     // create output
+    std::cout << "generations: " << l_fitness.getGeneration() << std::endl;
     std::cout << "best packing options with pack / position values [ value, value, ... ] (position starts with one):" << std::endl;
 
     for(std::size_t i=0; i < l_elite.size(); ++i) {
@@ -0,0 +1,96 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+import machinelearning.tools.ThreadPool;
+import machinelearning.clustering.nonsupervised.*;
+import java.util.Random;
+
+
+/** java testprogram for running an asynchronous training with progress and cancellation **/
+public class asynchronous {
+    
+    
+    /** progress class, that is called by the native training thread after each iteration **/
+    private static class printprogress extends Progress {
+        
+        /** update call
+         * @param p_iteration number of finished iterations
+         * @param p_iterations number of all iterations
+         * @param p_error quantization error
+         **/
+        public void update( long p_iteration, long p_iterations, double p_error )
+        {
+            System.out.println("iteration " + p_iteration + " of " + p_iterations + "\tquantization error " + p_error);
+        }
+        
+    }
+    
+    
+    /** main method
+     * @param p_args input arguments
+     **/
+    public static void main(String[] p_args) throws InterruptedException
+    {
+        // generates random dissimilarity data
+        Random l_rand = new Random();
+        
+        double[][] l_data = new double[200][200];
+        for(int i=0; i < l_data.length; i++)
+            for (int j=0; j < i; j++) {
+                l_data[i][j] = l_rand.nextDouble();
+                l_data[j][i] = l_data[i][j];
+            }
+        
+        // the pool runs the native training threads
+        ThreadPool l_pool = new ThreadPool(2);
+        RelationalNeuralGas l_rng = new RelationalNeuralGas(4, l_data.length);
+        printprogress l_progress = new printprogress();
+        
+        // starts the training and cancels it, if it does not finish within one second
+        RelationalNeuralGasTask l_task = new RelationalNeuralGasTask(l_pool, l_rng, l_data, 500, l_progress);
+        if (!l_task.waitFor(1000)) {
+            l_task.cancel();
+            l_task.waitFor();
+        }
+        
+        System.out.println("\nstate: " + l_task.getState() + " after " + l_task.getIteration() + " iterations");
+        if (l_task.getState() == RelationalNeuralGasTask.state.failed)
+            System.out.println(l_task.getMessage());
+        
+        
+        // delete manually the native objects, the task must be deleted first
+        l_task.delete();
+        l_rng.delete();
+        l_progress.delete();
+        l_pool.delete();
+        
+        l_task     = null;
+        l_rng      = null;
+        l_progress = null;
+        l_pool     = null;
+        l_data     = null;
+        l_rand     = null;
+    }
+    
+}
@@ -38,11 +38,11 @@ public class mds {
         // generates random datapoints
         Random l_rand = new Random();
         
-        Double[][] l_data = new Double[8][8];
+        double[][] l_data = new double[8][8];
         for(int i=0; i < l_data.length; i++) {
             for (int j=0; j < l_data[i].length; j++) {
                 if (i==j)
-                    l_data[i][j] = new Double(0);
+                    l_data[i][j] = 0;
                 else
                     l_data[i][j] = l_rand.nextDouble();
                 System.out.print(l_data[i][j] + "\t");
@@ -55,7 +55,7 @@ public class mds {
         
         
         // maps the random data points
-        Double[][] l_result = l_mds.map(l_data);
+        double[][] l_result = l_mds.map(l_data);
         System.out.println("\nproject data:");
         if (l_result == null)
             System.out.println("no data is returned");
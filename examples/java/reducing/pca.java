@@ -38,7 +38,7 @@ public class pca {
         // generates random datapoints
         Random l_rand = new Random();
         
-        Double[][] l_data = new Double[15][8];
+        double[][] l_data = new double[15][8];
         for(int i=0; i < l_data.length; i++) {
             for (int j=0; j < l_data[i].length; j++) {
                 l_data[i][j] = l_rand.nextDouble() * 500;
@@ -52,7 +52,7 @@ public class pca {
         
         
         // maps the random data points
-        Double[][] l_result = l_pca.map(l_data);
+        double[][] l_result = l_pca.map(l_data);
         System.out.println("\nproject data:");
         if (l_result == null)
             System.out.println("no data is returned");
@@ -64,7 +64,7 @@ public class pca {
             }
         
         // show PCA eigenvectors 
-        Double[][] l_eig = l_pca.getProject();
+        double[][] l_eig = l_pca.getProject();
         System.out.println("\neigenvectors:");
         if (l_eig == null)
             System.out.println("no data is returned");
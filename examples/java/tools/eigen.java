@@ -38,7 +38,7 @@ public class eigen {
         // generates random datapoints
         java.util.Random l_rand = new java.util.Random();
         
-        Double[][] l_data = new Double[6][6];
+        double[][] l_data = new double[6][6];
         for(int i=0; i < l_data.length; i++) {
             for (int j=0; j < l_data[i].length; j++) {
                 l_data[i][j] = l_rand.nextDouble() * 500;
@@ -49,16 +49,16 @@ public class eigen {
         
      
         // create eigenvectors / -values
-        ArrayList<Double> l_eigenvals   = new ArrayList<Double>();
-        ArrayList<Double[]> l_eigenvecs = new ArrayList<Double[]>();
+        ArrayList<double[]> l_eigenvals = new ArrayList<double[]>();
+        ArrayList<double[]> l_eigenvecs = new ArrayList<double[]>();
         
         Lapack.eigen(l_data, l_eigenvals, l_eigenvecs);
             
         
         
         System.out.println("\neigenvalues:");
-        for(int i=0; i < l_eigenvals.size(); i++)
-            System.out.print(l_eigenvals.get(i) + "\t");
+        for(int i=0; i < l_eigenvals.get(0).length; i++)
+            System.out.print(l_eigenvals.get(0)[i] + "\t");
         System.out.println("");
         l_eigenvals = null;
         
@@ -75,7 +75,7 @@ public class eigen {
         
             
         // get the largest eigenvector with perron-frobenius
-        Double[] l_perron = Lapack.perronFrobenius( l_data, 2*l_data.length );
+        double[] l_perron = Lapack.perronFrobenius( l_data, 2*l_data.length );
             
         System.out.println("\nlargest eigenvector with perron-frobenius-theorem:");
         for(int i=0; i < l_perron.length; i++)
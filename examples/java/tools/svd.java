@@ -38,7 +38,7 @@ public class svd {
         // generates random datapoints
         java.util.Random l_rand = new java.util.Random();
         
-        Double[][] l_data = new Double[4][8];
+        double[][] l_data = new double[4][8];
         for(int i=0; i < l_data.length; i++) {
             for (int j=0; j < l_data[i].length; j++) {
                 l_data[i][j] = l_rand.nextDouble() * 500;
@@ -49,17 +49,17 @@ public class svd {
         
 
         // create SVD
-        ArrayList<Double> l_svdvals   = new ArrayList<Double>();
-        ArrayList<Double[]> l_svdvecs1 = new ArrayList<Double[]>();
-        ArrayList<Double[]> l_svdvecs2 = new ArrayList<Double[]>();
+        ArrayList<double[]> l_svdvals  = new ArrayList<double[]>();
+        ArrayList<double[]> l_svdvecs1 = new ArrayList<double[]>();
+        ArrayList<double[]> l_svdvecs2 = new ArrayList<double[]>();
         
         Lapack.svd(l_data, l_svdvals, l_svdvecs1, l_svdvecs2);
         
 
         
         System.out.println("\nsvd values:");
-        for(int i=0; i < l_svdvals.size(); i++)
-            System.out.print(l_svdvals.get(i) + "\t");
+        for(int i=0; i < l_svdvals.get(0).length; i++)
+            System.out.print(l_svdvals.get(0)[i] + "\t");
         System.out.println("");
         l_svdvals = null;
         
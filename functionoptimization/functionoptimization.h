@@ -31,6 +31,7 @@ namespace machinelearning {
     namespace functionaloptimization {}
 }
 
+#include "tape.hpp"
 #include "gradientdescent.hpp"
 
 
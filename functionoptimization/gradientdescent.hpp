@@ -21,28 +21,31 @@
  @endcond
  **/
 
+
 #ifdef MACHINELEARNING_SYMBOLICMATH
 
 #ifndef __MACHINELEARNING_FUNCTIONOPTIMIZATION_GRADIENTDESCENT_HPP
 #define __MACHINELEARNING_FUNCTIONOPTIMIZATION_GRADIENTDESCENT_HPP
 
 
+#include <omp.h>
+
 #include <map>
+#include <cmath>
 #include <string>
-#include <sstream>
+#include <limits>
 #include <algorithm>
 #include <ginac/ginac.h>
-#include <boost/bind.hpp>
 #include <boost/algorithm/string.hpp> 
-#include <boost/lexical_cast.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/multi_array.hpp>
 #include <boost/static_assert.hpp>
-#include <boost/thread.hpp>
 
 
 #include "../errorhandling/exception.hpp"
 #include "../tools/tools.h"
+#include "../clustering/instrumentation.hpp"
+#include "tape.hpp"
 
 
 
@@ -53,8 +56,12 @@ namespace machinelearning { namespace functionaloptimization {
     
     /** class for using a (stochastic) gradient descent.
      * For symbolic numerical algorithms @see http://www.ginac.de .
-     * GiNaC is not thread-safe, so for the thread we create only std::string vars
-     * @bug uncomplete, so doesn't work
+     * GiNaC is only used for parsing, the error function is compiled into a numerical
+     * tape and the gradient is calculated with reverse-mode automatic differentiation.
+     * The optimization runs on shuffled mini-batches of the static data, each mini-batch
+     * gradient is calculated in parallel over all threads and reduced before the update.
+     * The error of an iteration is calculated over all samples after the last update, so the
+     * best values are the values of the iteration with the smallest error
      * @todo adding detection of numerical instability eg x*exp(x) the optimization of the
      * multiplication x is uncomplicated that the exp(x) (in the exponent). One solution to
      * optimize this function is to optimize for the multiplication and next the exponent.
@@ -70,13 +77,38 @@ namespace machinelearning { namespace functionaloptimization {
         
     
         public :
+        
+            /** update rules **/
+            enum method
+            {
+                gradient    = 0,
+                momentum    = 1,
+                adam        = 2
+            };
+        
+            /** step size schedules **/
+            enum schedule
+            {
+                constant    = 0,
+                inverse     = 1,
+                exponential = 2
+            };
+        
 
             gradientdescent( const std::string& );
             void setErrorFunction( const std::string&, const std::string& = "0.5 * (target-(function))^2", const std::string& = "target", const std::string& = "function", const std::string& = " ,;\t\n-" );
             void setOptimizeVar( const std::string&, const T&, const T& );
             void setOptimizeVar( const std::string&, const T& );
             void setStaticVar( const std::string&, const boost::multi_array<T,D>& );
-            std::map<std::string, T> optimize( const std::size_t&, const std::size_t&, const std::vector<std::string>& = std::vector<std::string>() ) const;
+            void setMethod( const method&, const T& = 0.01, const T& = 0.9, const T& = 0.999 );
+            void setSchedule( const schedule&, const T& = 0 );
+            void setEarlyStopping( const std::size_t&, const T& = 0 );
+            void setLogging( const bool& );
+            bool getLogging( void ) const;
+            std::vector<T> getLoggedError( void ) const;
+            void setInstrumentation( clustering::instrumentation<T>& );
+            void removeInstrumentation( void );
+            std::map<std::string, T> optimize( const std::size_t&, const std::size_t&, const std::vector<std::string>& = std::vector<std::string>() );
         
         
         private :
@@ -96,72 +128,93 @@ namespace machinelearning { namespace functionaloptimization {
             std::map<std::string, std::pair<T,T> > m_optimize;
             /** map for static parameter **/
             std::map<std::string, boost::multi_array<T,D> > m_static;
-        
-            static std::string expression2string( const GiNaC::ex& );
-        
-        
-        
-        
-            /** class for worker thread for calulating gradient values **/
-            class worker {
-                
-                public :
-                
-                    worker( const std::size_t&, 
-                        const std::size_t&,
-                        const std::string&,
-                        const std::string&,
-                        const std::vector<std::string>&, 
-                        const std::map<std::string, std::pair<T,T> >&,  
-                        const std::map<std::string, boost::multi_array<T,D> >&,
-                        const std::vector<std::string>&
-                       );
-                
-                    std::map<std::string, T> getResult( void ) const;
-                    void optimize( void );
-                
-                
-                
-                private :
-                
-                    /** maximum iterations **/
-                    std::size_t m_iteration;
-                    /** sampling value **/
-                    std::size_t m_sampling;
-                    /** map with lower & upper initialisation values **/
-                    std::map<std::string, std::pair<T,T> > m_initvalues;
-                    /** map with static values **/
-                    std::map<std::string, boost::multi_array<T,D> > m_staticvalues;
-                    /** vector with variables for batch optimize **/
-                    std::vector<std::string> m_batch;
-                    /** map with optimized values **/
-                    std::map<std::string, T> m_result;
-                    
-                    GiNaC::ex m_function;
-                    GiNaC::symtab m_functionsymbols;
-                    GiNaC::ex m_errorfunction;
-                    GiNaC::symtab m_errorfunctionsymbols;
-                    std::vector<std::string> m_derivationvars;
-                
-            };
+            /** compiled error function **/
+            tape<T> m_tape;
+            /** variable names of the tape (position is the variable index) **/
+            std::vector<std::string> m_tapevars;
+            /** update rule **/
+            method m_method;
+            /** initial step size **/
+            T m_rate;
+            /** momentum factor (first moment decay of adam) **/
+            T m_beta1;
+            /** second moment decay of adam **/
+            T m_beta2;
+            /** step size schedule **/
+            schedule m_schedule;
+            /** decay of the step size schedule **/
+            T m_decay;
+            /** number of iterations without improvement until the optimization stops (zero disables early stopping) **/
+            std::size_t m_patience;
+            /** minimal improvement of the error **/
+            T m_tolerance;
+            /** flag for logging **/
+            bool m_logging;
+            /** error of each iteration **/
+            std::vector<T> m_logerror;
+            /** optional instrumentation object (not owned) **/
+            clustering::instrumentation<T>* m_instrumentation;
+        
+            static std::size_t compile( const GiNaC::ex&, const std::map<std::string, std::size_t>&, tape<T>& );
+            T getRate( const std::size_t& ) const;
         
     };
 
     
     
-    /** converts a GiNaC expression to a string
+    /** compiles a GiNaC expression into the tape
      * @param p_ex expression
-     * @return string with expression
+     * @param p_index map with the variable name and the variable index of the tape
+     * @param p_tape tape
+     * @return index of the instruction with the expression value
      **/
-    template<typename T, std::size_t D> inline std::string gradientdescent<T,D>::expression2string( const GiNaC::ex& p_ex )
+    template<typename T, std::size_t D> inline std::size_t gradientdescent<T,D>::compile( const GiNaC::ex& p_ex, const std::map<std::string, std::size_t>& p_index, tape<T>& p_tape )
     {
-        std::string l_str;
-        std::stringstream l_sstream;
+        if (GiNaC::is_a<GiNaC::numeric>(p_ex))
+            return p_tape.push( tape<T>::constant, 0, 0, static_cast<T>(GiNaC::ex_to<GiNaC::numeric>(p_ex).to_double()) );
+        
+        if (GiNaC::is_a<GiNaC::symbol>(p_ex)) {
+            const std::map<std::string, std::size_t>::const_iterator it = p_index.find( GiNaC::ex_to<GiNaC::symbol>(p_ex).get_name() );
+            if (it == p_index.end())
+                throw exception::runtime(_("variable is not found in the symbol table"));
+            return p_tape.push( tape<T>::variable, it->second );
+        }
         
-        l_sstream << p_ex;
-        l_sstream >> l_str;
+        if ( GiNaC::is_a<GiNaC::add>(p_ex) || GiNaC::is_a<GiNaC::mul>(p_ex) ) {
+            const typename tape<T>::operation l_op = GiNaC::is_a<GiNaC::add>(p_ex) ? tape<T>::add : tape<T>::multiply;
+            
+            std::size_t l_index = compile( p_ex.op(0), p_index, p_tape );
+            for(std::size_t i=1; i < p_ex.nops(); ++i)
+                l_index = p_tape.push( l_op, l_index, compile(p_ex.op(i), p_index, p_tape) );
+            return l_index;
+        }
         
-        return l_str;
+        if (GiNaC::is_a<GiNaC::power>(p_ex)) {
+            const std::size_t l_base = compile( p_ex.op(0), p_index, p_tape );
+            if (GiNaC::is_a<GiNaC::numeric>(p_ex.op(1)))
+                return p_tape.push( tape<T>::powerconst, l_base, 0, static_cast<T>(GiNaC::ex_to<GiNaC::numeric>(p_ex.op(1)).to_double()) );
+            return p_tape.push( tape<T>::power, l_base, compile(p_ex.op(1), p_index, p_tape) );
+        }
+        
+        if ( (GiNaC::is_a<GiNaC::function>(p_ex)) && (p_ex.nops() == 1) ) {
+            const std::string l_name = GiNaC::ex_to<GiNaC::function>(p_ex).get_name();
+            const std::size_t l_arg  = compile( p_ex.op(0), p_index, p_tape );
+            
+            if (l_name == "exp")    return p_tape.push( tape<T>::exp,   l_arg );
+            if (l_name == "log")    return p_tape.push( tape<T>::log,   l_arg );
+            if (l_name == "sin")    return p_tape.push( tape<T>::sin,   l_arg );
+            if (l_name == "cos")    return p_tape.push( tape<T>::cos,   l_arg );
+            if (l_name == "tan")    return p_tape.push( tape<T>::tan,   l_arg );
+            if (l_name == "abs")    return p_tape.push( tape<T>::abs,   l_arg );
+            if (l_name == "sinh")   return p_tape.push( tape<T>::sinh,  l_arg );
+            if (l_name == "cosh")   return p_tape.push( tape<T>::cosh,  l_arg );
+            if (l_name == "tanh")   return p_tape.push( tape<T>::tanh,  l_arg );
+            if (l_name == "asin")   return p_tape.push( tape<T>::asin,  l_arg );
+            if (l_name == "acos")   return p_tape.push( tape<T>::acos,  l_arg );
+            if (l_name == "atan")   return p_tape.push( tape<T>::atan,  l_arg );
+        }
+        
+        throw exception::runtime(_("expression contains a term that can not be compiled"));
     }
     
     
@@ -174,7 +227,20 @@ namespace machinelearning { namespace functionaloptimization {
         m_exprtable(),
         m_derivationvars(),
         m_optimize(),
-        m_static()
+        m_static(),
+        m_tape(),
+        m_tapevars(),
+        m_method( adam ),
+        m_rate( 0.01 ),
+        m_beta1( 0.9 ),
+        m_beta2( 0.999 ),
+        m_schedule( constant ),
+        m_decay( 0 ),
+        m_patience( 0 ),
+        m_tolerance( 0 ),
+        m_logging( false ),
+        m_logerror(),
+        m_instrumentation( NULL )
     {
         if (p_func.empty())
             throw exception::runtime(_("function need not be empty"), *this);
@@ -217,6 +283,8 @@ namespace machinelearning { namespace functionaloptimization {
         m_static.clear();
         m_derivationvars.clear();
         m_fulltable.clear();
+        m_tape = tape<T>();
+        m_tapevars.clear();
         
         // check if symbols for optimization are in the table
         std::vector<std::string> l_sep;
@@ -255,7 +323,16 @@ namespace machinelearning { namespace functionaloptimization {
         
         // checks number of variables (target symbolic var, so increment +1)
         if (m_exprtable.size()+1 != m_fulltable.size())
-            throw exception::runtime(_("only one variable for the data must be added"), *this);        
+            throw exception::runtime(_("only one variable for the data must be added"), *this);
+        
+        // compile the error function, the tape variables are numbered in the order of the symbol table
+        std::map<std::string, std::size_t> l_index;
+        for(GiNaC::symtab::const_iterator it = m_fulltable.begin(); it != m_fulltable.end(); ++it) {
+            l_index[it->first] = m_tapevars.size();
+            m_tapevars.push_back( it->first );
+        }
+        
+        compile( m_full, l_index, m_tape );
     }
     
     
@@ -294,144 +371,353 @@ namespace machinelearning { namespace functionaloptimization {
         if ( (std::find(m_derivationvars.begin(), m_derivationvars.end(), p_name) != m_derivationvars.end()) || (m_fulltable.find(p_name) == m_fulltable.end()) )
             throw exception::runtime(_("static variable is not in the symbol table or is an optimazation variable"), *this);
         
-        m_static[p_name] = p_data;
+        // multi_array assignment needs equal shapes, so the entry is replaced
+        m_static.erase( p_name );
+        m_static.insert( std::pair<std::string, boost::multi_array<T,D> >(p_name, p_data) );
     }
     
     
-    /** optimization method
-     * @param p_iteration number of iterations
-     * @param p_sampling number of samples for each static range
-     * @param p_batch batch call of fotting
-     * @return map with name and value
-     * @todo adding parameter for setting number of start points and creating the correct thread group
+    /** sets the update rule
+     * @param p_method update rule
+     * @param p_rate initial step size
+     * @param p_beta1 momentum factor, on adam the decay of the first moment
+     * @param p_beta2 decay of the second moment (only adam)
      **/
-    template<typename T, std::size_t D> inline std::map<std::string, T> gradientdescent<T,D>::optimize( const std::size_t& p_iteration, const std::size_t& p_sampling, const std::vector<std::string>& p_batch ) const
+    template<typename T, std::size_t D> inline void gradientdescent<T,D>::setMethod( const method& p_method, const T& p_rate, const T& p_beta1, const T& p_beta2 )
     {
-        if (p_iteration == 0)
-            throw exception::runtime(_("iterations must be greater than zero"), *this);
-        if (p_sampling == 0 )
-            throw exception::runtime(_("stepsize must be greater than zero"), *this);
-        
-        // all variables must be set to a numerical value, so we check it
-        if (m_static.size() + m_optimize.size() != m_fulltable.size())
-            throw exception::runtime(_("there are unsed variables"), *this);
-                
-           
-        // creating worker
-        std::vector< worker > l_worker;
-        
-        // if only one thread is used, we create the worker object directly and run it
-        if (boost::thread::hardware_concurrency() == 1) {
-            l_worker.push_back(  worker(p_iteration, p_sampling, expression2string(m_expression), expression2string(m_full), m_derivationvars, m_optimize, m_static, p_batch)  );
-            l_worker[0].optimize();
-        } else { 
-            boost::thread_group l_threadgroup;
-            for(std::size_t i=0; i < boost::thread::hardware_concurrency(); ++i) {
-                l_worker.push_back( worker(p_iteration, p_sampling, expression2string(m_expression), expression2string(m_full), m_derivationvars, m_optimize, m_static, p_batch)  );
-                l_threadgroup.create_thread(  boost::bind( &worker::optimize, &l_worker[i] )  );
-            }
-        
-            // run threads and wait during all finished
-            l_threadgroup.join_all();
-        }
-        
-        // get data and creates best values
-        std::map<std::string, T> x;
-        return x;
+        if (p_rate <= 0)
+            throw exception::runtime(_("step size must be greater than zero"), *this);
+        if ( (p_beta1 < 0) || (p_beta1 >= 1) || (p_beta2 < 0) || (p_beta2 >= 1) )
+            throw exception::runtime(_("decay values must be in [0,1)"), *this);
+        
+        m_method = p_method;
+        m_rate   = p_rate;
+        m_beta1  = p_beta1;
+        m_beta2  = p_beta2;
+    }
+    
+    
+    /** sets the step size schedule, the step size of iteration t is rate on constant,
+     * rate / (1 + decay * t) on inverse and rate * exp(-decay * t) on exponential
+     * @param p_schedule schedule
+     * @param p_decay decay value
+     **/
+    template<typename T, std::size_t D> inline void gradientdescent<T,D>::setSchedule( const schedule& p_schedule, const T& p_decay )
+    {
+        if (p_decay < 0)
+            throw exception::runtime(_("decay must be greater or equal than zero"), *this);
         
+        m_schedule = p_schedule;
+        m_decay    = p_decay;
     }
-     
-    
-    //======= Multithreading Workerclass ==================================================================================================================================
-    
-    /** The constructor is only called by the gradient class, so we must not check
-     * the parameter
-     * @param p_iteration maximum iterations
-     * @param p_sampling initializsation stepsize
-     * @param p_function function string
-     * @param p_errorfunction error function
-     * @param p_derivationvars map with all derivations
-     * @param p_initvalues map with values and optimize range
-     * @param p_staticvalues map with multidimensional array for static variables
-     * @param p_batch vector with information wich variable can be optimize together
+    
+    
+    /** sets the early stopping, the optimization stops if the error of an iteration
+     * is not smaller than the best error minus the tolerance for the given number of
+     * iterations, the values of the best iteration are returned
+     * @param p_patience number of iterations (zero disables early stopping)
+     * @param p_tolerance minimal improvement
      **/
-    template<typename T, std::size_t D> inline gradientdescent<T,D>::worker::worker(  
-        const std::size_t& p_iteration, 
-        const std::size_t& p_sampling, 
-        const std::string& p_function,
-        const std::string& p_errorfunction,
-        const std::vector<std::string>& p_derivationvars, 
-        const std::map<std::string, std::pair<T,T> >& p_initvalues, 
-        const std::map<std::string, boost::multi_array<T,D> >& p_staticvalues, 
-        const std::vector<std::string>& p_batch  
-    ) :
-    m_iteration( p_iteration ),
-    m_sampling( p_stepsize ),
-    m_initvalues( p_initvalues ),
-    m_staticvalues( p_staticvalues ),
-    m_batch( p_batch ),
-    m_result(),
-    m_function(),
-    m_functionsymbols(),
-    m_errorfunction(),
-    m_derivationvars(p_derivationvars)
+    template<typename T, std::size_t D> inline void gradientdescent<T,D>::setEarlyStopping( const std::size_t& p_patience, const T& p_tolerance )
     {
-        // parsing the expression are not thread-safe, so we do this here
-        GiNaC::parser l_parser;
+        if (p_tolerance < 0)
+            throw exception::runtime(_("tolerance must be greater or equal than zero"), *this);
         
-        try {
-            m_function              = l_parser( p_function );
-            m_functionsymbols       = l_parser.get_syms();
-            
-            m_errorfunction         = l_parser( p_errorfunction );
-            m_errorfunctionsymbols  = l_parser.get_syms();
-        } catch (...) {
-            throw exception::runtime(_("arithmetic expression could not be parsed"), *this);
-        }
+        m_patience  = p_patience;
+        m_tolerance = p_tolerance;
     }
     
     
+    /** enabled logging for optimization
+     * @param p_val bool
+     **/
+    template<typename T, std::size_t D> inline void gradientdescent<T,D>::setLogging( const bool& p_val )
+    {
+        m_logging = p_val;
+        m_logerror.clear();
+    }
+    
     
-    /** returns the calculated values 
-     * @return std::map with value and variable name
+    /** shows the logging status
+     * @return bool
      **/
-    template<typename T, std::size_t D> inline std::map<std::string, T> gradientdescent<T,D>::worker::getResult( void ) const
+    template<typename T, std::size_t D> inline bool gradientdescent<T,D>::getLogging( void ) const
     {
-        return m_result;
+        return m_logging && (m_logerror.size() > 0);
     }
     
     
-    /** optimize value with gradient descent **/
-    template<typename T, std::size_t D> inline void gradientdescent<T,D>::worker::optimize( void ) 
+    /** returns the mean error of each iteration
+     * @return error for each iteration
+     **/
+    template<typename T, std::size_t D> inline std::vector<T> gradientdescent<T,D>::getLoggedError( void ) const
     {
+        return m_logerror;
+    }
+    
+    
+    /** sets an instrumentation object, that records the phase times (gradient, update and
+     * evaluate), the error and the snapshots of the values of the following optimize calls
+     * @param p_instrumentation instrumentation object, that must exist during optimization
+     **/
+    template<typename T, std::size_t D> inline void gradientdescent<T,D>::setInstrumentation( clustering::instrumentation<T>& p_instrumentation )
+    {
+        m_instrumentation = &p_instrumentation;
+    }
+    
+    
+    /** removes the instrumentation object **/
+    template<typename T, std::size_t D> inline void gradientdescent<T,D>::removeInstrumentation( void )
+    {
+        m_instrumentation = NULL;
+    }
+    
+    
+    /** returns the step size of an iteration
+     * @param p_iteration iteration
+     * @return step size
+     **/
+    template<typename T, std::size_t D> inline T gradientdescent<T,D>::getRate( const std::size_t& p_iteration ) const
+    {
+        switch (m_schedule) {
+            case inverse        :   return m_rate / (1 + m_decay * p_iteration);
+            case exponential    :   return m_rate * std::exp(-m_decay * p_iteration);
+            default             :   return m_rate;
+        }
+    }
+    
+    
+    /** optimization method. Each iteration is a pass over the shuffled samples in mini-batches,
+     * the mini-batch is split over the threads and the mean gradient of the mini-batch is
+     * reduced before the values are updated. After the pass the mean error of all samples is
+     * calculated with the new values, it is used for logging, instrumentation and early stopping
+     * @param p_iteration number of iterations
+     * @param p_sampling number of samples of each mini-batch
+     * @param p_batch names of the variables, that are optimized (empty for all variables), all other variables are fixed on their start value
+     * @return map with name and value
+     **/
+    template<typename T, std::size_t D> inline std::map<std::string, T> gradientdescent<T,D>::optimize( const std::size_t& p_iteration, const std::size_t& p_sampling, const std::vector<std::string>& p_batch )
+    {
+        if (p_iteration == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        if (p_sampling == 0 )
+            throw exception::runtime(_("stepsize must be greater than zero"), *this);
+        
+        // all variables must be set to a numerical value, so we check it
+        if (m_static.size() + m_optimize.size() != m_fulltable.size())
+            throw exception::runtime(_("there are unsed variables"), *this);
+        
+        // the static arrays are used directly as flat data, so all arrays must have the same number of elements
+        std::vector<const T*> l_data( m_tapevars.size(), static_cast<const T*>(NULL) );
+        std::size_t l_samples = 0;
+        for(std::size_t i=0; i < m_tapevars.size(); ++i) {
+            const typename std::map<std::string, boost::multi_array<T,D> >::const_iterator it = m_static.find( m_tapevars[i] );
+            if (it == m_static.end())
+                continue;
+            
+            if ( (l_samples != 0) && (l_samples != it->second.num_elements()) )
+                throw exception::runtime(_("static variables must have the same number of elements"), *this);
+            l_samples  = it->second.num_elements();
+            l_data[i]  = it->second.data();
+        }
+        if (l_samples == 0)
+            throw exception::runtime(_("static variables need not be empty"), *this);
+        
+        // tape indices of the variables, that are optimized
+        std::vector<std::size_t> l_batch;
+        for(std::size_t i=0; i < m_tapevars.size(); ++i)
+            if ( (m_optimize.find(m_tapevars[i]) != m_optimize.end()) && (p_batch.empty() || (std::find(p_batch.begin(), p_batch.end(), m_tapevars[i]) != p_batch.end())) )
+                l_batch.push_back( i );
+        if (l_batch.empty())
+            throw exception::runtime(_("there are no variables for optimization"), *this);
+        
+        // start values
+        tools::random l_rand;
+        std::vector<T> l_values( m_tapevars.size(), static_cast<T>(0) );
+        for(std::size_t i=0; i < m_tapevars.size(); ++i) {
+            const typename std::map<std::string, std::pair<T,T> >::const_iterator it = m_optimize.find( m_tapevars[i] );
+            if (it == m_optimize.end())
+                continue;
+            
+            if (tools::function::isNumericalEqual(it->second.first, it->second.second))
+                l_values[i] = it->second.first;
+            else
+                l_values[i] = l_rand.get<T>( tools::random::uniform, it->second.first, it->second.second );
+        }
         
-        //create derivations of the errorfunction
-        std::vector<GiNaC::ex> l_derivation;
+        if (m_logging) {
+            m_logerror.clear();
+            m_logerror.reserve( p_iteration );
+        }
+        if (m_instrumentation)
+            m_instrumentation->reserve( p_iteration );
         
-        for(std::size_t i=0; i < m_derivationvars.size(); ++i)
-            m_errorfunction.diff( GiNaC::ex_to<GiNaC::symbol>(m_errorfunctionsymbols[ m_derivationvars[i] ]), 1);
         
+        const std::size_t l_sampling = std::min(p_sampling, l_samples);
+        std::vector<std::size_t> l_index( l_samples );
+        for(std::size_t i=0; i < l_samples; ++i)
+            l_index[i] = i;
         
+        std::vector<T> l_gradient( m_tapevars.size() );
+        std::vector<T> l_first( m_tapevars.size(), static_cast<T>(0) );
+        std::vector<T> l_second( m_tapevars.size(), static_cast<T>(0) );
+        std::vector<T> l_best( l_values );
+        T l_besterror     = std::numeric_limits<T>::max();
+        std::size_t l_wait = 0;
+        std::size_t l_step = 0;
         
-        // init dynamic values
-        /*GiNaC::exmap l_dynamic;
-         tools::random l_rand;
-         for(typename std::map<std::string, std::pair<T,T> >::iterator it = m_initvalues.begin(); it != m_initvalues.end(); ++it)
-         if (tools::function::isNumericalEqual(it->second.first, it->second.second))
-         l_dynamic[ m_symbols[it->first] ] = it->second.first;
-         else
-         l_dynamic[ m_symbols[it->first] ] = l_rand.get<T>( tools::random::uniform, it->second.first, it->second.second );
-         
-         */
-        // run
-        //for(std::size_t i=0; i < m_iteration; ++i) {
+        for(std::size_t i=0; i < p_iteration; ++i) {
+            
+            // shuffle the samples (Fisher-Yates), the random values are created outside the threads, because the generator is not thread-safe
+            for(std::size_t j=l_samples-1; j > 0; --j)
+                std::swap( l_index[j], l_index[ std::min(static_cast<std::size_t>(l_rand.get<T>(tools::random::uniform, 0, static_cast<T>(j+1))), j) ] );
+            
+            const T l_rate = getRate(i);
+            
+            if (m_instrumentation) {
+                m_instrumentation->beginIteration();
+                if (m_instrumentation->isSnapshot()) {
+                    ublas::matrix<T> l_snapshot( 1, l_values.size() );
+                    std::copy( l_values.begin(), l_values.end(), l_snapshot.data().begin() );
+                    m_instrumentation->addSnapshot( l_snapshot );
+                }
+            }
+            
+            for(std::size_t l_begin=0; l_begin < l_samples; l_begin += l_sampling) {
+                const std::size_t l_end = std::min(l_begin + l_sampling, l_samples);
+                
+                if (m_instrumentation)
+                    m_instrumentation->startPhase();
+                
+                std::fill( l_gradient.begin(), l_gradient.end(), static_cast<T>(0) );
+                
+                #pragma omp parallel shared(l_gradient)
+                {
+                    // each thread gathers a contiguous part of the mini-batch into local buffers
+                    const std::size_t l_threads = static_cast<std::size_t>(omp_get_num_threads());
+                    const std::size_t l_thread  = static_cast<std::size_t>(omp_get_thread_num());
+                    const std::size_t l_from    = l_begin + (l_end-l_begin) * l_thread / l_threads;
+                    const std::size_t l_to      = l_begin + (l_end-l_begin) * (l_thread+1) / l_threads;
+                    
+                    if (l_from < l_to) {
+                        std::vector< std::vector<T> > l_buffer( l_data.size() );
+                        std::vector< typename tape<T>::input > l_input( l_data.size() );
+                        for(std::size_t n=0; n < l_data.size(); ++n) {
+                            if (!l_data[n]) {
+                                l_input[n] = typename tape<T>::input( &l_values[n], 0 );
+                                continue;
+                            }
+                            
+                            l_buffer[n].resize( l_to-l_from );
+                            for(std::size_t k=l_from; k < l_to; ++k)
+                                l_buffer[n][k-l_from] = l_data[n][l_index[k]];
+                            l_input[n] = typename tape<T>::input( &l_buffer[n][0], 1 );
+                        }
+                        
+                        std::vector<T> l_localgradient;
+                        m_tape.gradient( l_input, l_to-l_from, l_localgradient );
+                        
+                        // reduce the thread-local gradients once per mini-batch
+                        #pragma omp critical
+                        for(std::size_t n=0; n < l_gradient.size(); ++n)
+                            l_gradient[n] += l_localgradient[n];
+                    }
+                }
+                
+                if (m_instrumentation) {
+                    m_instrumentation->stopPhase( clustering::instrumentation<T>::gradient );
+                    m_instrumentation->startPhase();
+                }
+                
+                // update the values with the mean gradient of the mini-batch
+                ++l_step;
+                const T l_size = static_cast<T>(l_end-l_begin);
+                for(std::size_t j=0; j < l_batch.size(); ++j) {
+                    const std::size_t n = l_batch[j];
+                    const T l_grad      = l_gradient[n] / l_size;
+                    
+                    switch (m_method) {
+                        
+                        case momentum :
+                            l_first[n]   = m_beta1 * l_first[n] - l_rate * l_grad;
+                            l_values[n] += l_first[n];
+                            break;
+                            
+                        case adam :
+                            l_first[n]   = m_beta1 * l_first[n]  + (1-m_beta1) * l_grad;
+                            l_second[n]  = m_beta2 * l_second[n] + (1-m_beta2) * l_grad * l_grad;
+                            l_values[n] -= l_rate * (l_first[n] / (1-std::pow(m_beta1, static_cast<T>(l_step)))) / (std::sqrt(l_second[n] / (1-std::pow(m_beta2, static_cast<T>(l_step)))) + static_cast<T>(1e-8));
+                            break;
+                            
+                        default :
+                            l_values[n] -= l_rate * l_grad;
+                    }
+                }
+                
+                if (m_instrumentation)
+                    m_instrumentation->stopPhase( clustering::instrumentation<T>::update );
+            }
+            
+            
+            // the error of the iteration is the mean error of all samples with the updated values,
+            // the samples are read in their original order, so each thread uses its part of the arrays directly
+            if (m_instrumentation)
+                m_instrumentation->startPhase();
+            
+            T l_error = 0;
+            #pragma omp parallel shared(l_error)
+            {
+                const std::size_t l_threads = static_cast<std::size_t>(omp_get_num_threads());
+                const std::size_t l_thread  = static_cast<std::size_t>(omp_get_thread_num());
+                const std::size_t l_from    = l_samples * l_thread / l_threads;
+                const std::size_t l_to      = l_samples * (l_thread+1) / l_threads;
+                
+                if (l_from < l_to) {
+                    std::vector< typename tape<T>::input > l_input( l_data.size() );
+                    for(std::size_t n=0; n < l_data.size(); ++n)
+                        l_input[n] = l_data[n] ? typename tape<T>::input( l_data[n]+l_from, 1 ) : typename tape<T>::input( &l_values[n], 0 );
+                    
+                    std::vector<T> l_result( l_to-l_from );
+                    m_tape.evaluate( l_input, l_result.size(), &l_result[0] );
+                    
+                    T l_localerror = 0;
+                    for(std::size_t n=0; n < l_result.size(); ++n)
+                        l_localerror += l_result[n];
+                    
+                    #pragma omp critical
+                    l_error += l_localerror;
+                }
+            }
+            l_error /= l_samples;
+            
+            if (m_instrumentation) {
+                m_instrumentation->stopPhase( clustering::instrumentation<T>::evaluate );
+                m_instrumentation->setQuantizationError( l_error );
+            }
+            if (m_logging)
+                m_logerror.push_back( l_error );
+            
+            // a non-finite error stops the optimization with the best values
+            if ( (l_error != l_error) || (l_error > std::numeric_limits<T>::max()) )
+                break;
+            
+            const bool l_improved = l_error < l_besterror - m_tolerance;
+            if (l_error < l_besterror) {
+                l_besterror = l_error;
+                l_best      = l_values;
+            }
+            
+            l_wait = l_improved ? 0 : l_wait+1;
+            if ( (m_patience > 0) && (l_wait >= m_patience) )
+                break;
+        }
         
+        std::map<std::string, T> l_result;
+        for(std::size_t i=0; i < m_tapevars.size(); ++i)
+            if (m_optimize.find(m_tapevars[i]) != m_optimize.end())
+                l_result[m_tapevars[i]] = l_best[i];
         
-        // iterate over every derivation
-        //for(std::map<std::string, GiNaC::ex>::iterator it = m_derivation.begin(); it != m_derivation.end(); ++it) {
-        //std::cout << it->second << "\t\t" << it->second.subs(l_dynamic) << std::endl;
-        //}
-        //}
+        return l_result;
     }
     
 }}
@@ -0,0 +1,509 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#ifndef __MACHINELEARNING_FUNCTIONOPTIMIZATION_TAPE_HPP
+#define __MACHINELEARNING_FUNCTIONOPTIMIZATION_TAPE_HPP
+
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <boost/static_assert.hpp>
+#include <boost/type_traits/is_integral.hpp>
+
+#include "../errorhandling/exception.hpp"
+#include "../tools/language/language.h"
+
+
+namespace machinelearning { namespace functionaloptimization { 
+    
+    
+    /** class of a compiled arithmetic expression. The expression is stored as a flat
+     * list of instructions in topological order (the last instruction is the result),
+     * so the evaluation needs no symbolic library and all methods are const and
+     * thread-safe. The gradient is calculated with reverse-mode automatic differentiation.
+     * The batch methods evaluate each instruction over a block of samples, so the inner
+     * loops can be vectorized by the compiler, each variable of a batch is given by a
+     * pointer and a stride (zero stride for a value, that is equal for all samples)
+     **/
+    template<typename T> class tape
+    {
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        
+        public :
+        
+            /** instruction types **/
+            enum operation
+            {
+                constant    = 0,
+                variable    = 1,
+                add         = 2,
+                multiply    = 3,
+                power       = 4,
+                powerconst  = 5,
+                exp         = 6,
+                log         = 7,
+                sin         = 8,
+                cos         = 9,
+                tan         = 10,
+                abs         = 11,
+                sinh        = 12,
+                cosh        = 13,
+                tanh        = 14,
+                asin        = 15,
+                acos        = 16,
+                atan        = 17
+            };
+        
+            /** type of a batch input (pointer to the first sample and stride) **/
+            typedef std::pair<const T*, std::size_t> input;
+        
+        
+            tape( void );
+            std::size_t push( const operation&, const std::size_t& = 0, const std::size_t& = 0, const T& = 0 );
+            std::size_t size( void ) const;
+            std::size_t getVariableCount( void ) const;
+        
+            T evaluate( const std::vector<T>& ) const;
+            T gradient( const std::vector<T>&, std::vector<T>& ) const;
+            void evaluate( const std::vector<input>&, const std::size_t&, T* ) const;
+            T gradient( const std::vector<input>&, const std::size_t&, std::vector<T>& ) const;
+        
+        
+        private :
+        
+            /** instruction **/
+            struct instruction
+            {
+                /** operation **/
+                operation op;
+                /** first operand (instruction index or variable index) **/
+                std::size_t left;
+                /** second operand (instruction index) **/
+                std::size_t right;
+                /** constant value or exponent **/
+                T value;
+            };
+        
+            /** number of samples, that are processed together in the batch methods **/
+            static const std::size_t m_blocksize = 256;
+        
+            /** instructions **/
+            std::vector<instruction> m_instructions;
+            /** number of variables **/
+            std::size_t m_variables;
+        
+            void forward( const std::vector<input>&, const std::size_t&, const std::size_t&, std::vector<T>& ) const;
+            void backward( const std::vector<T>&, const std::size_t&, std::vector<T>&, std::vector<T>& ) const;
+        
+    };
+    
+    
+    
+    /** constructor of an empty tape **/
+    template<typename T> inline tape<T>::tape( void ) :
+        m_instructions(),
+        m_variables( 0 )
+    {}
+    
+    
+    /** adds an instruction, the operands must be added before
+     * @param p_operation operation
+     * @param p_left first operand (index of the variable on variable operations)
+     * @param p_right second operand (only binary operations)
+     * @param p_value value of a constant or exponent of the powerconst operation
+     * @return index of the instruction
+     **/
+    template<typename T> inline std::size_t tape<T>::push( const operation& p_operation, const std::size_t& p_left, const std::size_t& p_right, const T& p_value )
+    {
+        const bool l_binary = (p_operation == add) || (p_operation == multiply) || (p_operation == power);
+        
+        if ( (p_operation != constant) && (p_operation != variable) && (p_left >= m_instructions.size()) )
+            throw exception::runtime(_("operand of the instruction does not exist"), *this);
+        if ( l_binary && (p_right >= m_instructions.size()) )
+            throw exception::runtime(_("operand of the instruction does not exist"), *this);
+        
+        instruction l_instruction;
+        l_instruction.op    = p_operation;
+        l_instruction.left  = p_left;
+        l_instruction.right = l_binary ? p_right : 0;
+        l_instruction.value = p_value;
+        
+        if (p_operation == variable)
+            m_variables = std::max(m_variables, p_left+1);
+        
+        m_instructions.push_back( l_instruction );
+        return m_instructions.size()-1;
+    }
+    
+    
+    /** returns the number of instructions
+     * @return number of instructions
+     **/
+    template<typename T> inline std::size_t tape<T>::size( void ) const
+    {
+        return m_instructions.size();
+    }
+    
+    
+    /** returns the number of variables (largest variable index + 1)
+     * @return number of variables
+     **/
+    template<typename T> inline std::size_t tape<T>::getVariableCount( void ) const
+    {
+        return m_variables;
+    }
+    
+    
+    /** evaluates the expression on one sample
+     * @param p_variables values of the variables
+     * @return value
+     **/
+    template<typename T> inline T tape<T>::evaluate( const std::vector<T>& p_variables ) const
+    {
+        std::vector<input> l_input;
+        for(std::size_t i=0; i < p_variables.size(); ++i)
+            l_input.push_back( input(&p_variables[i], 0) );
+        
+        T l_result = 0;
+        evaluate( l_input, 1, &l_result );
+        return l_result;
+    }
+    
+    
+    /** evaluates the expression and the gradient on one sample
+     * @param p_variables values of the variables
+     * @param p_gradient gradient vector (is resized to the number of variables)
+     * @return value
+     **/
+    template<typename T> inline T tape<T>::gradient( const std::vector<T>& p_variables, std::vector<T>& p_gradient ) const
+    {
+        std::vector<input> l_input;
+        for(std::size_t i=0; i < p_variables.size(); ++i)
+            l_input.push_back( input(&p_variables[i], 0) );
+        
+        return gradient( l_input, 1, p_gradient );
+    }
+    
+    
+    /** evaluates the expression on a batch of samples
+     * @param p_input pointer and stride of each variable
+     * @param p_size number of samples
+     * @param p_result result array with p_size elements
+     **/
+    template<typename T> inline void tape<T>::evaluate( const std::vector<input>& p_input, const std::size_t& p_size, T* p_result ) const
+    {
+        if (m_instructions.empty())
+            throw exception::runtime(_("tape is empty"), *this);
+        if (p_input.size() < m_variables)
+            throw exception::runtime(_("number of inputs is less than the number of variables"), *this);
+        
+        std::vector<T> l_values( m_instructions.size() * m_blocksize );
+        for(std::size_t i=0; i < p_size; i += m_blocksize) {
+            const std::size_t l_block = std::min(static_cast<std::size_t>(m_blocksize), p_size-i);
+            forward( p_input, i, l_block, l_values );
+            
+            const T* l_result = &l_values[(m_instructions.size()-1) * m_blocksize];
+            std::copy( l_result, l_result+l_block, p_result+i );
+        }
+    }
+    
+    
+    /** evaluates the sum of the expression and its gradient over a batch of samples
+     * @param p_input pointer and stride of each variable
+     * @param p_size number of samples
+     * @param p_gradient gradient vector of the sum (is resized to the number of inputs)
+     * @return sum of the expression values
+     **/
+    template<typename T> inline T tape<T>::gradient( const std::vector<input>& p_input, const std::size_t& p_size, std::vector<T>& p_gradient ) const
+    {
+        if (m_instructions.empty())
+            throw exception::runtime(_("tape is empty"), *this);
+        if (p_input.size() < m_variables)
+            throw exception::runtime(_("number of inputs is less than the number of variables"), *this);
+        
+        p_gradient.assign( p_input.size(), static_cast<T>(0) );
+        
+        T l_sum = 0;
+        std::vector<T> l_values( m_instructions.size() * m_blocksize );
+        std::vector<T> l_adjoints( m_instructions.size() * m_blocksize );
+        for(std::size_t i=0; i < p_size; i += m_blocksize) {
+            const std::size_t l_block = std::min(static_cast<std::size_t>(m_blocksize), p_size-i);
+            forward( p_input, i, l_block, l_values );
+            
+            const T* l_result = &l_values[(m_instructions.size()-1) * m_blocksize];
+            for(std::size_t n=0; n < l_block; ++n)
+                l_sum += l_result[n];
+            
+            backward( l_values, l_block, l_adjoints, p_gradient );
+        }
+        
+        return l_sum;
+    }
+    
+    
+    /** forward pass over a block, the value of instruction i and sample n is stored at i * blocksize + n
+     * @param p_input pointer and stride of each variable
+     * @param p_offset index of the first sample
+     * @param p_block number of samples of the block
+     * @param p_values value buffer
+     **/
+    template<typename T> inline void tape<T>::forward( const std::vector<input>& p_input, const std::size_t& p_offset, const std::size_t& p_block, std::vector<T>& p_values ) const
+    {
+        for(std::size_t i=0; i < m_instructions.size(); ++i) {
+            const instruction& l_ins = m_instructions[i];
+            T* const l_out           = &p_values[i * m_blocksize];
+            
+            // on variable and constant operations the left operand is not an instruction index
+            const bool l_operand     = (l_ins.op != constant) && (l_ins.op != variable);
+            const T* const l_a       = l_operand ? &p_values[l_ins.left * m_blocksize] : NULL;
+            const T* const l_b       = l_operand ? &p_values[l_ins.right * m_blocksize] : NULL;
+            
+            switch (l_ins.op) {
+                    
+                case constant :
+                    std::fill( l_out, l_out+p_block, l_ins.value );
+                    break;
+                    
+                case variable : {
+                    const T* const l_data      = p_input[l_ins.left].first;
+                    const std::size_t l_stride = p_input[l_ins.left].second;
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = l_data[(p_offset+n) * l_stride];
+                    break;
+                }
+                    
+                case add :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = l_a[n] + l_b[n];
+                    break;
+                    
+                case multiply :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = l_a[n] * l_b[n];
+                    break;
+                    
+                case power :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::pow(l_a[n], l_b[n]);
+                    break;
+                    
+                case powerconst :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::pow(l_a[n], l_ins.value);
+                    break;
+                    
+                case exp :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::exp(l_a[n]);
+                    break;
+                    
+                case log :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::log(l_a[n]);
+                    break;
+                    
+                case sin :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::sin(l_a[n]);
+                    break;
+                    
+                case cos :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::cos(l_a[n]);
+                    break;
+                    
+                case tan :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::tan(l_a[n]);
+                    break;
+                    
+                case abs :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::fabs(l_a[n]);
+                    break;
+                    
+                case sinh :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::sinh(l_a[n]);
+                    break;
+                    
+                case cosh :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::cosh(l_a[n]);
+                    break;
+                    
+                case tanh :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::tanh(l_a[n]);
+                    break;
+                    
+                case asin :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::asin(l_a[n]);
+                    break;
+                    
+                case acos :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::acos(l_a[n]);
+                    break;
+                    
+                case atan :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_out[n] = std::atan(l_a[n]);
+                    break;
+            }
+        }
+    }
+    
+    
+    /** reverse pass over a block, the adjoints of the operands are accumulated from the
+     * last to the first instruction, the adjoints of the variables are added to the gradient
+     * @param p_values value buffer of the forward pass
+     * @param p_block number of samples of the block
+     * @param p_adjoints adjoint buffer
+     * @param p_gradient gradient vector
+     **/
+    template<typename T> inline void tape<T>::backward( const std::vector<T>& p_values, const std::size_t& p_block, std::vector<T>& p_adjoints, std::vector<T>& p_gradient ) const
+    {
+        std::fill( p_adjoints.begin(), p_adjoints.end(), static_cast<T>(0) );
+        std::fill( p_adjoints.begin() + (m_instructions.size()-1) * m_blocksize, p_adjoints.begin() + (m_instructions.size()-1) * m_blocksize + p_block, static_cast<T>(1) );
+        
+        for(std::size_t i=m_instructions.size(); i > 0; --i) {
+            const instruction& l_ins = m_instructions[i-1];
+            const T* const l_adj     = &p_adjoints[(i-1) * m_blocksize];
+            const T* const l_out     = &p_values[(i-1) * m_blocksize];
+            
+            // on variable and constant operations the left operand is not an instruction index
+            const bool l_operand     = (l_ins.op != constant) && (l_ins.op != variable);
+            const T* const l_a       = l_operand ? &p_values[l_ins.left * m_blocksize] : NULL;
+            const T* const l_b       = l_operand ? &p_values[l_ins.right * m_blocksize] : NULL;
+            T* const l_adja          = l_operand ? &p_adjoints[l_ins.left * m_blocksize] : NULL;
+            T* const l_adjb          = l_operand ? &p_adjoints[l_ins.right * m_blocksize] : NULL;
+            
+            switch (l_ins.op) {
+                    
+                case constant :
+                    break;
+                    
+                case variable : {
+                    T l_sum = 0;
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_sum += l_adj[n];
+                    p_gradient[l_ins.left] += l_sum;
+                    break;
+                }
+                    
+                case add :
+                    for(std::size_t n=0; n < p_block; ++n) {
+                        l_adja[n] += l_adj[n];
+                        l_adjb[n] += l_adj[n];
+                    }
+                    break;
+                    
+                case multiply :
+                    for(std::size_t n=0; n < p_block; ++n) {
+                        l_adja[n] += l_adj[n] * l_b[n];
+                        l_adjb[n] += l_adj[n] * l_a[n];
+                    }
+                    break;
+                    
+                // the derivative of the exponent is only defined for a positive base
+                case power :
+                    for(std::size_t n=0; n < p_block; ++n) {
+                        l_adja[n] += l_adj[n] * l_b[n] * std::pow(l_a[n], l_b[n]-1);
+                        if (l_a[n] > 0)
+                            l_adjb[n] += l_adj[n] * l_out[n] * std::log(l_a[n]);
+                    }
+                    break;
+                    
+                case powerconst :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += l_adj[n] * l_ins.value * std::pow(l_a[n], l_ins.value-1);
+                    break;
+                    
+                case exp :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += l_adj[n] * l_out[n];
+                    break;
+                    
+                case log :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += l_adj[n] / l_a[n];
+                    break;
+                    
+                case sin :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += l_adj[n] * std::cos(l_a[n]);
+                    break;
+                    
+                case cos :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] -= l_adj[n] * std::sin(l_a[n]);
+                    break;
+                    
+                case tan :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += l_adj[n] * (1 + l_out[n]*l_out[n]);
+                    break;
+                    
+                case abs :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += (l_a[n] < 0) ? -l_adj[n] : ((l_a[n] > 0) ? l_adj[n] : 0);
+                    break;
+                    
+                case sinh :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += l_adj[n] * std::cosh(l_a[n]);
+                    break;
+                    
+                case cosh :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += l_adj[n] * std::sinh(l_a[n]);
+                    break;
+                    
+                case tanh :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += l_adj[n] * (1 - l_out[n]*l_out[n]);
+                    break;
+                    
+                case asin :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += l_adj[n] / std::sqrt(1 - l_a[n]*l_a[n]);
+                    break;
+                    
+                case acos :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] -= l_adj[n] / std::sqrt(1 - l_a[n]*l_a[n]);
+                    break;
+                    
+                case atan :
+                    for(std::size_t n=0; n < p_block; ++n)
+                        l_adja[n] += l_adj[n] / (1 + l_a[n]*l_a[n]);
+                    break;
+            }
+        }
+    }
+    
+}}
+#endif
@@ -0,0 +1,481 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+#ifndef __MACHINELEARNING_GENETICALGORITHM_BITPOPULATION_HPP
+#define __MACHINELEARNING_GENETICALGORITHM_BITPOPULATION_HPP
+
+#include <omp.h>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "../errorhandling/exception.hpp"
+#include "../tools/tools.h"
+
+#include "individual/bitindividual.hpp"
+#include "fitness/bitfitness.hpp"
+
+
+namespace machinelearning { namespace geneticalgorithm {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class for a population of binary individuals, that are stored bit-packed within one
+     * contiguous arena (structure-of-arrays). The arena holds two generations, so the
+     * new generation is build into the second half and the halfs are swapped after each iteration,
+     * there is no heap allocation on the iteration. Crossover and mutation are calculated with word masks,
+     * so the inner loops work on whole words and can be vectorized by the compiler.
+     * The elite individuals are copied unchanged into the next generation
+     **/
+    template<typename T> class bitpopulation
+    {
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        
+        public :
+        
+            bitpopulation( const std::size_t&, const std::size_t&, const std::size_t&, const std::size_t& = 1 );
+        
+            std::size_t size( void ) const;
+            std::size_t getIndividualSize( void ) const;
+            void setEliteSize( const std::size_t& );
+            std::size_t getEliteSize( void ) const;
+            void setCrossoverCuts( const std::size_t& );
+            std::size_t getCrossoverCuts( void ) const;
+            void setMutalProbability( const T&, const std::size_t& = 1 );
+            individual::bitindividual getIndividual( const std::size_t& );
+            std::vector<individual::bitindividual> getPopulation( void );
+            std::vector<individual::bitindividual> getElite( void );
+            ublas::vector<T> getEliteFitness( void ) const;
+            void iterate( const std::size_t&, fitness::bitfitness<T>& );
+        
+        
+        private :
+        
+            typedef individual::bitindividual::word word;
+        
+            /** number of bits of each individual **/
+            const std::size_t m_bits;
+            /** number of words of each individual **/
+            const std::size_t m_words;
+            /** number of individuals **/
+            const std::size_t m_size;
+            /** arena with two generations (each generation has size * words elements) **/
+            std::vector<word> m_arena;
+            /** index of the current generation (0 or 1) **/
+            std::size_t m_current;
+            /** elite size **/
+            std::size_t m_elitesize;
+            /** number of crossover cuts (zero uses uniform crossover) **/
+            std::size_t m_cuts;
+            /** mutation probability **/
+            T m_mutateprobability;
+            /** number of bits that are flipped on mutation **/
+            std::size_t m_mutatebits;
+            /** indices of the elite individuals within the current generation **/
+            std::vector<std::size_t> m_elite;
+            /** fitness values of the current generation **/
+            ublas::vector<T> m_fitness;
+        
+            word* getWords( const std::size_t&, const std::size_t& );
+            word getRandomWord( tools::random& ) const;
+            void combine( const word*, const word*, word*, std::vector<std::size_t>&, tools::random& ) const;
+            void mutate( word*, tools::random& ) const;
+            void copyRange( const word*, word*, const std::size_t&, const std::size_t& ) const;
+    };
+    
+    
+    
+    /** constructor
+     * @param p_bits number of bits of each individual
+     * @param p_size size of the population
+     * @param p_elite size of the elites
+     * @param p_cuts number of cut points for the crossover (zero creates a uniform crossover)
+     **/
+    template<typename T> inline bitpopulation<T>::bitpopulation( const std::size_t& p_bits, const std::size_t& p_size, const std::size_t& p_elite, const std::size_t& p_cuts ) :
+        m_bits( p_bits ),
+        m_words( individual::bitindividual::getWordSize(p_bits) ),
+        m_size( p_size ),
+        m_arena(),
+        m_current( 0 ),
+        m_elitesize( p_elite ),
+        m_cuts( p_cuts ),
+        m_mutateprobability( 0.4 ),
+        m_mutatebits( 1 ),
+        m_elite(),
+        m_fitness( p_size, 0 )
+    {
+        if (p_bits == 0)
+            throw exception::runtime(_("size number need not to be zero"), *this);
+        
+        if (p_size < 3)
+            throw exception::runtime(_("population size must be greater than two"), *this);
+        
+        if (p_elite < 2)
+            throw exception::runtime(_("elite size must be greater than one"), *this);
+        
+        if (p_elite >= p_size)
+            throw exception::runtime(_("elite size must be smaller than population size"), *this);
+        
+        if (p_cuts >= p_bits)
+            throw exception::runtime(_("number of cuts must be smaller than the individual size"), *this);
+        
+        // allocate both generations at once and initialize the first one randomly
+        m_arena.resize( 2 * m_size * m_words, 0 );
+        
+        tools::random l_random;
+        const word l_tail = individual::bitindividual::getTailMask(m_bits);
+        for(std::size_t i=0; i < m_size; ++i) {
+            word* l_ind = getWords(m_current, i);
+            
+            for(std::size_t n=0; n < m_words; ++n)
+                l_ind[n] = getRandomWord(l_random);
+            l_ind[m_words-1] &= l_tail;
+        }
+    }
+    
+    
+    /** returns the pointer to the first word of an individual
+     * @param p_generation generation index
+     * @param p_index individual index
+     * @return pointer
+     **/
+    template<typename T> inline typename bitpopulation<T>::word* bitpopulation<T>::getWords( const std::size_t& p_generation, const std::size_t& p_index )
+    {
+        return &m_arena[ (p_generation * m_size + p_index) * m_words ];
+    }
+    
+    
+    /** creates a random word
+     * @param p_random random object
+     * @return word with random bits
+     **/
+    template<typename T> inline typename bitpopulation<T>::word bitpopulation<T>::getRandomWord( tools::random& p_random ) const
+    {
+        // the uniform distribution returns doubles, so the word is build of 16 bit blocks
+        word l_value = 0;
+        for(std::size_t i=0; i < individual::bitindividual::wordbits; i+=16)
+            l_value |= static_cast<word>( static_cast<std::size_t>(p_random.get<double>(tools::random::uniform, 0, 65536)) & 0xFFFF ) << i;
+        
+        return l_value;
+    }
+    
+    
+    /** returns the population size
+     * @return size of the population
+     **/
+    template<typename T> inline std::size_t bitpopulation<T>::size( void ) const
+    {
+        return m_size;
+    }
+    
+    
+    /** returns the number of bits of each individual
+     * @return number of bits
+     **/
+    template<typename T> inline std::size_t bitpopulation<T>::getIndividualSize( void ) const
+    {
+        return m_bits;
+    }
+    
+    
+    /** change the elite size
+     * @param p_size size number
+     **/
+    template<typename T> inline void bitpopulation<T>::setEliteSize( const std::size_t& p_size )
+    {
+        if (p_size < 2)
+            throw exception::runtime(_("elite size must be greater than one"), *this);
+        
+        if (p_size >= m_size)
+            throw exception::runtime(_("elite size must be smaller than population size"), *this);
+        
+        m_elitesize = p_size;
+    }
+    
+    
+    /** returns the elite size
+     * @return size of elite
+     **/
+    template<typename T> inline std::size_t bitpopulation<T>::getEliteSize( void ) const
+    {
+        return m_elitesize;
+    }
+    
+    
+    /** sets the number of crossover cuts
+     * @param p_cuts number of cuts (zero creates a uniform crossover)
+     **/
+    template<typename T> inline void bitpopulation<T>::setCrossoverCuts( const std::size_t& p_cuts )
+    {
+        if (p_cuts >= m_bits)
+            throw exception::runtime(_("number of cuts must be smaller than the individual size"), *this);
+        
+        m_cuts = p_cuts;
+    }
+    
+    
+    /** returns the number of crossover cuts
+     * @return number of cuts
+     **/
+    template<typename T> inline std::size_t bitpopulation<T>::getCrossoverCuts( void ) const
+    {
+        return m_cuts;
+    }
+    
+    
+    /** changes the mutal probability
+     * @param p_prop probability of an individual to be mutated
+     * @param p_bits number of bits, that are flipped on a mutation
+     **/
+    template<typename T> inline void bitpopulation<T>::setMutalProbability( const T& p_prop, const std::size_t& p_bits )
+    {
+        if ((p_prop < 0) || (p_prop > 1))
+            throw exception::runtime(_("probability must be in [0,1]"), *this);
+        
+        if (p_bits == 0)
+            throw exception::runtime(_("number of mutation bits must be greater than zero"), *this);
+        
+        m_mutateprobability = p_prop;
+        m_mutatebits        = p_bits;
+    }
+    
+    
+    /** returns an individual of the current generation
+     * @note the object is a view to the arena and is valid until the next iterate call
+     * @param p_index index of the individual
+     * @return individual
+     **/
+    template<typename T> inline individual::bitindividual bitpopulation<T>::getIndividual( const std::size_t& p_index )
+    {
+        if (p_index >= m_size)
+            throw exception::runtime(_("index out of range"), *this);
+        
+        return individual::bitindividual( getWords(m_current, p_index), m_bits );
+    }
+    
+    
+    /** returns all individuals of the current generation
+     * @note the objects are views to the arena and are valid until the next iterate call
+     * @return vector with individuals
+     **/
+    template<typename T> inline std::vector<individual::bitindividual> bitpopulation<T>::getPopulation( void )
+    {
+        std::vector<individual::bitindividual> l_population;
+        l_population.reserve( m_size );
+        
+        for(std::size_t i=0; i < m_size; ++i)
+            l_population.push_back( individual::bitindividual(getWords(m_current, i), m_bits) );
+        
+        return l_population;
+    }
+    
+    
+    /** returns the elite individuals of the last iteration (best individual first)
+     * @note the objects are views to the arena and are valid until the next iterate call
+     * @return vector with individuals
+     **/
+    template<typename T> inline std::vector<individual::bitindividual> bitpopulation<T>::getElite( void )
+    {
+        std::vector<individual::bitindividual> l_elite;
+        l_elite.reserve( m_elite.size() );
+        
+        for(std::size_t i=0; i < m_elite.size(); ++i)
+            l_elite.push_back( individual::bitindividual(getWords(m_current, m_elite[i]), m_bits) );
+        
+        return l_elite;
+    }
+    
+    
+    /** returns the fitness values of the elite individuals (same order as getElite)
+     * @return fitness vector
+     **/
+    template<typename T> inline ublas::vector<T> bitpopulation<T>::getEliteFitness( void ) const
+    {
+        ublas::vector<T> l_fitness( m_elite.size() );
+        for(std::size_t i=0; i < m_elite.size(); ++i)
+            l_fitness(i) = m_fitness(m_elite[i]);
+        
+        return l_fitness;
+    }
+    
+    
+    /** copies the bit range [start, end) of the source to the target, full words are copied directly,
+     * only the border words are combined with masks
+     * @param p_source source words
+     * @param p_target target words
+     * @param p_start start bit
+     * @param p_end end bit
+     **/
+    template<typename T> inline void bitpopulation<T>::copyRange( const word* p_source, word* p_target, const std::size_t& p_start, const std::size_t& p_end ) const
+    {
+        if (p_start >= p_end)
+            return;
+        
+        const std::size_t l_first = p_start / individual::bitindividual::wordbits;
+        const std::size_t l_last  = (p_end - 1) / individual::bitindividual::wordbits;
+        const word l_firstmask    = ~static_cast<word>(0) << (p_start % individual::bitindividual::wordbits);
+        const word l_lastmask     = individual::bitindividual::getTailMask(p_end);
+        
+        if (l_first == l_last) {
+            const word l_mask = l_firstmask & l_lastmask;
+            p_target[l_first] = (p_target[l_first] & ~l_mask) | (p_source[l_first] & l_mask);
+            return;
+        }
+        
+        p_target[l_first] = (p_target[l_first] & ~l_firstmask) | (p_source[l_first] & l_firstmask);
+        for(std::size_t i=l_first+1; i < l_last; ++i)
+            p_target[i] = p_source[i];
+        p_target[l_last] = (p_target[l_last] & ~l_lastmask) | (p_source[l_last] & l_lastmask);
+    }
+    
+    
+    /** creates a child of two parents. With cuts the k-point crossover is used (the
+     * parents are switched on each cut), without cuts each bit is taken randomly of one parent
+     * @param p_first first parent
+     * @param p_second second parent
+     * @param p_child child
+     * @param p_cutbuffer buffer for the cut positions
+     * @param p_random random object
+     **/
+    template<typename T> inline void bitpopulation<T>::combine( const word* p_first, const word* p_second, word* p_child, std::vector<std::size_t>& p_cutbuffer, tools::random& p_random ) const
+    {
+        if (m_cuts == 0) {
+            for(std::size_t i=0; i < m_words; ++i) {
+                const word l_mask = getRandomWord(p_random);
+                p_child[i] = (p_first[i] & l_mask) | (p_second[i] & ~l_mask);
+            }
+            return;
+        }
+        
+        // cut positions are in [1, bits), the first parent is copied completely
+        // and the parts between odd and even cuts are replaced by the second parent
+        for(std::size_t i=0; i < m_cuts; ++i)
+            p_cutbuffer[i] = static_cast<std::size_t>(p_random.get<double>(tools::random::uniform, 1, m_bits));
+        p_cutbuffer[m_cuts] = m_bits;
+        std::sort( p_cutbuffer.begin(), p_cutbuffer.begin()+m_cuts );
+        
+        std::copy( p_first, p_first+m_words, p_child );
+        for(std::size_t i=0; i < m_cuts; i+=2)
+            copyRange( p_second, p_child, p_cutbuffer[i], p_cutbuffer[i+1] );
+    }
+    
+    
+    /** mutates an individual by flipping random bits
+     * @param p_individual words of the individual
+     * @param p_random random object
+     **/
+    template<typename T> inline void bitpopulation<T>::mutate( word* p_individual, tools::random& p_random ) const
+    {
+        for(std::size_t i=0; i < m_mutatebits; ++i) {
+            const std::size_t l_pos = std::min( m_bits-1, static_cast<std::size_t>(p_random.get<double>(tools::random::uniform, 0, m_bits)) );
+            p_individual[l_pos / individual::bitindividual::wordbits] ^= static_cast<word>(1) << (l_pos % individual::bitindividual::wordbits);
+        }
+    }
+    
+    
+    /** executes the algorithm iteratively
+     * @param p_iteration number of iterations
+     * @param p_fitness fitness function object
+     **/
+    template<typename T> inline void bitpopulation<T>::iterate( const std::size_t& p_iteration, fitness::bitfitness<T>& p_fitness )
+    {
+        if (p_iteration == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        
+        for(std::size_t i=0; i < p_iteration; ++i) {
+            
+            // calculate the fitness values on the current generation
+            bool l_optimumreached = false;
+            
+            #pragma omp parallel shared(l_optimumreached)
+            {
+                boost::shared_ptr< fitness::bitfitness<T> > l_fitnessfunction;
+                p_fitness.clone( l_fitnessfunction );
+                
+                #pragma omp for
+                for(std::size_t n=0; n < m_size; ++n) {
+                    m_fitness(n) = l_fitnessfunction->getFitness( individual::bitindividual(getWords(m_current, n), m_bits) );
+                    
+                    if (l_fitnessfunction->isOptimumReached())
+                        #pragma omp critical
+                        l_optimumreached = true;
+                }
+            }
+            
+            // rank the fitness values, the elite are the last elements of the rank index
+            const ublas::vector<std::size_t> l_rankIndex( tools::vector::rankIndexVector(m_fitness) );
+            
+            m_elite.clear();
+            for(std::size_t n=0; n < m_elitesize; ++n)
+                m_elite.push_back( l_rankIndex(m_size-1-n) );
+            
+            if (l_optimumreached)
+                break;
+            
+            
+            // build the next generation: elites are copied on the first positions, all other
+            // individuals are created by crossover of two random elite individuals
+            const std::size_t l_next = 1 - m_current;
+            
+            for(std::size_t n=0; n < m_elitesize; ++n)
+                std::copy( getWords(m_current, m_elite[n]), getWords(m_current, m_elite[n])+m_words, getWords(l_next, n) );
+            
+            #pragma omp parallel
+            {
+                tools::random l_random;
+                std::vector<std::size_t> l_cuts( m_cuts+1, 0 );
+                
+                #pragma omp for
+                for(std::size_t n=m_elitesize; n < m_size; ++n) {
+                    const std::size_t l_first  = std::min( m_elitesize-1, static_cast<std::size_t>(l_random.get<T>(tools::random::uniform, 0, m_elitesize)) );
+                    const std::size_t l_second = std::min( m_elitesize-1, static_cast<std::size_t>(l_random.get<T>(tools::random::uniform, 0, m_elitesize)) );
+                    
+                    word* l_child = getWords(l_next, n);
+                    combine( getWords(l_next, l_first), getWords(l_next, l_second), l_child, l_cuts, l_random );
+                    
+                    if (l_random.get<T>(tools::random::uniform, 0, 1) <= m_mutateprobability)
+                        mutate( l_child, l_random );
+                }
+            }
+            
+            // swap the generations, the elites are now the first individuals
+            const ublas::vector<T> l_elitefitness( getEliteFitness() );
+            
+            m_current = l_next;
+            for(std::size_t n=0; n < m_elitesize; ++n) {
+                m_fitness(n) = l_elitefitness(n);
+                m_elite[n]   = n;
+            }
+            
+            p_fitness.onEachIteration( getPopulation() );
+        }
+    }
+    
+}}
+#endif
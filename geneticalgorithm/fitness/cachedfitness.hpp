@@ -0,0 +1,314 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+#ifndef __MACHINELEARNING_GENETICALGORITHM_FITNESS_CACHEDFITNESS_HPP
+#define __MACHINELEARNING_GENETICALGORITHM_FITNESS_CACHEDFITNESS_HPP
+
+#include <map>
+#include <list>
+#include <vector>
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/functional/hash.hpp>
+
+#include "fitness.hpp"
+#include "../individual/individual.hpp"
+#include "../../errorhandling/exception.hpp"
+#include "../../tools/tools.h"
+
+
+namespace machinelearning { namespace geneticalgorithm { namespace fitness {
+    
+    
+    /** class of a fitness memoisation. The object wraps another fitness function and stores the
+     * fitness values keyed by the genome, so unchanged elites and duplicated individuals are not
+     * evaluated again. The cache is bounded (least recently used entries are removed) and divided
+     * into shards with their own lock, all clones share the same cache, so the object can be
+     * used directly within the multithreaded population. The onEachIteration calls are passed to
+     * the wrapped object and the clones for the evaluation are created from it, so a stateful
+     * fitness function gets the updates of each iteration
+     * @note the wrapped object must exist until the cache object and all clones are destroyed. The cached
+     * values are not changed by onEachIteration, so the cache must be cleared if the fitness values are changed
+     **/
+    template<typename T, typename L> class cachedfitness : public fitness<T,L>
+    {
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        
+        public :
+        
+            cachedfitness( fitness<T,L>&, const std::size_t&, const std::size_t& = 16 );
+        
+            T getFitness( const individual::individual<L>& );
+            bool isOptimumReached( void ) const;
+            void clone( boost::shared_ptr< fitness<T,L> >& ) const;
+            void onEachIteration( const std::vector< boost::shared_ptr< individual::individual<L> > >& );
+        
+            std::size_t getCacheSize( void ) const;
+            std::size_t getHits( void ) const;
+            std::size_t getMisses( void ) const;
+            void clear( void );
+        
+        
+        private :
+        
+            /** struct of a cache entry **/
+            struct entry
+            {
+                /** hash value **/
+                std::size_t hash;
+                /** genome values **/
+                std::vector<L> genome;
+                /** fitness value **/
+                T value;
+                /** optimum flag **/
+                bool optimum;
+            };
+        
+            /** struct of a cache shard **/
+            struct shard
+            {
+                /** entries, the most recently used entry is the first one **/
+                std::list<entry> entries;
+                /** map of the hash value to the entry **/
+                std::map< std::size_t, typename std::list<entry>::iterator > index;
+                /** lock of the shard **/
+                boost::mutex lock;
+                /** number of cache hits **/
+                std::size_t hits;
+                /** number of cache misses **/
+                std::size_t misses;
+            };
+        
+            /** struct of the shared cache **/
+            struct cache
+            {
+                /** shards **/
+                std::vector< boost::shared_ptr<shard> > shards;
+                /** maximum number of entries of each shard **/
+                std::size_t capacity;
+            };
+        
+        
+            /** wrapped fitness function, that gets the onEachIteration calls **/
+            fitness<T,L>& m_original;
+            /** clone of the wrapped fitness function for the evaluation **/
+            boost::shared_ptr< fitness<T,L> > m_fitness;
+            /** shared cache **/
+            boost::shared_ptr<cache> m_cache;
+            /** optimum flag of the last call **/
+            bool m_optimum;
+        
+            cachedfitness( fitness<T,L>&, const boost::shared_ptr<cache>& );
+    };
+    
+    
+    
+    /** constructor
+     * @param p_fitness fitness function, that is wrapped (the object is cloned for the evaluation)
+     * @param p_size maximum number of cached fitness values
+     * @param p_shards number of cache shards with own lock
+     **/
+    template<typename T, typename L> inline cachedfitness<T,L>::cachedfitness( fitness<T,L>& p_fitness, const std::size_t& p_size, const std::size_t& p_shards ) :
+        m_original( p_fitness ),
+        m_fitness(),
+        m_cache( new cache() ),
+        m_optimum( false )
+    {
+        if (p_size == 0)
+            throw exception::runtime(_("cache size must be greater than zero"), *this);
+        if (p_shards == 0)
+            throw exception::runtime(_("number of shards must be greater than zero"), *this);
+        
+        p_fitness.clone( m_fitness );
+        
+        m_cache->capacity = std::max( static_cast<std::size_t>(1), p_size / p_shards );
+        for(std::size_t i=0; i < p_shards; ++i) {
+            boost::shared_ptr<shard> l_shard( new shard() );
+            l_shard->hits   = 0;
+            l_shard->misses = 0;
+            m_cache->shards.push_back( l_shard );
+        }
+    }
+    
+    
+    /** private constructor for cloning
+     * @param p_fitness wrapped fitness function
+     * @param p_cache shared cache
+     **/
+    template<typename T, typename L> inline cachedfitness<T,L>::cachedfitness( fitness<T,L>& p_fitness, const boost::shared_ptr<cache>& p_cache ) :
+        m_original( p_fitness ),
+        m_fitness(),
+        m_cache( p_cache ),
+        m_optimum( false )
+    {
+        p_fitness.clone( m_fitness );
+    }
+    
+    
+    /** clones the object, the wrapped fitness function is cloned and the cache is shared
+     * @param p_ptr smart-pointer object
+     **/
+    template<typename T, typename L> inline void cachedfitness<T,L>::clone( boost::shared_ptr< fitness<T,L> >& p_ptr ) const
+    {
+        p_ptr = boost::shared_ptr< fitness<T,L> >( new cachedfitness<T,L>(m_original, m_cache) );
+    }
+    
+    
+    /** returns the fitness value of the individual, the wrapped function is only called if the genome is
+     * not within the cache. The shard is not locked during the evaluation, so the same genome can be
+     * evaluated on two threads at the same time, the second result overwrites the first one
+     * @param p_individual individual
+     * @return fitness value
+     **/
+    template<typename T, typename L> inline T cachedfitness<T,L>::getFitness( const individual::individual<L>& p_individual )
+    {
+        std::vector<L> l_genome( p_individual.size() );
+        for(std::size_t i=0; i < l_genome.size(); ++i)
+            l_genome[i] = p_individual[i];
+        
+        const std::size_t l_hash = boost::hash_range( l_genome.begin(), l_genome.end() );
+        // the low bits of the hash are not well distributed for small value ranges, so the bits are mixed for the shard index
+        const std::size_t l_mix = (l_hash ^ (l_hash >> 16)) * static_cast<std::size_t>(0x45d9f3b);
+        shard& l_shard = *m_cache->shards[ (l_mix ^ (l_mix >> 16)) % m_cache->shards.size() ];
+        
+        {
+            boost::lock_guard<boost::mutex> l_lock( l_shard.lock );
+            
+            typename std::map< std::size_t, typename std::list<entry>::iterator >::iterator l_it = l_shard.index.find( l_hash );
+            if ( (l_it != l_shard.index.end()) && (l_it->second->genome == l_genome) ) {
+                l_shard.hits++;
+                l_shard.entries.splice( l_shard.entries.begin(), l_shard.entries, l_it->second );
+                
+                m_optimum = l_it->second->optimum;
+                return l_it->second->value;
+            }
+            l_shard.misses++;
+        }
+        
+        entry l_entry;
+        l_entry.hash     = l_hash;
+        l_entry.value    = m_fitness->getFitness( p_individual );
+        l_entry.optimum  = m_fitness->isOptimumReached();
+        m_optimum        = l_entry.optimum;
+        
+        boost::lock_guard<boost::mutex> l_lock( l_shard.lock );
+        
+        // an existing entry with the same hash is replaced (hash collision or parallel evaluation)
+        typename std::map< std::size_t, typename std::list<entry>::iterator >::iterator l_it = l_shard.index.find( l_hash );
+        if (l_it != l_shard.index.end()) {
+            l_shard.entries.erase( l_it->second );
+            l_shard.index.erase( l_it );
+        }
+        
+        l_entry.genome.swap( l_genome );
+        l_shard.entries.push_front( l_entry );
+        l_shard.index[l_hash] = l_shard.entries.begin();
+        
+        if (l_shard.entries.size() > m_cache->capacity) {
+            l_shard.index.erase( l_shard.entries.back().hash );
+            l_shard.entries.pop_back();
+        }
+        
+        return l_entry.value;
+    }
+    
+    
+    /** returns the optimum flag of the last fitness call
+     * @return bool for stopping iteration process
+     **/
+    template<typename T, typename L> inline bool cachedfitness<T,L>::isOptimumReached( void ) const
+    {
+        return m_optimum;
+    }
+    
+    
+    /** calls the method of the wrapped fitness function and recreates the clone
+     * for the evaluation, so the clone gets the changed state
+     * @param p_population population
+     **/
+    template<typename T, typename L> inline void cachedfitness<T,L>::onEachIteration( const std::vector< boost::shared_ptr< individual::individual<L> > >& p_population )
+    {
+        m_original.onEachIteration( p_population );
+        m_original.clone( m_fitness );
+    }
+    
+    
+    /** returns the number of cached values
+     * @return number of values
+     **/
+    template<typename T, typename L> inline std::size_t cachedfitness<T,L>::getCacheSize( void ) const
+    {
+        std::size_t l_size = 0;
+        for(std::size_t i=0; i < m_cache->shards.size(); ++i) {
+            boost::lock_guard<boost::mutex> l_lock( m_cache->shards[i]->lock );
+            l_size += m_cache->shards[i]->entries.size();
+        }
+        
+        return l_size;
+    }
+    
+    
+    /** returns the number of cache hits
+     * @return number of hits
+     **/
+    template<typename T, typename L> inline std::size_t cachedfitness<T,L>::getHits( void ) const
+    {
+        std::size_t l_hits = 0;
+        for(std::size_t i=0; i < m_cache->shards.size(); ++i) {
+            boost::lock_guard<boost::mutex> l_lock( m_cache->shards[i]->lock );
+            l_hits += m_cache->shards[i]->hits;
+        }
+        
+        return l_hits;
+    }
+    
+    
+    /** returns the number of cache misses (calls of the wrapped fitness function)
+     * @return number of misses
+     **/
+    template<typename T, typename L> inline std::size_t cachedfitness<T,L>::getMisses( void ) const
+    {
+        std::size_t l_misses = 0;
+        for(std::size_t i=0; i < m_cache->shards.size(); ++i) {
+            boost::lock_guard<boost::mutex> l_lock( m_cache->shards[i]->lock );
+            l_misses += m_cache->shards[i]->misses;
+        }
+        
+        return l_misses;
+    }
+    
+    
+    /** removes all cached values (eg. if the fitness function is changed within onEachIteration) **/
+    template<typename T, typename L> inline void cachedfitness<T,L>::clear( void )
+    {
+        for(std::size_t i=0; i < m_cache->shards.size(); ++i) {
+            boost::lock_guard<boost::mutex> l_lock( m_cache->shards[i]->lock );
+            m_cache->shards[i]->entries.clear();
+            m_cache->shards[i]->index.clear();
+        }
+    }
+    
+}}}
+#endif
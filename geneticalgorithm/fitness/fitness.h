@@ -33,6 +33,8 @@ namespace machinelearning { namespace geneticalgorithm {
 }}
 
 #include "fitness.hpp"
+#include "bitfitness.hpp"
+#include "cachedfitness.hpp"
 
 #endif
 
@@ -39,6 +39,9 @@ namespace machinelearning {
 
 
 #include "population.hpp"
+#include "bitpopulation.hpp"
+#include "islandmodel.hpp"
+#include "steadystate.hpp"
 
 #include "fitness/fitness.h"
 #include "selection/selection.h"
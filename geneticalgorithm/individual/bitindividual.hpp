@@ -0,0 +1,283 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+#ifndef __MACHINELEARNING_GENETICALGORITHM_INDIVIDUAL_BITINDIVIDUAL_HPP
+#define __MACHINELEARNING_GENETICALGORITHM_INDIVIDUAL_BITINDIVIDUAL_HPP
+
+#include <limits>
+#include <boost/cstdint.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+#include "../../errorhandling/exception.hpp"
+#include "../../tools/tools.h"
+
+
+namespace machinelearning { namespace geneticalgorithm { namespace individual {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class of a bit-packed individual. The object does not own any memory, it is
+     * a view of a contiguous word block within the arena of the bit population, so
+     * creating / copying the object does not need any heap allocation. Bit i is
+     * stored at word i / bits(word) on position i % bits(word), unused bits of the last
+     * word are always zero
+     **/
+    class bitindividual
+    {
+        
+        public :
+        
+            /** word type of the storage **/
+            typedef boost::uint64_t word;
+        
+            /** number of bits within a word **/
+            static const std::size_t wordbits = std::numeric_limits<word>::digits;
+        
+        
+            bitindividual( word*, const std::size_t& );
+        
+            bool operator[]( const std::size_t& ) const;
+            std::size_t size( void ) const;
+            std::size_t getWordSize( void ) const;
+            const word* getWords( void ) const;
+            std::size_t count( void ) const;
+            std::size_t count( const bitindividual& ) const;
+            template<typename T> T sum( const ublas::vector<T>& ) const;
+        
+            void set( const std::size_t&, const bool& );
+            void flip( const std::size_t& );
+            word* getWords( void );
+        
+            static std::size_t getWordSize( const std::size_t& );
+            static word getTailMask( const std::size_t& );
+            static std::size_t popcount( const word& );
+            static std::size_t lowestbit( const word& );
+        
+        
+        private :
+        
+            /** pointer to the first word **/
+            word* m_data;
+            /** number of bits **/
+            std::size_t m_size;
+        
+    };
+    
+    
+    
+    /** constructor
+     * @param p_data pointer to the first word (the memory must have getWordSize(p_size) words)
+     * @param p_size number of bits
+     **/
+    inline bitindividual::bitindividual( word* p_data, const std::size_t& p_size ) :
+        m_data( p_data ),
+        m_size( p_size )
+    {}
+    
+    
+    /** returns the number of words, that are needed for storing n bits
+     * @param p_size number of bits
+     * @return number of words
+     **/
+    inline std::size_t bitindividual::getWordSize( const std::size_t& p_size )
+    {
+        return (p_size + wordbits - 1) / wordbits;
+    }
+    
+    
+    /** returns the mask of the used bits within the last word
+     * @param p_size number of bits
+     * @return mask
+     **/
+    inline bitindividual::word bitindividual::getTailMask( const std::size_t& p_size )
+    {
+        const std::size_t l_tail = p_size % wordbits;
+        return l_tail == 0 ? ~static_cast<word>(0) : (static_cast<word>(1) << l_tail) - 1;
+    }
+    
+    
+    /** counts the set bits of a word
+     * @param p_value word
+     * @return number of set bits
+     **/
+    inline std::size_t bitindividual::popcount( const word& p_value )
+    {
+        #ifdef __GNUC__
+        return static_cast<std::size_t>( __builtin_popcountll(p_value) );
+        #else
+        word l_value = p_value - ((p_value >> 1) & static_cast<word>(0x5555555555555555ULL));
+        l_value      = (l_value & static_cast<word>(0x3333333333333333ULL)) + ((l_value >> 2) & static_cast<word>(0x3333333333333333ULL));
+        l_value      = (l_value + (l_value >> 4)) & static_cast<word>(0x0F0F0F0F0F0F0F0FULL);
+        return static_cast<std::size_t>( (l_value * static_cast<word>(0x0101010101010101ULL)) >> (wordbits-8) );
+        #endif
+    }
+    
+    
+    /** returns the position of the lowest set bit (the word must not be zero)
+     * @param p_value word
+     * @return bit position
+     **/
+    inline std::size_t bitindividual::lowestbit( const word& p_value )
+    {
+        #ifdef __GNUC__
+        return static_cast<std::size_t>( __builtin_ctzll(p_value) );
+        #else
+        return popcount( (p_value & (~p_value + 1)) - 1 );
+        #endif
+    }
+    
+    
+    /** read value on index position
+     * @param p_index index position
+     * @return bit value
+     **/
+    inline bool bitindividual::operator[]( const std::size_t& p_index ) const
+    {
+        if (p_index >= m_size)
+            throw exception::runtime(_("index out of range"), *this);
+        
+        return (m_data[p_index / wordbits] >> (p_index % wordbits)) & 1;
+    }
+    
+    
+    /** sets the value on the index position
+     * @param p_index index position
+     * @param p_value bit value
+     **/
+    inline void bitindividual::set( const std::size_t& p_index, const bool& p_value )
+    {
+        if (p_index >= m_size)
+            throw exception::runtime(_("index out of range"), *this);
+        
+        const word l_mask = static_cast<word>(1) << (p_index % wordbits);
+        if (p_value)
+            m_data[p_index / wordbits] |= l_mask;
+        else
+            m_data[p_index / wordbits] &= ~l_mask;
+    }
+    
+    
+    /** flips the bit on the index position
+     * @param p_index index position
+     **/
+    inline void bitindividual::flip( const std::size_t& p_index )
+    {
+        if (p_index >= m_size)
+            throw exception::runtime(_("index out of range"), *this);
+        
+        m_data[p_index / wordbits] ^= static_cast<word>(1) << (p_index % wordbits);
+    }
+    
+    
+    /** returns the number of bits
+     * @return size
+     **/
+    inline std::size_t bitindividual::size( void ) const
+    {
+        return m_size;
+    }
+    
+    
+    /** returns the number of words
+     * @return word size
+     **/
+    inline std::size_t bitindividual::getWordSize( void ) const
+    {
+        return getWordSize(m_size);
+    }
+    
+    
+    /** returns the pointer to the words
+     * @return const pointer
+     **/
+    inline const bitindividual::word* bitindividual::getWords( void ) const
+    {
+        return m_data;
+    }
+    
+    
+    /** returns the pointer to the words
+     * @return pointer
+     **/
+    inline bitindividual::word* bitindividual::getWords( void )
+    {
+        return m_data;
+    }
+    
+    
+    /** returns the number of set bits
+     * @return number of bits
+     **/
+    inline std::size_t bitindividual::count( void ) const
+    {
+        std::size_t l_count = 0;
+        for(std::size_t i=0; i < getWordSize(); ++i)
+            l_count += popcount( m_data[i] );
+        
+        return l_count;
+    }
+    
+    
+    /** returns the number of bits, that are set in both individuals (popcount of the and-combination),
+     * so a mask can be stored as an individual
+     * @param p_mask mask individual
+     * @return number of bits
+     **/
+    inline std::size_t bitindividual::count( const bitindividual& p_mask ) const
+    {
+        if (p_mask.size() != m_size)
+            throw exception::runtime(_("individual sizes are not equal"), *this);
+        
+        std::size_t l_count = 0;
+        for(std::size_t i=0; i < getWordSize(); ++i)
+            l_count += popcount( m_data[i] & p_mask.m_data[i] );
+        
+        return l_count;
+    }
+    
+    
+    /** calculates the sum of the weights on the set bit positions (eg. the value of a knapsack packing),
+     * only the set bits are visited, so zero words are skipped
+     * @param p_weight weight vector
+     * @return weighted sum
+     **/
+    template<typename T> inline T bitindividual::sum( const ublas::vector<T>& p_weight ) const
+    {
+        if (p_weight.size() != m_size)
+            throw exception::runtime(_("weight vector size must be equal to the number of bits"), *this);
+        
+        T l_sum = 0;
+        for(std::size_t i=0; i < getWordSize(); ++i)
+            for(word l_value = m_data[i]; l_value != 0; l_value &= l_value - 1)
+                l_sum += p_weight( i * wordbits + lowestbit(l_value) );
+        
+        return l_sum;
+    }
+    
+}}}
+#endif
@@ -34,6 +34,7 @@ namespace machinelearning { namespace geneticalgorithm {
 
 #include "individual.hpp"
 #include "binaryindividual.hpp"
+#include "bitindividual.hpp"
 
 #endif
 
@@ -0,0 +1,469 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+#ifndef __MACHINELEARNING_GENETICALGORITHM_ISLANDMODEL_HPP
+#define __MACHINELEARNING_GENETICALGORITHM_ISLANDMODEL_HPP
+
+#include <omp.h>
+#include <deque>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+
+#ifdef MACHINELEARNING_MPI
+#include <boost/mpi.hpp>
+#include <boost/serialization/vector.hpp>
+#endif
+
+#include "../errorhandling/exception.hpp"
+#include "../tools/tools.h"
+
+#include "population.hpp"
+
+
+namespace machinelearning { namespace geneticalgorithm {
+    
+    #ifdef MACHINELEARNING_MPI
+    namespace mpi   = boost::mpi;
+    #endif
+    
+    
+    /** class for the island model. The islands are independent populations, that are
+     * iterated on their own thread. Every n iterations each island sends copies of its elite
+     * individuals to the next island (ring topology) and inserts all individuals that are
+     * waiting in its own mailbox, so the islands are never synchronized by a barrier.
+     * On MPI the first island of each process sends additionally to and receives from
+     * the neighbour processes, so the processes build a second ring
+     * @note the thread count of the OpenMP regions within the population is divided by the number of islands
+     **/
+    template<typename T, typename L> class islandmodel
+    {
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        
+        public :
+        
+            islandmodel( const individual::individual<L>&, const std::size_t&, const std::size_t&, const std::size_t& );
+        
+            std::size_t size( void ) const;
+            void setMigration( const std::size_t&, const std::size_t& );
+            std::size_t getMigrationInterval( void ) const;
+            std::size_t getMigrationSize( void ) const;
+            void setMutalProbability( const T&, const tools::random::distribution& = tools::random::uniform, const T& = std::numeric_limits<T>::epsilon(), const T& = std::numeric_limits<T>::epsilon(), const T& = std::numeric_limits<T>::epsilon() );
+            void setPopulationBuild( const typename population<T,L>::buildoption&, const tools::random::distribution& = tools::random::uniform );
+            std::vector< boost::shared_ptr< individual::individual<L> > > getElite( void ) const;
+            void iterate( const std::size_t&, fitness::fitness<T,L>&, selection::selection<T,L>&, crossover::crossover<L>&, const tools::execution& = tools::execution::getGlobal() );
+        
+            #ifdef MACHINELEARNING_MPI
+            void iterate( const mpi::communicator&, const std::size_t&, fitness::fitness<T,L>&, selection::selection<T,L>&, crossover::crossover<L>&, const tools::execution& = tools::execution::getGlobal() );
+            #endif
+        
+        
+        private :
+        
+            /** struct of an island with the population and the mailbox of the incoming individuals **/
+            struct island
+            {
+                /** population **/
+                boost::shared_ptr< population<T,L> > group;
+                /** incoming individuals **/
+                std::deque< boost::shared_ptr< individual::individual<L> > > mailbox;
+                /** mutex of the mailbox **/
+                boost::shared_ptr< boost::mutex > mailboxlock;
+            };
+        
+        
+            /** reference of the individual **/
+            const individual::individual<L>& m_individualref;
+            /** islands **/
+            std::vector<island> m_islands;
+            /** number of iterations between two migrations **/
+            std::size_t m_interval;
+            /** number of individuals that are send on migration **/
+            std::size_t m_migrants;
+        
+            #ifdef MACHINELEARNING_MPI
+            /** MPI tag of the migration messages **/
+            static const int m_mpitag = 997;
+            /** communicator pointer (only set within the MPI iteration) **/
+            const mpi::communicator* m_mpi;
+            #endif
+        
+            void run( const std::size_t&, const std::size_t&, const tools::execution&, fitness::fitness<T,L>&, selection::selection<T,L>&, crossover::crossover<L>& );
+            std::vector< boost::shared_ptr< individual::individual<L> > > emigrate( const std::size_t& ) const;
+            void immigrate( const std::size_t&, const std::vector< boost::shared_ptr< individual::individual<L> > >& );
+            void receive( const std::size_t& );
+        
+            #ifdef MACHINELEARNING_MPI
+            void send( const std::vector< boost::shared_ptr< individual::individual<L> > >&, std::vector<mpi::request>&, std::vector< std::vector< std::vector<L> > >& ) const;
+            std::size_t receive( const bool&, const std::size_t& );
+            #endif
+    };
+    
+    
+    
+    /** constructor
+     * @param p_individualref reference to the individual object, that is cloned for the populations
+     * @param p_islands number of islands
+     * @param p_size population size of each island
+     * @param p_elite elite size of each island
+     **/
+    template<typename T, typename L> inline islandmodel<T,L>::islandmodel( const individual::individual<L>& p_individualref, const std::size_t& p_islands, const std::size_t& p_size, const std::size_t& p_elite ) :
+        m_individualref( p_individualref ),
+        m_islands(),
+        m_interval( 5 ),
+        m_migrants( std::max(static_cast<std::size_t>(1), p_elite/2) )
+        #ifdef MACHINELEARNING_MPI
+        , m_mpi( NULL )
+        #endif
+    {
+        if (p_islands == 0)
+            throw exception::runtime(_("number of islands must be greater than zero"), *this);
+        
+        for(std::size_t i=0; i < p_islands; ++i) {
+            island l_island;
+            l_island.group  = boost::shared_ptr< population<T,L> >( new population<T,L>(p_individualref, p_size, p_elite) );
+            l_island.mailboxlock = boost::shared_ptr< boost::mutex >( new boost::mutex() );
+            m_islands.push_back( l_island );
+        }
+    }
+    
+    
+    /** returns the number of islands
+     * @return number of islands
+     **/
+    template<typename T, typename L> inline std::size_t islandmodel<T,L>::size( void ) const
+    {
+        return m_islands.size();
+    }
+    
+    
+    /** sets the migration parameter
+     * @param p_interval number of iterations between two migrations
+     * @param p_migrants number of elite individuals that are send on each migration
+     **/
+    template<typename T, typename L> inline void islandmodel<T,L>::setMigration( const std::size_t& p_interval, const std::size_t& p_migrants )
+    {
+        if (p_interval == 0)
+            throw exception::runtime(_("migration interval must be greater than zero"), *this);
+        
+        if (p_migrants == 0)
+            throw exception::runtime(_("number of migrants must be greater than zero"), *this);
+        
+        if (p_migrants > m_islands[0].group->getEliteSize())
+            throw exception::runtime(_("number of migrants must be smaller or equal than the elite size"), *this);
+        
+        m_interval = p_interval;
+        m_migrants = p_migrants;
+    }
+    
+    
+    /** returns the migration interval
+     * @return number of iterations between two migrations
+     **/
+    template<typename T, typename L> inline std::size_t islandmodel<T,L>::getMigrationInterval( void ) const
+    {
+        return m_interval;
+    }
+    
+    
+    /** returns the number of migrants
+     * @return number of individuals
+     **/
+    template<typename T, typename L> inline std::size_t islandmodel<T,L>::getMigrationSize( void ) const
+    {
+        return m_migrants;
+    }
+    
+    
+    /** changes the mutal probability of all islands
+     * @param p_prop probility
+     * @param p_distribution distribution
+     * @param p_first first distribution value
+     * @param p_second second distribution value
+     * @param p_third third distribution value
+     **/
+    template<typename T, typename L> inline void islandmodel<T,L>::setMutalProbability( const T& p_prop, const tools::random::distribution& p_distribution, const T& p_first, const T& p_second, const T& p_third )
+    {
+        for(std::size_t i=0; i < m_islands.size(); ++i)
+            m_islands[i].group->setMutalProbability( p_prop, p_distribution, p_first, p_second, p_third );
+    }
+    
+    
+    /** sets the population-building-option of all islands
+     * @param p_opt build option
+     * @param p_distribution distribution
+     **/
+    template<typename T, typename L> inline void islandmodel<T,L>::setPopulationBuild( const typename population<T,L>::buildoption& p_opt, const tools::random::distribution& p_distribution )
+    {
+        for(std::size_t i=0; i < m_islands.size(); ++i)
+            m_islands[i].group->setPopulationBuild( p_opt, p_distribution );
+    }
+    
+    
+    /** returns a copy of the elite individuals of all islands
+     * @return vector with smart-pointer objects of the elite individuals
+     **/
+    template<typename T, typename L> inline std::vector< boost::shared_ptr< individual::individual<L> > > islandmodel<T,L>::getElite( void ) const
+    {
+        std::vector< boost::shared_ptr< individual::individual<L> > > l_result;
+        
+        for(std::size_t i=0; i < m_islands.size(); ++i) {
+            const std::vector< boost::shared_ptr< individual::individual<L> > > l_elite = m_islands[i].group->getElite();
+            std::copy( l_elite.begin(), l_elite.end(), std::back_inserter(l_result) );
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** returns copies of the first elite individuals of an island
+     * @param p_island island index
+     * @return vector with individuals
+     **/
+    template<typename T, typename L> inline std::vector< boost::shared_ptr< individual::individual<L> > > islandmodel<T,L>::emigrate( const std::size_t& p_island ) const
+    {
+        std::vector< boost::shared_ptr< individual::individual<L> > > l_elite = m_islands[p_island].group->getElite();
+        if (l_elite.size() > m_migrants)
+            l_elite.resize( m_migrants );
+        
+        return l_elite;
+    }
+    
+    
+    /** pushes individuals into the mailbox of an island
+     * @param p_island island index
+     * @param p_individuals individuals
+     **/
+    template<typename T, typename L> inline void islandmodel<T,L>::immigrate( const std::size_t& p_island, const std::vector< boost::shared_ptr< individual::individual<L> > >& p_individuals )
+    {
+        boost::lock_guard<boost::mutex> l_lock( *m_islands[p_island].mailboxlock );
+        std::copy( p_individuals.begin(), p_individuals.end(), std::back_inserter(m_islands[p_island].mailbox) );
+    }
+    
+    
+    /** inserts all waiting individuals of the mailbox into the island population. The mailbox
+     * is only locked during the individuals are moved out
+     * @param p_island island index
+     **/
+    template<typename T, typename L> inline void islandmodel<T,L>::receive( const std::size_t& p_island )
+    {
+        std::vector< boost::shared_ptr< individual::individual<L> > > l_incoming;
+        {
+            boost::lock_guard<boost::mutex> l_lock( *m_islands[p_island].mailboxlock );
+            
+            // a slow island can collect more migrants than it can take, so the oldest are dropped
+            const std::size_t l_max = m_islands[p_island].group->size() - m_islands[p_island].group->getEliteSize();
+            while (m_islands[p_island].mailbox.size() > l_max)
+                m_islands[p_island].mailbox.pop_front();
+            
+            std::copy( m_islands[p_island].mailbox.begin(), m_islands[p_island].mailbox.end(), std::back_inserter(l_incoming) );
+            m_islands[p_island].mailbox.clear();
+        }
+        
+        if (l_incoming.size() > 0)
+            m_islands[p_island].group->insert( l_incoming );
+    }
+    
+    
+    /** iterates all islands
+     * @param p_iteration number of iterations
+     * @param p_fitness fitness function object
+     * @param p_elite elite selection object
+     * @param p_crossover crossover object
+     * @param p_execution execution context, that is split over the islands
+     **/
+    template<typename T, typename L> inline void islandmodel<T,L>::iterate( const std::size_t& p_iteration, fitness::fitness<T,L>& p_fitness, selection::selection<T,L>& p_elite, crossover::crossover<L>& p_crossover, const tools::execution& p_execution )
+    {
+        if (p_iteration == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        
+        if (m_islands.size() == 1) {
+            run( 0, p_iteration, p_execution.getPartition(0, 1), p_fitness, p_elite, p_crossover );
+            return;
+        }
+        
+        boost::thread_group l_threadgroup;
+        for(std::size_t i=0; i < m_islands.size(); ++i)
+            l_threadgroup.create_thread(  boost::bind( &islandmodel<T,L>::run, this, i, p_iteration, p_execution.getPartition(i, m_islands.size()), boost::ref(p_fitness), boost::ref(p_elite), boost::ref(p_crossover) )  );
+        
+        l_threadgroup.join_all();
+    }
+    
+    
+    /** thread method of an island, the fitness, selection and crossover objects are cloned, so
+     * the onEachIteration calls of different islands does not collide
+     * @param p_island island index
+     * @param p_iteration number of iterations
+     * @param p_execution execution context of the island
+     * @param p_fitness fitness function object
+     * @param p_elite elite selection object
+     * @param p_crossover crossover object
+     **/
+    template<typename T, typename L> inline void islandmodel<T,L>::run( const std::size_t& p_island, const std::size_t& p_iteration, const tools::execution& p_execution, fitness::fitness<T,L>& p_fitness, selection::selection<T,L>& p_elite, crossover::crossover<L>& p_crossover )
+    {
+        // a failed pinning must not stop the thread, it runs unpinned
+        try {
+            p_execution.apply();
+        } catch (...) {}
+        
+        boost::shared_ptr< fitness::fitness<T,L> > l_fitness;
+        boost::shared_ptr< selection::selection<T,L> > l_selection;
+        boost::shared_ptr< crossover::crossover<L> > l_crossover;
+        p_fitness.clone( l_fitness );
+        p_elite.clone( l_selection );
+        p_crossover.clone( l_crossover );
+        
+        const std::size_t l_next = (p_island + 1) % m_islands.size();
+        
+        #ifdef MACHINELEARNING_MPI
+        std::vector<mpi::request> l_requests;
+        std::vector< std::vector< std::vector<L> > > l_sendbuffer;
+        std::size_t l_received = 0;
+        const bool l_remote = (m_mpi) && (p_island == 0) && (m_mpi->size() > 1);
+        l_sendbuffer.reserve( p_iteration / m_interval + 1 );
+        #endif
+        
+        for(std::size_t i=0; i < p_iteration; i+=m_interval) {
+            m_islands[p_island].group->iterate( std::min(m_interval, p_iteration-i), *l_fitness, *l_selection, *l_crossover );
+            
+            if (m_islands.size() > 1)
+                immigrate( l_next, emigrate(p_island) );
+            
+            #ifdef MACHINELEARNING_MPI
+            if (l_remote) {
+                send( emigrate(p_island), l_requests, l_sendbuffer );
+                l_received += receive( false, 0 );
+            }
+            #endif
+            
+            receive( p_island );
+        }
+        
+        #ifdef MACHINELEARNING_MPI
+        // each process sends the same number of messages, so all outstanding messages are received and
+        // the send requests are finished, after that the migrants, that are arrived at the end, are dropped
+        if (l_remote) {
+            const std::size_t l_messages = (p_iteration + m_interval - 1) / m_interval;
+            receive( true, l_messages - l_received );
+            mpi::wait_all( l_requests.begin(), l_requests.end() );
+            
+            boost::lock_guard<boost::mutex> l_lock( *m_islands[p_island].mailboxlock );
+            m_islands[p_island].mailbox.clear();
+        }
+        #endif
+    }
+    
+    
+    
+    //======= MPI ==================================================================================================================================
+    #ifdef MACHINELEARNING_MPI
+    
+    /** iterates the islands of all processes. The local islands are connected in a ring, the first local
+     * island sends its migrants additionally to the first island of the next process and receives the migrants of
+     * the previous process. The messages are send and received non-blocking, so the processes
+     * are not synchronized during the iteration
+     * @note the MPI calls are only done by the thread of the first island, so MPI must be initialized with thread level serialized
+     * @param p_mpi MPI object for communication
+     * @param p_iteration number of iterations
+     * @param p_fitness fitness function object
+     * @param p_elite elite selection object
+     * @param p_crossover crossover object
+     * @param p_execution execution context, that is split over the islands of the process
+     **/
+    template<typename T, typename L> inline void islandmodel<T,L>::iterate( const mpi::communicator& p_mpi, const std::size_t& p_iteration, fitness::fitness<T,L>& p_fitness, selection::selection<T,L>& p_elite, crossover::crossover<L>& p_crossover, const tools::execution& p_execution )
+    {
+        m_mpi = &p_mpi;
+        try {
+            iterate( p_iteration, p_fitness, p_elite, p_crossover, p_execution );
+        } catch (...) {
+            m_mpi = NULL;
+            throw;
+        }
+        m_mpi = NULL;
+    }
+    
+    
+    /** sends the migrants non-blocking to the next process, the values are copied into a buffer,
+     * that must be exist until the requests are finished
+     * @param p_individuals migrants
+     * @param p_requests vector with requests
+     * @param p_buffer send buffer
+     **/
+    template<typename T, typename L> inline void islandmodel<T,L>::send( const std::vector< boost::shared_ptr< individual::individual<L> > >& p_individuals, std::vector<mpi::request>& p_requests, std::vector< std::vector< std::vector<L> > >& p_buffer ) const
+    {
+        std::vector< std::vector<L> > l_values( p_individuals.size() );
+        for(std::size_t i=0; i < p_individuals.size(); ++i)
+            for(std::size_t n=0; n < p_individuals[i]->size(); ++n) {
+                // we need a copy of the value - the [] operator returns a reference so we force the value-copy
+                const L l_value = (*(p_individuals[i]))[n];
+                l_values[i].push_back( l_value );
+            }
+        
+        p_buffer.push_back( l_values );
+        p_requests.push_back( m_mpi->isend( (m_mpi->rank() + 1) % m_mpi->size(), m_mpitag, p_buffer.back() ) );
+    }
+    
+    
+    /** receives the migrants of the previous process and puts them into the mailbox of the first island
+     * @param p_blocking on true the given number of messages are received blocking, otherwise all arrived messages are received
+     * @param p_count number of messages on blocking receive
+     * @return number of received messages
+     **/
+    template<typename T, typename L> inline std::size_t islandmodel<T,L>::receive( const bool& p_blocking, const std::size_t& p_count )
+    {
+        const int l_source = (m_mpi->rank() + m_mpi->size() - 1) % m_mpi->size();
+        std::size_t l_count = 0;
+        
+        while ( (p_blocking && (l_count < p_count)) || (!p_blocking && m_mpi->iprobe(l_source, m_mpitag)) ) {
+            std::vector< std::vector<L> > l_values;
+            m_mpi->recv( l_source, m_mpitag, l_values );
+            l_count++;
+            
+            std::vector< boost::shared_ptr< individual::individual<L> > > l_individuals;
+            for(std::size_t i=0; i < l_values.size(); ++i) {
+                boost::shared_ptr< individual::individual<L> > l_ind;
+                m_individualref.clone( l_ind );
+                
+                if (l_ind->size() != l_values[i].size())
+                    throw exception::runtime(_("element sizes are not equal"), *this);
+                
+                for(std::size_t n=0; n < l_values[i].size(); ++n)
+                    (*l_ind)[n] = l_values[i][n];
+                
+                l_individuals.push_back( l_ind );
+            }
+            
+            immigrate( 0, l_individuals );
+        }
+        
+        return l_count;
+    }
+    
+    #endif
+    
+}}
+#endif
@@ -27,6 +27,7 @@
 
 #include <omp.h>
 #include <limits>
+#include <algorithm>
 #include <boost/numeric/ublas/vector.hpp>
 
 #include <boost/shared_ptr.hpp>
@@ -70,6 +71,7 @@ namespace machinelearning { namespace geneticalgorithm {
             void setMutalProbability( const T&, const tools::random::distribution& = tools::random::uniform, const T& = std::numeric_limits<T>::epsilon(), const T& = std::numeric_limits<T>::epsilon(), const T& = std::numeric_limits<T>::epsilon() );
             void setPopulationBuild( const buildoption&, const tools::random::distribution& = tools::random::uniform );
             void iterate( const std::size_t&, fitness::fitness<T,L>&, selection::selection<T,L>&, crossover::crossover<L>& );
+            void insert( const std::vector< boost::shared_ptr< individual::individual<L> > >& );
             //bool iterateUntilConverged( const std::size_t&, const fitness::fitness<T>&, const selection::selection<T>&, const crossover& );
         
         
@@ -216,6 +218,31 @@ namespace machinelearning { namespace geneticalgorithm {
     }
         
 
+    /** inserts individuals (eg. migrants of another population) into the population. The
+     * individuals replace random non-elite individuals, the objects are not copied
+     * @param p_individuals vector with individuals
+     **/
+    template<typename T, typename L> inline void population<T,L>::insert( const std::vector< boost::shared_ptr< individual::individual<L> > >& p_individuals )
+    {
+        if (p_individuals.size() > m_population.size() - m_elitesize)
+            throw exception::runtime(_("number of individuals must be smaller or equal than the number of non-elite individuals"), *this);
+        
+        tools::random l_random;
+        for(std::size_t i=0; i < p_individuals.size(); ++i) {
+            if (p_individuals[i]->size() != m_individualref.size())
+                throw exception::runtime(_("element sizes are not equal"), *this);
+            
+            // elite objects are shared with the population, so they are not replaced
+            std::size_t l_pos = 0;
+            do
+                l_pos = std::min( m_population.size()-1, static_cast<std::size_t>(l_random.get<T>(tools::random::uniform, 0, m_population.size())) );
+            while (std::find(m_elite.begin(), m_elite.end(), m_population[l_pos]) != m_elite.end());
+            
+            m_population[l_pos] = p_individuals[i];
+        }
+    }
+    
+    
     /** returns the population size
      * @return size of the population
      **/
@@ -236,19 +263,6 @@ namespace machinelearning { namespace geneticalgorithm {
         if (p_iteration == 0)
             throw exception::runtime(_("iterations must be greater than zero"), *this);
         
-        // create a map with the parts of the elites that are build on each thread (eg: elites [0,k) on thread 0, [k,n) on thread 1, ...)
-        std::size_t l_inc = m_elitesize / omp_get_max_threads();
-        l_inc = l_inc == 0 ? m_elitesize : l_inc;
-        std::vector< std::pair<std::size_t, std::size_t> > l_eliteparts;
-        for( std::size_t i=0; i < m_elitesize-1; i+=l_inc )
-            l_eliteparts.push_back( std::pair<std::size_t, std::size_t>(i, i+l_inc) );
-        
-        if (l_eliteparts.size() == 0)
-            l_eliteparts.push_back( std::pair<std::size_t, std::size_t>(0, m_elitesize) );
-        else
-            l_eliteparts[l_eliteparts.size()-1].second += m_elitesize % omp_get_max_threads();
-        l_eliteparts[l_eliteparts.size()-1].second = std::min( l_eliteparts[l_eliteparts.size()-1].second, m_elitesize );
-
         // create local random generator
         tools::random l_random;
         
@@ -300,15 +314,24 @@ namespace machinelearning { namespace geneticalgorithm {
             
             #pragma omp parallel shared(l_fitness)
             {
-                boost::shared_ptr< selection::selection<T,L> > l_selection;
-                p_elite.clone( l_selection );
+                // each thread builds an equal part of the elites (eg: elites [0,k) on thread 0, [k,n) on thread 1, ...),
+                // the parts are created from the size of the team, threads with an empty part are idle
+                const std::size_t l_threads = static_cast<std::size_t>(omp_get_num_threads());
+                const std::size_t l_thread  = static_cast<std::size_t>(omp_get_thread_num());
+                const std::size_t l_start   = l_thread * m_elitesize / l_threads;
+                const std::size_t l_end     = (l_thread+1) * m_elitesize / l_threads;
                 
-                std::vector< boost::shared_ptr< individual::individual<L> > > l_elite;
-                l_selection->getElite(l_eliteparts[omp_get_thread_num()].first, l_eliteparts[omp_get_thread_num()].second, m_population, l_fitness, l_rankIndex, l_rank, l_elite);
+                if (l_start < l_end) {
+                    boost::shared_ptr< selection::selection<T,L> > l_selection;
+                    p_elite.clone( l_selection );
+                    
+                    std::vector< boost::shared_ptr< individual::individual<L> > > l_elite;
+                    l_selection->getElite(l_start, l_end, m_population, l_fitness, l_rankIndex, l_rank, l_elite);
 
-                if (l_elite.size() > 0)
-                    #pragma omp critical
-                    std::copy( l_elite.begin(), l_elite.end(), std::back_inserter(m_elite));
+                    if (l_elite.size() > 0)
+                        #pragma omp critical
+                        std::copy( l_elite.begin(), l_elite.end(), std::back_inserter(m_elite));
+                }
             }
             
             // updateing elite size and break if optimum is found
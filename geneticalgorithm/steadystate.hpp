@@ -0,0 +1,541 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+
+#ifndef __MACHINELEARNING_GENETICALGORITHM_STEADYSTATE_HPP
+#define __MACHINELEARNING_GENETICALGORITHM_STEADYSTATE_HPP
+
+#include <deque>
+#include <algorithm>
+#include <limits>
+#include <vector>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+#include "../errorhandling/exception.hpp"
+#include "../tools/tools.h"
+
+#include "individual/individual.h"
+#include "crossover/crossover.h"
+#include "selection/selection.h"
+#include "fitness/fitness.h"
+
+
+namespace machinelearning { namespace geneticalgorithm {
+    
+    #ifndef SWIG
+    namespace ublas = boost::numeric::ublas;
+    #endif
+    
+    
+    /** class for the asynchronous steady-state optimization. The fitness values are calculated
+     * by a pool of worker threads and each result is handled on arrival: the individual replaces the
+     * worst individual of the population (if it is better) and a new child is created for the free
+     * worker, so there is no generation barrier. It should be used for expensive fitness functions,
+     * that have different run times
+     **/
+    template<typename T, typename L> class steadystate
+    {
+        BOOST_STATIC_ASSERT( !boost::is_integral<T>::value );
+        
+        public :
+        
+            steadystate( const individual::individual<L>&, const std::size_t&, const std::size_t&, const std::size_t& = boost::thread::hardware_concurrency() );
+        
+            std::size_t size( void ) const;
+            void setEliteSize( const std::size_t& );
+            std::size_t getEliteSize( void ) const;
+            std::size_t getWorkerSize( void ) const;
+            std::size_t getEvaluations( void ) const;
+            std::vector< boost::shared_ptr< individual::individual<L> > > getElite( void ) const;
+            void setMutalProbability( const T&, const tools::random::distribution& = tools::random::uniform, const T& = std::numeric_limits<T>::epsilon(), const T& = std::numeric_limits<T>::epsilon(), const T& = std::numeric_limits<T>::epsilon() );
+            void iterate( const std::size_t&, fitness::fitness<T,L>&, selection::selection<T,L>&, crossover::crossover<L>&, const tools::execution& = tools::execution::getGlobal() );
+        
+        
+        private :
+        
+            /** struct of an evaluation job / result **/
+            struct job
+            {
+                /** individual **/
+                boost::shared_ptr< individual::individual<L> > object;
+                /** population index or number of population elements for a new child **/
+                std::size_t index;
+                /** fitness value **/
+                T value;
+                /** optimum flag **/
+                bool optimum;
+                /** error flag **/
+                bool error;
+            };
+        
+            /** struct of the probabilities **/
+            struct probability {
+                tools::random::distribution distribution;
+                T probabilityvalue;
+                T first;
+                T second;
+                T third;
+                
+                probability() :
+                    distribution(tools::random::uniform),
+                    probabilityvalue( 0.4 ),
+                    first( 0.0 ),
+                    second( 1.0 ),
+                    third( std::numeric_limits<T>::epsilon() )
+                {}
+            };
+        
+        
+            /** reference of the individual **/
+            const individual::individual<L>& m_individualref;
+            /** vector with smart-pointer of individuals **/
+            std::vector< boost::shared_ptr< individual::individual<L> > > m_population;
+            /** fitness values of the population **/
+            ublas::vector<T> m_fitness;
+            /** flag, that the individual is evaluated **/
+            std::vector<bool> m_evaluated;
+            /** vector with smart-pointer of elite-individuals **/
+            std::vector< boost::shared_ptr< individual::individual<L> > > m_elite;
+            /** elite size **/
+            std::size_t m_elitesize;
+            /** number of worker threads **/
+            const std::size_t m_workersize;
+            /** mutation probability **/
+            probability m_mutateprobility;
+            /** number of evaluations of the last iteration call **/
+            std::size_t m_evaluations;
+        
+            /** queue of the jobs **/
+            std::deque<job> m_jobs;
+            /** queue of the results **/
+            std::deque<job> m_results;
+            /** stop flag of the workers **/
+            bool m_stop;
+            /** mutex of the queues **/
+            boost::mutex m_queuelock;
+            /** condition for new jobs **/
+            boost::condition_variable m_jobcondition;
+            /** condition for new results **/
+            boost::condition_variable m_resultcondition;
+        
+            void worker( const tools::execution&, fitness::fitness<T,L>& );
+            void submit( const boost::shared_ptr< individual::individual<L> >&, const std::size_t& );
+            job waitResult( void );
+            void selectElite( selection::selection<T,L>& );
+            boost::shared_ptr< individual::individual<L> > createChild( crossover::crossover<L>&, tools::random& ) const;
+            void replace( const job& );
+    };
+    
+    
+    
+    /** constructor
+     * @param p_individualref reference to the individual object, that is n-times cloned for the population
+     * @param p_size size of the population
+     * @param p_elite size of the elites
+     * @param p_worker number of worker threads
+     **/
+    template<typename T, typename L> inline steadystate<T,L>::steadystate( const individual::individual<L>& p_individualref, const std::size_t& p_size, const std::size_t& p_elite, const std::size_t& p_worker ) :
+        m_individualref( p_individualref ),
+        m_population(),
+        m_fitness( p_size, 0 ),
+        m_evaluated( p_size, false ),
+        m_elite(),
+        m_elitesize( p_elite ),
+        m_workersize( std::max(static_cast<std::size_t>(1), p_worker) ),
+        m_mutateprobility(),
+        m_evaluations( 0 ),
+        m_jobs(),
+        m_results(),
+        m_stop( false )
+    {
+        if (p_size < 3)
+            throw exception::runtime(_("population size must be greater than two"), *this);
+        
+        if (p_elite < 2)
+            throw exception::runtime(_("elite size must be greater than one"), *this);
+        
+        if (p_elite >= p_size)
+            throw exception::runtime(_("elite size must be smaller than population size"), *this);
+        
+        for(std::size_t i=0; i < p_size; ++i) {
+            boost::shared_ptr< individual::individual<L> > l_ptr;
+            m_individualref.clone( l_ptr );
+            m_population.push_back( l_ptr );
+        }
+    }
+    
+    
+    /** returns the population size
+     * @return size of the population
+     **/
+    template<typename T, typename L> inline std::size_t steadystate<T,L>::size( void ) const
+    {
+        return m_population.size();
+    }
+    
+    
+    /** change the elite size
+     * @param p_size size number
+     **/
+    template<typename T, typename L> inline void steadystate<T,L>::setEliteSize( const std::size_t& p_size )
+    {
+        if (p_size < 2)
+            throw exception::runtime(_("elite size must be greater than one"), *this);
+        
+        if (p_size >= m_population.size())
+            throw exception::runtime(_("elite size must be smaller than population size"), *this);
+        
+        m_elitesize = p_size;
+    }
+    
+    
+    /** returns the elite size
+     * @return size of elite
+     **/
+    template<typename T, typename L> inline std::size_t steadystate<T,L>::getEliteSize( void ) const
+    {
+        return m_elitesize;
+    }
+    
+    
+    /** returns the number of worker threads
+     * @return number of threads
+     **/
+    template<typename T, typename L> inline std::size_t steadystate<T,L>::getWorkerSize( void ) const
+    {
+        return m_workersize;
+    }
+    
+    
+    /** returns the number of fitness evaluations of the last iterate call
+     * @return number of evaluations
+     **/
+    template<typename T, typename L> inline std::size_t steadystate<T,L>::getEvaluations( void ) const
+    {
+        return m_evaluations;
+    }
+    
+    
+    /** changes the mutal probability
+     * @param p_prop probility
+     * @param p_distribution distribution
+     * @param p_first first distribution value
+     * @param p_second second distribution value
+     * @param p_third third distribution value
+     **/
+    template<typename T, typename L> inline void steadystate<T,L>::setMutalProbability( const T& p_prop, const tools::random::distribution& p_distribution, const T& p_first, const T& p_second, const T& p_third )
+    {
+        m_mutateprobility.distribution      = p_distribution;
+        m_mutateprobility.probabilityvalue  = p_prop;
+        m_mutateprobility.first             = p_first;
+        m_mutateprobility.second            = p_second;
+        m_mutateprobility.third             = p_third;
+    }
+    
+    
+    /** returns a copy of the elite individuals
+     * @return vector with smart-pointer objects of the elite individuals
+     **/
+    template<typename T, typename L> inline std::vector< boost::shared_ptr< individual::individual<L> > > steadystate<T,L>::getElite( void ) const
+    {
+        std::vector< boost::shared_ptr< individual::individual<L> > > l_result;
+        
+        for(std::size_t i=0; i < m_elite.size(); ++i) {
+            boost::shared_ptr< individual::individual<L> > l_ind;
+            m_individualref.clone( l_ind );
+            
+            if (l_ind->size() != m_elite[i]->size())
+                throw exception::runtime(_("element sizes are not equal"), *this);
+            
+            for(std::size_t n=0; n < m_elite[i]->size(); ++n) {
+                // we need a copy of the value - the [] operator returns a reference so we force the value-copy
+                L l_value = (*(m_elite[i]))[n];
+                (*l_ind)[n] = l_value;
+            }
+            l_result.push_back( l_ind );
+        }
+        
+        return l_result;
+    }
+    
+    
+    /** thread method of a worker, that evaluates the jobs until the stop flag is set.
+     * Exceptions of the fitness function are returned as error results
+     * @param p_execution execution context of the worker
+     * @param p_fitness fitness function object
+     **/
+    template<typename T, typename L> inline void steadystate<T,L>::worker( const tools::execution& p_execution, fitness::fitness<T,L>& p_fitness )
+    {
+        // a failed pinning must not stop the thread, it runs unpinned
+        try {
+            p_execution.apply();
+        } catch (...) {}
+        
+        boost::shared_ptr< fitness::fitness<T,L> > l_fitness;
+        {
+            boost::lock_guard<boost::mutex> l_lock( m_queuelock );
+            p_fitness.clone( l_fitness );
+        }
+        
+        while (true) {
+            job l_job;
+            {
+                boost::unique_lock<boost::mutex> l_lock( m_queuelock );
+                while (!m_stop && m_jobs.empty())
+                    m_jobcondition.wait( l_lock );
+                
+                if (m_stop)
+                    return;
+                
+                l_job = m_jobs.front();
+                m_jobs.pop_front();
+            }
+            
+            try {
+                l_job.value   = l_fitness->getFitness( *l_job.object );
+                l_job.optimum = l_fitness->isOptimumReached();
+            } catch (...) {
+                l_job.error   = true;
+            }
+            
+            {
+                boost::lock_guard<boost::mutex> l_lock( m_queuelock );
+                m_results.push_back( l_job );
+            }
+            m_resultcondition.notify_one();
+        }
+    }
+    
+    
+    /** adds an individual to the job queue
+     * @param p_individual individual
+     * @param p_index population index or population size for children
+     **/
+    template<typename T, typename L> inline void steadystate<T,L>::submit( const boost::shared_ptr< individual::individual<L> >& p_individual, const std::size_t& p_index )
+    {
+        job l_job;
+        l_job.object     = p_individual;
+        l_job.index      = p_index;
+        l_job.value      = 0;
+        l_job.optimum    = false;
+        l_job.error      = false;
+        
+        {
+            boost::lock_guard<boost::mutex> l_lock( m_queuelock );
+            m_jobs.push_back( l_job );
+        }
+        m_jobcondition.notify_one();
+    }
+    
+    
+    /** waits for the next result
+     * @return result
+     **/
+    template<typename T, typename L> inline typename steadystate<T,L>::job steadystate<T,L>::waitResult( void )
+    {
+        boost::unique_lock<boost::mutex> l_lock( m_queuelock );
+        while (m_results.empty())
+            m_resultcondition.wait( l_lock );
+        
+        const job l_job = m_results.front();
+        m_results.pop_front();
+        return l_job;
+    }
+    
+    
+    /** stores the result within the population, initial individuals are stored on their position,
+     * children replace the worst evaluated individual if they are better
+     * @param p_job result
+     **/
+    template<typename T, typename L> inline void steadystate<T,L>::replace( const job& p_job )
+    {
+        if (p_job.index < m_population.size()) {
+            m_fitness(p_job.index)   = p_job.value;
+            m_evaluated[p_job.index] = true;
+            return;
+        }
+        
+        std::size_t l_worst = m_population.size();
+        for(std::size_t i=0; i < m_population.size(); ++i)
+            if ( m_evaluated[i] && ((l_worst == m_population.size()) || (m_fitness(i) < m_fitness(l_worst))) )
+                l_worst = i;
+        
+        if ( (l_worst < m_population.size()) && (p_job.value > m_fitness(l_worst)) ) {
+            m_population[l_worst] = p_job.object;
+            m_fitness(l_worst)    = p_job.value;
+        }
+    }
+    
+    
+    /** creates the elite of the evaluated individuals with the selection object
+     * @param p_selection selection object
+     **/
+    template<typename T, typename L> inline void steadystate<T,L>::selectElite( selection::selection<T,L>& p_selection )
+    {
+        std::vector< boost::shared_ptr< individual::individual<L> > > l_population;
+        std::vector<T> l_values;
+        for(std::size_t i=0; i < m_population.size(); ++i)
+            if (m_evaluated[i]) {
+                l_population.push_back( m_population[i] );
+                l_values.push_back( m_fitness(i) );
+            }
+        
+        // scales the fitness values to [0,x] and ranks them
+        ublas::vector<T> l_fitness = tools::vector::copy( l_values );
+        const T l_min = tools::vector::min( l_fitness );
+        for(std::size_t i=0; i < l_fitness.size(); ++i)
+            l_fitness(i) -= l_min;
+        
+        const ublas::vector<std::size_t> l_rankIndex( tools::vector::rankIndexVector(l_fitness) );
+        const ublas::vector<std::size_t> l_rank( tools::vector::rank(l_fitness) );
+        
+        m_elite.clear();
+        p_selection.getElite( 0, std::min(m_elitesize, l_population.size()), l_population, l_fitness, l_rankIndex, l_rank, m_elite );
+    }
+    
+    
+    /** creates a new child of the elite individuals
+     * @param p_crossover crossover object
+     * @param p_random random object
+     * @return new individual
+     **/
+    template<typename T, typename L> inline boost::shared_ptr< individual::individual<L> > steadystate<T,L>::createChild( crossover::crossover<L>& p_crossover, tools::random& p_random ) const
+    {
+        for(std::size_t i=0; i < p_crossover.getNumberOfIndividuals(); ++i)
+            p_crossover.setIndividual( m_elite[ std::min(m_elite.size()-1, static_cast<std::size_t>(p_random.get<T>(tools::random::uniform, 0, m_elite.size()))) ] );
+        
+        boost::shared_ptr< individual::individual<L> > l_child = p_crossover.combine();
+        
+        if (p_random.get<T>( m_mutateprobility.distribution, m_mutateprobility.first, m_mutateprobility.second, m_mutateprobility.third ) <= m_mutateprobility.probabilityvalue)
+            l_child->mutate();
+        
+        return l_child;
+    }
+    
+    
+    /** runs the optimization, the worker threads are created for each call
+     * @param p_evaluations number of fitness evaluations of new children (each population size
+     * evaluations the onEachIteration methods are called)
+     * @param p_fitness fitness function object
+     * @param p_elite elite selection object
+     * @param p_crossover crossover object
+     * @param p_execution execution context, that is split over the workers
+     **/
+    template<typename T, typename L> inline void steadystate<T,L>::iterate( const std::size_t& p_evaluations, fitness::fitness<T,L>& p_fitness, selection::selection<T,L>& p_elite, crossover::crossover<L>& p_crossover, const tools::execution& p_execution )
+    {
+        if (p_evaluations == 0)
+            throw exception::runtime(_("iterations must be greater than zero"), *this);
+        
+        m_stop        = false;
+        m_evaluations = 0;
+        m_jobs.clear();
+        m_results.clear();
+        
+        boost::thread_group l_threadgroup;
+        for(std::size_t i=0; i < m_workersize; ++i)
+            l_threadgroup.create_thread(  boost::bind( &steadystate<T,L>::worker, this, p_execution.getPartition(i, m_workersize), boost::ref(p_fitness) )  );
+        
+        // all individuals, that are not evaluated, are added first
+        std::size_t l_running = 0;
+        for(std::size_t i=0; i < m_population.size(); ++i)
+            if (!m_evaluated[i]) {
+                submit( m_population[i], i );
+                l_running++;
+            }
+        
+        tools::random l_random;
+        std::size_t l_submitted = 0;
+        bool l_optimumreached = false;
+        bool l_error = false;
+        
+        // the workers must be stopped on an exception of the selection / crossover objects
+        try {
+        
+            // children are created if enough individuals are evaluated, the queue
+            // contains only so many children that all workers are busy
+            while (true) {
+            
+                const std::size_t l_evaluated = static_cast<std::size_t>(std::count( m_evaluated.begin(), m_evaluated.end(), true ));
+                if (!l_optimumreached && !l_error && (l_evaluated >= m_elitesize) && (l_submitted < p_evaluations)) {
+                    selectElite( p_elite );
+                
+                    while ( (l_running < m_workersize) && (l_submitted < p_evaluations) ) {
+                        submit( createChild(p_crossover, l_random), m_population.size() );
+                        l_running++;
+                        l_submitted++;
+                    }
+                }
+            
+                if (l_running == 0)
+                    break;
+            
+                const job l_result = waitResult();
+                l_running--;
+            
+                if (l_result.error) {
+                    l_error = true;
+                    continue;
+                }
+            
+                replace( l_result );
+                l_optimumreached = l_optimumreached || l_result.optimum;
+            
+                if (l_result.index >= m_population.size()) {
+                    m_evaluations++;
+                
+                    // call the "eachIteration" method of each object after each population size evaluations
+                    if (m_evaluations % m_population.size() == 0) {
+                        p_fitness.onEachIteration( m_population );
+                        p_elite.onEachIteration( m_population );
+                        p_crossover.onEachIteration( m_population );
+                    }
+                }
+            }
+        } catch (...) {
+            {
+                boost::lock_guard<boost::mutex> l_lock( m_queuelock );
+                m_stop = true;
+            }
+            m_jobcondition.notify_all();
+            l_threadgroup.join_all();
+            throw;
+        }
+        
+        {
+            boost::lock_guard<boost::mutex> l_lock( m_queuelock );
+            m_stop = true;
+        }
+        m_jobcondition.notify_all();
+        l_threadgroup.join_all();
+        
+        if (l_error)
+            throw exception::runtime(_("fitness function has thrown an exception"), *this);
+        
+        selectElite( p_elite );
+    }
+    
+}}
+#endif
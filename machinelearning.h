@@ -130,7 +130,11 @@
  * <li><dfn>MACHINELEARNING_NDEBUG</dfn> remove any debug information (eg framework individual asserts)</li> 
  * <li><dfn>MACHINELEARNING_RANDOMDEVICE</dfn> for using the Boost Device Random support (requires Boost Random Device Support), otherwise a Mersenne Twister is used</li>
  * <li><dfn>MACHINELEARNING_MULTILANGUAGE</dfn> option for compiling the framework with multilanguage support (uses gettext)</li>
- * <li><dfn>MACHINELEARNING_LOGGER</dfn> option for using a own logger</li>
+ * <li><dfn>MACHINELEARNING_LOGGER</dfn> option for using a own logger<ul>
+ * <li><dfn>MACHINELEARNING_LOGGER_MAXLEVEL</dfn> highest log level, that is compiled into the write calls with a template level (default <dfn>info</dfn>)</li>
+ * <li><dfn>MACHINELEARNING_LOGGER_QUEUESIZE</dfn> number of messages within the asynchronous logger queue (default 8192)</li>
+ * </ul></li>
+ * <li><dfn>MACHINELEARNING_DISTANCES_KERNEL_SCALAR</dfn> disables the SSE / AVX distance kernels, which are selected at runtime on GCC x86 builds</li>
  * <li><dfn>MACHINELEARNING_FILES</dfn> adds the support for file reading and writing (default CSV). Special file support can be set with the following flags<ul>
  * <li><dfn>MACHINELEARNING_FILES_HDF</dfn> Hierarchical Data Format support</li>
  * </ul></li>
@@ -209,6 +213,8 @@
  * <li><dfn>other</dfn> this target build all other examples, <dfn>withfiles</dfn> options must be set, <dfn>withsources</dfn> can be set (includes nntp and wikipedia examples) and optional 
  * <dfn>withmpi</dfn> </li>
  * <li><dfn>ga</dfn> target for building genetic algorithms</li>
+ * <li><dfn>benchmark</dfn> builds the benchmark program, that measures the run times of the main algorithms on synthetic data over different problem sizes and thread counts
+ * and writes the results as JSON (<dfn>withsources</dfn> is set by the target, the file benchmarks need <dfn>withfiles</dfn>)</li>
  * </ul><ul>
  * <li><dfn>java</dfn> create the the C/C++ stub files of each Java class, create the shared library and add all to the Jar file. With the system environment variable (<dfn>MACHINELEARNING_DLL_OVERWRITE</dfn>
  * on java run (option flag <dfn>-D</dfn>), the DLLs are written on each call to the temporary directory)</li>
@@ -301,7 +307,8 @@
  * The namespace machinelearning::distances holds all types of distances. Every distance function is a subclass of <i>distance</i> and calculates distances values for vector- and matrixdata.
  * The class must be implementated as a template class and must hold some special functions for using the distance operation. In the namespace is also the ncd-class that creates a
  * symmetric/asymmetric dissimilarity matrix of string- or filedata with the <i>normalized compression distance</i>, that based on an approximation of the the Kolmogorov complexity. The
- * example show how to use these classes.
+ * example show how to use these classes. The norm namespace holds the euclidian, manhattan, chebyshev, cosine and mahalanobis distance, each of them can be passed to the
+ * clustering classes and the knn, either as <i>distance</i> reference or as template parameter (eg <dfn>neuralgas<double, distances::norm::cosine<double> ></dfn>) for static binding.
  *
  * @section ncd Normalize Compression Distance (NCD)
  * @include examples/distance/ncd.cpp
@@ -334,7 +341,8 @@
  *
  * @page logger Examples Logger
  * Within the toolbox is a logger class which implements a thread-safe and optional MPI logger. The logger create a singleton object that create
- * a file access for writing messages. The MPI component sends all messages with non-blocking communication to the CPU 0. See in the logger class
+ * a file access for writing messages. The messages are pushed into a lock-free queue and written by a background thread, so a write call does
+ * not block on the file. The MPI component sends all messages with non-blocking communication to the CPU 0. See in the logger class
  * for log states, which must be used for writing the messages.
  * @section normal Normal Use
  * @code
@@ -345,7 +353,7 @@
     tools::logger::getInstance()->setLevel( tools::logger::info );
  
     // creates a message
-    tools::logger::getInstance()->write( tools::logger::warn, "test message" );
+    tools::logger::getInstance()->write<tools::logger::warn>( "test message" );
  
     // shows the filename in which the messages are write down
     std::cout << tools::logger::getInstance()->getFilename() << std::endl;
@@ -371,10 +379,10 @@
     tools::logger::getInstance()->setLevel( tools::logger::info );
  
     // creates a message in the local log
-    tools::logger::getInstance()->write( tools::logger::warn, "test message" );
+    tools::logger::getInstance()->write<tools::logger::warn>( "test message" );
  
     // creates a message with MPI use
-    tools::logger::getInstance()->write( l_mpi, tools::logger::warn, "test message with MPI" );
+    tools::logger::getInstance()->write<tools::logger::warn>( l_mpi, "test message with MPI" );
  
     // close the listener
     tools::logger::getInstance()->shutdownListener( l_mpi );
@@ -605,6 +613,7 @@
  * <li>@ref javarandom</li>
  * <li>@ref javapca</li>
  * <li>@ref javamds</li>
+ * <li>@ref javaasync</li>
  * </ul>
  *
  * @section javaeigen Eigenvalues
@@ -622,6 +631,11 @@
  * @section javamds Multidimensional Scaling (MDS)
  * @include examples/java/reducing/mds.java
  *
+ * @section javaasync Asynchronous Training
+ * The task classes run the training of neural gas, relational neural gas or k-means on a native thread pool, so the Java thread is not blocked. A derived
+ * Progress class gets the quantization error of each iteration and the training can be canceled between two iterations
+ * @include examples/java/clustering/asynchronous.java
+ *
  *
  *
  * @file machinelearning.h main header for including in a project
@@ -635,6 +649,8 @@
  * @file clustering/nonsupervised/clustering.hpp header for nonsupervised abstract clustering classes
  * @file clustering/nonsupervised/kmeans.hpp k-means implementation
  * @file clustering/nonsupervised/neuralgas.hpp neuralgas implemention for real vector space
+ * @file clustering/nonsupervised/patch.hpp weighted data patch for patch clustering
+ * @file clustering/nonsupervised/pipeline.hpp pipeline for loading and training patches
  * @file clustering/nonsupervised/relational_neuralgas.hpp neuralgas implemention for distance / relational data
  * @file clustering/nonsupervised/spectralclustering.hpp implementation of the spectral clustering
  * @file clustering/supervised/clustering.hpp header for supervised abstract clustering classes
@@ -652,6 +668,7 @@
  * @file distances/distance.hpp abstract class for distance algorithms
  * @file distances/norm/euclid.hpp class for euclidian distances
  * @file distances/ncd.hpp implementation of the normalize compression distance
+ * @file distances/dissimilaritycache.hpp tile cache of a dissimilarity matrix, that is created on demand
  *
  * @file errorhandling/exception.hpp header file for exceptions with implemention (forward declaration)
  * @file errorhandling/exception.implementation.hpp file with the exception implementation
@@ -659,6 +676,7 @@
  *
  * @file functionoptimization/functionoptimization.h main header for function optimization
  * @file functionoptimization/gradientdescent.hpp gradient descent implementation
+ * @file functionoptimization/tape.hpp compiled expression evaluator with reverse-mode gradient
  *
  * @file geneticalgorithm/geneticalgorithm.h main header for all genetic algorithms
  * @file geneticalgorithm/population.hpp population class
@@ -681,6 +699,7 @@
  * @file neighborhood/knn.hpp k-nearest-neighborhood implementation
  *
  * @file tools/tools.h main header for tools algorithms
+ * @file tools/execution.hpp execution context of the parallel regions
  * @file tools/function.hpp different functions eg. numerical limit checking
  * @file tools/logger.hpp logger implementation (forward declaration)
  * @file tools/logger.implementation.hpp logger implementation
@@ -27,6 +27,10 @@
 #define __MACHINELEARNING_NEIGHBORHOOD_KNN_HPP
 
 
+#include <omp.h>
+#include <algorithm>
+#include <boost/lambda/lambda.hpp>
+#include <boost/iterator/counting_iterator.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/symmetric.hpp>
 #include <boost/numeric/ublas/vector.hpp>
@@ -42,12 +46,14 @@ namespace machinelearning { namespace neighborhood {
     
     
     namespace ublas   = boost::numeric::ublas;
+    namespace lam     = boost::lambda;
     
     
-    /** implementation for the k-nearest-neighbor
+    /** implementation for the k-nearest-neighbor, the distance type can be set as template
+     * parameter for static binding of the distance calls
      * @todo recreate the data structur with kdtree (http://en.wikipedia.org/wiki/Kd-tree) or r-tree (http://en.wikipedia.org/wiki/R-tree) for optimizing
      **/
-    template<typename T> class knn : public neighborhood<T>
+    template<typename T, typename D = distances::distance<T> > class knn : public neighborhood<T>
     {
         
         public :
@@ -59,10 +65,11 @@ namespace machinelearning { namespace neighborhood {
             };
         
         
-            knn( const distances::distance<T>&, const std::size_t& );
+            knn( const D&, const std::size_t& );
             std::size_t getNeighborCount( void ) const;
             ublas::matrix<std::size_t> get( const ublas::matrix<T>& ) const;
             ublas::matrix<std::size_t> get( const ublas::matrix<T>&, const ublas::matrix<T>& ) const;
+            ublas::matrix<std::size_t> get( const ublas::matrix<T>&, const ublas::matrix<T>&, ublas::matrix<T>& ) const;
             T calculateDistance( const ublas::vector<T>&, const ublas::vector<T>& ) const;
             T invert( const T& p_val ) const;
         
@@ -77,7 +84,7 @@ namespace machinelearning { namespace neighborhood {
             /** number of nearest **/
             const std::size_t m_knn;
             /** distance object **/
-            const distances::distance<T>& m_distance;       
+            typename distances::policy<D>::type m_distance;       
         
             ublas::symmetric_matrix<T, ublas::upper> calculate( const ublas::matrix<T>& ) const;
         
@@ -90,7 +97,7 @@ namespace machinelearning { namespace neighborhood {
      * @param p_knn number of neighborhood
      * @deprecated removed if class will be redesigned
      **/
-    template<typename T> inline knn<T>::knn( const distances::distance<T>& p_distance, const std::size_t& p_knn ) :
+    template<typename T, typename D> inline knn<T, D>::knn( const D& p_distance, const std::size_t& p_knn ) :
         m_knn(p_knn),    
         m_distance( p_distance )
     {
@@ -103,7 +110,7 @@ namespace machinelearning { namespace neighborhood {
      * @return number
      * @deprecated removed if class will be redesigned
      **/
-    template<typename T> inline std::size_t knn<T>::getNeighborCount( void ) const
+    template<typename T, typename D> inline std::size_t knn<T, D>::getNeighborCount( void ) const
     {
         return m_knn;
     }
@@ -114,7 +121,7 @@ namespace machinelearning { namespace neighborhood {
      * @return N x kNN matrix, with N rows (data points) and k index points
      * @deprecated removed if class will be redesigned
     **/
-    template<typename T> inline ublas::matrix<std::size_t> knn<T>::get( const ublas::matrix<T>& p_data ) const
+    template<typename T, typename D> inline ublas::matrix<std::size_t> knn<T, D>::get( const ublas::matrix<T>& p_data ) const
     {
         if (m_knn > p_data.size1())
             throw exception::runtime(_("knn is greater than datapoints"), *this);
@@ -146,9 +153,9 @@ namespace machinelearning { namespace neighborhood {
      * @return N x kNN matrix, with N rows (data points) and k index fix points
      * @deprecated removed if class will be redesigned
      **/
-    template<typename T> inline ublas::matrix<std::size_t> knn<T>::get( const ublas::matrix<T>& p_fix, const ublas::matrix<T>& p_data  ) const
+    template<typename T, typename D> inline ublas::matrix<std::size_t> knn<T, D>::get( const ublas::matrix<T>& p_fix, const ublas::matrix<T>& p_data  ) const
     {
-        if (m_knn > p_data.size1())
+        if (m_knn > p_fix.size1())
             throw exception::runtime(_("knn is greater than datapoints"), *this);
         
         
@@ -157,9 +164,7 @@ namespace machinelearning { namespace neighborhood {
         for(std::size_t i=0; i < p_data.size1(); ++i) {
             const ublas::vector<T> l_vec = static_cast< ublas::vector<T> >(ublas::row(p_data, i));
             
-            ublas::vector<T> l_distance(p_fix.size1());
-            for(std::size_t j=0; j < p_fix.size1(); ++j)
-                l_distance(j) = calculateDistance( l_vec, static_cast< ublas::vector<T> >(ublas::row(p_fix, j)) );
+            ublas::vector<T> l_distance = m_distance.getDistance( p_fix, l_vec );
             
             ublas::vector<std::size_t> l_rank = tools::vector::rankIndexVector(l_distance);
             const ublas::vector_range< ublas::vector<std::size_t> > l_range( l_rank, ublas::range(0, m_knn)  );
@@ -171,13 +176,52 @@ namespace machinelearning { namespace neighborhood {
     }
     
     
+    /** returns the k-nearest-index-points (row index) and their distances to every data point. The data
+     * points are processed in parallel, each point calculates the distances to all fix points with one call
+     * and only the k smallest distances are sorted
+     * @param p_fix for every row row in the second parameter will be calculated the distance to this rows
+     * @param p_data input data matrix
+     * @param p_distance N x kNN matrix, that is filled with the distances of the neighbors
+     * @return N x kNN matrix, with N rows (data points) and k index fix points (sorted by distance)
+     **/
+    template<typename T, typename D> inline ublas::matrix<std::size_t> knn<T, D>::get( const ublas::matrix<T>& p_fix, const ublas::matrix<T>& p_data, ublas::matrix<T>& p_distance ) const
+    {
+        if (m_knn > p_fix.size1())
+            throw exception::runtime(_("knn is greater than datapoints"), *this);
+        
+        ublas::matrix<std::size_t> l_index(p_data.size1(), m_knn);
+        p_distance.resize(p_data.size1(), m_knn, false);
+        
+        #pragma omp parallel shared(l_index, p_distance)
+        {
+            // thread-local buffer for the index positions
+            std::vector<std::size_t> l_rank(p_fix.size1());
+        
+            #pragma omp for
+            for(std::size_t i=0; i < p_data.size1(); ++i) {
+                ublas::vector<T> l_distance = m_distance.getDistance( p_fix, static_cast< ublas::vector<T> >(ublas::row(p_data, i)) );
+                
+                std::copy( boost::counting_iterator<std::size_t>(0), boost::counting_iterator<std::size_t>(p_fix.size1()), l_rank.begin() );
+                std::partial_sort( l_rank.begin(), l_rank.begin()+m_knn, l_rank.end(), lam::var(l_distance)[lam::_1] < lam::var(l_distance)[lam::_2] );
+                
+                for(std::size_t j=0; j < m_knn; ++j) {
+                    l_index(i,j)    = l_rank[j];
+                    p_distance(i,j) = l_distance(l_rank[j]);
+                }
+            }
+        }
+        
+        return l_index;
+    }
+    
+    
     /** calculates the distances between two vectors
      * @param p_first first vector
      * @param p_second second vector
      * @return distance
      * @deprecated removed if class will be redesigned
      **/
-    template<typename T> inline T knn<T>::calculateDistance( const ublas::vector<T>& p_first, const ublas::vector<T>& p_second ) const
+    template<typename T, typename D> inline T knn<T, D>::calculateDistance( const ublas::vector<T>& p_first, const ublas::vector<T>& p_second ) const
     {
         return m_distance.getDistance( p_first, p_second );
     }
@@ -188,7 +232,7 @@ namespace machinelearning { namespace neighborhood {
      * @return inverted value
      * @deprecated removed if class will be redesigned
      **/
-    template<typename T> inline T knn<T>::invert( const T& p_val ) const
+    template<typename T, typename D> inline T knn<T, D>::invert( const T& p_val ) const
     {
         return m_distance.getInvert( p_val );
     }
@@ -199,7 +243,7 @@ namespace machinelearning { namespace neighborhood {
      * @return symmetric matrix with distance values
      * @deprecated removed if class will be redesigned
     **/
-    template<typename T> inline ublas::symmetric_matrix<T, ublas::upper> knn<T>::calculate( const ublas::matrix<T>& p_data ) const
+    template<typename T, typename D> inline ublas::symmetric_matrix<T, ublas::upper> knn<T, D>::calculate( const ublas::matrix<T>& p_data ) const
     {
         ublas::symmetric_matrix<T, ublas::upper> l_distance(p_data.size1(), p_data.size1());
         
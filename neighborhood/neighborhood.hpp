@@ -61,6 +61,9 @@ namespace machinelearning {
                 /** function for calculating the neighborhoods between different datapoints **/
                 virtual ublas::matrix<std::size_t> get( const ublas::matrix<T>&, const ublas::matrix<T>& ) const = 0;
             
+                /** function for calculating the neighborhoods between different datapoints, the distances of the neighbors are returned within the matrix **/
+                virtual ublas::matrix<std::size_t> get( const ublas::matrix<T>&, const ublas::matrix<T>&, ublas::matrix<T>& ) const = 0;
+            
                 /** calculates the distance between two vectors **/
                 virtual T calculateDistance( const ublas::vector<T>&, const ublas::vector<T>& ) const = 0;
             
@@ -114,7 +114,8 @@ dll      = []
 for i in filter(lambda x: str(x).endswith(env["SHLIBSUFFIX"]), builddll) :
     dll.append( env.Install(os.path.join("#build", env["buildtype"], "jar", "build", "native"), i) )
 
-java   = env.Java(  os.path.join("#build", env["buildtype"], "jar", "build"), os.path.join("#build", env["buildtype"], "jar", "source", "java")  )
+# the generated Swig classes and the hand-written support classes (eg. DoubleMatrix) are compiled together
+java   = env.Java(  os.path.join("#build", env["buildtype"], "jar", "build"), [os.path.join("#build", env["buildtype"], "jar", "source", "java"), "source"]  )
 libcp  = env.LibraryCopy( os.path.join("#build", env["buildtype"], "jar", "build", "native"), [] )
 rellib = env.Command("rellib_dll", dll, libchange )
 Depends(rellib, libcp)
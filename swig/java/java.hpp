@@ -39,8 +39,9 @@ namespace machinelearning { namespace swig {
     /** class for generate fragment code, that is used to convert
      * numericial structurs of Java to C++ UBlas (both ways), it is called by
      * the SWIG fragment calls
+     * @note double data is passed as primitive arrays, flat arrays or direct
+     * buffers and copied block-wise, boxed Double arrays are read for compatibility
      * @todo catching exception and pipe them to Java (use Swig calls)
-     * @todo add copy process with OpenMP
      **/
     class java {
         
@@ -55,12 +56,16 @@ namespace machinelearning { namespace swig {
 
             
             
+            static ublas::matrix<double> getDoubleMatrix( JNIEnv*, const jobject& );
+            static ublas::vector<double> getDoubleVector( JNIEnv*, const jobject& );
+            static ublas::matrix<double> getDoubleMatrixFrom2DPrimitiveArray( JNIEnv*, const jobjectArray& );
+            static ublas::matrix<double> getDoubleMatrixFromDoubleMatrix( JNIEnv*, const jobject& );
             static ublas::matrix<double> getDoubleMatrixFrom2DArray( JNIEnv*, const jobjectArray& );
             static ublas::vector<double> getDoubleVectorFrom1DArray( JNIEnv*, const jobjectArray& );
             
             static jobjectArray getArray( JNIEnv*, const ublas::matrix<double>&, const rowtype& = row );
-            static jobjectArray getArray( JNIEnv*, const ublas::vector<double>& );
-            static jobjectArray getArray( JNIEnv*, const std::vector<double>& );
+            static jdoubleArray getArray( JNIEnv*, const ublas::vector<double>& );
+            static jdoubleArray getArray( JNIEnv*, const std::vector<double>& );
             static jobjectArray getArray( JNIEnv*, const ublas::indirect_array<>& );
             
             static jobject getArrayList( JNIEnv*, const std::vector< ublas::matrix<double> >&, const rowtype& = row );
@@ -79,6 +84,11 @@ namespace machinelearning { namespace swig {
             static jmethodID getMethodID(JNIEnv*, const jobject&, const char*, const char*);
             static jmethodID getMethodID(JNIEnv*, const char*, const char*, const char*);
             static void getCtor(JNIEnv*, const char*, const char*, jclass&, jmethodID&);
+            static bool isInstanceOf(JNIEnv*, const jobject&, const char*);
+            static void copyFromArray(JNIEnv*, const jdoubleArray&, const std::size_t&, const std::size_t&, double*);
+            static void copyFromBuffer(JNIEnv*, const jobject&, const std::size_t&, double*);
+            static bool isNativeOrder(JNIEnv*, const jobject&);
+            static jdoubleArray getPrimitiveArray(JNIEnv*, const double*, const std::size_t&, const std::size_t& = 1);
         
     };
     
@@ -159,10 +169,248 @@ namespace machinelearning { namespace swig {
     }
     
     
-    /** creates a ublas double matrix from a java 2D array
+    /** creates a ublas double matrix of a Java object, the object can be a primitive double[][] array,
+     * a boxed Double[][] array or a machinelearning.DoubleMatrix (flat row-major double[] array or
+     * java.nio.DoubleBuffer with shape). The primitive and flat data is copied row-wise / block-wise
+     * without any per-element JNI call
+     * @param p_env JNI environment
+     * @param p_data Java object
+     * @return ublas matrix (empty on null or on an unsupported type)
+     **/
+    inline ublas::matrix<double> java::getDoubleMatrix( JNIEnv* p_env, const jobject& p_data )
+    {
+        if (!p_data)
+            return ublas::matrix<double>(0,0);
+        
+        if (isInstanceOf(p_env, p_data, "[[D"))
+            return getDoubleMatrixFrom2DPrimitiveArray(p_env, (jobjectArray)p_data);
+        
+        if (isInstanceOf(p_env, p_data, "machinelearning/DoubleMatrix"))
+            return getDoubleMatrixFromDoubleMatrix(p_env, p_data);
+        
+        if (isInstanceOf(p_env, p_data, "[[Ljava/lang/Double;"))
+            return getDoubleMatrixFrom2DArray(p_env, (jobjectArray)p_data);
+        
+        SWIG_JavaThrowException(p_env, SWIG_JavaIllegalArgumentException, "matrix type is not supported, use double[][], Double[][] or machinelearning.DoubleMatrix");
+        return ublas::matrix<double>(0,0);
+    }
+    
+    
+    /** creates a ublas double vector of a Java object, the object can be a primitive double[] array, a
+     * boxed Double[] array or a java.nio.DoubleBuffer (the remaining elements are read)
+     * @param p_env JNI environment
+     * @param p_data Java object
+     * @return ublas vector (empty on null or on an unsupported type)
+     **/
+    inline ublas::vector<double> java::getDoubleVector( JNIEnv* p_env, const jobject& p_data )
+    {
+        if (!p_data)
+            return ublas::vector<double>(0);
+        
+        if (isInstanceOf(p_env, p_data, "[D")) {
+            ublas::vector<double> l_data( static_cast<std::size_t>(p_env->GetArrayLength((jdoubleArray)p_data)) );
+            copyFromArray(p_env, (jdoubleArray)p_data, 0, l_data.size(), l_data.data().begin());
+            return l_data;
+        }
+        
+        if (isInstanceOf(p_env, p_data, "java/nio/DoubleBuffer")) {
+            ublas::vector<double> l_data( static_cast<std::size_t>(p_env->CallIntMethod(p_data, getMethodID(p_env, p_data, "remaining", "()I"))) );
+            copyFromBuffer(p_env, p_data, l_data.size(), l_data.data().begin());
+            return l_data;
+        }
+        
+        if (isInstanceOf(p_env, p_data, "[Ljava/lang/Double;"))
+            return getDoubleVectorFrom1DArray(p_env, (jobjectArray)p_data);
+        
+        SWIG_JavaThrowException(p_env, SWIG_JavaIllegalArgumentException, "vector type is not supported, use double[], Double[] or java.nio.DoubleBuffer");
+        return ublas::vector<double>(0);
+    }
+    
+    
+    /** checks if an object is an instance of a class
+     * @param p_env JNI environment
+     * @param p_object object
+     * @param p_class JNI class name
+     * @return boolean
+     **/
+    inline bool java::isInstanceOf( JNIEnv* p_env, const jobject& p_object, const char* p_class )
+    {
+        jclass l_class = p_env->FindClass(p_class);
+        if (!l_class) {
+            // an unknown class is not an error, so the pending ClassNotFound exception is removed
+            p_env->ExceptionClear();
+            return false;
+        }
+        
+        const bool l_instance = p_env->IsInstanceOf(p_object, l_class);
+        p_env->DeleteLocalRef(l_class);
+        return l_instance;
+    }
+    
+    
+    /** copies elements of a primitive double array into memory. The array is pinned with the critical
+     * call, so the JVM need not copy the array, no other JNI call is run within the critical section
+     * @param p_env JNI environment
+     * @param p_array primitive array
+     * @param p_offset start index within the array
+     * @param p_size number of elements
+     * @param p_target target memory
+     **/
+    inline void java::copyFromArray( JNIEnv* p_env, const jdoubleArray& p_array, const std::size_t& p_offset, const std::size_t& p_size, double* p_target )
+    {
+        if (p_size == 0)
+            return;
+        
+        if (p_offset + p_size > static_cast<std::size_t>(p_env->GetArrayLength(p_array))) {
+            SWIG_JavaThrowException(p_env, SWIG_JavaIndexOutOfBoundsException, "array is smaller than the requested data");
+            return;
+        }
+        
+        const double* l_source = static_cast<const double*>( p_env->GetPrimitiveArrayCritical(p_array, NULL) );
+        if (!l_source) {
+            SWIG_JavaThrowException(p_env, SWIG_JavaOutOfMemoryError, "can not access the array data");
+            return;
+        }
+        
+        std::copy( l_source + p_offset, l_source + p_offset + p_size, p_target );
+        p_env->ReleasePrimitiveArrayCritical(p_array, const_cast<double*>(l_source), JNI_ABORT);
+    }
+    
+    
+    /** copies the elements of a DoubleBuffer (from the current position) into memory. A direct buffer
+     * is read with the buffer address (the bytes of each element are swapped, if the buffer order is not
+     * the native order), a heap buffer with the backing array
+     * @param p_env JNI environment
+     * @param p_buffer DoubleBuffer object
+     * @param p_size number of elements
+     * @param p_target target memory
+     **/
+    inline void java::copyFromBuffer( JNIEnv* p_env, const jobject& p_buffer, const std::size_t& p_size, double* p_target )
+    {
+        const std::size_t l_position  = static_cast<std::size_t>( p_env->CallIntMethod(p_buffer, getMethodID(p_env, p_buffer, "position", "()I")) );
+        const std::size_t l_remaining = static_cast<std::size_t>( p_env->CallIntMethod(p_buffer, getMethodID(p_env, p_buffer, "remaining", "()I")) );
+        if (p_size > l_remaining) {
+            SWIG_JavaThrowException(p_env, SWIG_JavaIndexOutOfBoundsException, "buffer is smaller than the requested data");
+            return;
+        }
+        
+        // direct buffer (the address is the start of the buffer, so the position is added)
+        const double* l_address = static_cast<const double*>( p_env->GetDirectBufferAddress(p_buffer) );
+        if (l_address) {
+            std::copy( l_address + l_position, l_address + l_position + p_size, p_target );
+            
+            if (!isNativeOrder(p_env, p_buffer))
+                for(std::size_t i=0; i < p_size; ++i) {
+                    unsigned char* const l_bytes = reinterpret_cast<unsigned char*>(p_target + i);
+                    std::reverse( l_bytes, l_bytes + sizeof(double) );
+                }
+            return;
+        }
+        
+        // heap buffer with backing array
+        if (p_env->CallBooleanMethod(p_buffer, getMethodID(p_env, p_buffer, "hasArray", "()Z"))) {
+            const jdoubleArray l_array  = (jdoubleArray)p_env->CallObjectMethod(p_buffer, getMethodID(p_env, p_buffer, "array", "()[D"));
+            const std::size_t l_offset  = static_cast<std::size_t>( p_env->CallIntMethod(p_buffer, getMethodID(p_env, p_buffer, "arrayOffset", "()I")) );
+            copyFromArray(p_env, l_array, l_offset + l_position, p_size, p_target);
+            p_env->DeleteLocalRef(l_array);
+            return;
+        }
+        
+        SWIG_JavaThrowException(p_env, SWIG_JavaIllegalArgumentException, "buffer must be a direct buffer or must have a backing array");
+    }
+    
+    
+    /** checks if the byte order of a buffer is the native byte order (a direct buffer, that is created
+     * with ByteBuffer.allocateDirect(n).asDoubleBuffer(), is big-endian by default)
+     * @param p_env JNI environment
+     * @param p_buffer buffer object
+     * @return boolean
+     **/
+    inline bool java::isNativeOrder( JNIEnv* p_env, const jobject& p_buffer )
+    {
+        jclass l_class = p_env->FindClass("java/nio/ByteOrder");
+        if (!l_class) {
+            SWIG_JavaThrowException(p_env, SWIG_JavaRuntimeException, "can not find associated java class");
+            return true;
+        }
+        
+        const jobject l_native = p_env->CallStaticObjectMethod(l_class, p_env->GetStaticMethodID(l_class, "nativeOrder", "()Ljava/nio/ByteOrder;"));
+        const jobject l_order  = p_env->CallObjectMethod(p_buffer, getMethodID(p_env, p_buffer, "order", "()Ljava/nio/ByteOrder;"));
+        
+        // the byte orders are the constant objects BIG_ENDIAN and LITTLE_ENDIAN
+        const bool l_same = p_env->IsSameObject(l_native, l_order);
+        
+        p_env->DeleteLocalRef(l_order);
+        p_env->DeleteLocalRef(l_native);
+        p_env->DeleteLocalRef(l_class);
+        return l_same;
+    }
+    
+    
+    /** creates a ublas double matrix from a primitive java 2D array, each row is copied with one call
+     * @param p_env JNI environment
+     * @param p_data java array
+     * @return ublas matrix if matrix have zero columns and/or rows the array can not be read
+     **/
+    inline ublas::matrix<double> java::getDoubleMatrixFrom2DPrimitiveArray( JNIEnv* p_env, const jobjectArray& p_data )
+    {
+        const std::size_t l_rows = p_env->GetArrayLength(p_data);
+        if (l_rows == 0)
+            return ublas::matrix<double>(0,0);
+        
+        jdoubleArray l_first     = (jdoubleArray)p_env->GetObjectArrayElement(p_data, 0);
+        const std::size_t l_cols = l_first ? p_env->GetArrayLength(l_first) : 0;
+        p_env->DeleteLocalRef(l_first);
+        if (l_cols == 0)
+            return ublas::matrix<double>(0,0);
+        
+        // the ublas matrix is row-major, so each row is read directly into the matrix memory
+        ublas::matrix<double> l_data(l_rows, l_cols, 0);
+        for(std::size_t i=0; i < l_rows; ++i) {
+            jdoubleArray l_row = (jdoubleArray)p_env->GetObjectArrayElement(p_data, i);
+            if (!l_row)
+                continue;
+            
+            p_env->GetDoubleArrayRegion( l_row, 0, static_cast<jsize>(std::min(l_cols, static_cast<std::size_t>(p_env->GetArrayLength(l_row)))), l_data.data().begin() + i*l_cols );
+            p_env->DeleteLocalRef(l_row);
+        }
+        
+        return l_data;
+    }
+    
+    
+    /** creates a ublas double matrix from a machinelearning.DoubleMatrix object
+     * @param p_env JNI environment
+     * @param p_data DoubleMatrix object
+     * @return ublas matrix
+     **/
+    inline ublas::matrix<double> java::getDoubleMatrixFromDoubleMatrix( JNIEnv* p_env, const jobject& p_data )
+    {
+        jclass l_class = p_env->GetObjectClass(p_data);
+        
+        const std::size_t l_rows    = static_cast<std::size_t>( p_env->GetIntField(p_data, p_env->GetFieldID(l_class, "m_rows", "I")) );
+        const std::size_t l_columns = static_cast<std::size_t>( p_env->GetIntField(p_data, p_env->GetFieldID(l_class, "m_columns", "I")) );
+        jobject l_array             = p_env->GetObjectField(p_data, p_env->GetFieldID(l_class, "m_array", "[D"));
+        jobject l_buffer            = p_env->GetObjectField(p_data, p_env->GetFieldID(l_class, "m_buffer", "Ljava/nio/DoubleBuffer;"));
+        p_env->DeleteLocalRef(l_class);
+        
+        ublas::matrix<double> l_data(l_rows, l_columns);
+        if (l_array)
+            copyFromArray(p_env, (jdoubleArray)l_array, 0, l_data.data().size(), l_data.data().begin());
+        else if (l_buffer)
+            copyFromBuffer(p_env, l_buffer, l_data.data().size(), l_data.data().begin());
+        
+        p_env->DeleteLocalRef(l_array);
+        p_env->DeleteLocalRef(l_buffer);
+        return l_data;
+    }
+    
+    
+    /** creates a ublas double matrix from a java 2D array of boxed Double objects
      * @param p_env JNI environment
      * @param p_data java array
      * @return ublas matrix if matrix have zero columns and/or rows the array can not be read
+     * @deprecated each element is read with a JNI method call, use primitive arrays
      **/
     inline ublas::matrix<double> java::getDoubleMatrixFrom2DArray( JNIEnv* p_env, const jobjectArray& p_data )
     {
@@ -196,10 +444,11 @@ namespace machinelearning { namespace swig {
     }
 
     
-    /** creates a ublas double vector from a java 1D array
+    /** creates a ublas double vector from a java 1D array of boxed Double objects
      * @param p_env JNI environment
      * @param p_data java array
      * @return ublas vector if vector have zero columns the array can not be read
+     * @deprecated each element is read with a JNI method call, use primitive arrays
      **/
     inline ublas::vector<double> java::getDoubleVectorFrom1DArray( JNIEnv* p_env, const jobjectArray& p_data )
     {
@@ -225,7 +474,37 @@ namespace machinelearning { namespace swig {
     }
     
     
-    /** sets the data into an array (vector) of mutable double objects
+    /** creates a primitive Java double array of strided memory, the array data is written within a
+     * critical section, numerical zero values are set to zero
+     * @param p_env JNI environment
+     * @param p_data pointer to the first element
+     * @param p_size number of elements
+     * @param p_stride distance between two elements
+     * @return primitive array
+     **/
+    inline jdoubleArray java::getPrimitiveArray( JNIEnv* p_env, const double* p_data, const std::size_t& p_size, const std::size_t& p_stride )
+    {
+        jdoubleArray l_array = p_env->NewDoubleArray( static_cast<jsize>(p_size) );
+        if ( (!l_array) || (p_size == 0) )
+            return l_array;
+        
+        double* l_target = static_cast<double*>( p_env->GetPrimitiveArrayCritical(l_array, NULL) );
+        if (!l_target) {
+            SWIG_JavaThrowException(p_env, SWIG_JavaOutOfMemoryError, "can not access the array data");
+            return l_array;
+        }
+        
+        for(std::size_t i=0; i < p_size; ++i) {
+            const double l_value = p_data[i*p_stride];
+            l_target[i] = tools::function::isNumericalZero(l_value) ? static_cast<double>(0) : l_value;
+        }
+        
+        p_env->ReleasePrimitiveArrayCritical(l_array, l_target, 0);
+        return l_array;
+    }
+    
+    
+    /** adds the vector as primitive double[] to an ArrayList
      * @param p_env JNI environment
      * @param p_array input array
      * @param p_data vector data
@@ -240,20 +519,13 @@ namespace machinelearning { namespace swig {
             return;
         }
         
-        // get add method
-        jmethodID l_add = getMethodID(p_env, p_array, "add", "(Ljava/lang/Object;)Z"); 
-        
-        // get Double object
-        jclass l_doubleelementclass   = NULL;
-        jmethodID l_doubleelementctor = NULL;
-        getCtor(p_env, "java/lang/Double", "(D)V", l_doubleelementclass, l_doubleelementctor);
-        
-        for(std::size_t i=0; i < p_data.size(); ++i)
-            p_env->CallObjectMethod(  p_array, l_add, p_env->NewObject(l_doubleelementclass, l_doubleelementctor, tools::function::isNumericalZero(p_data(i)) ? static_cast<double>(0) : p_data(i) )  );
+        jdoubleArray l_vec = getPrimitiveArray(p_env, p_data.data().begin(), p_data.size());
+        p_env->CallBooleanMethod( p_array, getMethodID(p_env, p_array, "add", "(Ljava/lang/Object;)Z"), (jobject)l_vec );
+        p_env->DeleteLocalRef(l_vec);
     }
     
     
-    /** sets the data into an array (matrix) of mutable double objects
+    /** adds each row (or column) of the matrix as primitive double[] to an ArrayList
      * @param p_env JNI environment
      * @param p_array input array
      * @param p_data matrix data
@@ -269,43 +541,24 @@ namespace machinelearning { namespace swig {
             return;
         }
         
-        // get add method
-        jmethodID l_add = getMethodID(p_env, p_array, "add", "(Ljava/lang/Object;)Z"); 
+        const jmethodID l_add = getMethodID(p_env, p_array, "add", "(Ljava/lang/Object;)Z");
         
-        // get Double object
-        jclass l_doubleelementclass   = NULL;
-        jmethodID l_doubleelementctor = NULL;
-        getCtor(p_env, "java/lang/Double", "(D)V", l_doubleelementclass, l_doubleelementctor);
+        // the ublas matrix is row-major, so a column is read with the stride of the row length
+        const std::size_t l_count  = (p_rowtype == row) ? p_data.size1() : p_data.size2();
+        const std::size_t l_size   = (p_rowtype == row) ? p_data.size2() : p_data.size1();
+        const std::size_t l_step   = (p_rowtype == row) ? p_data.size2() : 1;
+        const std::size_t l_stride = (p_rowtype == row) ? 1 : p_data.size2();
         
-        switch (p_rowtype) {
-            
-            case row: {
-                for(std::size_t i=0; i < p_data.size1(); ++i)
-                {
-                    jobjectArray l_row = p_env->NewObjectArray( static_cast<jint>(p_data.size2()), l_doubleelementclass, NULL );
-                    for(std::size_t j=0; j < p_data.size2(); ++j)
-                        p_env->SetObjectArrayElement(l_row, j, p_env->NewObject(l_doubleelementclass, l_doubleelementctor, tools::function::isNumericalZero(p_data(i,j)) ? static_cast<double>(0) : p_data(i,j) ) );
-                    p_env->CallObjectMethod( p_array, l_add, (jobject)l_row );
-                }
-                break;
-            }
-                
-            case column: {
-                for(std::size_t i=0; i < p_data.size2(); ++i)
-                {
-                    jobjectArray l_row = p_env->NewObjectArray( static_cast<jint>(p_data.size1()), l_doubleelementclass, NULL );
-                    for(std::size_t j=0; j < p_data.size1(); ++j)
-                        p_env->SetObjectArrayElement(l_row, j, p_env->NewObject(l_doubleelementclass, l_doubleelementctor, tools::function::isNumericalZero(p_data(i,j)) ? static_cast<double>(0) : p_data(i,j) ) );
-                    p_env->CallObjectMethod( p_array, l_add, (jobject)l_row );
-                }
-                break;
-            }
-                
+        for(std::size_t i=0; i < l_count; ++i)
+        {
+            jdoubleArray l_vec = getPrimitiveArray(p_env, p_data.data().begin() + i*l_step, l_size, l_stride);
+            p_env->CallBooleanMethod( p_array, l_add, (jobject)l_vec );
+            p_env->DeleteLocalRef(l_vec);
         }
     }
-   
     
-    /** creates a 2D java array of an ublas double matrix
+    
+    /** creates a primitive 2D java array (double[][]) of an ublas double matrix
      * @param p_env JNI environment
      * @param p_data input data matrix
      * @param p_rowtype row type
@@ -316,91 +569,52 @@ namespace machinelearning { namespace swig {
         if ( (p_data.size1() == 0) || (p_data.size2() == 0) )
             return (jobjectArray)p_env->NewGlobalRef(NULL);
         
-        jclass l_elementclass   = NULL;
-        jmethodID l_elementctor = NULL;
-        getCtor(p_env, "java/lang/Double", "(D)V", l_elementclass, l_elementctor);
-        
-        switch (p_rowtype) {
-                
-            case row: {
-                // create the row array
-                jobjectArray l_row = p_env->NewObjectArray( static_cast<jint>(p_data.size1()), p_env->FindClass("[Ljava/lang/Double;"), NULL );
-                for(std::size_t i=0; i < p_data.size1(); ++i) {
-                    
-                    // create column array and fill data into the double java object
-                    jobjectArray l_col = p_env->NewObjectArray( static_cast<jint>(p_data.size2()), l_elementclass, NULL );
-                    for(std::size_t j=0; j < p_data.size2(); ++j)
-                        p_env->SetObjectArrayElement(l_col, j, p_env->NewObject(l_elementclass, l_elementctor, tools::function::isNumericalZero(p_data(i,j)) ? static_cast<double>(0) : p_data(i,j) ) );
-                    
-                    p_env->SetObjectArrayElement(l_row, i, l_col);
-                }
-                
-                return l_row;
-            }
-                
-                
-            case column: {
-                // create the row array
-                jobjectArray l_row = p_env->NewObjectArray( static_cast<jint>(p_data.size2()), p_env->FindClass("[Ljava/lang/Double;"), NULL );
-                for(std::size_t i=0; i < p_data.size2(); ++i) {
-                    
-                    // create column array and fill data into the double java object
-                    jobjectArray l_col = p_env->NewObjectArray( static_cast<jint>(p_data.size1()), l_elementclass, NULL );
-                    for(std::size_t j=0; j < p_data.size1(); ++j)
-                        p_env->SetObjectArrayElement(l_col, j, p_env->NewObject(l_elementclass, l_elementctor,tools::function::isNumericalZero(p_data(i,j)) ? static_cast<double>(0) : p_data(i,j)) );
-                    
-                    p_env->SetObjectArrayElement(l_row, i, l_col);
-                }
-                
-                return l_row;
-            }
+        const std::size_t l_count  = (p_rowtype == row) ? p_data.size1() : p_data.size2();
+        const std::size_t l_size   = (p_rowtype == row) ? p_data.size2() : p_data.size1();
+        const std::size_t l_step   = (p_rowtype == row) ? p_data.size2() : 1;
+        const std::size_t l_stride = (p_rowtype == row) ? 1 : p_data.size2();
+        
+        jclass l_rowclass    = p_env->FindClass("[D");
+        jobjectArray l_array = p_env->NewObjectArray( static_cast<jsize>(l_count), l_rowclass, NULL );
+        p_env->DeleteLocalRef(l_rowclass);
+        if (!l_array)
+            return l_array;
+        
+        for(std::size_t i=0; i < l_count; ++i) {
+            jdoubleArray l_vec = getPrimitiveArray(p_env, p_data.data().begin() + i*l_step, l_size, l_stride);
+            p_env->SetObjectArrayElement(l_array, static_cast<jsize>(i), l_vec);
+            p_env->DeleteLocalRef(l_vec);
         }
         
-        return (jobjectArray)p_env->NewGlobalRef(NULL);
+        return l_array;
     }
     
     
-    /** converts a ublas::vector to a java array
+    /** converts a ublas::vector to a primitive java array
      * @param p_env JNI environment
      * @param p_data vector
      * @return java array
      **/
-    inline jobjectArray java::getArray( JNIEnv* p_env, const ublas::vector<double>& p_data )
+    inline jdoubleArray java::getArray( JNIEnv* p_env, const ublas::vector<double>& p_data )
     {
         if (p_data.size() == 0)
-            return (jobjectArray)p_env->NewGlobalRef(NULL);
-        
-        jclass l_elementclass   = NULL;
-        jmethodID l_elementctor = NULL;
-        getCtor(p_env, "java/lang/Double", "(D)V", l_elementclass, l_elementctor);
+            return (jdoubleArray)p_env->NewGlobalRef(NULL);
         
-        jobjectArray l_vec = p_env->NewObjectArray( static_cast<jint>(p_data.size()), l_elementclass, NULL );
-        for(std::size_t i=0; i < p_data.size(); ++i)
-            p_env->SetObjectArrayElement(l_vec, i, p_env->NewObject(l_elementclass, l_elementctor, tools::function::isNumericalZero(p_data(i)) ? static_cast<double>(0) : p_data(i)) );
-        
-        return l_vec;
+        return getPrimitiveArray(p_env, p_data.data().begin(), p_data.size());
     }
     
     
-    /** converts a std::vector to a java array
+    /** converts a std::vector to a primitive java array
      * @param p_env JNI environment
      * @param p_data vector
      * @return java array
      **/
-    inline jobjectArray java::getArray( JNIEnv* p_env, const std::vector<double>& p_data )
+    inline jdoubleArray java::getArray( JNIEnv* p_env, const std::vector<double>& p_data )
     {
         if (p_data.size() == 0)
-            return (jobjectArray)p_env->NewGlobalRef(NULL);
-        
-        jclass l_elementclass   = NULL;
-        jmethodID l_elementctor = NULL;
-        getCtor(p_env, "java/lang/Double", "(D)V", l_elementclass, l_elementctor);
+            return (jdoubleArray)p_env->NewGlobalRef(NULL);
         
-        jobjectArray l_vec = p_env->NewObjectArray( static_cast<jint>(p_data.size()), l_elementclass, NULL );
-        for(std::size_t i=0; i < p_data.size(); ++i)
-            p_env->SetObjectArrayElement(l_vec, i, p_env->NewObject(l_elementclass, l_elementctor, tools::function::isNumericalZero(p_data[i]) ? static_cast<double>(0) : p_data[i]) );
-        
-        return l_vec;
+        return getPrimitiveArray(p_env, &p_data[0], p_data.size());
     }
     
     
@@ -426,7 +640,8 @@ namespace machinelearning { namespace swig {
     }
     
     
-    /** convert a std::vector of ublas::vector to a ArrayList of Double[]
+    
+    /** convert a std::vector of ublas::vector to a ArrayList of double[]
      * @param p_env JNI environment
      * @param p_data vector with ublas vector
      * @return array list object
@@ -444,29 +659,20 @@ namespace machinelearning { namespace swig {
         jobject l_list = p_env->NewObject( l_elementclass, l_elementctor, static_cast<jint>(p_data.size()) );
         
         // get add method of the ArrayList        
-        jmethodID l_add = getMethodID(p_env, l_list, "add", "(Ljava/lang/Object;)Z"); 
-        
-        
-        // get Double object
-        jclass l_doubleelementclass   = NULL;
-        jmethodID l_doubleelementctor = NULL;
-        getCtor(p_env, "java/lang/Double", "(D)V", l_doubleelementclass, l_doubleelementctor);
+        const jmethodID l_add = getMethodID(p_env, l_list, "add", "(Ljava/lang/Object;)Z"); 
         
         for(std::size_t i=0; i < p_data.size(); ++i)
         {
-            jobjectArray l_vec = p_env->NewObjectArray( static_cast<jint>(p_data[i].size()), l_doubleelementclass, NULL );
-            
-            for(std::size_t n=0; n < p_data[i].size(); ++n)
-                p_env->SetObjectArrayElement(l_vec, n, p_env->NewObject(l_doubleelementclass, l_doubleelementctor, tools::function::isNumericalZero(p_data[i](n)) ? static_cast<double>(0) : p_data[n](n) ) );
-            
-            p_env->CallObjectMethod( l_list, l_add, (jobject)l_vec );
+            jdoubleArray l_vec = getPrimitiveArray(p_env, p_data[i].data().begin(), p_data[i].size());
+            p_env->CallBooleanMethod( l_list, l_add, (jobject)l_vec );
+            p_env->DeleteLocalRef(l_vec);
         }
         
         return l_list;
     }
     
     
-    /** convert a std::vector of ublas::matrix to a ArrayList of Double[][]
+    /** convert a std::vector of ublas::matrix to a ArrayList of double[][]
      * @param p_env JNI environment
      * @param p_data vector with matrix
      * @param p_rowtype row type of the matrix
@@ -485,75 +691,16 @@ namespace machinelearning { namespace swig {
         jobject l_list = p_env->NewObject( l_elementclass, l_elementctor, static_cast<jint>(p_data.size()) );
         
         // get add method of the ArrayList        
-        jmethodID l_add = getMethodID(p_env, l_list, "add", "(Ljava/lang/Object;)Z"); 
-        
-        
-        // get Double object
-        jclass l_doubleelementclass   = NULL;
-        jmethodID l_doubleelementctor = NULL;
-        getCtor(p_env, "java/lang/Double", "(D)V", l_doubleelementclass, l_doubleelementctor);
-        
-        
-        switch (p_rowtype) {
-                
-            case row: {
-                
-                for(std::size_t n=0; n < p_data.size(); ++n) {
-                    
-                    if ( (p_data[n].size1() == 0) || (p_data[n].size2() == 0) ) {
-                        p_env->CallObjectMethod( l_list, l_add, p_env->NewGlobalRef(NULL) );
-                        continue;
-                    }
-                    
-                    // create the row array
-                    jobjectArray l_row = p_env->NewObjectArray( static_cast<jint>(p_data[n].size1()), p_env->FindClass("[Ljava/lang/Double;"), NULL );
-                    for(std::size_t i=0; i < p_data[n].size1(); ++i) {
-                        
-                        // create column array and fill data into the double java object
-                        jobjectArray l_col = p_env->NewObjectArray( static_cast<jint>(p_data[n].size2()), l_doubleelementclass, NULL );
-                        for(std::size_t j=0; j < p_data[n].size2(); ++j)
-                            p_env->SetObjectArrayElement(l_col, j, p_env->NewObject(l_doubleelementclass, l_doubleelementctor, tools::function::isNumericalZero(p_data[n](i,j)) ? static_cast<double>(0) : p_data[n](i,j) ) );
-                        p_env->SetObjectArrayElement(l_row, i, l_col);
-                    }
-                    
-                    p_env->CallObjectMethod( l_list, l_add, (jobject)l_row );
-                }
-                
-                break;
-            }
-                
-                
-                
-            case column: {
-                
-                for(std::size_t n=0; n < p_data.size(); ++n) {
-                    
-                    if ( (p_data[n].size1() == 0) || (p_data[n].size2() == 0) ) {
-                        p_env->CallObjectMethod( l_list, l_add, p_env->NewGlobalRef(NULL) );
-                        continue;
-                    }
-                    
-                    // create the row array
-                    jobjectArray l_row = p_env->NewObjectArray( static_cast<jint>(p_data[n].size2()), p_env->FindClass("[Ljava/lang/Double;"), NULL );
-                    for(std::size_t i=0; i < p_data[n].size2(); ++i) {
-                        
-                        // create column array and fill data into the double java object
-                        jobjectArray l_col = p_env->NewObjectArray( static_cast<jint>(p_data[n].size1()), l_doubleelementclass, NULL );
-                        for(std::size_t j=0; j < p_data[n].size1(); ++j)
-                            p_env->SetObjectArrayElement(l_col, j, p_env->NewObject(l_doubleelementclass, l_doubleelementctor,tools::function::isNumericalZero(p_data[n](i,j)) ? static_cast<double>(0) : p_data[n](i,j)) );
-                        
-                        p_env->SetObjectArrayElement(l_row, i, l_col);
-                    }
-                    
-                    p_env->CallObjectMethod( l_list, l_add, (jobject)l_row );
-                }
-                
-                break;
-            }
-                
+        const jmethodID l_add = getMethodID(p_env, l_list, "add", "(Ljava/lang/Object;)Z"); 
+        
+        // empty matrices are added as null, so the list index matches the vector index
+        for(std::size_t n=0; n < p_data.size(); ++n) {
+            jobjectArray l_matrix = getArray(p_env, p_data[n], p_rowtype);
+            p_env->CallBooleanMethod( l_list, l_add, (jobject)l_matrix );
+            if (l_matrix)
+                p_env->DeleteLocalRef(l_matrix);
         }
         
-        
         return l_list;
     }
         
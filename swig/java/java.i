@@ -39,6 +39,16 @@
 %enddef
 
 
+%define INPUTTYPES( JNITYPE, JVTYPE, CPPTYPE )
+
+%typemap(jni)       const CPPTYPE&      "JNITYPE"
+%typemap(jtype)     const CPPTYPE&      "JVTYPE"
+%typemap(jstype)    const CPPTYPE&      "JVTYPE"
+%typemap(javain)    const CPPTYPE&      "$javainput"
+
+%enddef
+
+
 %define NONCONSTTYPES( JNITYPE, JVTYPE, CPPTYPE )
 
 %typemap(jni)       CPPTYPE&       "JNITYPE"
@@ -53,12 +63,12 @@
 
 #define %arg(X...) X
 
-CONSTTYPES( jobjectArray,        Double[],                              ublas::vector<double> )
-CONSTTYPES( jobjectArray,        Double[],                              std::vector<double> )
-CONSTTYPES( jobjectArray,        Double[][],                            ublas::matrix<double> )
-CONSTTYPES( jobjectArray,        Double[][],                            %arg(ublas::symmetric_matrix<double, ublas::upper>) )
-CONSTTYPES( jobject,             java.util.ArrayList<Double[][]>,       std::vector< ublas::matrix<double> > )
-CONSTTYPES( jobject,             java.util.ArrayList<Double[]>,         std::vector< ublas::vector<double> > )
+CONSTTYPES( jdoubleArray,        double[],                              ublas::vector<double> )
+CONSTTYPES( jdoubleArray,        double[],                              std::vector<double> )
+CONSTTYPES( jobjectArray,        double[][],                            ublas::matrix<double> )
+CONSTTYPES( jobjectArray,        double[][],                            %arg(ublas::symmetric_matrix<double, ublas::upper>) )
+CONSTTYPES( jobject,             java.util.ArrayList<double[][]>,       std::vector< ublas::matrix<double> > )
+CONSTTYPES( jobject,             java.util.ArrayList<double[]>,         std::vector< ublas::vector<double> > )
 CONSTTYPES( jobjectArray,        String[],                              std::vector<std::string> )
 CONSTTYPES( jobjectArray,        long[],                                std::vector<std::size_t> )
 CONSTTYPES( jobjectArray,        Long[],                                ublas::indirect_array<> )
@@ -67,8 +77,13 @@ CONSTTYPES( jstring,             String,                                std::str
 CONSTTYPES( jobject,             machinelearning.distances.Distance,    distances::distance<double> )
 CONSTTYPES( jobject,             machinelearning.tools.Matrix.rowtype,  tools::matrix::rowtype )
 
-NONCONSTTYPES( jobject,          java.util.ArrayList<Double>,           ublas::vector<double> )
-NONCONSTTYPES( jobject,          java.util.ArrayList<Double[]>,         ublas::matrix<double> )
+// numerical input parameters are passed as Object, so the native code reads double[][] / double[], flat
+// machinelearning.DoubleMatrix data, java.nio.DoubleBuffer and the boxed Double[][] / Double[] arrays
+INPUTTYPES( jobject,             Object,                                ublas::vector<double> )
+INPUTTYPES( jobject,             Object,                                ublas::matrix<double> )
+
+NONCONSTTYPES( jobject,          java.util.ArrayList<double[]>,         ublas::vector<double> )
+NONCONSTTYPES( jobject,          java.util.ArrayList<double[]>,         ublas::matrix<double> )
 
 // add the global rule, so no swigtype is created and JNI return types are passed to the Java method return
 %typemap(javaout) SWIGTYPE { return $jnicall; }
@@ -80,7 +95,7 @@ NONCONSTTYPES( jobject,          java.util.ArrayList<Double[]>,         ublas::m
 
 %typemap(out, noblock=1) ublas::matrix<double>,                const ublas::matrix<double>&,
                          ublas::vector<double>,                const ublas::vector<double>&,
-                         ublas::indirect_array<>,              const ublas::indirect_array<>&
+                         ublas::indirect_array<>,              const ublas::indirect_array<>&,
                          std::vector<double>,                  const std::vector<double>&
 {
     $result = swig::java::getArray(jenv, $1);
@@ -133,13 +148,17 @@ NONCONSTTYPES( jobject,          java.util.ArrayList<Double[]>,         ublas::m
 
 %typemap(in, noblock=1) ublas::matrix<double>, const ublas::matrix<double>& (ublas::matrix<double> l_param)
 {
-    l_param = swig::java::getDoubleMatrixFrom2DArray(jenv, $input);
+    l_param = swig::java::getDoubleMatrix(jenv, $input);
+    if (jenv->ExceptionCheck())
+        return $null;
     $1 = &l_param;
 }
 
 %typemap(in, noblock=1) ublas::vector<double>, const ublas::vector<double>& (ublas::vector<double> l_param)
 {
-    l_param = swig::java::getDoubleVectorFrom1DArray(jenv, $input);
+    l_param = swig::java::getDoubleVector(jenv, $input);
+    if (jenv->ExceptionCheck())
+        return $null;
     $1 = &l_param;
 }
 
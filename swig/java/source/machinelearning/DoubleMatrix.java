@@ -0,0 +1,112 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+package machinelearning;
+
+
+/** row-major double matrix with flat storage, that can be passed to each native
+ * method with a matrix parameter. The data is a primitive double array or a
+ * java.nio.DoubleBuffer (a direct buffer is read by the native code without any
+ * copy into the Java heap), so the native code can copy the whole block at once
+ **/
+public class DoubleMatrix {
+    
+    /** flat array data (or null) **/
+    private final double[] m_array;
+    /** buffer data (or null) **/
+    private final java.nio.DoubleBuffer m_buffer;
+    /** number of rows **/
+    private final int m_rows;
+    /** number of columns **/
+    private final int m_columns;
+    
+    
+    /** creates the matrix of a flat array
+     * @param p_data row-major array with p_rows * p_columns elements
+     * @param p_rows number of rows
+     * @param p_columns number of columns
+     **/
+    public DoubleMatrix( double[] p_data, int p_rows, int p_columns )
+    {
+        if (p_data == null)
+            throw new NullPointerException("data must not be null");
+        if ( (p_rows < 0) || (p_columns < 0) || (p_data.length < (long)p_rows * p_columns) )
+            throw new IllegalArgumentException("array is smaller than the matrix shape");
+        
+        m_array   = p_data;
+        m_buffer  = null;
+        m_rows    = p_rows;
+        m_columns = p_columns;
+    }
+    
+    
+    /** creates the matrix of a buffer, the data is read from the current
+     * position of the buffer
+     * @param p_data row-major buffer with at least p_rows * p_columns remaining elements
+     * @param p_rows number of rows
+     * @param p_columns number of columns
+     **/
+    public DoubleMatrix( java.nio.DoubleBuffer p_data, int p_rows, int p_columns )
+    {
+        if (p_data == null)
+            throw new NullPointerException("data must not be null");
+        if ( (p_rows < 0) || (p_columns < 0) || (p_data.remaining() < (long)p_rows * p_columns) )
+            throw new IllegalArgumentException("buffer is smaller than the matrix shape");
+        
+        m_array   = null;
+        m_buffer  = p_data;
+        m_rows    = p_rows;
+        m_columns = p_columns;
+    }
+    
+    
+    /** creates a direct buffer with native byte order, that can be used for
+     * the matrix data
+     * @param p_rows number of rows
+     * @param p_columns number of columns
+     * @return direct buffer
+     **/
+    public static java.nio.DoubleBuffer allocateDirect( int p_rows, int p_columns )
+    {
+        return java.nio.ByteBuffer.allocateDirect( p_rows * p_columns * 8 ).order( java.nio.ByteOrder.nativeOrder() ).asDoubleBuffer();
+    }
+    
+    
+    /** returns the number of rows
+     * @return rows
+     **/
+    public int getRows()
+    {
+        return m_rows;
+    }
+    
+    
+    /** returns the number of columns
+     * @return columns
+     **/
+    public int getColumns()
+    {
+        return m_columns;
+    }
+    
+}
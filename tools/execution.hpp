@@ -0,0 +1,332 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#ifndef __MACHINELEARNING_TOOLS_EXECUTION_HPP
+#define __MACHINELEARNING_TOOLS_EXECUTION_HPP
+
+#include <omp.h>
+#include <vector>
+#include <algorithm>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#include "../errorhandling/exception.hpp"
+#include "language/language.h"
+
+
+#ifdef MACHINELEARNING_OPENBLAS
+extern "C" void openblas_set_num_threads( int );
+#endif
+
+
+namespace machinelearning { namespace tools {
+    
+    
+    /** class of the execution context of the parallel regions. The context holds the number of OpenMP
+     * threads, the number of BLAS threads, the nested parallelism flag and the core pinning. OpenMP stores
+     * the number of threads and the nested flag for each thread, so the context must be applied on each
+     * thread, that calls the algorithms. Algorithms, that create their own threads (thread pool, island model,
+     * steady-state GA), get the context as argument (default the global context) and apply an equal partition
+     * of it on each of their threads, so the threads of the context are shared by the workers / islands.
+     * All other algorithms (eg. clustering, distances, knn, pca) have no context argument, their parallel
+     * regions use the context, that is applied on the calling thread (eg. with setGlobal or apply)
+     * @note a value of zero for the number of threads uses the OpenMP / BLAS default. The number of BLAS threads
+     * can be set only with OpenBLAS (compileflag MACHINELEARNING_OPENBLAS), the ATLAS threads are fixed on the
+     * link (single / multi threaded library). The pinning is supported only on Linux, the cores are the
+     * CPUs of the process affinity mask (eg. set by taskset or a cpuset), which is read on the first pinning
+     * @note the global context is not synchronized, so it should be set before any algorithm runs
+     **/
+    class execution
+    {
+        
+        public :
+        
+            execution( const std::size_t& = 0, const std::size_t& = 0, const bool& = false );
+            void setThreads( const std::size_t& );
+            std::size_t getThreads( void ) const;
+            void setBLASThreads( const std::size_t& );
+            std::size_t getBLASThreads( void ) const;
+            void setNested( const bool& );
+            bool getNested( void ) const;
+            void setPinning( const bool&, const std::size_t& = 0 );
+            bool getPinning( void ) const;
+            std::size_t getFirstCore( void ) const;
+            execution getPartition( const std::size_t&, const std::size_t& ) const;
+            void apply( void ) const;
+        
+            static execution getGlobal( void );
+            static void setGlobal( const execution& );
+        
+        
+        private :
+        
+            /** number of OpenMP threads **/
+            std::size_t m_threads;
+            /** number of BLAS threads **/
+            std::size_t m_blasthreads;
+            /** flag for nested parallel regions **/
+            bool m_nested;
+            /** flag for pinning the threads to cores **/
+            bool m_pinning;
+            /** core of the first thread **/
+            std::size_t m_firstcore;
+        
+            static execution& getGlobalInstance( void );
+        
+            #ifdef __linux__
+            static const std::vector<int>& getCores( void );
+            static std::vector<int> readCores( void );
+            #endif
+        
+    };
+    
+    
+    
+    /** constructor
+     * @param p_threads number of OpenMP threads (zero for the OpenMP default)
+     * @param p_blasthreads number of BLAS threads (zero for the BLAS default)
+     * @param p_nested allows nested parallel regions
+     **/
+    inline execution::execution( const std::size_t& p_threads, const std::size_t& p_blasthreads, const bool& p_nested ) :
+        m_threads( p_threads ),
+        m_blasthreads( p_blasthreads ),
+        m_nested( p_nested ),
+        m_pinning( false ),
+        m_firstcore( 0 )
+    {}
+    
+    
+    /** sets the number of OpenMP threads
+     * @param p_threads number of threads (zero for the OpenMP default)
+     **/
+    inline void execution::setThreads( const std::size_t& p_threads )
+    {
+        m_threads = p_threads;
+    }
+    
+    
+    /** returns the number of OpenMP threads
+     * @return number of threads (zero for the OpenMP default)
+     **/
+    inline std::size_t execution::getThreads( void ) const
+    {
+        return m_threads;
+    }
+    
+    
+    /** sets the number of BLAS threads
+     * @param p_threads number of threads (zero for the BLAS default)
+     **/
+    inline void execution::setBLASThreads( const std::size_t& p_threads )
+    {
+        m_blasthreads = p_threads;
+    }
+    
+    
+    /** returns the number of BLAS threads
+     * @return number of threads (zero for the BLAS default)
+     **/
+    inline std::size_t execution::getBLASThreads( void ) const
+    {
+        return m_blasthreads;
+    }
+    
+    
+    /** enables / disables nested parallel regions
+     * @param p_nested bool
+     **/
+    inline void execution::setNested( const bool& p_nested )
+    {
+        m_nested = p_nested;
+    }
+    
+    
+    /** returns the nested flag
+     * @return bool
+     **/
+    inline bool execution::getNested( void ) const
+    {
+        return m_nested;
+    }
+    
+    
+    /** enables / disables the pinning, thread i of a parallel region runs on core (first core + i),
+     * the core is an index into the CPUs of the process affinity mask
+     * @param p_pinning bool
+     * @param p_firstcore core index of the first thread
+     **/
+    inline void execution::setPinning( const bool& p_pinning, const std::size_t& p_firstcore )
+    {
+        m_pinning   = p_pinning;
+        m_firstcore = p_firstcore;
+    }
+    
+    
+    /** returns the pinning flag
+     * @return bool
+     **/
+    inline bool execution::getPinning( void ) const
+    {
+        return m_pinning;
+    }
+    
+    
+    /** returns the core index of the first thread
+     * @return core index
+     **/
+    inline std::size_t execution::getFirstCore( void ) const
+    {
+        return m_firstcore;
+    }
+    
+    
+    /** splits the threads of the context for concurrent workers, each worker gets an equal part of the
+     * threads (at least one) and the pinned cores of the workers do not overlap
+     * @param p_index index of the worker
+     * @param p_count number of workers
+     * @return context of the worker
+     **/
+    inline execution execution::getPartition( const std::size_t& p_index, const std::size_t& p_count ) const
+    {
+        if (p_count == 0)
+            throw exception::runtime(_("number of workers must be greater than zero"), *this);
+        if (p_index >= p_count)
+            throw exception::runtime(_("worker index must be less than the number of workers"), *this);
+        
+        const std::size_t l_threads = m_threads > 0 ? m_threads : static_cast<std::size_t>(omp_get_max_threads());
+        
+        execution l_partition( *this );
+        l_partition.m_threads   = std::max( static_cast<std::size_t>(1), l_threads / p_count );
+        l_partition.m_firstcore = m_firstcore + p_index * l_partition.m_threads;
+        
+        return l_partition;
+    }
+    
+    
+    /** applies the context on the calling thread, the parallel regions of the thread use the
+     * number of threads and the nested flag of the context, on pinning the threads of a parallel
+     * region are bound to their cores (OpenMP reuses the threads, so the binding is kept)
+     * @note a failed pinning throws an exception after the parallel region
+     **/
+    inline void execution::apply( void ) const
+    {
+        if (m_threads > 0)
+            omp_set_num_threads( static_cast<int>(m_threads) );
+        omp_set_nested( m_nested ? 1 : 0 );
+        
+        #ifdef MACHINELEARNING_OPENBLAS
+        if (m_blasthreads > 0)
+            openblas_set_num_threads( static_cast<int>(m_blasthreads) );
+        #endif
+        
+        #ifdef __linux__
+        if (m_pinning) {
+            const std::vector<int>& l_cores = getCores();
+            bool l_error = false;
+            
+            #pragma omp parallel shared(l_cores, l_error)
+            {
+                cpu_set_t l_set;
+                CPU_ZERO( &l_set );
+                CPU_SET( l_cores[(m_firstcore + static_cast<std::size_t>(omp_get_thread_num())) % l_cores.size()], &l_set );
+                if (sched_setaffinity( 0, sizeof(l_set), &l_set ) != 0)
+                    #pragma omp critical
+                    l_error = true;
+            }
+            
+            if (l_error)
+                throw exception::runtime(_("threads can not be pinned to their cores"), *this);
+        }
+        #endif
+    }
+    
+    
+    #ifdef __linux__
+    
+    /** returns the CPUs of the process affinity mask, the mask is read on the first call, so
+     * the list is not changed by the pinning of the calling thread
+     * @return vector with CPU ids
+     **/
+    inline const std::vector<int>& execution::getCores( void )
+    {
+        static const std::vector<int> l_cores = readCores();
+        return l_cores;
+    }
+    
+    
+    /** reads the CPUs of the affinity mask of the calling thread
+     * @return vector with CPU ids
+     **/
+    inline std::vector<int> execution::readCores( void )
+    {
+        cpu_set_t l_set;
+        CPU_ZERO( &l_set );
+        if (sched_getaffinity( 0, sizeof(l_set), &l_set ) != 0)
+            throw exception::runtime(_("affinity mask of the process can not be read"));
+        
+        std::vector<int> l_cores;
+        for(int i=0; i < CPU_SETSIZE; ++i)
+            if (CPU_ISSET(i, &l_set))
+                l_cores.push_back( i );
+        
+        if (l_cores.empty())
+            throw exception::runtime(_("affinity mask of the process is empty"));
+        
+        return l_cores;
+    }
+    
+    #endif
+    
+    
+    /** returns the global instance (the instance is created on the first call)
+     * @return reference of the instance
+     **/
+    inline execution& execution::getGlobalInstance( void )
+    {
+        static execution l_global;
+        return l_global;
+    }
+    
+    
+    /** returns a copy of the global context
+     * @return context
+     **/
+    inline execution execution::getGlobal( void )
+    {
+        return getGlobalInstance();
+    }
+    
+    
+    /** sets the global context and applies it on the calling thread
+     * @param p_execution context
+     **/
+    inline void execution::setGlobal( const execution& p_execution )
+    {
+        getGlobalInstance() = p_execution;
+        p_execution.apply();
+    }
+    
+}}
+#endif
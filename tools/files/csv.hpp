@@ -26,10 +26,12 @@
 #ifndef __MACHINELEARNING_TOOLS_FILES_CSV_HPP
 #define __MACHINELEARNING_TOOLS_FILES_CSV_HPP
 
+#include <omp.h>
 #include <fstream>
 #include <iostream>
 #include <string>
 #include <algorithm>
+#include <utility>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/algorithm/string.hpp> 
@@ -109,6 +111,8 @@ namespace machinelearning { namespace tools { namespace files {
      * @param p_file filename as string
      * @param p_separator characters for sperator (default , ; \\t blank)
      * @param p_header first element in the input file is the size of the input matrix
+     * @note the rows are placed by a parallel first touch, the placement is kept only if the
+     * result initializes a matrix (see tools::matrix::firsttouch)
      * @return ublas vector with data
      **/
     template<typename T> inline ublas::matrix<T> csv::readBlasMatrix( const std::string& p_file, const std::string& p_separator, const bool& p_header ) const
@@ -164,10 +168,29 @@ namespace machinelearning { namespace tools { namespace files {
             throw exception::runtime(_("row size must be greater than zero"), *this);
 
         
+        // the rows are converted with a static schedule, so the memory pages are placed
+        // on the NUMA node of the thread (see tools::matrix::firsttouch)
+        // exceptions must not leave the parallel region, so the first malformed field is
+        // stored and its conversion is repeated after the loop to throw the cast exception
         ublas::matrix<T> l_mat( l_row, l_col ); 
-        for(std::size_t i=0; l_mat.size1(); ++i)             
+        bool l_error = false;
+        std::pair<std::size_t, std::size_t> l_errorfield;
+        
+        #pragma omp parallel for schedule(static) shared(l_mat, l_data, l_error, l_errorfield)
+        for(std::size_t i=0; i < l_mat.size1(); ++i)             
             for(std::size_t j=0; (j < l_mat.size2()) && (j < l_data[i].size()); ++j)
-                l_mat(i,j) =  boost::lexical_cast<T>( l_data[i][j] );
+                try {
+                    l_mat(i,j) =  boost::lexical_cast<T>( l_data[i][j] );
+                } catch (...) {
+                    #pragma omp critical
+                    if ( !l_error || (std::make_pair(i, j) < l_errorfield) ) {
+                        l_error      = true;
+                        l_errorfield = std::make_pair(i, j);
+                    }
+                }
+        
+        if (l_error)
+            boost::lexical_cast<T>( l_data[l_errorfield.first][l_errorfield.second] );
         
         return l_mat;
     }
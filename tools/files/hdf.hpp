@@ -26,8 +26,10 @@
 #ifndef __MACHINELEARNING_TOOLS_FILES_HDF_HPP
 #define __MACHINELEARNING_TOOLS_FILES_HDF_HPP
 
+#include <omp.h>
 #include <string>
 #include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/ublas/storage.hpp>
 #include <boost/algorithm/string.hpp> 
@@ -336,6 +338,8 @@ namespace machinelearning { namespace tools { namespace files {
     /** reads a matrix with convert to blas matrix
      * @param p_path dataset name
      * @param p_datatype datatype for reading data
+     * @note the rows are placed by a parallel first touch, the placement is kept only if the
+     * result initializes a matrix (see tools::matrix::firsttouch)
      * @return ublas matrix
      **/ 
     template<typename T> inline ublas::matrix<T> hdf::readBlasMatrix( const std::string& p_path, const datatype& p_datatype ) const
@@ -366,7 +370,15 @@ namespace machinelearning { namespace tools { namespace files {
         
         l_dataspace.close();
         l_dataset.close();
-        return l_mat;
+        
+        // convert to row-major with a parallel first touch of the rows, so the memory pages
+        // are placed on the NUMA node of the thread (see tools::matrix::firsttouch)
+        ublas::matrix<T> l_result( l_mat.size1(), l_mat.size2() );
+        #pragma omp parallel for schedule(static) shared(l_result, l_mat)
+        for(std::size_t i=0; i < l_result.size1(); ++i)
+            ublas::row(l_result, i) = ublas::row(l_mat, i);
+        
+        return l_result;
     }
     
     
@@ -25,6 +25,7 @@
 #ifndef __MACHINELEARNING_TOOLS_LAPACK_HPP
 #define __MACHINELEARNING_TOOLS_LAPACK_HPP
 
+#include <algorithm>
 #include <boost/numeric/ublas/matrix.hpp>
 #include <boost/numeric/ublas/vector.hpp>
 #include <boost/numeric/bindings/blas.hpp>
@@ -35,6 +36,7 @@
 #include <boost/numeric/bindings/lapack/driver/gesv.hpp> 
 #include <boost/numeric/bindings/lapack/driver/gesvd.hpp>
 #include <boost/numeric/bindings/lapack/computational/hseqr.hpp>
+#include <boost/numeric/bindings/lapack/computational/geqrf.hpp>
 
 
 #include "../errorhandling/exception.hpp"
@@ -73,6 +75,7 @@ namespace machinelearning { namespace tools {
             template<typename T> static void eigen( const ublas::matrix<T>&, const ublas::matrix<T>&, ublas::vector<T>&, ublas::matrix<T>&, const bool& = true );
             template<typename T> static void svd( const ublas::matrix<T>&, ublas::vector<T>&, ublas::matrix<T>&, ublas::matrix<T>&, const bool& = true );
             template<typename T> static void solve( const ublas::matrix<T>&, const ublas::vector<T>&, ublas::vector<T>& );
+            template<typename T> static ublas::matrix<T> qr( const ublas::matrix<T>& );
             //template<typename T> static ublas::matrix<T> expm( const ublas::matrix<T>& );
             template<typename T> static ublas::vector<T> perronfrobenius( const ublas::matrix<T>&, const std::size_t& );
             template<typename T> static ublas::vector<T> perronfrobenius( const ublas::matrix<T>&, const std::size_t&, const ublas::vector<T>& );
@@ -229,6 +232,28 @@ namespace machinelearning { namespace tools {
     }
   
      
+    /** QR decomposition, only the upper triangular matrix R is returned (Q is not formed)
+     * @param p_matrix input matrix
+     * @return upper triangular matrix with min(rows, columns) rows
+    **/
+    template<typename T> inline ublas::matrix<T> lapack::qr( const ublas::matrix<T>& p_matrix )
+    {
+        // copy matrix for LAPACK
+        ublas::matrix<T, ublas::column_major> l_matrix(p_matrix);
+        ublas::vector<T> l_tau( std::min(l_matrix.size1(), l_matrix.size2()) );
+        
+        // the Householder vectors are stored below the diagonal, R above
+        linalg::geqrf( l_matrix, l_tau, linalg::optimal_workspace() );
+        
+        ublas::matrix<T> l_r( l_tau.size(), l_matrix.size2(), 0 );
+        for(std::size_t i=0; i < l_r.size1(); ++i)
+            for(std::size_t j=i; j < l_r.size2(); ++j)
+                l_r(i,j) = l_matrix(i,j);
+        
+        return l_r;
+    }
+    
+    
     /** generates the eigenvalue / -vector with the perronforbenius theorem
      * @see http://en.wikipedia.org/wiki/Perron–Frobenius_theorem
      * @param p_matrix input matrix
@@ -29,9 +29,24 @@
 #include <fstream>
 
 #include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <boost/type_traits/integral_constant.hpp>
 
 #ifdef MACHINELEARNING_MPI
 #include <boost/mpi.hpp>
+#include <boost/serialization/utility.hpp>
+#endif
+
+
+/** maximum log level, that is compiled into the write calls with a template level, messages with a higher level are removed at compile time **/
+#ifndef MACHINELEARNING_LOGGER_MAXLEVEL
+#define MACHINELEARNING_LOGGER_MAXLEVEL info
+#endif
+
+/** number of messages, that can be stored in the queue of the logger (must be less than 65535) **/
+#ifndef MACHINELEARNING_LOGGER_QUEUESIZE
+#define MACHINELEARNING_LOGGER_QUEUESIZE 8192
 #endif
 
 
@@ -55,6 +70,12 @@ namespace machinelearning { namespace tools {
         MPI::Finalize())
      * @endcode
      * The MPI libraries must be compiled with multithread support
+     * @note the write calls push the formatted message into a bounded lock-free queue, a background thread writes the messages
+     * in batches to the file. The file is flushed after the flush interval or directly on error / exception / assert messages.
+     * If the queue is full, the message is dropped and counted or the caller waits until the writer thread has freed space.
+     * The write calls with the level as template parameter (eg write<logger::info>(...)) are removed at compile time, if the
+     * level is above MACHINELEARNING_LOGGER_MAXLEVEL (default info), the write calls with a runtime level check the maximum
+     * level at runtime. The queue size is set with MACHINELEARNING_LOGGER_QUEUESIZE
      * @todo adding stream operator for writing data to logger
      * @todo removing Boost Thread and change it to OpenMP support
      **/
@@ -73,6 +94,12 @@ namespace machinelearning { namespace tools {
                 warn,
                 info
             };
+        
+            /** behaviour of a write call, if the queue is full **/
+            enum overflow {
+                drop,
+                block
+            };
                 
             static bool exists( void );
             static void createInstance( const std::string& = "", const std::string& = "" );
@@ -81,12 +108,18 @@ namespace machinelearning { namespace tools {
             void setLevel( const logstate& );
             logstate getLevel( void ) const;
             std::string getFilename( void ) const;
+            void setOverflow( const overflow& );
+            overflow getOverflow( void ) const;
+            void setFlushInterval( const std::size_t& );
+            std::size_t getDropped( void ) const;
             template<typename T> void write( const logstate&, const T& );
+            template<logstate L, typename T> void write( const T& );
                             
             #ifdef MACHINELEARNING_MPI
             void startListener( const mpi::communicator& );
             void shutdownListener( const mpi::communicator& );
             template<typename T> void write( const mpi::communicator&, const logstate&, const T& );
+            template<logstate L, typename T> void write( const mpi::communicator&, const T& );
             #endif
         
         
@@ -99,10 +132,30 @@ namespace machinelearning { namespace tools {
             std::string m_filename;
             /** logstate for writing data **/
             logstate m_logstate;
-            /** file handle **/
+            /** file handle (used only by the writer thread) **/
             std::ofstream m_file;
-            /** mutex for locking **/
-            boost::mutex m_muxwriter;
+            /** queue item **/
+            struct message
+            {
+                /** log level **/
+                logstate state;
+                /** formatted message **/
+                std::string text;
+            };
+            /** queue with the messages, that are not written **/
+            boost::lockfree::queue< message*, boost::lockfree::fixed_sized<true> > m_queue;
+            /** overflow behaviour **/
+            overflow m_overflow;
+            /** flush interval in milliseconds **/
+            boost::atomic<std::size_t> m_flushinterval;
+            /** number of dropped messages, that are not reported **/
+            boost::atomic<std::size_t> m_dropped;
+            /** number of all dropped messages **/
+            boost::atomic<std::size_t> m_droppedall;
+            /** bool for running the writer thread **/
+            boost::atomic<bool> m_running;
+            /** writer thread **/
+            boost::thread m_writer;
         
         
             logger( const std::string& = "", const std::string& = "" );  
@@ -110,8 +163,15 @@ namespace machinelearning { namespace tools {
             logger( const logger& ) {};
             logger& operator=( const logger& );
         
+            /** compile-time filter, the type is true, if the log level is compiled into the write calls **/
+            template<logstate L> struct compiled : public boost::integral_constant<bool, (L <= MACHINELEARNING_LOGGER_MAXLEVEL)> {};
+        
+            template<typename T> void write( const logstate&, const T&, const boost::true_type& );
+            template<typename T> void write( const logstate&, const T&, const boost::false_type& );
             template<typename T> void logformat( const logstate&, const T&, std::ostringstream& ) const;
-            void write2file( const std::ostringstream& );
+            void push( const logstate&, const std::string& );
+            void writer( void );
+            std::size_t writeQueue( bool& );
         
         
             #ifdef MACHINELEARNING_MPI
@@ -120,13 +180,17 @@ namespace machinelearning { namespace tools {
             static std::size_t m_mpitag;
             /** end-of-transmission string for closing the MPI logger listener **/
             static std::string m_mpieot;
+            /** MPI message with the log level and the formatted message **/
+            typedef std::pair<int, std::string> mpimessage;
             /** mutex for creating the listener **/
             boost::mutex m_muxlistener;
             /** mutex for finalizing **/
             boost::mutex m_muxfinalize;
             /** bool for running the listener **/
-            bool m_listenerrunning;
+            boost::atomic<bool> m_listenerrunning;
         
+            template<typename T> void write( const mpi::communicator&, const logstate&, const T&, const boost::true_type& );
+            template<typename T> void write( const mpi::communicator&, const logstate&, const T&, const boost::false_type& );
             void listener( const mpi::communicator& );
         
             #endif
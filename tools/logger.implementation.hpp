@@ -35,12 +35,16 @@
 #include <sstream>
 #include <fstream>
 
+#include <boost/bind.hpp>
 #include <boost/thread.hpp>
+#include <boost/atomic.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/lockfree/queue.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 #ifdef MACHINELEARNING_MPI
 #include <boost/mpi.hpp>
-#include <boost/bind.hpp>
+#include <boost/serialization/utility.hpp>
 #endif
 
 #include "../errorhandling/exception.hpp"
@@ -64,7 +68,13 @@ namespace machinelearning { namespace tools {
     inline logger::logger( const std::string& p_pathsuffix, const std::string& p_filename ) :
         m_filename(),
         m_logstate(none),
-        m_muxwriter()
+        m_queue(MACHINELEARNING_LOGGER_QUEUESIZE),
+        m_overflow(drop),
+        m_flushinterval(500),
+        m_dropped(0),
+        m_droppedall(0),
+        m_running(true),
+        m_writer()
         #ifdef MACHINELEARNING_MPI
         , m_muxlistener(),
         m_muxfinalize(),
@@ -86,15 +96,20 @@ namespace machinelearning { namespace tools {
             temppath /= "log.txt";
 
         m_filename = temppath.string();
+        
+        m_writer = boost::thread( boost::bind( &machinelearning::tools::logger::writer, this ) );
     };
 
 
-    /** destructor **/
+    /** destructor, writes all queued messages **/
     inline logger::~logger( void )
     {
         #ifdef MACHINELEARNING_MPI
         m_listenerrunning = false;
         #endif
+        
+        m_running = false;
+        m_writer.join();
         m_file.close();
     }
 
@@ -141,6 +156,7 @@ namespace machinelearning { namespace tools {
     {
         assert(m_instance);
         delete m_instance;
+        m_instance = NULL;
     }
 
 
@@ -171,12 +187,77 @@ namespace machinelearning { namespace tools {
     }
 
 
-    /** writes the data in the local log file 
+    /** sets the behaviour, if the message queue is full
+     * @param p_overflow drop the message or block until the queue has free space
+     **/
+    inline void logger::setOverflow( const overflow& p_overflow )
+    {
+        m_overflow = p_overflow;
+    }
+
+
+    /** returns the overflow behaviour
+     * @return overflow
+     **/
+    inline logger::overflow logger::getOverflow( void ) const
+    {
+        return m_overflow;
+    }
+
+
+    /** sets the interval, after that the writer thread flushs the file
+     * (error, exception and assert messages are flushed directly)
+     * @param p_milliseconds interval in milliseconds
+     **/
+    inline void logger::setFlushInterval( const std::size_t& p_milliseconds )
+    {
+        m_flushinterval = p_milliseconds;
+    }
+
+
+    /** returns the number of dropped messages
+     * @return number of messages
+     **/
+    inline std::size_t logger::getDropped( void ) const
+    {
+        return m_droppedall;
+    }
+
+
+    /** writes the data in the local log file, the level is removed at compile time, if it is
+     * above MACHINELEARNING_LOGGER_MAXLEVEL
+     * @param p_val value
+     **/
+    template<logger::logstate L, typename T> inline void logger::write( const T& p_val )
+    {
+        write( L, p_val, compiled<L>() );
+    }
+    
+    
+    /** writes the data of a compiled log level
+     * @param p_state log level
+     * @param p_val value
+     **/
+    template<typename T> inline void logger::write( const logger::logstate& p_state, const T& p_val, const boost::true_type& )
+    {
+        write( p_state, p_val );
+    }
+    
+    
+    /** empty write call of a log level, that is removed at compile time **/
+    template<typename T> inline void logger::write( const logger::logstate&, const T&, const boost::false_type& )
+    {}
+    
+    
+    /** writes the data in the local log file, the maximum level is checked at runtime
      * @param p_state log level
      * @param p_val value
      **/
     template<typename T> inline void logger::write( const logger::logstate& p_state, const T& p_val )
     {
+        if (p_state > MACHINELEARNING_LOGGER_MAXLEVEL)
+            return;
+        
         if ( !(
                #ifndef MACHINELEARNING_NDEBUG
                (p_state == assert) || 
@@ -188,7 +269,7 @@ namespace machinelearning { namespace tools {
         std::ostringstream l_stream;
         l_stream << "local - ";
         logformat(p_state, p_val, l_stream);
-        write2file( l_stream );
+        push( p_state, l_stream.str() );
     }
 
 
@@ -214,29 +295,100 @@ namespace machinelearning { namespace tools {
     }
 
 
-    /** writes the output stream to the file with thread locking
-     * @param p_data output stream
+    /** pushs a message into the queue, the call does not lock
+     * @param p_state log level
+     * @param p_data formatted message
      **/
-    inline void logger::write2file( const std::ostringstream& p_data )
+    inline void logger::push( const logstate& p_state, const std::string& p_data )
     {
-        if (p_data.str().empty())
+        if (p_data.empty())
             return;
         
-        // lock will remove with the destructor call
-        boost::lock_guard<boost::mutex> l_lock(m_muxwriter);         
+        message* l_message = new message();
+        l_message->state   = p_state;
+        l_message->text    = p_data;
+        
+        while (!m_queue.push(l_message)) {
+            if (m_overflow == drop) {
+                delete l_message;
+                m_dropped++;
+                m_droppedall++;
+                return;
+            }
+            
+            boost::this_thread::yield();
+        }
+    }
+
+
+    /** thread method, that writes the queued messages in batches to the file and flushs
+     * the file after the flush interval or on urgent messages. On shutdown the
+     * queue is written completely
+     **/
+    inline void logger::writer( void )
+    {
+        boost::posix_time::ptime l_flush = boost::posix_time::microsec_clock::universal_time();
+        bool l_dirty                     = false;
         
-        if (!m_file.is_open()) {
-            fsys::path logpath( m_filename );
-            logpath = logpath.remove_filename();
+        for(;;) {
+            // the state is read before the queue, so the last loop writes all messages
+            const bool l_running = m_running;
+            bool l_urgent        = false;
+            const std::size_t l_count = writeQueue( l_urgent );
+            l_dirty = l_dirty || (l_count > 0);
             
-            if (!fsys::is_directory(logpath))
-                fsys::create_directories( logpath );
+            const boost::posix_time::ptime l_now = boost::posix_time::microsec_clock::universal_time();
+            if (l_dirty && (l_urgent || (!l_running) || (l_now - l_flush >= boost::posix_time::milliseconds(static_cast<long>(m_flushinterval))))) {
+                m_file.flush();
+                l_flush = l_now;
+                l_dirty = false;
+            }
             
-            m_file.open( m_filename.c_str(), std::ios_base::app );
+            if (!l_running)
+                break;
+            if (l_count == 0)
+                boost::this_thread::sleep( boost::posix_time::milliseconds(1) );
         }
+    }
+
+
+    /** writes all queued messages to the file (the file stream buffers the data)
+     * @param p_urgent is set to true, if a message must be flushed directly
+     * @return number of written messages
+     **/
+    inline std::size_t logger::writeQueue( bool& p_urgent )
+    {
+        std::size_t l_count = 0;
+        message* l_message  = NULL;
         
-        m_file << p_data.str() << "\n";
-        m_file.flush();
+        while (m_queue.pop(l_message)) {
+            if (!m_file.is_open()) {
+                fsys::path logpath( m_filename );
+                logpath = logpath.remove_filename();
+                
+                if (!fsys::is_directory(logpath))
+                    fsys::create_directories( logpath );
+                
+                m_file.open( m_filename.c_str(), std::ios_base::app );
+            }
+            
+            m_file << l_message->text << "\n";
+            p_urgent = p_urgent || (l_message->state == exception) || (l_message->state == error)
+                       #ifndef MACHINELEARNING_NDEBUG
+                       || (l_message->state == assert)
+                       #endif
+                       ;
+            
+            delete l_message;
+            l_count++;
+        }
+        
+        // report the dropped messages after the messages, that are written
+        const std::size_t l_dropped = m_dropped.exchange(0);
+        if ((l_count > 0) && (l_dropped > 0))
+            m_file << "[warn]       " << l_dropped << " log messages are dropped, because the queue is full\n";
+        
+        return l_count;
     }
 
 
@@ -281,33 +433,61 @@ namespace machinelearning { namespace tools {
             std::size_t l_eot = p_mpi.size() - 1;
             while (l_eot > 0) {
                 while (boost::optional<mpi::status> l_status = p_mpi.iprobe(mpi::any_source, m_mpitag)) {
-                    std::string l_str;               
-                    p_mpi.recv(  l_status->source(), l_status->tag(), l_str );
+                    mpimessage l_message;
+                    p_mpi.recv(  l_status->source(), l_status->tag(), l_message );
                     
-                    if (l_str != m_mpieot) {
-                        std::ostringstream l_stream;
-                        l_stream << l_str;
-                        write2file( l_stream );
-                    } else
+                    if (l_message.second != m_mpieot)
+                        push( static_cast<logstate>(l_message.first), l_message.second );
+                    else
                         l_eot--;
                 }
                 boost::this_thread::yield();
             }
         } else 
-            p_mpi.isend(0, m_mpitag, m_mpieot);
+            p_mpi.isend(0, m_mpitag, mpimessage(none, m_mpieot));
         
         p_mpi.barrier();
     }
 
 
+    /** write log entry with MPI, the level is removed at compile time, if it is above MACHINELEARNING_LOGGER_MAXLEVEL
+     * @param p_mpi MPI object
+     * @param p_val value
+     **/
+    template<logger::logstate L, typename T> inline void logger::write( const mpi::communicator& p_mpi, const T& p_val )
+    {
+        write( p_mpi, L, p_val, compiled<L>() );
+    }
+    
+    
+    /** writes the MPI log entry of a compiled log level
+     * @param p_mpi MPI object
+     * @param p_state log level
+     * @param p_val value
+     **/
+    template<typename T> inline void logger::write( const mpi::communicator& p_mpi, const logstate& p_state, const T& p_val, const boost::true_type& )
+    {
+        write( p_mpi, p_state, p_val );
+    }
+    
+    
+    /** empty MPI write call of a log level, that is removed at compile time **/
+    template<typename T> inline void logger::write( const mpi::communicator&, const logstate&, const T&, const boost::false_type& )
+    {}
+    
+    
     /** write log entry. If the CPU rank == 0 the log will write to the file, on other CPU rank the message
-     * is send to the CPU 0 and write down there. The local log state is relevant for writing
+     * is send with its log level to the CPU 0 and write down there. The local log state is relevant for writing,
+     * the maximum level is checked at runtime
      * @param p_mpi MPI object
      * @param p_state log level
      * @param p_val value
      **/     
     template<typename T> inline void logger::write( const mpi::communicator& p_mpi, const logstate& p_state, const T& p_val )
     {
+        if (p_state > MACHINELEARNING_LOGGER_MAXLEVEL)
+            return;
+        
         if ( (m_logstate == none) || (p_state == none) || (p_state > m_logstate) )
             return;
         
@@ -316,13 +496,14 @@ namespace machinelearning { namespace tools {
         logformat(p_state, p_val, l_stream);
         
         if (p_mpi.rank() == 0)
-            write2file( l_stream );
+            push( p_state, l_stream.str() );
         else
-            p_mpi.isend(0, m_mpitag, l_stream.str());
+            p_mpi.isend(0, m_mpitag, mpimessage(p_state, l_stream.str()));
     }
 
 
-    /** thread method that receive the asynchrone messages of the MPI interface.
+    /** thread method that receive the asynchrone messages of the MPI interface
+     * and pushs them into the message queue
      * @param p_mpi MPI object
      **/
     inline void logger::listener( const mpi::communicator& p_mpi )
@@ -331,12 +512,9 @@ namespace machinelearning { namespace tools {
         
         while (m_listenerrunning) {
             while (boost::optional<mpi::status> l_status = p_mpi.iprobe(mpi::any_source, m_mpitag)) {
-                std::string l_str;
-                std::ostringstream l_stream;
-                
-                p_mpi.recv(  l_status->source(), l_status->tag(), l_str );
-                l_stream << l_str;
-                write2file( l_stream );
+                mpimessage l_message;
+                p_mpi.recv(  l_status->source(), l_status->tag(), l_message );
+                push( static_cast<logstate>(l_message.first), l_message.second );
             }
             boost::this_thread::yield();
         }
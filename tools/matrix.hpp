@@ -80,6 +80,8 @@ namespace machinelearning { namespace tools {
             template<typename T> static ublas::matrix<T> invert( const ublas::matrix<T>&);
             template<typename T> static ublas::matrix<T> repeat( const ublas::vector<T>&, const rowtype& p_which = row);
             template<typename T> static ublas::matrix<T> repeat( const ublas::vector<T>&, const std::size_t&, const rowtype& p_which = row);
+            template<typename T> static ublas::matrix<T> firsttouch( const ublas::matrix<T>& );
+            template<typename T> static void firsttouch( const ublas::matrix<T>&, ublas::matrix<T>& );
     };
     
     
@@ -543,6 +545,41 @@ namespace machinelearning { namespace tools {
         
         return l_mat;
     }
+    
+    
+    /** copies a matrix with a parallel first touch. The rows are written with a static schedule,
+     * so on NUMA systems the memory pages of each row block are placed on the node of the thread,
+     * that has written the block. Loops with a static schedule over the rows and the same
+     * number of threads (see tools::execution) work on local memory in each iteration.
+     * The placement is kept only if the result initializes a matrix, an assignment to an
+     * existing matrix copies the data serially (use the overload with the target matrix)
+     * @param p_matrix input matrix
+     * @return copy of the matrix
+     **/
+    template<typename T> inline ublas::matrix<T> matrix::firsttouch( const ublas::matrix<T>& p_matrix )
+    {
+        // the constructor does not initialize the storage, so the pages are placed on the first write
+        ublas::matrix<T> l_mat( p_matrix.size1(), p_matrix.size2() );
+        
+        #pragma omp parallel for schedule(static) shared(l_mat)
+        for(std::size_t i=0; i < p_matrix.size1(); ++i)
+            ublas::row(l_mat, i) = ublas::row(p_matrix, i);
+        
+        return l_mat;
+    }
+    
+    
+    /** copies a matrix with a parallel first touch into an existing matrix, the data is
+     * copied into new memory and swapped with the storage of the target matrix, so the
+     * placement of the first touch is kept (source and target can be the same matrix)
+     * @param p_matrix input matrix
+     * @param p_target target matrix, that is resized to the input matrix
+     **/
+    template<typename T> inline void matrix::firsttouch( const ublas::matrix<T>& p_matrix, ublas::matrix<T>& p_target )
+    {
+        ublas::matrix<T> l_mat( firsttouch(p_matrix) );
+        p_target.swap( l_mat );
+    }
         
 }}
 #endif
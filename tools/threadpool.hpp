@@ -0,0 +1,195 @@
+/** 
+ @cond
+ ############################################################################
+ # LGPL License                                                             #
+ #                                                                          #
+ # This file is part of the Machine Learning Framework.                     #
+ # Copyright (c) 2010-2012, Philipp Kraus, <philipp.kraus@flashpixx.de>     #
+ # This program is free software: you can redistribute it and/or modify     #
+ # it under the terms of the GNU Lesser General Public License as           #
+ # published by the Free Software Foundation, either version 3 of the       #
+ # License, or (at your option) any later version.                          #
+ #                                                                          #
+ # This program is distributed in the hope that it will be useful,          #
+ # but WITHOUT ANY WARRANTY; without even the implied warranty of           #
+ # MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the            #
+ # GNU Lesser General Public License for more details.                      #
+ #                                                                          #
+ # You should have received a copy of the GNU Lesser General Public License #
+ # along with this program. If not, see <http://www.gnu.org/licenses/>.     #
+ ############################################################################
+ @endcond
+ **/
+
+#ifndef __MACHINELEARNING_TOOLS_THREADPOOL_HPP
+#define __MACHINELEARNING_TOOLS_THREADPOOL_HPP
+
+#include <deque>
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+
+#include "../errorhandling/exception.hpp"
+#include "language/language.h"
+#include "execution.hpp"
+
+
+namespace machinelearning { namespace tools {
+    
+    
+    /** class of a fixed size thread pool, the jobs are run in the order
+     * of the post calls. The destructor runs all queued jobs and joins
+     * the threads, so a job must not wait of a job that is posted later.
+     * Exceptions of a job are not passed, so each job must catch
+     * its exceptions. The threads of the execution context are split
+     * over the workers, so the parallel regions of the jobs do not
+     * oversubscribe the cores
+     **/
+    class threadpool
+    {
+        
+        public :
+        
+            threadpool( const std::size_t& = boost::thread::hardware_concurrency(), const execution& = execution::getGlobal() );
+            ~threadpool( void );
+            #ifndef SWIG
+            void post( const boost::function<void()>& );
+            #endif
+            std::size_t getSize( void ) const;
+            std::size_t getQueueSize( void ) const;
+            execution getExecution( void ) const;
+        
+        
+        private :
+        
+            /** worker threads **/
+            boost::thread_group m_threads;
+            /** number of worker threads **/
+            const std::size_t m_size;
+            /** execution context of the pool **/
+            const execution m_execution;
+            /** queue of the jobs, that are not started **/
+            std::deque< boost::function<void()> > m_queue;
+            /** mutex of the queue **/
+            mutable boost::mutex m_mutex;
+            /** condition for notifying the workers **/
+            boost::condition_variable m_condition;
+            /** flag, that is false on destruction **/
+            bool m_running;
+        
+            threadpool( const threadpool& );
+            threadpool& operator=( const threadpool& );
+            void run( const std::size_t& );
+        
+    };
+    
+    
+    /** constructor, that starts the worker threads
+     * @param p_size number of threads
+     * @param p_execution execution context, that is split over the threads
+     **/
+    inline threadpool::threadpool( const std::size_t& p_size, const execution& p_execution ) :
+        m_threads(),
+        m_size( p_size ),
+        m_execution( p_execution ),
+        m_queue(),
+        m_mutex(),
+        m_condition(),
+        m_running( true )
+    {
+        if (p_size == 0)
+            throw exception::runtime(_("number of threads must be greater than zero"), *this);
+        
+        for(std::size_t i=0; i < m_size; ++i)
+            m_threads.create_thread( boost::bind( &threadpool::run, this, i ) );
+    }
+    
+    
+    /** destructor, runs the queued jobs and joins the threads **/
+    inline threadpool::~threadpool( void )
+    {
+        {
+            boost::lock_guard<boost::mutex> l_lock(m_mutex);
+            m_running = false;
+        }
+        m_condition.notify_all();
+        m_threads.join_all();
+    }
+    
+    
+    /** adds a job to the queue
+     * @param p_job job function
+     **/
+    inline void threadpool::post( const boost::function<void()>& p_job )
+    {
+        {
+            boost::lock_guard<boost::mutex> l_lock(m_mutex);
+            m_queue.push_back( p_job );
+        }
+        m_condition.notify_one();
+    }
+    
+    
+    /** returns the number of threads
+     * @return number of threads
+     **/
+    inline std::size_t threadpool::getSize( void ) const
+    {
+        return m_size;
+    }
+    
+    
+    /** returns the number of jobs, that are not started
+     * @return number of jobs
+     **/
+    inline std::size_t threadpool::getQueueSize( void ) const
+    {
+        boost::lock_guard<boost::mutex> l_lock(m_mutex);
+        return m_queue.size();
+    }
+    
+    
+    /** returns the execution context
+     * @return context
+     **/
+    inline execution threadpool::getExecution( void ) const
+    {
+        return m_execution;
+    }
+    
+    
+    /** worker loop, that runs the jobs until the pool is destroyed and the queue is empty
+     * @param p_index index of the worker
+     **/
+    inline void threadpool::run( const std::size_t& p_index )
+    {
+        // a failed pinning must not stop the thread, it runs unpinned
+        try {
+            m_execution.getPartition( p_index, m_size ).apply();
+        } catch (...) {}
+        
+        for(;;) {
+            boost::function<void()> l_job;
+            
+            {
+                boost::unique_lock<boost::mutex> l_lock(m_mutex);
+                while (m_running && m_queue.empty())
+                    m_condition.wait(l_lock);
+                
+                if (m_queue.empty())
+                    return;
+                
+                l_job = m_queue.front();
+                m_queue.pop_front();
+            }
+            
+            // a throwing job must not stop the worker
+            try {
+                l_job();
+            } catch (...) {}
+        }
+    }
+    
+}}
+#endif
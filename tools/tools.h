@@ -41,6 +41,8 @@ namespace machinelearning {
 #include "vector.hpp"
 #include "lapack.hpp"
 #include "logger.hpp"
+#include "execution.hpp"
+#include "threadpool.hpp"
 #include "sources/sources.h"
 #include "files/files.h"
 #include "language/language.h"